@@ -76,8 +76,9 @@
 // FluidsContainer Implementation
 // ------------------------------
 
-FluidsContainer::FluidsContainer()
+FluidsContainer::FluidsContainer(bool load_on_first_use)
 {
+	parsed_JSON = false;
 	
 	// The pure fluids
 	FluidsList.push_back(new WaterClass());
@@ -212,22 +213,9 @@ FluidsContainer::FluidsContainer()
 	FluidsList.push_back(new R507AClass());
 	FluidsList.push_back(new R407FClass());
 
-	// Includes the C++ JSON code for all the fluids as the variable JSON_code
-	#include "JSON_code.h"
-
-	// Includes the C++ JSON code for the CAS number lookup as the variable JSON_cas
-	#include "JSON_CAS.h"
-
-	JSON.Parse<0>(JSON_code);
-	JSON_CAS.Parse<0>(JSON_cas);
-
 	// Build the map of fluid names mapping to pointers to the Fluid class instances
 	for (std::vector<Fluid*>::iterator it = FluidsList.begin(); it != FluidsList.end(); it++)
 	{
-		//// Load all the parameters related to the Critical point spline
-		set_critical_spline_constants((*it));
-		// Call the post_load routine
-		(*it)->post_load(JSON, JSON_CAS);
 		// Load up entry in map
 		fluid_name_map[(*it)->get_name()] = *it;
 
@@ -239,6 +227,54 @@ FluidsContainer::FluidsContainer()
 			(*it)->add_alias(ucasename);
 		}
 	}
+
+	if (!load_on_first_use)
+	{
+		for (std::vector<Fluid*>::iterator it = FluidsList.begin(); it != FluidsList.end(); it++)
+		{
+			load(*it);
+		}
+	}
+}
+
+Fluid * FluidsContainer::load(Fluid *pFluid)
+{
+	if (pFluid == NULL || pFluid->loaded){ return pFluid; }
+
+	// post_load can call back into the container, hence the recursive lock.  A re-entrant call
+	// on this thread gets the fluid as it is, other threads wait here until it is loaded
+	CoolPropRecursiveLockGuard guard(load_lock);
+	if (pFluid->loaded || pFluid->loading){ return pFluid; }
+
+	if (!parsed_JSON)
+	{
+		// Includes the C++ JSON code for all the fluids as the variable JSON_code
+		#include "JSON_code.h"
+
+		// Includes the C++ JSON code for the CAS number lookup as the variable JSON_cas
+		#include "JSON_CAS.h"
+
+		JSON.Parse<0>(JSON_code);
+		JSON_CAS.Parse<0>(JSON_cas);
+		parsed_JSON = true;
+	}
+
+	pFluid->loading = true;
+	try
+	{
+		//// Load all the parameters related to the Critical point spline
+		set_critical_spline_constants(pFluid);
+		// Call the post_load routine
+		pFluid->post_load(JSON, JSON_CAS);
+	}
+	catch(...)
+	{
+		pFluid->loading = false;
+		throw;
+	}
+	pFluid->loading = false;
+	pFluid->loaded = true;
+	return pFluid;
 }
 
 // Destructor
@@ -255,6 +291,8 @@ bool FluidsContainer::add_REFPROP_fluid(std::string FluidName, std::vector<doubl
 {
 	// Some fluids from REFPROP that are not included in CoolProp due to not having a Helmholtz energy EOS
 	Fluid * pREFPROPFluid = new REFPROPFluidClass(FluidName,xmol);
+	// REFPROP fluids do not need to be post-loaded
+	pREFPROPFluid->loaded = true;
 	FluidsList.push_back(pREFPROPFluid);
 	// Add entry to the fluid name map
 	fluid_name_map.insert(std::pair<std::string,Fluid*>(FluidName,pREFPROPFluid));
@@ -265,7 +303,7 @@ Fluid * FluidsContainer::get_fluid(long iFluid)
 {
 	if (iFluid > -1)
 	{
-		return FluidsList[iFluid];
+		return load(FluidsList[iFluid]);
 	}
 	else
 	{
@@ -281,7 +319,7 @@ Fluid * FluidsContainer::get_fluid(std::string name)
 	if (it != fluid_name_map.end() )
 	{
 		// Return a pointer to the class
-		return (*it).second;
+		return load((*it).second);
 	}
 
 	// Wasn't found, now we need to check for an alias
@@ -289,7 +327,7 @@ Fluid * FluidsContainer::get_fluid(std::string name)
 	{
 		if ( (*it)->isAlias(name) )
 		{
-			return *it;
+			return load(*it);
 		}
 	}
 	return NULL;
@@ -329,7 +367,7 @@ std::string FluidsContainer::FluidList()
 
 TEST_CASE((char*)"Check ancillary curves for pure and pseudo-pure fluids","[slow],[ancillary]")
 {
-	FluidsContainer Fluids = FluidsContainer();
+	FluidsContainer Fluids;
 
 	SECTION((char*)"Saturated Liquid Pressure Ancillary")
 	{
@@ -422,7 +460,7 @@ TEST_CASE((char*)"Check ancillary curves for pure and pseudo-pure fluids","[slow
 
 TEST_CASE((char*)"Fluid parameter checks not requiring saturation","[fast]")
 {
-	FluidsContainer Fluids = FluidsContainer();
+	FluidsContainer Fluids;
 
 	SECTION((char*)"Check Tmin > Ttriple")
 	{
@@ -455,7 +493,7 @@ TEST_CASE((char*)"Fluid parameter checks not requiring saturation","[fast]")
 
 TEST_CASE((char*)"Fluid parameter checks requiring saturation","[slow]")
 {
-	FluidsContainer Fluids = FluidsContainer();
+	FluidsContainer Fluids;
 
 	SECTION((char*)"Check ptriple")
 	{
@@ -493,7 +531,7 @@ TEST_CASE((char*)"Fluid parameter checks requiring saturation","[slow]")
 }
 TEST_CASE((char*)"Saturation consistency checks", (char*)"[slow],[consistency]" )
 {
-	FluidsContainer Fluids = FluidsContainer();
+	FluidsContainer Fluids;
 	SECTION((char*)"saturation_T")
 	{
 		for (std::vector<Fluid*>::const_iterator it = Fluids.FluidsList.begin(); it != Fluids.FluidsList.end(); it++)
@@ -566,4 +604,42 @@ TEST_CASE((char*)"Saturation consistency checks", (char*)"[slow],[consistency]"
 		}
 	}
 }
+
+TEST_CASE((char*)"Fluids are loaded on first use","[fast],[fluids]")
+{
+	FluidsContainer Eager, Lazy(true);
+	REQUIRE(Eager.FluidsList.size() == Lazy.FluidsList.size());
+
+	SECTION((char*)"Nothing is loaded up front")
+	{
+		for (std::vector<Fluid*>::const_iterator it = Lazy.FluidsList.begin(); it != Lazy.FluidsList.end(); it++)
+		{
+			CHECK(!(*it)->loaded);
+		}
+	}
+	SECTION((char*)"Lookup by name, alias and index")
+	{
+		Fluid *pWater = Lazy.get_fluid("Water");
+		REQUIRE(pWater != NULL);
+		CHECK(pWater->loaded);
+		CHECK(Lazy.get_fluid("WATER") == pWater);
+		CHECK(!Lazy.get_fluid("R134a")->get_name().compare("R134a"));
+		long iR134a = Lazy.get_fluid_index(Lazy.get_fluid("R134a"));
+		CHECK(Lazy.get_fluid(iR134a)->loaded);
+		CHECK(Lazy.get_fluid("NotAFluid") == NULL);
+	}
+	SECTION((char*)"Same values as the eager container")
+	{
+		for (unsigned int i = 0; i < Eager.FluidsList.size(); i++)
+		{
+			Fluid *pE = Eager.get_fluid(i), *pL = Lazy.get_fluid(i);
+			std::string name = pL->get_name();
+			CAPTURE(name);
+			CHECK(pE->params.ptriple == pL->params.ptriple);
+			CHECK(pE->crit.h == pL->crit.h);
+			CHECK(!pE->params.CAS.compare(pL->params.CAS));
+			CHECK(pE->environment.GWP100 == pL->environment.GWP100);
+		}
+	}
+}
 #endif
\ No newline at end of file
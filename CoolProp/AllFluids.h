@@ -12,26 +12,34 @@ class FluidsContainer
 {
 private:
 	rapidjson::Document JSON, JSON_CAS;
+	bool parsed_JSON; ///< True once the JSON documents have been parsed
+	CoolPropRecursiveMutex load_lock; ///< Held while a fluid is being loaded
 	std::map<std::string,long> fluid_index_map; ///< maps fluid names to 0-based index
 	std::map<std::string,Fluid*> fluid_name_map; ///< maps fluid names to pointers to the fluid
-	
+
+	/// Finish loading the fluid (critical spline constants, JSON data, post_load) if it has not been done yet
+	/// @param pFluid Pointer to the fluid, or NULL
+	/// @returns The same pointer
+	Fluid * load(Fluid *pFluid);
+
 public:
 
 	std::vector <Fluid*> FluidsList; ///< A list of pointers to the instances of the fluids
 	
 	/// Constructor for the FluidsContainer class
+	/// @param load_on_first_use If true, the fluids are only registered here and the parsing of the JSON data and the post-loading of each fluid are deferred until the fluid is first retrieved with get_fluid
 	/// @see FluidsContainer
-	FluidsContainer();
+	FluidsContainer(bool load_on_first_use = false);
 
 	/// Destructor for the FluidsContainer class.  Deletes each fluid in tern
 	/// @see FluidsContainer
 	~FluidsContainer();
 
-	/// Accessor.  Throws a NotImplementedError if the fluid given by name is not found.  Also searches aliases
+	/// Accessor.  Throws a NotImplementedError if the fluid given by name is not found.  Also searches aliases.  The fluid is loaded if needed
 	/// @param name Fluid to be searched for
 	Fluid * get_fluid(std::string name);
 
-	/// Accessor.  Throws a NotImplementedError if the fluid index is invalid
+	/// Accessor.  Throws a NotImplementedError if the fluid index is invalid.  The fluid is loaded if needed
 	/// @param name Fluid index to be used
 	Fluid * get_fluid(long iFluid);
 
@@ -83,9 +83,10 @@ CoolPropStateClassSI::CoolPropStateClassSI(std::string Fluid)
 	flag_SinglePhase = false;
 	flag_TwoPhase = false;
 
-	SatL = NULL;
-	SatV = NULL;
 	_noSatLSatV = false;
+
+	continuation = false;
+	has_previous = false;
 }
 
 // Constructor with pointer to fluid
@@ -99,10 +100,11 @@ CoolPropStateClassSI::CoolPropStateClassSI(Fluid * pFluid){
 	flag_SinglePhase = false;
 	flag_TwoPhase = false;
 
-	SatL = NULL;
-	SatV = NULL;
 	_noSatLSatV = false;
 
+	continuation = false;
+	has_previous = false;
+
 	if (pFluid->pure())
 	{
 		fluid_type = FLUID_TYPE_PURE;
@@ -113,22 +115,110 @@ CoolPropStateClassSI::CoolPropStateClassSI(Fluid * pFluid){
 	}
 }
 
-CoolPropStateClassSI::~CoolPropStateClassSI()
+#if defined(COOLPROP_CXX11_THREADS)
+static std::atomic<long long> state_allocations(0);
+#else
+static long long state_allocations = 0;
+#endif
+
+long long get_state_allocation_count(void)
+{
+	return state_allocations;
+}
+
+SaturationStatePointer::SaturationStatePointer(const SaturationStatePointer &other)
 {
-	if (!_noSatLSatV) // We are de-alllocating one of the saturation classes
+	p = NULL;
+	*this = other;
+}
+SaturationStatePointer::~SaturationStatePointer()
+{
+	delete p;
+}
+SaturationStatePointer &SaturationStatePointer::operator=(const SaturationStatePointer &other)
+{
+	if (other.p == NULL || other.p == p){ return *this; }
+	if (p == NULL)
 	{
-		if (SatL != NULL)
-		{
-			delete SatL;
-			SatL = NULL;
-		}
-		if (SatV != NULL)
+		p = new CoolPropStateClassSI(*other.p);
+		state_allocations++;
+	}
+	else
+	{
+		*p = *other.p;
+	}
+	return *this;
+}
+SaturationStatePointer &SaturationStatePointer::operator=(CoolPropStateClassSI *p)
+{
+	if (p != this->p)
+	{
+		delete this->p;
+		this->p = p;
+	}
+	return *this;
+}
+
+/// The states of the calling thread that are not borrowed
+class CoolPropStatePool
+{
+public:
+	std::vector<CoolPropStateClassSI*> states;
+	CoolPropStatePool(){ states.reserve(max_states); };
+	~CoolPropStatePool();
+	/// The number of states that are kept; more states can be borrowed at the same time but the extra ones are deleted
+	static const std::size_t max_states = 32;
+};
+static COOLPROP_THREAD_LOCAL CoolPropStatePool state_pool;
+/// True once the pool of this thread has been destroyed at the exit of the thread, after which the states are not pooled
+static COOLPROP_THREAD_LOCAL bool state_pool_destroyed = false;
+
+CoolPropStatePool::~CoolPropStatePool()
+{
+	for (std::size_t i = 0; i < states.size(); i++){ delete states[i]; }
+	states.clear();
+	state_pool_destroyed = true;
+}
+
+PooledCoolPropStateSI::PooledCoolPropStateSI(Fluid *pFluid)
+{
+	state = NULL;
+	if (!state_pool_destroyed)
+	{
+		std::vector<CoolPropStateClassSI*> &states = state_pool.states;
+		for (std::size_t i = states.size(); i-- > 0; )
 		{
-			delete SatV; 
-			SatV = NULL;
+			if (states[i]->pFluid == pFluid)
+			{
+				state = states[i];
+				states[i] = states.back();
+				states.pop_back();
+				break;
+			}
 		}
 	}
+	if (state == NULL)
+	{
+		state = new CoolPropStateClassSI(pFluid);
+		state_allocations++;
+	}
+	else
+	{
+		state->reset();
+	}
 }
+PooledCoolPropStateSI::~PooledCoolPropStateSI()
+{
+	if (!state_pool_destroyed && state_pool.states.size() < CoolPropStatePool::max_states)
+	{
+		state_pool.states.push_back(state);
+	}
+	else
+	{
+		delete state;
+	}
+}
+
 bool match_pair(long iI1, long iI2, long I1, long I2)
 {
 	return ((iI1 == I1 || iI1 == I2) && (iI2 == I1 || iI2 == I2) && iI1!=iI2);
@@ -196,12 +286,14 @@ void CoolPropStateClassSI::_pre_update()
 	// Only build the Saturation classes if this is a top-level CPState for which no_SatLSatV() has not been called
 	if (!_noSatLSatV){
 		if (SatL == NULL){
-			SatL = new CoolPropStateClass(pFluid);
+			SatL = new CoolPropStateClassSI(pFluid);
 			SatL->no_SatLSatV(); // Kill the recursive building of the saturation classes
+			state_allocations++;
 		}
 		if (SatV == NULL){
-			SatV = new CoolPropStateClass(pFluid);
+			SatV = new CoolPropStateClassSI(pFluid);
 			SatV->no_SatLSatV(); // Kill the recursive building of the saturation classes
+			state_allocations++;
 		}
 	}
 
@@ -221,6 +313,11 @@ void CoolPropStateClassSI::update(long iInput1, double Value1, long iInput2, dou
 	|  H,S
 	|  P,D
 	|  T,S
+	|  D,U
+	|  D,H
+	|  T,U
+	|  T,H
+	|  P,U
 	*/
 
 	if (get_debug_level()>3){
@@ -236,6 +333,15 @@ void CoolPropStateClassSI::update(long iInput1, double Value1, long iInput2, dou
 
 	// Common code for all updating functions (set flags, clear cache, etc.)
 	this->_pre_update();
+
+	// In continuation mode, start from the previous solution unless a guess has been provided
+	if (continuation && has_previous && !(T0 > 0 && rho0 > 0))
+	{
+		T0 = T_previous;
+		rho0 = rho_previous;
+	}
+	// Only kept if this update succeeds
+	has_previous = false;
 	
 	// Determine whether the EOS or the TTSE will be used
 	bool using_EOS = true;
@@ -269,26 +375,35 @@ void CoolPropStateClassSI::update(long iInput1, double Value1, long iInput2, dou
 			update_Trho(iInput1,Value1,iInput2,Value2);
 		}
 		else if (match_pair(iInput1,iInput2,iT,iP)){
-			update_Tp(iInput1,Value1,iInput2,Value2);
+			update_Tp(iInput1,Value1,iInput2,Value2, rho0);
 		}
 		else if (match_pair(iInput1,iInput2,iP,iH)){
 			update_ph(iInput1,Value1,iInput2,Value2, T0, rho0);
 		}
 		else if (match_pair(iInput1,iInput2,iP,iS)){
-			update_ps(iInput1,Value1,iInput2,Value2);
+			update_ps(iInput1,Value1,iInput2,Value2, T0, rho0);
 		}
 		else if (match_pair(iInput1,iInput2,iP,iD)){
 			update_prho(iInput1,Value1,iInput2,Value2);
 		}
 		else if (match_pair(iInput1,iInput2,iH,iS)){
-			update_hs(iInput1,Value1,iInput2,Value2);
+			update_hs(iInput1,Value1,iInput2,Value2, T0, rho0);
 		}
 		else if (match_pair(iInput1,iInput2,iT,iS)){
 			update_Ts(iInput1,Value1,iInput2,Value2);
 		}
+		else if (match_pair(iInput1,iInput2,iD,iU) || match_pair(iInput1,iInput2,iD,iH)){
+			update_rho_energy(iInput1,Value1,iInput2,Value2, T0);
+		}
+		else if (match_pair(iInput1,iInput2,iT,iU) || match_pair(iInput1,iInput2,iT,iH)){
+			update_T_energy(iInput1,Value1,iInput2,Value2);
+		}
+		else if (match_pair(iInput1,iInput2,iP,iU)){
+			update_pu(iInput1,Value1,iInput2,Value2);
+		}
 		else
 		{
-			throw ValueError(format("Sorry your inputs didn't work; valid pairs are P,Q T,Q T,D T,P P,H P,S T,S"));
+			throw ValueError(format("Sorry your inputs didn't work; valid pairs are P,Q T,Q T,D T,P P,H P,S T,S D,U D,H T,U T,H P,U"));
 		}
 	}
 	else
@@ -307,6 +422,33 @@ void CoolPropStateClassSI::update(long iInput1, double Value1, long iInput2, dou
 
 	// Common code for all updating functions
 	this->_post_update();
+
+	// Keep the solution as the starting point for the next update; only single-phase states from the EOS are 
+	// used since the two-phase solution is not a good guess for the 2D Newton solvers
+	if (continuation && using_EOS && SinglePhase && !TwoPhase && ValidNumber(_T) && ValidNumber(_rho))
+	{
+		has_previous = true;
+		T_previous = _T;
+		rho_previous = _rho;
+	}
+}
+
+bool CoolPropStateClassSI::stable_single_phase(double T, double rho, long phase)
+{
+	if (!ValidNumber(T) || !ValidNumber(rho) || T <= 0 || rho <= 0){ return false; }
+	// Mechanically unstable (spinodal) solution
+	if (!(pFluid->dpdrho_Trho(T,rho) > 0)){ return false; }
+	// The solution must be on the same side of the saturation curve as the phase that was found by the caller
+	if (phase == iSupercritical){ return true; }
+	else if (phase == iLiquid){ return rho > pFluid->crit.rho; }
+	else if (phase == iGas){ return rho < pFluid->crit.rho; }
+	// Otherwise it must be clearly outside of the saturation dome.  The ancillaries are much cheaper than the 
+	// saturation solver, and the margin covers their error; the states in the margin are solved without the guess
+	if (T >= pFluid->crit.T){ return true; }
+	if (T < pFluid->limits.Tmin){ return false; }
+	double rhoL = pFluid->rhosatL(T), rhoV = pFluid->rhosatV(T);
+	if (!ValidNumber(rhoL) || !ValidNumber(rhoV)){ return false; }
+	return rho > 1.02*rhoL || rho < 0.98*rhoV;
 }
 
 void CoolPropStateClassSI::_post_update()
@@ -358,6 +500,24 @@ bool CoolPropStateClassSI::within_TTSE_range(long iInput1, double Value1, long i
 		sort_pair(&iInput1,&Value1,&iInput2,&Value2, iT, iD);
 		return pFluid->TTSESinglePhase.within_range_Trho(iT,Value1,iD,Value2);
 	}
+	else if (match_pair(iInput1,iInput2,iD,iU) || match_pair(iInput1,iInput2,iD,iH)){
+		// Only the density can be checked before the solution; if the temperature is out of range, update_TTSE_LUT
+		// falls back to the EOS
+		if (iInput1 != iD){ std::swap(Value1, Value2); }
+		return (Value1 > pFluid->TTSESinglePhase.rhomin && Value1 < pFluid->TTSESinglePhase.rhomax);
+	}
+	else if (match_pair(iInput1,iInput2,iT,iU) || match_pair(iInput1,iInput2,iT,iH)){
+		// Likewise only the temperature is checked
+		if (iInput1 != iT){ std::swap(Value1, Value2); }
+		return (Value1 > pFluid->TTSESinglePhase.Tmin && Value1 < pFluid->TTSESinglePhase.Tmax);
+	}
+	else if (match_pair(iInput1,iInput2,iP,iU)){
+		// Likewise only the pressure is checked
+		if (iInput1 != iP){ std::swap(Value1, Value2); }
+		double hmin = 0, hmax = 0, pmin = 0, pmax = 0;
+		pFluid->get_TTSESinglePhase_LUT_range(&hmin,&hmax,&pmin,&pmax);
+		return (Value1 > pmin && Value1 < pmax);
+	}
 	return true;
 }
 
@@ -583,7 +743,7 @@ void CoolPropStateClassSI::update_prho(long iInput1, double Value1, long iInput2
 }
 
 // Updater if T,p are inputs
-void CoolPropStateClassSI::update_Tp(long iInput1, double Value1, long iInput2, double Value2)
+void CoolPropStateClassSI::update_Tp(long iInput1, double Value1, long iInput2, double Value2, double rho0)
 {
 	// Get them in the right order
 	sort_pair(&iInput1,&Value1,&iInput2,&Value2,iT,iP);
@@ -603,6 +763,7 @@ void CoolPropStateClassSI::update_Tp(long iInput1, double Value1, long iInput2,
 	// If either SinglePhase or flag_SinglePhase is set to true, it will not make the call to the saturation routine
 	// SinglePhase is set by the class routines, and flag_SinglePhase is a flag that can be set externally
 	bool _TwoPhase;
+	long phase = -1;
 
 	if (flag_SinglePhase || SinglePhase){
 		_TwoPhase = false;
@@ -611,7 +772,8 @@ void CoolPropStateClassSI::update_Tp(long iInput1, double Value1, long iInput2,
 		_TwoPhase = true;
 	}
 	else{
-		_TwoPhase = (pFluid->phase_Tp_indices(_T,_p,psatL,psatV,rhosatL,rhosatV) == iTwoPhase);
+		phase = pFluid->phase_Tp_indices(_T,_p,psatL,psatV,rhosatL,rhosatV);
+		_TwoPhase = (phase == iTwoPhase);
 		if (get_debug_level() > 5) { std::cout << format("%s:%d: CoolPropStateClass::update_Tp::_TwoPhase : %d\n",__FILE__,__LINE__,_TwoPhase).c_str(); }
 	}
 
@@ -624,7 +786,21 @@ void CoolPropStateClassSI::update_Tp(long iInput1, double Value1, long iInput2,
 		SinglePhase = true;
 		SaturatedL = false;
 		SaturatedV = false;
-		_rho = pFluid->density_Tp(_T,_p);
+		if (rho0 > 0)
+		{
+			// Start at the guess density, but it must converge to the phase that was found above
+			try{
+				_rho = pFluid->density_Tp(_T,_p,rho0);
+				if (!stable_single_phase(_T,_rho,phase)){ _rho = pFluid->density_Tp(_T,_p); }
+			}
+			catch (std::exception &){
+				_rho = pFluid->density_Tp(_T,_p);
+			}
+		}
+		else
+		{
+			_rho = pFluid->density_Tp(_T,_p);
+		}
 	}
 }
 
@@ -645,7 +821,22 @@ void CoolPropStateClassSI::update_ph(long iInput1, double Value1, long iInput2,
 		std::cout << format("%s:%d: CoolPropStateClassSI::update_ph(p=%g,h=%g,T0=%g,rho0=%g)\n",__FILE__,__LINE__, _p, _h, T0, rho0) ;
 	}
 	// Solve for temperature and density with or without the guess values provided
-	pFluid->temperature_ph(_p, _h, _T, _rho, rhosatL, rhosatV, TsatL, TsatV, T0, rho0);
+	bool solved = false;
+	if (T0 > 0 && rho0 > 0)
+	{
+		// The solver does not check the phase when it starts from a guess, so the saturation curve might have 
+		// been crossed; if the solution is not a stable single-phase state, start over without the guess
+		rhosatL = -1; rhosatV = -1; TsatL = -1; TsatV = -1;
+		try{
+			pFluid->temperature_ph(_p, _h, _T, _rho, rhosatL, rhosatV, TsatL, TsatV, T0, rho0);
+			solved = stable_single_phase(_T,_rho);
+		}
+		catch (std::exception &){}
+	}
+	if (!solved)
+	{
+		pFluid->temperature_ph(_p, _h, _T, _rho, rhosatL, rhosatV, TsatL, TsatV);
+	}
 
 	// Set the phase flags
 	if (double_equal(_rho,rhosatL) || double_equal(_rho,rhosatV) ||(_p < pFluid->reduce.p.Pa && _rho <= rhosatL && _rho >= rhosatV))
@@ -668,7 +859,7 @@ void CoolPropStateClassSI::update_ph(long iInput1, double Value1, long iInput2,
 }
 
 // Updater if p,s are inputs
-void CoolPropStateClassSI::update_ps(long iInput1, double Value1, long iInput2, double Value2)
+void CoolPropStateClassSI::update_ps(long iInput1, double Value1, long iInput2, double Value2, double T0, double rho0)
 {
 	// Get them in the right order
 	sort_pair(&iInput1,&Value1,&iInput2,&Value2,iP,iS);
@@ -680,8 +871,21 @@ void CoolPropStateClassSI::update_ps(long iInput1, double Value1, long iInput2,
 	_s = Value2;
 	s_cached = true;
 
-	// Solve for temperature and density
-	pFluid->temperature_ps(_p, _s, _T, _rho, rhosatL, rhosatV, TsatL, TsatV);
+	// Solve for temperature and density, starting from the guess values if they are provided (see update_ph)
+	bool solved = false;
+	if (T0 > 0 && rho0 > 0)
+	{
+		rhosatL = -1; rhosatV = -1; TsatL = -1; TsatV = -1;
+		try{
+			pFluid->temperature_ps(_p, _s, _T, _rho, rhosatL, rhosatV, TsatL, TsatV, T0, rho0);
+			solved = stable_single_phase(_T,_rho);
+		}
+		catch (std::exception &){}
+	}
+	if (!solved)
+	{
+		pFluid->temperature_ps(_p, _s, _T, _rho, rhosatL, rhosatV, TsatL, TsatV);
+	}
 
 	if (get_debug_level() > 9)
 	{
@@ -710,7 +914,7 @@ void CoolPropStateClassSI::update_ps(long iInput1, double Value1, long iInput2,
 }
 
 // Updater if h,s are inputs
-void CoolPropStateClassSI::update_hs(long iInput1, double Value1, long iInput2, double Value2)
+void CoolPropStateClassSI::update_hs(long iInput1, double Value1, long iInput2, double Value2, double T0, double rho0)
 {
 	// Get them in the right order
 	sort_pair(&iInput1,&Value1,&iInput2,&Value2,iH,iS);
@@ -721,8 +925,21 @@ void CoolPropStateClassSI::update_hs(long iInput1, double Value1, long iInput2,
 	h_cached = true;
 	s_cached = true;
 
-	// Solve for temperature and density
-	pFluid->temperature_hs(_h, _s, _T, _rho, rhosatL, rhosatV, TsatL, TsatV);
+	// Solve for temperature and density, starting from the guess values if they are provided (see update_ph)
+	bool solved = false;
+	if (T0 > 0 && rho0 > 0)
+	{
+		rhosatL = -1; rhosatV = -1; TsatL = -1; TsatV = -1;
+		try{
+			pFluid->temperature_hs(_h, _s, _T, _rho, rhosatL, rhosatV, TsatL, TsatV, T0, rho0);
+			solved = stable_single_phase(_T,_rho);
+		}
+		catch (std::exception &){}
+	}
+	if (!solved)
+	{
+		pFluid->temperature_hs(_h, _s, _T, _rho, rhosatL, rhosatV, TsatL, TsatV);
+	}
 
 	// Reduced parameters
 	double delta = this->_rho/pFluid->reduce.rho;
@@ -791,6 +1008,194 @@ void CoolPropStateClassSI::update_Ts(long iInput1, double Value1, long iInput2,
 	}
 }
 
+// Updater if rho,u or rho,h are inputs
+void CoolPropStateClassSI::update_rho_energy(long iInput1, double Value1, long iInput2, double Value2, double T0)
+{
+	long iOther = match_pair(iInput1,iInput2,iD,iU) ? iU : iH;
+	// Get them in the right order
+	sort_pair(&iInput1,&Value1,&iInput2,&Value2,iD,iOther);
+
+	if (Value1 < 0 ){ throw ValueError(format("Your density [%g kg/m^3] is less than zero",Value1));}
+
+	// Set internal variables
+	_rho = Value1;
+	if (iOther == iH)
+	{
+		_h = Value2;
+		h_cached = true;
+	}
+
+	// Solve for temperature and pressure
+	if (iOther == iU)
+	{
+		pFluid->temperature_rhou(_rho, Value2, _T, _p, rhosatL, rhosatV, psatL, psatV, T0);
+	}
+	else
+	{
+		pFluid->temperature_rhoh(_rho, Value2, _T, _p, rhosatL, rhosatV, psatL, psatV, T0);
+	}
+
+	// Set the phase flags; the saturation densities are only valid numbers for a two-phase state
+	if (ValidNumber(rhosatL) && ValidNumber(rhosatV))
+	{
+		TwoPhase = true;
+		SinglePhase = false;
+		_Q = (1/_rho-1/rhosatL)/(1/rhosatV-1/rhosatL);
+		check_saturated_quality(_Q);
+
+		TsatL = _T;
+		TsatV = _T;
+	}
+	else
+	{
+		TwoPhase = false;
+		SinglePhase = true;
+		SaturatedL = false;
+		SaturatedV = false;
+	}
+}
+
+// Updater if T,u or T,h are inputs
+void CoolPropStateClassSI::update_T_energy(long iInput1, double Value1, long iInput2, double Value2)
+{
+	long iOther = match_pair(iInput1,iInput2,iT,iU) ? iU : iH;
+	// Get them in the right order
+	sort_pair(&iInput1,&Value1,&iInput2,&Value2,iT,iOther);
+
+	if (Value1 < 0 ){ throw ValueError(format("Your temperature [%g K] is less than zero",Value1));}
+
+	// Set internal variables
+	_T = Value1;
+	if (iOther == iH)
+	{
+		_h = Value2;
+		h_cached = true;
+	}
+
+	// Solve for density and pressure
+	if (iOther == iU)
+	{
+		pFluid->density_Tu(_T, Value2, _rho, _p, rhosatL, rhosatV, psatL, psatV);
+	}
+	else
+	{
+		pFluid->density_Th(_T, Value2, _rho, _p, rhosatL, rhosatV, psatL, psatV);
+	}
+
+	// Set the phase flags; the saturation densities are only valid numbers for a two-phase state
+	if (ValidNumber(rhosatL) && ValidNumber(rhosatV))
+	{
+		TwoPhase = true;
+		SinglePhase = false;
+		_Q = (1/_rho-1/rhosatL)/(1/rhosatV-1/rhosatL);
+		check_saturated_quality(_Q);
+
+		TsatL = _T;
+		TsatV = _T;
+	}
+	else
+	{
+		TwoPhase = false;
+		SinglePhase = true;
+		SaturatedL = false;
+		SaturatedV = false;
+	}
+}
+
+// Updater if p,u are inputs
+void CoolPropStateClassSI::update_pu(long iInput1, double Value1, long iInput2, double Value2)
+{
+	// Get them in the right order
+	sort_pair(&iInput1,&Value1,&iInput2,&Value2,iP,iU);
+
+	if (Value1 < 0 ){ throw ValueError(format("Your pressure [%g Pa] is less than zero",Value1));}
+
+	// Set internal variables
+	_p = Value1;
+
+	// Solve for temperature and density
+	pFluid->temperature_pu(_p, Value2, _T, _rho, rhosatL, rhosatV, TsatL, TsatV);
+
+	// Set the phase flags; the saturation densities are only valid numbers for a two-phase state
+	if (ValidNumber(rhosatL) && ValidNumber(rhosatV))
+	{
+		TwoPhase = true;
+		SinglePhase = false;
+		_Q = (1/_rho-1/rhosatL)/(1/rhosatV-1/rhosatL);
+		check_saturated_quality(_Q);
+
+		psatL = _p;
+		psatV = _p;
+	}
+	else
+	{
+		TwoPhase = false;
+		SinglePhase = true;
+		SaturatedL = false;
+		SaturatedV = false;
+	}
+}
+
+/// The enthalpy (iOther = iH) or the internal energy (iOther = iU) at T,p from the TTSE tables for a single-phase
+/// state; the enthalpy of the last call is kept.  At the saturation pressure psat the values hsat and esat of the 
+/// saturated phase are used, since the inverse of the tables is not well-defined on the saturation curve
+class TTSETEnergyFuncClass : public FuncWrapper1D
+{
+private:
+	Fluid *pFluid;
+	long iOther;
+	double T, value;
+public:
+	double h, psat, hsat, esat;
+	TTSETEnergyFuncClass(Fluid *pFluid, long iOther, double T, double value) 
+		: pFluid(pFluid), iOther(iOther), T(T), value(value){ h = _HUGE; psat = -1; hsat = _HUGE; esat = _HUGE; };
+	double call(double p)
+	{
+		if (p == psat)
+		{
+			h = hsat;
+			return esat - value;
+		}
+		if (!pFluid->TTSESinglePhase.within_range_one_other_input(iP,p,iT,T)){
+			throw ValueError(format("Input to TTSE [p = %g, T = %g] is out of range",p,T));
+		}
+		h = pFluid->TTSESinglePhase.evaluate_one_other_input(iP,p,iT,T);
+		if (iOther == iH){ return h - value; }
+		return h - p/pFluid->TTSESinglePhase.evaluate(iD,p,log(p),h) - value;
+	};
+};
+
+/// The enthalpy (iOther = iH) or the internal energy (iOther = iU) at T,rho from the TTSE tables, for a state that 
+/// can be two-phase
+class TTSErhoEnergyFuncClass : public FuncWrapper1D
+{
+private:
+	Fluid *pFluid;
+	long iOther;
+	double rho, logrho, value;
+public:
+	double psatL, psatV, rhoL, rhoV;
+	bool TwoPhase;
+	TTSErhoEnergyFuncClass(Fluid *pFluid, long iOther, double rho, double logrho, double value) 
+		: pFluid(pFluid), iOther(iOther), rho(rho), logrho(logrho), value(value){ TwoPhase = false; };
+	double call(double T)
+	{
+		psatL = pFluid->TTSESatL.evaluate_T(T);
+		psatV = pFluid->TTSESatV.evaluate_T(T);
+		rhoL = pFluid->TTSESatL.evaluate(iD,psatL);
+		rhoV = pFluid->TTSESatV.evaluate(iD,psatV);
+		TwoPhase = (rho > rhoV && rho < rhoL);
+		if (TwoPhase)
+		{
+			double eL = pFluid->TTSESatL.evaluate(iH,psatL), eV = pFluid->TTSESatV.evaluate(iH,psatV);
+			if (iOther == iU){ eL -= psatL/rhoL; eV -= psatV/rhoV; }
+			double Q = (1/rho-1/rhoL)/(1/rhoV-1/rhoL);
+			return eL + Q*(eV-eL) - value;
+		}
+		return pFluid->TTSESinglePhase.energy_Trho(iOther,T,rho,logrho) - value;
+	};
+};
+
 // Updater if you are using TTSE LUT
 void CoolPropStateClassSI::update_TTSE_LUT(long iInput1, double Value1, long iInput2, double Value2)
 {
@@ -1044,6 +1449,170 @@ void CoolPropStateClassSI::update_TTSE_LUT(long iInput1, double Value1, long iIn
 			_Q = (1/_rho-1/rhosatL)/(1/rhosatV-1/rhosatL);
 		}
 	}
+	else if (match_pair(iInput1,iInput2,iD,iU) || match_pair(iInput1,iInput2,iD,iH))
+	{
+		long iOther = match_pair(iInput1,iInput2,iD,iU) ? iU : iH;
+		// Sort in the right order (D,U) or (D,H)
+		sort_pair(&iInput1,&Value1,&iInput2,&Value2,iD,iOther);
+
+		double rho = Value1, logrho = log(rho);
+		// The single-phase state from the inverse of the tables with T,rho as inputs
+		double T = pFluid->TTSESinglePhase.evaluate_Trho_one_other_input(iOther,rho,logrho,Value2);
+		bool _SinglePhase = ValidNumber(T);
+		if (_SinglePhase && T < pFluid->crit.T && T > pFluid->params.Ttriple)
+		{
+			double psatL = pFluid->TTSESatL.evaluate_T(T), psatV = pFluid->TTSESatV.evaluate_T(T);
+			_SinglePhase = (rho < pFluid->TTSESatV.evaluate(iD,psatV) || rho > pFluid->TTSESatL.evaluate(iD,psatL));
+		}
+
+		if (_SinglePhase)
+		{
+			TwoPhase = false;
+			SinglePhase = true;
+			_T = T;
+			_rho = rho;
+			_logrho = logrho;
+			_p = pFluid->TTSESinglePhase.evaluate_Trho(iP,T,rho,logrho);
+		}
+		else
+		{
+			// Two-phase, or below the single-phase part of the tables: solve along the isochore with the saturation 
+			// tables, or with the EOS if the state is out of range of the tables
+			TTSErhoEnergyFuncClass f(pFluid,iOther,rho,logrho,Value2);
+			std::string errstr;
+			try
+			{
+				T = Brent(&f,pFluid->TTSESatL.T.front(),pFluid->TTSESatL.T.back(),1e-12,1e-10,100,&errstr);
+				f.call(T);
+			}
+			catch (std::exception &)
+			{
+				errstr = "out of range";
+			}
+			if (errstr.size() > 0)
+			{
+				update_rho_energy(iInput1,Value1,iInput2,Value2);
+				return;
+			}
+			_T = T;
+			_rho = rho;
+			_logrho = logrho;
+			if (f.TwoPhase)
+			{
+				TwoPhase = true;
+				SinglePhase = false;
+				rhosatL = f.rhoL;
+				rhosatV = f.rhoV;
+				psatL = f.psatL;
+				psatV = f.psatV;
+				TsatL = T;
+				TsatV = T;
+				_Q = (1/rho-1/rhosatL)/(1/rhosatV-1/rhosatL);
+				_p = _Q*psatV+(1-_Q)*psatL;
+				check_saturated_quality(_Q);
+			}
+			else
+			{
+				TwoPhase = false;
+				SinglePhase = true;
+				_p = pFluid->TTSESinglePhase.evaluate_Trho(iP,T,rho,logrho);
+			}
+		}
+		if (iOther == iH)
+		{
+			_h = Value2;
+			h_cached = true;
+		}
+	}
+	else if (match_pair(iInput1,iInput2,iP,iU))
+	{
+		// Sort in the right order (P,U)
+		sort_pair(&iInput1,&Value1,&iInput2,&Value2,iP,iU);
+		double p = Value1, u = Value2, h;
+
+		// The two-phase state from the saturation tables
+		if (p < pFluid->reduce.p.Pa && p > pFluid->params.ptriple && !flag_SinglePhase)
+		{
+			double hsatL = pFluid->TTSESatL.evaluate(iH,p), hsatV = pFluid->TTSESatV.evaluate(iH,p);
+			double usatL = hsatL-p/pFluid->TTSESatL.evaluate(iD,p), usatV = hsatV-p/pFluid->TTSESatV.evaluate(iD,p);
+			if (u >= usatL && u <= usatV)
+			{
+				update_TTSE_LUT(iP,p,iH,hsatL+(u-usatL)/(usatV-usatL)*(hsatV-hsatL));
+				return;
+			}
+		}
+		// The single-phase state from the enthalpy; out of range of the tables the EOS is used
+		try
+		{
+			h = pFluid->TTSESinglePhase.evaluate_one_other_input(iP,p,iU,u);
+		}
+		catch (std::exception &)
+		{
+			update_pu(iInput1,Value1,iInput2,Value2);
+			return;
+		}
+		update_TTSE_LUT(iP,p,iH,h);
+	}
+	else if (match_pair(iInput1,iInput2,iT,iU) || match_pair(iInput1,iInput2,iT,iH))
+	{
+		long iOther = match_pair(iInput1,iInput2,iT,iU) ? iU : iH;
+		// Sort in the right order (T,U) or (T,H)
+		sort_pair(&iInput1,&Value1,&iInput2,&Value2,iT,iOther);
+		double T = Value1, value = Value2;
+
+		// The search for the pressure starts at the saturation pressure below the critical temperature
+		TTSETEnergyFuncClass f(pFluid,iOther,T,value);
+		double a = pFluid->reduce.p.Pa;
+		if (T < pFluid->crit.T && T > pFluid->params.Ttriple)
+		{
+			double p = pFluid->TTSESatL.evaluate_T(T);
+			double hsatL = pFluid->TTSESatL.evaluate(iH,p), hsatV = pFluid->TTSESatV.evaluate(iH,p);
+			double esatL = hsatL, esatV = hsatV;
+			if (iOther == iU)
+			{
+				esatL -= p/pFluid->TTSESatL.evaluate(iD,p);
+				esatV -= p/pFluid->TTSESatV.evaluate(iD,p);
+			}
+			if (value >= esatL && value <= esatV)
+			{
+				update_TTSE_LUT(iP,p,iH,hsatL+(value-esatL)/(esatV-esatL)*(hsatV-hsatL));
+				_T = T;
+				return;
+			}
+			a = p;
+			f.psat = p;
+			f.hsat = (value < esatL) ? hsatL : hsatV;
+			f.esat = (value < esatL) ? esatL : esatV;
+		}
+		// The single-phase state from the pressure; out of range of the tables the EOS is used.  Like for the 
+		// EOS, the bracket is grown towards higher pressures if the energy is too large
+		std::string errstr;
+		double p = _HUGE;
+		try
+		{
+			double fa = f.call(a), b = a, fb = fa;
+			for (int i = 0; i < 40 && fa*fb > 0; i++)
+			{
+				a = b;
+				fa = fb;
+				b *= (fa > 0) ? 2 : 0.5;
+				fb = f.call(b);
+			}
+			p = Brent(&f,a,b,DBL_EPSILON,1e-10*std::min(a,b),100,&errstr);
+			f.call(p);
+		}
+		catch (std::exception &)
+		{
+			errstr = "out of range";
+		}
+		if (errstr.size() > 0 || !ValidNumber(p))
+		{
+			update_T_energy(iInput1,Value1,iInput2,Value2);
+			return;
+		}
+		update_TTSE_LUT(iP,p,iH,f.h);
+		_T = T;
+	}
 	else
 	{
 		printf("Sorry your inputs[%d,%d] don't work for now with TTSE\n",(int)iInput1,(int)iInput2);
@@ -1107,6 +1676,30 @@ void CoolPropStateClassSI::update_incompressible(long iInput1, double Value1, lo
 
 }
 
+long CoolPropStateClassSI::update_array(long iInput1, const double *Value1, long iInput2, const double *Value2, long length, const long *iOutputs, long Noutputs, double *outputs, std::string *errstr)
+{
+	long Nfail = 0;
+	for (long i = 0; i < length; i++)
+	{
+		try{
+			CoolPropStateClassSI::update(iInput1, Value1[i], iInput2, Value2[i]);
+			for (long j = 0; j < Noutputs; j++){
+				outputs[j*length+i] = CoolPropStateClassSI::keyed_output(iOutputs[j]);
+			}
+			continue;
+		}
+		catch(std::exception &e){
+			if (errstr != NULL){ *errstr = e.what(); }
+		}
+		catch(...){
+			if (errstr != NULL){ *errstr = "Indeterminate error"; }
+		}
+		for (long j = 0; j < Noutputs; j++){ outputs[j*length+i] = _HUGE; }
+		Nfail++;
+	}
+	return Nfail;
+}
+
 /// Return an output based on the integer key for the term
 double CoolPropStateClassSI::keyed_output(long iOutput)
 {
@@ -1817,8 +2410,9 @@ double CoolPropStateClassSI::drhodh_constp(void){
 
 double CoolPropStateClassSI::drhodp_consth_smoothed(double xend){
 	if (fluid_type == FLUID_TYPE_INCOMPRESSIBLE_LIQUID || fluid_type == FLUID_TYPE_INCOMPRESSIBLE_SOLUTION){throw ValueError("function invalid for incompressibles");}
-	// Make a state class instance
-	CoolPropStateClassSI CPS(pFluid);
+	// Borrow a state class instance
+	PooledCoolPropStateSI pooled_CPS(pFluid);
+	CoolPropStateClassSI &CPS = *pooled_CPS;
 	SplineClass SC = SplineClass();
 	double hL = this->hL();
 	double hV = this->hV();
@@ -1847,8 +2441,9 @@ double CoolPropStateClassSI::drhodp_consth_smoothed(double xend){
 
 double CoolPropStateClassSI::drhodh_constp_smoothed(double xend){
 	if (fluid_type == FLUID_TYPE_INCOMPRESSIBLE_LIQUID || fluid_type == FLUID_TYPE_INCOMPRESSIBLE_SOLUTION){throw ValueError("function invalid for incompressibles");}
-	// Make a state class instance
-	CoolPropStateClassSI CPS(pFluid);
+	// Borrow a state class instance
+	PooledCoolPropStateSI pooled_CPS(pFluid);
+	CoolPropStateClassSI &CPS = *pooled_CPS;
 	SplineClass SC = SplineClass();
 	double hL = this->hL();
 	double hV = this->hV();
@@ -1877,8 +2472,9 @@ double CoolPropStateClassSI::drhodh_constp_smoothed(double xend){
 
 void CoolPropStateClassSI::rho_smoothed(double xend, double &rho_spline, double &dsplinedh, double &dsplinedp){
 	if (fluid_type == FLUID_TYPE_INCOMPRESSIBLE_LIQUID || fluid_type == FLUID_TYPE_INCOMPRESSIBLE_SOLUTION){throw ValueError("function invalid for incompressibles");}
-	// Make a state class instance in two-phase at the junction point (end):
-	CoolPropStateClassSI CPS(pFluid);
+	// Borrow a state class instance in two-phase at the junction point (end):
+	PooledCoolPropStateSI pooled_CPS(pFluid);
+	CoolPropStateClassSI &CPS = *pooled_CPS;
 	CPS.update(iT,TsatL,iQ,xend);
 
 	// A few necessary properties:
@@ -2058,6 +2654,269 @@ TEST_CASE("Check of density smoothing derivatives","[normal]")
 		}
 	}
 }
+
+TEST_CASE("All the Helmholtz energy derivatives at once","[helmholtz],[fast]")
+{
+	const char *fluids[] = {"Water", "CarbonDioxide", "R134a", "Methanol"};
+	for (int k = 0; k < 4; k++)
+	{
+		Fluid *pFluid = get_fluid(get_Fluid_index(fluids[k]));
+		double tau = 1.3, delta = 0.7;
+		FluidHelmholtzDerivatives derivs = pFluid->Helmholtz_derivatives(tau, delta);
+		double expected[] = {pFluid->phir(tau,delta), pFluid->dphir_dDelta(tau,delta), pFluid->dphir_dTau(tau,delta), 
+			pFluid->d2phir_dDelta2(tau,delta), pFluid->d2phir_dDelta_dTau(tau,delta), pFluid->d2phir_dTau2(tau,delta), 
+			pFluid->d3phir_dDelta3(tau,delta), pFluid->d3phir_dDelta2_dTau(tau,delta), pFluid->d3phir_dDelta_dTau2(tau,delta), pFluid->d3phir_dTau3(tau,delta),
+			pFluid->phi0(tau,delta), pFluid->dphi0_dDelta(tau,delta), pFluid->dphi0_dTau(tau,delta), 
+			pFluid->d2phi0_dDelta2(tau,delta), pFluid->d2phi0_dDelta_dTau(tau,delta), pFluid->d2phi0_dTau2(tau,delta), pFluid->d3phi0_dTau3(tau,delta)};
+		double actual[] = {derivs.phir.base, derivs.phir.dDelta, derivs.phir.dTau, 
+			derivs.phir.dDelta2, derivs.phir.dDelta_dTau, derivs.phir.dTau2, 
+			derivs.phir.dDelta3, derivs.phir.dDelta2_dTau, derivs.phir.dDelta_dTau2, derivs.phir.dTau3,
+			derivs.phi0.base, derivs.phi0.dDelta, derivs.phi0.dTau, 
+			derivs.phi0.dDelta2, derivs.phi0.dDelta_dTau, derivs.phi0.dTau2, derivs.phi0.dTau3};
+		for (int i = 0; i < 17; i++)
+		{
+			CAPTURE(fluids[k]);
+			CAPTURE(i);
+			CHECK(fabs(actual[i]-expected[i]) <= 1e-10*std::max(1.0, fabs(expected[i])));
+		}
+
+		// The state class takes all its derivatives from one evaluation
+		CoolPropStateClassSI CPS(pFluid);
+		CPS.update(iT, pFluid->reduce.T/tau, iD, pFluid->reduce.rho*delta);
+		CHECK(fabs(CPS.keyed_output(iDERd2phir_dDelta_dTau)-expected[4]) <= 1e-10*std::max(1.0, fabs(expected[4])));
+		CHECK(fabs(CPS.keyed_output(iDERd2phi0_dTau2)-expected[15]) <= 1e-10*std::max(1.0, fabs(expected[15])));
+	}
+}
+
+TEST_CASE("Continuation gives the same states as the cold solvers","[continuation],[fast]")
+{
+	Fluid *pFluid = get_fluid(get_Fluid_index("Water"));
+	CoolPropStateClassSI cold(pFluid), warm(pFluid);
+	warm.enable_continuation();
+	REQUIRE(warm.isenabled_continuation());
+
+	SECTION("P,H across the saturation curve")
+	{
+		// Liquid to two-phase to gas and back again at 1 MPa
+		for (int i = 0; i <= 80; i++)
+		{
+			double h = 300e3 + 3000e3*(i <= 40 ? i : 80-i)/40.0;
+			CAPTURE(h);
+			cold.update(iP, 1e6, iH, h);
+			warm.update(iP, 1e6, iH, h);
+			CHECK(warm.TwoPhase == cold.TwoPhase);
+			CHECK(fabs(warm.T()/cold.T()-1) < 1e-8);
+			CHECK(fabs(warm.rho()/cold.rho()-1) < 1e-6);
+			if (cold.TwoPhase){ CHECK(fabs(warm.Q()-cold.Q()) < 1e-8); }
+		}
+	}
+	SECTION("P,S and T,P in the gas and supercritical regions")
+	{
+		for (int i = 0; i <= 40; i++)
+		{
+			double p = 1e6 + 0.6e6*i;
+			CAPTURE(p);
+			cold.update(iP, p, iS, 7000);
+			warm.update(iP, p, iS, 7000);
+			CHECK(fabs(warm.T()/cold.T()-1) < 1e-8);
+			CHECK(fabs(warm.rho()/cold.rho()-1) < 1e-6);
+			cold.update(iT, 700, iP, p);
+			warm.update(iT, 700, iP, p);
+			CHECK(fabs(warm.rho()/cold.rho()-1) < 1e-8);
+		}
+	}
+	SECTION("H,S in the gas")
+	{
+		for (int i = 0; i <= 20; i++)
+		{
+			double s = 7000 + 10*i;
+			CAPTURE(s);
+			cold.update(iH, 3000e3, iS, s);
+			warm.update(iH, 3000e3, iS, s);
+			CHECK(fabs(warm.T()/cold.T()-1) < 1e-8);
+			CHECK(fabs(warm.rho()/cold.rho()-1) < 1e-6);
+		}
+	}
+	SECTION("Guess on the other side of the saturation curve")
+	{
+		// The liquid is the starting point for a gas state at the same pressure
+		warm.update(iP, 1e6, iH, 500e3);
+		warm.update(iP, 1e6, iH, 3000e3);
+		cold.update(iP, 1e6, iH, 3000e3);
+		CHECK(fabs(warm.rho()/cold.rho()-1) < 1e-6);
+		warm.update(iT, 500, iP, 1e6);
+		cold.update(iT, 500, iP, 1e6);
+		CHECK(fabs(warm.rho()/cold.rho()-1) < 1e-8);
+	}
+}
+
+TEST_CASE("Steady-state updates do not construct new saturation or pooled states","[allocations],[fast]")
+{
+	// This counts the states that are constructed on the heap, not all the heap allocations
+	Fluid *pFluid = get_fluid(get_Fluid_index("R134a"));
+	long iFluid = get_Fluid_index("R134a");
+	CoolPropStateClassSI CPS(pFluid);
+	// Warm up: the saturation states, the pool of this thread and the ancillary curves
+	CPS.update(iP, 1e6, iH, 300e3);
+	CPS.update(iP, 1e6, iS, 1200);
+	IPropsSI(iT, iP, 1e6, iH, 300e3, iFluid);
+	IPropsSI(iT, iP, 1e6, iS, 1200, iFluid);
+	long long N0 = get_state_allocation_count();
+
+	SECTION("Updates of the same state")
+	{
+		for (int i = 0; i < 20; i++)
+		{
+			CPS.update(iP, 1e6, iH, 200e3+10e3*i); // Liquid to two-phase
+			CPS.update(iP, 1e6, iS, 1100+20*i);
+			CPS.update(iT, 300, iQ, 0.05*i);
+			CPS.hL();
+		}
+		CHECK(get_state_allocation_count() == N0);
+	}
+	SECTION("PropsSI")
+	{
+		for (int i = 0; i < 20; i++)
+		{
+			IPropsSI(iT, iP, 1e6, iH, 200e3+10e3*i, iFluid);
+			IPropsSI(iT, iP, 1e6, iS, 1100+20*i, iFluid);
+		}
+		CHECK(get_state_allocation_count() == N0);
+	}
+	SECTION("Copies have their own saturation states")
+	{
+		CPS.update(iT, 300, iQ, 0.5);
+		CoolPropStateClassSI copied = CPS;
+		CHECK(get_state_allocation_count() == N0+2);
+		double hL = CPS.hL();
+		CPS.update(iT, 280, iQ, 0.5);
+		CHECK(copied.hL() == hL);
+		// Assigning to a state that has saturation states reuses them
+		for (int i = 0; i < 5; i++){ copied = CPS; }
+		CHECK(get_state_allocation_count() == N0+2);
+		CHECK(copied.hL() == CPS.hL());
+	}
+}
+
+TEST_CASE("D,U and D,H give back the states from T,D and T,Q","[rhou],[fast]")
+{
+	const char *fluids[] = {"Water", "R134a"};
+	for (int k = 0; k < 2; k++)
+	{
+		Fluid *pFluid = get_fluid(get_Fluid_index(fluids[k]));
+		CoolPropStateClassSI ref(pFluid), CPS(pFluid);
+		double Tc = pFluid->crit.T, rhoc = pFluid->crit.rho;
+		// Liquid, gas, two-phase at two qualities, supercritical gas and supercritical liquid-like
+		double T[] = {0.7*Tc, 0.9*Tc, 0.8*Tc, 0.95*Tc, 1.3*Tc, 1.05*Tc};
+		double Q[] = {-1, -1, 0.3, 0.8, -1, -1};
+		double rho[] = {-1, 0.01*rhoc, -1, -1, 0.5*rhoc, 2*rhoc};
+		for (int i = 0; i < 6; i++)
+		{
+			CAPTURE(fluids[k]);
+			CAPTURE(i);
+			if (Q[i] >= 0)
+			{
+				ref.update(iT, T[i], iQ, Q[i]);
+			}
+			else if (rho[i] < 0)
+			{
+				// Subcooled liquid at twice the saturation pressure
+				ref.update(iT, T[i], iP, 2*PropsSI("P","T",T[i],"Q",0,fluids[k]));
+			}
+			else
+			{
+				ref.update(iT, T[i], iD, rho[i]);
+			}
+			for (int j = 0; j < 2; j++)
+			{
+				if (j == 0){ CPS.update(iD, ref.rho(), iU, ref.keyed_output(iU)); }
+				else { CPS.update(iH, ref.h(), iD, ref.rho()); }
+				CHECK(CPS.TwoPhase == ref.TwoPhase);
+				CHECK(fabs(CPS.T()/ref.T()-1) < 1e-8);
+				CHECK(fabs(CPS.p()/ref.p()-1) < 1e-6);
+				CHECK(fabs(CPS.h()-ref.h()) < 1e-3);
+				if (ref.TwoPhase){ CHECK(fabs(CPS.Q()-ref.Q()) < 1e-8); }
+			}
+		}
+	}
+}
+
+TEST_CASE("T,U, T,H and P,U give back the states from T,P, T,D and T,Q","[Tu],[fast]")
+{
+	const char *fluids[] = {"Water", "R134a"};
+	for (int k = 0; k < 2; k++)
+	{
+		Fluid *pFluid = get_fluid(get_Fluid_index(fluids[k]));
+		CoolPropStateClassSI ref(pFluid), CPS(pFluid);
+		double Tc = pFluid->crit.T, rhoc = pFluid->crit.rho;
+		// Compressed liquid, gas, two-phase at two qualities, supercritical gas and supercritical liquid-like
+		double T[] = {0.7*Tc, 0.9*Tc, 0.8*Tc, 0.95*Tc, 1.3*Tc, 1.05*Tc};
+		double Q[] = {-1, -1, 0.3, 0.8, -1, -1};
+		double rho[] = {-1, 0.01*rhoc, -1, -1, 0.5*rhoc, 2*rhoc};
+		for (int i = 0; i < 6; i++)
+		{
+			CAPTURE(fluids[k]);
+			CAPTURE(i);
+			if (Q[i] >= 0)
+			{
+				ref.update(iT, T[i], iQ, Q[i]);
+			}
+			else if (rho[i] < 0)
+			{
+				ref.update(iT, T[i], iP, 50*PropsSI("P","T",T[i],"Q",0,fluids[k]));
+			}
+			else
+			{
+				ref.update(iT, T[i], iD, rho[i]);
+			}
+			// The enthalpy of this compressed liquid is also the enthalpy of a two-phase state at the same 
+			// temperature, which is the one that T,H gives
+			int Npairs = (i == 0) ? 2 : 3;
+			long iInput1[] = {iT, iP, iT};
+			long iInput2[] = {iU, iU, iH};
+			for (int j = 0; j < Npairs; j++)
+			{
+				CAPTURE(j);
+				double Value1 = (iInput1[j] == iT) ? ref.T() : ref.p();
+				double Value2 = (iInput2[j] == iU) ? ref.keyed_output(iU) : ref.h();
+				CPS.update(iInput1[j], Value1, iInput2[j], Value2);
+				CHECK(CPS.TwoPhase == ref.TwoPhase);
+				CHECK(fabs(CPS.T()/ref.T()-1) < 1e-8);
+				CHECK(fabs(CPS.rho()/ref.rho()-1) < 1e-6);
+				CHECK(fabs(CPS.p()/ref.p()-1) < 1e-6);
+				if (ref.TwoPhase){ CHECK(fabs(CPS.Q()-ref.Q()) < 1e-8); }
+			}
+		}
+		CPS.update(iT, 0.7*Tc, iH, PropsSI("H","T",0.7*Tc,"Q",0.001,fluids[k]));
+		CHECK(CPS.TwoPhase);
+	}
+}
+
+TEST_CASE("Array updates give the same outputs as updating point by point","[update_array],[fast]")
+{
+	CoolPropStateClassSI CPS("R134a"), ref("R134a");
+	// Liquid, two-phase, gas, and a point that cannot be evaluated
+	double p[] = {1e6, 1e6, 1e6, -1};
+	double h[] = {200e3, 300e3, 450e3, 300e3};
+	long iOutputs[] = {iT, iD, iS, iQ};
+	double outputs[16];
+	std::string errstr;
+	CHECK(CPS.update_array(iP, p, iH, h, 4, iOutputs, 4, outputs, &errstr) == 1);
+	CHECK(!errstr.empty());
+	for (int i = 0; i < 3; i++)
+	{
+		CAPTURE(i);
+		ref.update(iP, p[i], iH, h[i]);
+		for (int j = 0; j < 4; j++)
+		{
+			CHECK(fabs(outputs[j*4+i]-ref.keyed_output(iOutputs[j])) <= 1e-12*fabs(ref.keyed_output(iOutputs[j])));
+		}
+	}
+	for (int j = 0; j < 4; j++)
+	{
+		CHECK(!ValidNumber(outputs[j*4+3]));
+	}
+}
 #endif
 
 
@@ -2573,220 +3432,110 @@ double CoolPropStateClassSI::drhodT_along_sat_liquid(void)
 }
 
 // All the derivatives of the ideal-gas and residual Helmholtz energy
+// The first one that is needed evaluates all of them up to second order, this is much faster than one pass through the 
+// terms per derivative.  The third derivatives are only needed for some of the derivative outputs, so they are evaluated separately
+void CoolPropStateClassSI::cache_Helmholtz_derivatives(double tau, double delta, int max_order)
+{
+	FluidHelmholtzDerivatives derivs = pFluid->Helmholtz_derivatives(tau,delta,max_order);
+	cache.phi0 = derivs.phi0.base;
+	cache.dphi0_dDelta = derivs.phi0.dDelta;
+	cache.dphi0_dTau = derivs.phi0.dTau;
+	cache.d2phi0_dDelta2 = derivs.phi0.dDelta2;
+	cache.d2phi0_dDelta_dTau = derivs.phi0.dDelta_dTau;
+	cache.d2phi0_dTau2 = derivs.phi0.dTau2;
+	cache.phir = derivs.phir.base;
+	cache.dphir_dDelta = derivs.phir.dDelta;
+	cache.dphir_dTau = derivs.phir.dTau;
+	cache.d2phir_dDelta2 = derivs.phir.dDelta2;
+	cache.d2phir_dDelta_dTau = derivs.phir.dDelta_dTau;
+	cache.d2phir_dTau2 = derivs.phir.dTau2;
+	if (max_order < 3) return;
+	cache.d3phi0_dTau3 = derivs.phi0.dTau3;
+	cache.d3phi0_dDelta_dTau2 = derivs.phi0.dDelta_dTau2;
+	cache.d3phi0_dDelta2_dTau = derivs.phi0.dDelta2_dTau;
+	cache.d3phi0_dDelta3 = derivs.phi0.dDelta3;
+	cache.d3phir_dTau3 = derivs.phir.dTau3;
+	cache.d3phir_dDelta_dTau2 = derivs.phir.dDelta_dTau2;
+	cache.d3phir_dDelta2_dTau = derivs.phir.dDelta2_dTau;
+	cache.d3phir_dDelta3 = derivs.phir.dDelta3;
+}
 double CoolPropStateClassSI::phi0(double tau, double delta){
-	if (cache.phi0) 
-	{
-		return cache.phi0; 
-	}
-	else 
-	{
-		cache.phi0 = pFluid->phi0(tau,delta);
-		return cache.phi0;
-	}
+	if (!cache.phi0){ cache_Helmholtz_derivatives(tau,delta,2); }
+	return cache.phi0;
 };
 double CoolPropStateClassSI::dphi0_dDelta(double tau, double delta){
-	if (cache.dphi0_dDelta)
-	{
-		return cache.dphi0_dDelta; 
-	}
-	else 
-	{
-		cache.dphi0_dDelta = pFluid->dphi0_dDelta(tau,delta);
-		return cache.dphi0_dDelta;
-	}
+	if (!cache.dphi0_dDelta){ cache_Helmholtz_derivatives(tau,delta,2); }
+	return cache.dphi0_dDelta;
 };
 double CoolPropStateClassSI::dphi0_dTau(double tau, double delta){
-	if (cache.dphi0_dTau)
-	{
-		return cache.dphi0_dTau; 
-	}
-	else 
-	{
-		cache.dphi0_dTau = pFluid->dphi0_dTau(tau,delta);
-		return cache.dphi0_dTau;
-	}
+	if (!cache.dphi0_dTau){ cache_Helmholtz_derivatives(tau,delta,2); }
+	return cache.dphi0_dTau;
 };
 double CoolPropStateClassSI::d2phi0_dDelta2(double tau, double delta){
-	if (cache.d2phi0_dDelta2) 
-	{
-		return cache.d2phi0_dDelta2; 
-	}
-	else 
-	{
-		cache.d2phi0_dDelta2 = pFluid->d2phi0_dDelta2(tau,delta);
-		return cache.d2phi0_dDelta2;
-	}
+	if (!cache.d2phi0_dDelta2){ cache_Helmholtz_derivatives(tau,delta,2); }
+	return cache.d2phi0_dDelta2;
 };
 double CoolPropStateClassSI::d2phi0_dDelta_dTau(double tau, double delta){
-	if (cache.d2phi0_dDelta_dTau) 
-	{
-		return cache.d2phi0_dDelta_dTau; 
-	}
-	else 
-	{
-		cache.d2phi0_dDelta_dTau = pFluid->d2phi0_dDelta_dTau(tau,delta);
-		return cache.d2phi0_dDelta_dTau;
-	}
+	if (!cache.d2phi0_dDelta_dTau){ cache_Helmholtz_derivatives(tau,delta,2); }
+	return cache.d2phi0_dDelta_dTau;
 };
 double CoolPropStateClassSI::d2phi0_dTau2(double tau, double delta){
-	if (cache.d2phi0_dTau2) 
-	{
-		return cache.d2phi0_dTau2; 
-	}
-	else 
-	{
-		cache.d2phi0_dTau2 = pFluid->d2phi0_dTau2(tau,delta);
-		return cache.d2phi0_dTau2;
-	}
+	if (!cache.d2phi0_dTau2){ cache_Helmholtz_derivatives(tau,delta,2); }
+	return cache.d2phi0_dTau2;
 };
-
 double CoolPropStateClassSI::d3phi0_dTau3(double tau, double delta){
-	if (cache.d3phi0_dTau3) 
-	{
-		return cache.d3phi0_dTau3; 
-	}
-	else 
-	{
-		cache.d3phi0_dTau3 = pFluid->d3phi0_dTau3(tau,delta);
-		return cache.d3phi0_dTau3;
-	}
+	if (!cache.d3phi0_dTau3){ cache_Helmholtz_derivatives(tau,delta,3); }
+	return cache.d3phi0_dTau3;
 };
-
 double CoolPropStateClassSI::d3phi0_dDelta_dTau2(double tau, double delta){
 	return 0;
 };
-
 double CoolPropStateClassSI::d3phi0_dDelta2_dTau(double tau, double delta){
 	return 0;
 };
-
 double CoolPropStateClassSI::d3phi0_dDelta3(double tau, double delta){
-	if (cache.d3phi0_dDelta3) 
-	{
-		return cache.d3phi0_dDelta3; 
-	}
-	else 
-	{
-		cache.d3phi0_dDelta3 = pFluid->d3phi0_dDelta3(tau,delta);
-		return cache.d3phi0_dDelta3;
-	}
+	if (!cache.d3phi0_dDelta3){ cache_Helmholtz_derivatives(tau,delta,3); }
+	return cache.d3phi0_dDelta3;
 };
-
-
 double CoolPropStateClassSI::phir(double tau, double delta){
-	if (cache.phir) 
-	{
-		return cache.phir; 
-	}
-	else 
-	{
-		cache.phir = pFluid->phir(tau,delta);
-		return cache.phir;
-	}
+	if (!cache.phir){ cache_Helmholtz_derivatives(tau,delta,2); }
+	return cache.phir;
 };
 double CoolPropStateClassSI::dphir_dDelta(double tau, double delta){
-	if (cache.dphir_dDelta)
-	{
-		return cache.dphir_dDelta; 
-	}
-	else 
-	{
-		cache.dphir_dDelta = pFluid->dphir_dDelta(tau,delta);
-		return cache.dphir_dDelta;
-	}
+	if (!cache.dphir_dDelta){ cache_Helmholtz_derivatives(tau,delta,2); }
+	return cache.dphir_dDelta;
 };
 double CoolPropStateClassSI::dphir_dTau(double tau, double delta){
-	if (cache.dphir_dTau)
-	{
-		return cache.dphir_dTau; 
-	}
-	else 
-	{
-		cache.dphir_dTau = pFluid->dphir_dTau(tau,delta);
-		return cache.dphir_dTau;
-	}
+	if (!cache.dphir_dTau){ cache_Helmholtz_derivatives(tau,delta,2); }
+	return cache.dphir_dTau;
 };
 double CoolPropStateClassSI::d2phir_dDelta2(double tau, double delta){
-	if (cache.d2phir_dDelta2) 
-	{
-		return cache.d2phir_dDelta2; 
-	}
-	else 
-	{
-		cache.d2phir_dDelta2 = true;
-		cache.d2phir_dDelta2 = pFluid->d2phir_dDelta2(tau,delta);
-		return cache.d2phir_dDelta2;
-	}
+	if (!cache.d2phir_dDelta2){ cache_Helmholtz_derivatives(tau,delta,2); }
+	return cache.d2phir_dDelta2;
 };
 double CoolPropStateClassSI::d2phir_dDelta_dTau(double tau, double delta){
-	if (cache.d2phir_dDelta_dTau) 
-	{
-		return cache.d2phir_dDelta_dTau; 
-	}
-	else 
-	{
-		cache.d2phir_dDelta_dTau = pFluid->d2phir_dDelta_dTau(tau,delta);
-		return cache.d2phir_dDelta_dTau;
-	}
+	if (!cache.d2phir_dDelta_dTau){ cache_Helmholtz_derivatives(tau,delta,2); }
+	return cache.d2phir_dDelta_dTau;
 };
 double CoolPropStateClassSI::d2phir_dTau2(double tau, double delta){
-	if (cache.d2phir_dTau2) 
-	{
-		return cache.d2phir_dTau2; 
-	}
-	else 
-	{
-		cache.d2phir_dTau2 = pFluid->d2phir_dTau2(tau,delta);
-		return cache.d2phir_dTau2;
-	}
+	if (!cache.d2phir_dTau2){ cache_Helmholtz_derivatives(tau,delta,2); }
+	return cache.d2phir_dTau2;
 };
-
 double CoolPropStateClassSI::d3phir_dTau3(double tau, double delta){
-	if (cache.d3phir_dTau3) 
-	{
-		return cache.d3phir_dTau3;
-	}
-	else 
-	{
-		cache.d3phir_dTau3 = pFluid->d3phir_dTau3(tau,delta);
-		return cache.d3phir_dTau3;
-	}
+	if (!cache.d3phir_dTau3){ cache_Helmholtz_derivatives(tau,delta,3); }
+	return cache.d3phir_dTau3;
 };
-
 double CoolPropStateClassSI::d3phir_dDelta_dTau2(double tau, double delta){
-	if (cache.d3phir_dDelta_dTau2) 
-	{
-		return cache.d3phir_dDelta_dTau2;
-	}
-	else 
-	{
-		cache.d3phir_dDelta_dTau2 = pFluid->d3phir_dDelta_dTau2(tau,delta);
-		return cache.d3phir_dDelta_dTau2;
-	}
+	if (!cache.d3phir_dDelta_dTau2){ cache_Helmholtz_derivatives(tau,delta,3); }
+	return cache.d3phir_dDelta_dTau2;
 };
-
 double CoolPropStateClassSI::d3phir_dDelta2_dTau(double tau, double delta){
-	if (cache.d3phir_dDelta2_dTau) 
-	{
-		return cache.d3phir_dDelta2_dTau; 
-	}
-	else 
-	{
-		cache.d3phir_dDelta2_dTau = pFluid->d3phir_dDelta2_dTau(tau,delta);
-		return cache.d3phir_dDelta2_dTau;
-	}
+	if (!cache.d3phir_dDelta2_dTau){ cache_Helmholtz_derivatives(tau,delta,3); }
+	return cache.d3phir_dDelta2_dTau;
 };
-
 double CoolPropStateClassSI::d3phir_dDelta3(double tau, double delta){
-	if (cache.d3phir_dDelta3) 
-	{
-		return cache.d3phir_dDelta3; 
-	}
-	else 
-	{
-		cache.d3phir_dDelta3 = pFluid->d3phir_dDelta3(tau,delta);
-		return cache.d3phir_dDelta3;
-	}
+	if (!cache.d3phir_dDelta3){ cache_Helmholtz_derivatives(tau,delta,3); }
+	return cache.d3phir_dDelta3;
 };
 /// Interpolation routines
 double CoolPropStateClassSI::interp_linear(double Q, double valueL, double valueV) {
@@ -2801,6 +3550,13 @@ void CoolPropStateClassSI::enable_EXTTP(void){pFluid->enable_EXTTP();};
 bool CoolPropStateClassSI::isenabled_EXTTP(void){return pFluid->isenabled_EXTTP();};
 /// Disable the extended two-phase calculations
 void CoolPropStateClassSI::disable_EXTTP(void){pFluid->disable_EXTTP();};
+
+/// Enable the continuation mode
+void CoolPropStateClassSI::enable_continuation(void){continuation = true;};
+/// Check if the continuation mode is enabled
+bool CoolPropStateClassSI::isenabled_continuation(void){return continuation;};
+/// Disable the continuation mode
+void CoolPropStateClassSI::disable_continuation(void){continuation = false; has_previous = false;};
 /// Enable the TTSE
 void CoolPropStateClassSI::enable_TTSE_LUT(void){pFluid->enable_TTSE_LUT();};
 /// Check if TTSE is enabled
@@ -2817,6 +3573,8 @@ void CoolPropStateClassSI::disable_TTSE_LUT_writing(void){pFluid->disable_TTSE_L
 void CoolPropStateClassSI::set_TTSESat_LUT_size(int N){pFluid->set_TTSESat_LUT_size(N);};
 /// Over-ride the default size of the single-phase LUT
 void CoolPropStateClassSI::set_TTSESinglePhase_LUT_size(int Np, int Nh){pFluid->set_TTSESinglePhase_LUT_size(Np,Nh);};
+/// Over-ride the number of threads used to build the single-phase LUT
+void CoolPropStateClassSI::set_TTSE_LUT_build_threads(int Nthreads){pFluid->set_TTSE_LUT_build_threads(Nthreads);};
 /// Over-ride the default range of the single-phase LUT
 void CoolPropStateClassSI::set_TTSESinglePhase_LUT_range(double hmin, double hmax, double pmin, double pmax){pFluid->set_TTSESinglePhase_LUT_range(hmin,hmax,pmin,pmax);};
 /// Get the current range of the single-phase LUT
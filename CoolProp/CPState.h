@@ -82,6 +82,27 @@ public:
 			};
 };
 
+class CoolPropStateClassSI;
+
+/// Owns one of the saturation states of a CoolPropStateClassSI and deletes it with its parent.
+///
+/// When a state is copied, its saturation states are copied into those of the target rather than shared,
+/// and the saturation states of the target are only allocated if it does not have them yet
+class SaturationStatePointer
+{
+public:
+	SaturationStatePointer(){p = NULL;};
+	SaturationStatePointer(const SaturationStatePointer &other);
+	~SaturationStatePointer();
+	SaturationStatePointer &operator=(const SaturationStatePointer &other);
+	/// Take ownership of a state allocated with new
+	SaturationStatePointer &operator=(CoolPropStateClassSI *p);
+	CoolPropStateClassSI *operator->() const {return p;};
+	operator CoolPropStateClassSI*() const {return p;};
+private:
+	CoolPropStateClassSI *p;
+};
+
 class CoolPropStateClassSI
 {
 protected:
@@ -99,8 +120,12 @@ protected:
 	// Saturation values
 	double rhosatL, rhosatV, psatL, psatV, TsatL, TsatV;
 
-	// Pointers to the Liquid and Vapor classes
-	CoolPropStateClassSI *SatL, *SatV;
+	// The Liquid and Vapor classes
+	SaturationStatePointer SatL, SatV;
+
+	// Continuation mode, in which the previous single-phase solution is the starting point for the next update
+	bool continuation, has_previous;
+	double T_previous, rho_previous;
 
 	void add_saturation_states(void);
 	void remove_saturation_states(void);
@@ -114,25 +139,38 @@ protected:
 	// To be used to update internal variables if you know that your parameters are T,D
 	void update_Trho(long iInput1, double Value1, long iInput2, double Value2);
 
-	// To be used to update internal variables if you know that your parameters are T,P
-	void update_Tp(long iInput1, double Value1, long iInput2, double Value2);
+	/// To be used to update internal variables if you know that your parameters are T,P
+	/// If rho0 is included, start at this value for the solution
+	void update_Tp(long iInput1, double Value1, long iInput2, double Value2, double rho0 = -1);
 
 	/// To be used to update internal variables if you know that your parameters are P,H
 	/// If T0 and rho0 are included, start at this value for the solution
 	void update_ph(long iInput1, double Value1, long iInput2, double Value2, double T0 = -1, double rho0 = -1);
 
-	// To be used to update internal variables if you know that your parameters are P,S
-	void update_ps(long iInput1, double Value1, long iInput2, double Value2);
+	/// To be used to update internal variables if you know that your parameters are P,S
+	/// If T0 and rho0 are included, start at this value for the solution
+	void update_ps(long iInput1, double Value1, long iInput2, double Value2, double T0 = -1, double rho0 = -1);
 
 	// To be used to update internal variables if you know that your parameters are P,D
 	void update_prho(long iInput1, double Value1, long iInput2, double Value2);
 
-	// To be used to update internal variables if you know that your parameters are H,S
-	void update_hs(long iInput1, double Value1, long iInput2, double Value2);
+	/// To be used to update internal variables if you know that your parameters are H,S
+	/// If T0 and rho0 are included, start at this value for the solution
+	void update_hs(long iInput1, double Value1, long iInput2, double Value2, double T0 = -1, double rho0 = -1);
 
 	// To be used to update internal variables if you know that your parameters are T,S
 	void update_Ts(long iInput1, double Value1, long iInput2, double Value2);
 
+	/// To be used to update internal variables if you know that your parameters are D,U or D,H
+	/// If T0 is included, start at this value for the solution
+	void update_rho_energy(long iInput1, double Value1, long iInput2, double Value2, double T0 = -1);
+
+	/// To be used to update internal variables if you know that your parameters are T,U or T,H
+	void update_T_energy(long iInput1, double Value1, long iInput2, double Value2);
+
+	/// To be used to update internal variables if you know that your parameters are P,U
+	void update_pu(long iInput1, double Value1, long iInput2, double Value2);
+
 	// Update using the TTSE lookup tables
 	void update_TTSE_LUT(long iInput1, double Value1, long iInput2, double Value2);
 
@@ -145,13 +183,21 @@ protected:
 	/// Check whether within the TTSE range
 	bool within_TTSE_range(long iInput1, double Value1, long iInput2, double Value2);
 
+	/// Check whether the solution T, rho that was started from a guess value is a stable single-phase state.  If not, 
+	/// the saturation curve might have been crossed and the solution is not valid.  If the phase at the inputs is already
+	/// known, the density must be on its side of the critical density, otherwise it must be clear of the saturated 
+	/// densities given by the ancillaries; states close to the saturation curve are rejected and solved without the guess
+	/// @param phase The phase index (iLiquid, iGas or iSupercritical) if it is known, -1 otherwise
+	bool stable_single_phase(double T, double rho, long phase = -1);
+
 	/// Extended two-phase calculations need different interpolation functions
 	double interp_linear(double Q, double valueL, double valueV);
 	double interp_recip(double Q, double valueL, double valueV);
 
 public:
 
-	//CoolPropStateClassSI(CoolPropStateClassSI const&);  // for copying
+	/// A new state of the same fluid, which is not updated.  Copying a state (with the copy constructor or
+	/// the assignment operator) copies its saturation states as well
 	CoolPropStateClassSI copy(void){
 		if (fluid_type == FLUID_TYPE_INCOMPRESSIBLE_LIQUID || fluid_type == FLUID_TYPE_INCOMPRESSIBLE_SOLUTION)
 		{
@@ -192,7 +238,7 @@ public:
 	bool TwoPhase, SinglePhase, s_cached, h_cached;
 	
 	// Default Constructor
-	CoolPropStateClassSI(){SatL = NULL; SatV = NULL;};
+	CoolPropStateClassSI(){continuation = false; has_previous = false;};
 
 	// Constructor with fluid name
 	CoolPropStateClassSI(std::string FluidName);
@@ -200,9 +246,6 @@ public:
 	// Constructor with fluid pointer
 	CoolPropStateClassSI(Fluid *pFluid);
 
-	// Destructor to clear SatL and SatV
-	~CoolPropStateClassSI();
-
 	/// Saturation temperature
 	double Tsat(double Q);
 
@@ -228,11 +271,25 @@ public:
 	/// Stop it from adding the SatL and SatV class pointers
 	void no_SatLSatV(void){_noSatLSatV = true;};
 
+	/// Clear the flags and turn off the continuation mode so that the state can be used for another calculation
+	void reset(void){flag_SinglePhase = false; flag_TwoPhase = false; disable_continuation();};
+
 	// Property updater
 	// Uses the indices in CoolProp for the input parameters
-	// If P,H are inputs, can also use the input values of T0,rho0 as start guess for the 2D Newton solver
+	// If P,H or P,S or H,S are inputs, can also use the input values of T0,rho0 as start guess for the 2D Newton solver
+	// (and rho0 as the start guess for T,P inputs).  If the solution is not a stable single-phase state, the guess is discarded
 	void update(long iInput1, double Value1, long iInput2, double Value2, double T0 = -1, double rho0 = -1);
 
+	/// Update the state for each of a vector of state points and evaluate several outputs at each of them, all in SI units.
+	/// The outputs of the point i are stored in outputs[j*length+i] for j = 0..Noutputs-1, so that each output is contiguous.
+	/// If a point cannot be evaluated, its outputs are set to _HUGE, the error message is stored in errstr, and the loop carries on.
+	/// The state is left at the last point.
+	/// @param length The number of state points in Value1 and Value2
+	/// @param iOutputs Array of output parameter indices, as for keyed_output
+	/// @param outputs Array of length*Noutputs values
+	/// @returns The number of state points that could not be evaluated
+	long update_array(long iInput1, const double *Value1, long iInput2, const double *Value2, long length, const long *iOutputs, long Noutputs, double *outputs, std::string *errstr);
+
 	// Returns an output based on the key provided
 	// where iInput is one of iT,iP,iH,iS,....
 	double keyed_output(long iInput);
@@ -300,6 +357,20 @@ public:
 	/// Disable the extended two-phase calculations
 	void disable_EXTTP(void);
 
+	// ----------------------------------------
+	// Continuation things
+	// ----------------------------------------
+	/// Enable the continuation mode, in which the solvers for P,H, P,S, H,S and T,P inputs start from the 
+	/// previous single-phase solution of this state rather than from the ancillary equations.  For inputs that 
+	/// only change a little from one update to the next, as in a transient simulation, the solvers converge in one 
+	/// or two steps.  If the new solution is not a stable single-phase state, for instance because the saturation curve
+	/// was crossed, the state is solved for again without the guess
+	void enable_continuation(void);
+	/// Check if the continuation mode is enabled
+	bool isenabled_continuation(void);
+	/// Disable the continuation mode
+	void disable_continuation(void);
+
 	// ----------------------------------------	
 	// TTSE LUT things
 	// ----------------------------------------
@@ -319,6 +390,8 @@ public:
 	void set_TTSESat_LUT_size(int N);
 	/// Over-ride the default size of the single-phase LUT
 	void set_TTSESinglePhase_LUT_size(int Np, int Nh);
+	/// Over-ride the number of threads used to build the single-phase LUT
+	void set_TTSE_LUT_build_threads(int Nthreads);
 	/// Over-ride the default range of the single-phase LUT
 	void set_TTSESinglePhase_LUT_range(double hmin, double hmax, double pmin, double pmax);
 	/// Get the current range of the single-phase LUT
@@ -436,6 +509,9 @@ public:
 	// Helmholtz Energy Derivatives
 	// ----------------------------------------
 
+	/// Evaluate all the derivatives of the Helmholtz energy up to max_order at once and store them in the cache
+	void cache_Helmholtz_derivatives(double tau, double delta, int max_order);
+
 	double phi0(double tau, double delta);
 	double dphi0_dDelta(double tau, double delta);
 	double dphi0_dTau(double tau, double delta);
@@ -665,4 +741,27 @@ public:
 	double drhodT_along_sat_liquid(void){return CoolPropStateClassSI::drhodT_along_sat_liquid()*conversion_factor("D/T");};
 };
 
+/// A state of a CoolProp fluid that is borrowed from a pool of the calling thread, for the states that are
+/// only needed during a call (in PropsSI and the flash routines for instance).
+///
+/// The state is reset when it is borrowed and given back to the pool when the PooledCoolPropStateSI goes out
+/// of scope, so that it is reused with its saturation states by the next call for the same fluid and no
+/// memory is allocated once the pool is warm.
+class PooledCoolPropStateSI
+{
+public:
+	PooledCoolPropStateSI(Fluid *pFluid);
+	~PooledCoolPropStateSI();
+	CoolPropStateClassSI &operator*() const {return *state;};
+	CoolPropStateClassSI *operator->() const {return state;};
+private:
+	CoolPropStateClassSI *state;
+	PooledCoolPropStateSI(const PooledCoolPropStateSI &);
+	PooledCoolPropStateSI &operator=(const PooledCoolPropStateSI &);
+};
+
+/// The number of states that have been allocated on the heap for the saturation states and the pools since
+/// the start, for checking that they are reused
+long long get_state_allocation_count(void);
+
 #endif
@@ -0,0 +1,189 @@
+#include "Chebyshev.h"
+#include "CPExceptions.h"
+#include "CoolPropTools.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void PiecewiseChebyshevClass::build(ChebyshevFunction &f, int Nout, double xmin, double xmax, int degree, double rtol, int max_depth, bool keep_unconverged)
+{
+	if (degree < 1){ throw ValueError(format("degree [%d] must be at least 1",degree)); }
+	if (max_depth < 0 || max_depth > 20){ throw ValueError(format("max_depth [%d] must be between 0 and 20",max_depth)); }
+	if (!(xmax > xmin)){ throw ValueError(format("xmax [%g] must be greater than xmin [%g]",xmax,xmin)); }
+	this->Nout = Nout;
+	this->degree = degree;
+	this->max_depth = max_depth;
+	this->xmin = xmin;
+	this->xmax = xmax;
+	this->keep_unconverged = keep_unconverged;
+	intervals.clear();
+
+	fit(f, xmin, xmax, 0, rtol);
+
+	// The intervals are dyadic, so each one covers a whole number of the subintervals of the finest level
+	int N = 1 << max_depth;
+	double h = (xmax-xmin)/N;
+	index.assign(N, -1);
+	for (unsigned int i = 0; i < intervals.size(); i++)
+	{
+		int lo = (int)floor((intervals[i].a-xmin)/h+0.5), hi = (int)floor((intervals[i].b-xmin)/h+0.5);
+		for (int m = lo; m < hi; m++){ index[m] = (int)i; }
+	}
+}
+
+void PiecewiseChebyshevClass::fit(ChebyshevFunction &f, double a, double b, int depth, double rtol)
+{
+	int n = degree+1;
+	ChebyshevInterval I;
+	I.a = a;
+	I.b = b;
+	I.c.assign(Nout*n, 0.0);
+	std::vector<double> y(Nout);
+	std::vector<std::vector<double> > ynodes(n);
+	bool converged = true, evaluated = false;
+	try
+	{
+		// Values at the Chebyshev nodes (of the first kind)
+		for (int j = 0; j < n; j++)
+		{
+			double t = cos(M_PI*(j+0.5)/n);
+			f.call((a+b)/2+(b-a)/2*t, ynodes[j]);
+			for (int k = 0; k < Nout; k++){ if (!ValidNumber(ynodes[j][k])){ throw ValueError("Invalid value"); } }
+		}
+		// Coefficients by the discrete cosine transform of the values at the nodes
+		for (int k = 0; k < Nout; k++)
+		{
+			for (int q = 0; q < n; q++)
+			{
+				double summer = 0;
+				for (int j = 0; j < n; j++){ summer += ynodes[j][k]*cos(M_PI*q*(j+0.5)/n); }
+				I.c[k*n+q] = 2.0/n*summer;
+			}
+			I.c[k*n] /= 2;
+		}
+		evaluated = true;
+		intervals.push_back(I);
+		int i = (int)intervals.size()-1;
+		try
+		{
+			// Check halfway between the nodes, where the error of the interpolation is the largest
+			for (int j = 0; j < n-1 && converged; j++)
+			{
+				double x = (a+b)/2+(b-a)/2*cos(M_PI*(j+1)/n);
+				f.call(x, y);
+				for (int k = 0; k < Nout; k++)
+				{
+					if (!(fabs(evaluate(i,k,x)-y[k]) <= rtol*std::max(fabs(y[k]),1.0))){ converged = false; break; }
+				}
+			}
+		}
+		catch (std::exception &)
+		{
+			converged = false;
+		}
+		intervals.pop_back();
+	}
+	catch (std::exception &)
+	{
+		converged = false;
+	}
+
+	if (converged || (keep_unconverged && evaluated && depth >= max_depth))
+	{
+		intervals.push_back(I);
+		int i = (int)intervals.size()-1;
+		intervals[i].ya.resize(Nout);
+		intervals[i].yb.resize(Nout);
+		for (int k = 0; k < Nout; k++)
+		{
+			intervals[i].ya[k] = evaluate(i,k,a);
+			intervals[i].yb[k] = evaluate(i,k,b);
+		}
+	}
+	else if (depth < max_depth)
+	{
+		fit(f, a, (a+b)/2, depth+1, rtol);
+		fit(f, (a+b)/2, b, depth+1, rtol);
+	}
+	// Otherwise the interval is left out
+}
+
+int PiecewiseChebyshevClass::interval(double x) const
+{
+	if (!(x >= xmin && x <= xmax) || index.empty()){ return -1; }
+	int N = (int)index.size();
+	int m = (int)((x-xmin)/(xmax-xmin)*N);
+	if (m >= N){ m = N-1; }
+	return index[m];
+}
+
+double PiecewiseChebyshevClass::evaluate(int i, int k, double x) const
+{
+	const ChebyshevInterval &I = intervals[i];
+	const double *c = &(I.c[k*(degree+1)]);
+	double t = (2*x-I.a-I.b)/(I.b-I.a);
+	// Clenshaw's recurrence
+	double b1 = 0, b2 = 0;
+	for (int q = degree; q >= 1; q--)
+	{
+		double b0 = 2*t*b1-b2+c[q];
+		b2 = b1;
+		b1 = b0;
+	}
+	return t*b1-b2+c[0];
+}
+
+double PiecewiseChebyshevClass::evaluate(int i, int k, double x, double &dydx) const
+{
+	const ChebyshevInterval &I = intervals[i];
+	const double *c = &(I.c[k*(degree+1)]);
+	double t = (2*x-I.a-I.b)/(I.b-I.a);
+	// The Chebyshev polynomials and their derivatives by the three-term recurrence
+	double T0 = 1, T1 = t, dT0 = 0, dT1 = 1;
+	double y = c[0]+c[1]*t, dy = c[1];
+	for (int q = 2; q <= degree; q++)
+	{
+		double T2 = 2*t*T1-T0, dT2 = 2*T1+2*t*dT1-dT0;
+		y += c[q]*T2;
+		dy += c[q]*dT2;
+		T0 = T1; T1 = T2; dT0 = dT1; dT1 = dT2;
+	}
+	dydx = dy*2/(I.b-I.a);
+	return y;
+}
+
+bool PiecewiseChebyshevClass::solve(int k, double y, double &x, int &i) const
+{
+	if (intervals.empty()){ return false; }
+	// Sign such that s*y_k is increasing with x
+	double s = (intervals.back().yb[k] > intervals.front().ya[k]) ? 1 : -1;
+	// Bisection for the first interval whose upper end is not below y
+	int lo = 0, hi = (int)intervals.size()-1;
+	if (s*y > s*intervals[hi].yb[k] || s*y < s*intervals[lo].ya[k]){ return false; }
+	while (lo < hi)
+	{
+		int mid = (lo+hi)/2;
+		if (s*intervals[mid].yb[k] < s*y){ lo = mid+1; } else { hi = mid; }
+	}
+	i = lo;
+	const ChebyshevInterval &I = intervals[i];
+	// y is in a gap between two intervals
+	if (s*y < s*I.ya[k]){ return false; }
+
+	// Newton's method on the expansion, starting from linear interpolation
+	double xa = I.a, xb = I.b;
+	x = (I.yb[k] == I.ya[k]) ? (xa+xb)/2 : xa+(xb-xa)*(y-I.ya[k])/(I.yb[k]-I.ya[k]);
+	for (int iter = 0; iter < 50; iter++)
+	{
+		double dydx, r = evaluate(i,k,x,dydx)-y;
+		// Keep a bracket so that a bad step falls back to bisection
+		if (s*r > 0){ xb = x; } else { xa = x; }
+		double xnew = x-r/dydx;
+		if (!(xnew > xa && xnew < xb)){ xnew = (xa+xb)/2; }
+		if (fabs(xnew-x) <= 1e-15*(fabs(x)+(I.b-I.a))){ x = xnew; return true; }
+		x = xnew;
+	}
+	return true;
+}
@@ -0,0 +1,70 @@
+#ifndef CHEBYSHEV_H
+#define CHEBYSHEV_H
+
+#include <vector>
+
+/// A function of one variable with several outputs, all of which are approximated on the same intervals
+class ChebyshevFunction
+{
+public:
+	ChebyshevFunction(){};
+	virtual ~ChebyshevFunction(){};
+	/// Evaluate all the outputs at x.  Throw an exception if the function cannot be evaluated at x
+	virtual void call(double x, std::vector<double> &y) = 0;
+};
+
+/// Piecewise Chebyshev expansions of several outputs on a common set of intervals of [xmin,xmax]
+///
+/// The intervals are found by adaptive bisection of [xmin,xmax], until each output is reproduced within
+/// rtol*max(|y|,1) at the points halfway between the Chebyshev nodes.  Intervals where the function cannot
+/// be evaluated are left out, as are intervals that do not converge within the maximum number of bisections
+/// unless they are explicitly kept.
+/// The interval that contains x is found in O(1) through an index on the finest level of bisection.
+class PiecewiseChebyshevClass
+{
+public:
+	struct ChebyshevInterval
+	{
+		double a, b;
+		std::vector<double> c; ///< Coefficients, degree+1 for each output
+		std::vector<double> ya, yb; ///< The outputs at both ends of the interval
+	};
+	PiecewiseChebyshevClass(){Nout = 0; degree = 0; max_depth = 0; xmin = 0; xmax = 0; keep_unconverged = false;};
+
+	/// Build the expansions
+	/// @param f The function to be approximated
+	/// @param Nout The number of outputs of f
+	/// @param xmin The lower end of the range
+	/// @param xmax The upper end of the range
+	/// @param degree The degree of the expansion in each interval
+	/// @param rtol The relative tolerance
+	/// @param max_depth The maximum number of bisections of [xmin,xmax]
+	/// @param keep_unconverged If true, the intervals that have not converged after max_depth bisections are kept rather than left out
+	void build(ChebyshevFunction &f, int Nout, double xmin, double xmax, int degree, double rtol, int max_depth, bool keep_unconverged = false);
+
+	/// The index of the interval that contains x, or -1 if x is not covered
+	int interval(double x) const;
+	/// Evaluate the output k in the interval i
+	double evaluate(int i, int k, double x) const;
+	/// Evaluate the output k and its derivative with respect to x in the interval i
+	double evaluate(int i, int k, double x, double &dydx) const;
+	/// Solve for the x that gives y for the output k, which must be monotonic over [xmin,xmax]
+	/// @param k The index of the output
+	/// @param y The value of the output
+	/// @param x The solution
+	/// @param i The interval that contains the solution
+	/// @returns false if y is not covered
+	bool solve(int k, double y, double &x, int &i) const;
+
+	bool empty() const {return intervals.empty();};
+
+	std::vector<ChebyshevInterval> intervals;
+	std::vector<int> index; ///< The interval of each of the 2^max_depth subintervals of the finest level, -1 if not covered
+	int Nout, degree, max_depth;
+	double xmin, xmax;
+	bool keep_unconverged;
+private:
+	void fit(ChebyshevFunction &f, double a, double b, int depth, double rtol);
+};
+
+#endif
@@ -34,15 +34,18 @@
 #include "purefluids/R134a.h"
 #include "AllFluids.h"
 
+#if defined(COOLPROP_CXX11_THREADS)
+#include <thread>
+#endif
+
 /// The lower-level methods that can throw exceptions
 double _CoolProp_Fluid_PropsSI(long iOutput, long iName1, double Value1, long iName2, double Value2, Fluid *pFluid);
 double _PropsSI(std::string Output,std::string Name1, double Prop1, std::string Name2, double Prop2, std::string Ref);
 double _Props1SI(std::string FluidName, std::string Output);
 
-static std::string err_string;
-static std::string warning_string;
-
-static Fluid * pFluid;
+// The error and warning strings are per-thread so that concurrent calls do not clobber each other
+static COOLPROP_THREAD_LOCAL std::string err_string;
+static COOLPROP_THREAD_LOCAL std::string warning_string;
 
 // This is very hacky, but pull the git revision from the file
 #include "gitrevision.h" // Contents are like "long gitrevision = "aa121435436ggregrea4t43t433";"
@@ -180,7 +183,7 @@ std::pair<std::string, long> map_data[] = {
 std::map<std::string, long> param_map(map_data,
     map_data + sizeof map_data / sizeof map_data[0]);
 
-FluidsContainer Fluids = FluidsContainer();
+FluidsContainer Fluids(true);
 
 void set_err_string(std::string error_string)
 {
@@ -233,7 +236,7 @@ Fluid* get_fluid(long iFluid){
 long get_Fluid_index(std::string FluidName)
 {
 	// Try to get the fluid from Fluids by name
-	pFluid = Fluids.get_fluid(FluidName);
+	Fluid *pFluid = Fluids.get_fluid(FluidName);
 	// If NULL, didn't find it (or its alias)
 	if (pFluid!=NULL)
 	{
@@ -298,6 +301,7 @@ long get_param_index(std::string param)
 
 static int IsCoolPropFluid(std::string FluidName)
 {
+	Fluid *pFluid;
 	// Try to get the fluid from Fluids by name
 	try
 	{
@@ -371,7 +375,7 @@ long getFluidType(std::string FluidName){
 		// If iFluid is greater than -1, it is a CoolProp Fluid, otherwise not
 		if (iFluid > -1) {
 			// Get a pointer to the fluid object
-			pFluid = get_fluid(iFluid);
+			Fluid *pFluid = get_fluid(iFluid);
 			if (pFluid->pure())	{ return FLUID_TYPE_PURE;}
 			else { return FLUID_TYPE_PSEUDOPURE; }
 		} else {
@@ -383,7 +387,7 @@ long getFluidType(std::string FluidName){
 
 EXPORT_CODE int CONVENTION IsFluidType(const char *Ref, const char *Type)
 {
-	pFluid = Fluids.get_fluid(Ref);
+	Fluid *pFluid = Fluids.get_fluid(Ref);
 
 	if (IsBrine(Ref)){ // TODO Solution: Remove this part
 		if (!strcmp(Type,"Brine")){
@@ -467,11 +471,11 @@ double _T_hp_secant(std::string Ref, double h, double p, double T_guess)
     return T;
 }
 
-std::string Phase_Trho(std::string Fluid, double T, double rho)
+std::string Phase_Trho(std::string FluidName, double T, double rho)
 {
 	try{
 		// Try to load the CoolProp Fluid
-		pFluid = Fluids.get_fluid(Fluid);
+		Fluid *pFluid = Fluids.get_fluid(FluidName);
 		double pL,pV,rhoL,rhoV;
 		return pFluid->phase_Trho(T,rho, pL, pV, rhoL, rhoV);
 	}
@@ -481,11 +485,11 @@ std::string Phase_Trho(std::string Fluid, double T, double rho)
 	return std::string("");
 }
 
-std::string Phase(std::string Fluid, double T, double p)
+std::string Phase(std::string FluidName, double T, double p)
 {
 	try{
 		// Try to load the CoolProp Fluid
-		pFluid = Fluids.get_fluid(Fluid);
+		Fluid *pFluid = Fluids.get_fluid(FluidName);
 		double pL,pV,rhoL,rhoV;
 		return pFluid->phase_Tp(T, p, pL, pV, rhoL, rhoV);
 	}
@@ -495,9 +499,9 @@ std::string Phase(std::string Fluid, double T, double p)
 	return std::string("");
 }
 
-std::string Phase_Tp(std::string Fluid, double T, double p)
+std::string Phase_Tp(std::string FluidName, double T, double p)
 {
-	return Phase(Fluid,T,p);
+	return Phase(FluidName,T,p);
 }
 
 /*
@@ -509,7 +513,7 @@ double _Props1SI(std::string FluidName, std::string Output)
 {
     double out = _HUGE;
 	// Try to load the CoolProp Fluid
-	pFluid = Fluids.get_fluid(FluidName);
+	Fluid *pFluid = Fluids.get_fluid(FluidName);
 	if (pFluid != NULL)
 	{
 		// It's a CoolProp fluid
@@ -634,7 +638,7 @@ double _PropsSI(std::string Output, std::string Name1, double Prop1, std::string
 	else if (IsCoolPropFluid(Ref))
 	{
 		if (get_debug_level()>7) std::cout << format("%s:%d: Identified CoolProp fluid - %s\n",__FILE__,__LINE__,Ref.c_str()).c_str();
-		pFluid = Fluids.get_fluid(Ref);
+		Fluid *pFluid = Fluids.get_fluid(Ref);
 		// Convert all the parameters to integers
 		long iOutput = get_param_index(Output);
 		if (iOutput<0) 
@@ -692,10 +696,8 @@ double _PropsSI(std::string Output, std::string Name1, double Prop1, std::string
 				std::swap(Name1,Name2);
 			}
 			
-			// Solve for the temperature
-			double Tma     = IncompLiquidSI(get_param_index("Tmax"),0.0,0.0,Ref);
-			double T_guess = Tma - 10.0 ;
-			double T =_T_hp_secant(Ref,Prop1,Prop2,T_guess);
+			// Solve for the temperature directly from the polynomials
+			double T = IncompLiquid_T_hp(Ref,Prop1,Prop2);
 			// Return whatever property is desired
 			return IncompLiquidSI(get_param_index(Output),T,Prop2,Ref);
 		}
@@ -724,11 +726,8 @@ double _PropsSI(std::string Output, std::string Name1, double Prop1, std::string
 				std::swap(Name1,Name2);
 			}
 
-			// Solve for the temperature
-			double Tma     = IncompSolutionSI(get_param_index("Tmax"),0.0,0.0,Ref);
-			double Tmi     = IncompSolutionSI(get_param_index("Tmin"),0.0,0.0,Ref);
-			double T_guess = (Tma+Tmi)/2.0 ;
-			double T =_T_hp_secant(Ref,Prop1,Prop2,T_guess);
+			// Solve for the temperature directly from the polynomials
+			double T = IncompSolution_T_hp(Ref,Prop1,Prop2);
 			// Return whatever property is desired
 			return IncompSolutionSI(get_param_index(Output),T,Prop2,Ref);
 		}
@@ -756,6 +755,21 @@ EXPORT_CODE double CONVENTION IProps(long iOutput, long iName1, double Prop1, lo
 	double out = IPropsSI(iOutput,iName1,Prop1,iName2,Prop2,iFluid);
     return convert_from_SI_to_unit_system(iOutput,out,get_standard_unit_system());
 }
+/// True if the output does not require a state update (ancillaries, critical and triple point values, etc.)
+static bool _is_state_independent_output(long iOutput)
+{
+	switch (iOutput)
+	{
+	case iI: case iRhosatLanc: case iRhosatVanc: case iPsatLanc: case iPsatVanc:
+	case iMM: case iPcrit: case iTcrit: case iTtriple: case iPtriple: case iRhocrit: case iTmin:
+	case iAccentric: case iPHASE_LIQUID: case iPHASE_GAS: case iPHASE_SUPERCRITICAL: case iPHASE_TWOPHASE:
+	case iGWP20: case iGWP100: case iGWP500: case iODP: case iCritSplineT: case iScrit: case iHcrit:
+	case iTreduce: case iRhoreduce:
+		return true;
+	default:
+		return false;
+	}
+}
 double _CoolProp_Fluid_PropsSI(long iOutput, long iName1, double Prop1, long iName2, double Prop2, Fluid *pFluid)
 {
 	double val = _HUGE, T = _HUGE;
@@ -769,70 +783,55 @@ double _CoolProp_Fluid_PropsSI(long iOutput, long iName1, double Prop1, long iNa
     else if (iName2 == iT){
         T = Prop2;} 
 
-	// Generate a State instance wrapped around the Fluid instance
-	CoolPropStateClassSI CPS(pFluid);
+	// Borrow a State instance wrapped around the Fluid instance from the pool of this thread, so that the state
+	// and its saturation states are not allocated for each call
+	PooledCoolPropStateSI pooled_CPS(pFluid);
+	CoolPropStateClassSI &CPS = *pooled_CPS;
 
 	// Check if it is an output that doesn't require a state input
 	// Deal with it and return
-	switch (iOutput)
+	if (_is_state_independent_output(iOutput))
 	{
-        case iI:
-            {
-            if (!ValidNumber(T)){throw ValueError(format("T must be provided as an input to use this output").c_str());}
-            return CPS.pFluid->surface_tension_T(T);
-            }
-        case iRhosatLanc:
-            {
-            if (!ValidNumber(T)){throw ValueError(format("T must be provided as an input to use this output").c_str());}
-            return CPS.pFluid->rhosatL(T);
-            }
-        case iRhosatVanc:
-            {
-            if (!ValidNumber(T)){throw ValueError(format("T must be provided as an input to use this output").c_str());}
-            return CPS.pFluid->rhosatV(T);
-            }
-        case iPsatLanc:
-            {
-            if (!ValidNumber(T)){throw ValueError(format("T must be provided as an input to use this output").c_str());}
-            if (CPS.pFluid->pure()){
-                return CPS.pFluid->psat(T);
-            }
-            else{
-                return CPS.pFluid->psatL(T);
-            }
-            }
-        case iPsatVanc:
-            {
-            if (!ValidNumber(T)){throw ValueError(format("T must be provided as an input to use this output").c_str());}
-            if (CPS.pFluid->pure()){
-                return CPS.pFluid->psat(T);
-            }
-            else{
-                return CPS.pFluid->psatV(T);
-            }
-            }
-		case iMM:
-		case iPcrit:
-		case iTcrit:
-		case iTtriple:
-		case iPtriple:
-		case iRhocrit:
-		case iTmin:
-		case iAccentric:
-		case iPHASE_LIQUID:
-		case iPHASE_GAS:
-		case iPHASE_SUPERCRITICAL:
-		case iPHASE_TWOPHASE:
-		case iGWP20:
-		case iGWP100:
-		case iGWP500:
-		case iODP:
-		case iCritSplineT:
-		case iScrit:
-		case iHcrit:
-		case iTreduce:
-		case iRhoreduce:
-			return CPS.keyed_output(iOutput);
+		switch (iOutput)
+		{
+			case iI:
+				{
+				if (!ValidNumber(T)){throw ValueError(format("T must be provided as an input to use this output").c_str());}
+				return CPS.pFluid->surface_tension_T(T);
+				}
+			case iRhosatLanc:
+				{
+				if (!ValidNumber(T)){throw ValueError(format("T must be provided as an input to use this output").c_str());}
+				return CPS.pFluid->rhosatL(T);
+				}
+			case iRhosatVanc:
+				{
+				if (!ValidNumber(T)){throw ValueError(format("T must be provided as an input to use this output").c_str());}
+				return CPS.pFluid->rhosatV(T);
+				}
+			case iPsatLanc:
+				{
+				if (!ValidNumber(T)){throw ValueError(format("T must be provided as an input to use this output").c_str());}
+				if (CPS.pFluid->pure()){
+					return CPS.pFluid->psat(T);
+				}
+				else{
+					return CPS.pFluid->psatL(T);
+				}
+				}
+			case iPsatVanc:
+				{
+				if (!ValidNumber(T)){throw ValueError(format("T must be provided as an input to use this output").c_str());}
+				if (CPS.pFluid->pure()){
+					return CPS.pFluid->psat(T);
+				}
+				else{
+					return CPS.pFluid->psatV(T);
+				}
+				}
+			default:
+				return CPS.keyed_output(iOutput);
+		}
 	}
 
 	// Update the class
@@ -852,7 +851,7 @@ double _CoolProp_Fluid_PropsSI(long iOutput, long iName1, double Prop1, long iNa
 }
 EXPORT_CODE double CONVENTION IPropsSI(long iOutput, long iName1, double Prop1, long iName2, double Prop2, long iFluid)
 {
-	pFluid = Fluids.get_fluid(iFluid);
+	Fluid *pFluid = Fluids.get_fluid(iFluid);
 	// Didn't work
 	if (pFluid == NULL){
 		err_string=std::string("CoolProp error: ").append(format("%d is an invalid fluid index to IProps",iFluid));
@@ -891,6 +890,280 @@ double PropsSI(std::string Output, std::string Name1, double Prop1, std::string
 	}
 	return _HUGE;
 }
+/// Evaluate the same output for a vector of state points with the given state class.
+/// If a point cannot be evaluated, its output is set to _HUGE, the error message is stored in errstr, and the loop carries on.
+/// @returns The number of points that could not be evaluated
+static long _PropsSI_array_kernel(CoolPropStateClassSI &CPS, long iOutput, long iName1, const double *Prop1, long iName2, const double *Prop2, long length, double *outputs, std::string &errstr)
+{
+	long Nfail = 0;
+	for (long i = 0; i < length; i++)
+	{
+		try{
+			if (_is_state_independent_output(iOutput)){
+				// Outputs that do not need a state update go through the normal path
+				outputs[i] = _CoolProp_Fluid_PropsSI(iOutput,iName1,Prop1[i],iName2,Prop2[i],CPS.pFluid);
+			}
+			else{
+				CPS.update(iName1,Prop1[i],iName2,Prop2[i]);
+				outputs[i] = CPS.keyed_output(iOutput);
+			}
+		}
+		catch(std::exception &e){
+			errstr=std::string("CoolProp error: ").append(e.what());
+			outputs[i] = _HUGE; Nfail++;
+		}
+		catch(...){
+			errstr=std::string("CoolProp error: Indeterminate error");
+			outputs[i] = _HUGE; Nfail++;
+		}
+	}
+	return Nfail;
+}
+/// Evaluate the same output for a vector of state points of a CoolProp fluid.  The same
+/// state class is re-used for all the points so that the per-call overhead of PropsSI is only paid once.
+/// @returns The number of points that could not be evaluated
+long _CoolProp_Fluid_PropsSI_array(long iOutput, long iName1, const double *Prop1, long iName2, const double *Prop2, long length, Fluid *pFluid, double *outputs)
+{
+	CoolPropStateClassSI CPS(pFluid);
+	std::string errstr;
+	long Nfail = _PropsSI_array_kernel(CPS,iOutput,iName1,Prop1,iName2,Prop2,length,outputs,errstr);
+	if (Nfail > 0){ err_string = errstr; }
+	return Nfail;
+}
+#if defined(COOLPROP_CXX11_THREADS)
+/// The points [begin, end) that remain to be evaluated by one worker of the parallel array evaluation.
+/// The owner takes chunks from the front, idle workers steal from the back
+struct _PropsSI_work_range
+{
+	CoolPropMutex lock;
+	long begin, end;
+};
+static bool _pop_front_chunk(_PropsSI_work_range &r, long chunk, long &i0, long &i1)
+{
+	CoolPropLockGuard guard(r.lock);
+	if (r.begin >= r.end){ return false; }
+	i0 = r.begin;
+	i1 = std::min(r.begin + chunk, r.end);
+	r.begin = i1;
+	return true;
+}
+static bool _steal_back_half(_PropsSI_work_range &r, long &i0, long &i1)
+{
+	CoolPropLockGuard guard(r.lock);
+	long remaining = r.end - r.begin;
+	if (remaining <= 0){ return false; }
+	i1 = r.end;
+	i0 = r.end - (remaining+1)/2;
+	r.end = i0;
+	return true;
+}
+/// One worker of the parallel array evaluation.  It has its own state class, works through its own range, and 
+/// then steals half of the remaining work of the other workers until there is nothing left.  Two-phase and near-critical
+/// points are much more expensive than the others, so a static split of the array would leave workers idle
+static void _PropsSI_array_worker(int id, std::vector<_PropsSI_work_range> *ranges, Fluid *pFluid, long iOutput, long iName1, const double *Prop1, long iName2, const double *Prop2, double *outputs, long *Nfail, std::string *errstr)
+{
+	const long chunk = 16;
+	const int Nworkers = (int)ranges->size();
+	_PropsSI_work_range &mine = (*ranges)[id];
+	CoolPropStateClassSI CPS(pFluid);
+	long i0, i1;
+	for (;;)
+	{
+		while (_pop_front_chunk(mine, chunk, i0, i1)){
+			*Nfail += _PropsSI_array_kernel(CPS,iOutput,iName1,Prop1+i0,iName2,Prop2+i0,i1-i0,outputs+i0,*errstr);
+		}
+		bool stolen = false;
+		for (int k = 1; k < Nworkers && !stolen; k++)
+		{
+			if (_steal_back_half((*ranges)[(id+k)%Nworkers], i0, i1)){
+				CoolPropLockGuard guard(mine.lock);
+				mine.begin = i0; mine.end = i1;
+				stolen = true;
+			}
+		}
+		if (!stolen){ return; }
+	}
+}
+#endif
+/// Evaluate the same output for a vector of state points of a CoolProp fluid using several threads.  Without
+/// thread support (see COOLPROP_CXX11_THREADS) this is the same as _CoolProp_Fluid_PropsSI_array
+/// @param Nthreads The number of threads to use, the number of hardware threads if less than one
+/// @returns The number of points that could not be evaluated
+long _CoolProp_Fluid_PropsSI_array_parallel(long iOutput, long iName1, const double *Prop1, long iName2, const double *Prop2, long length, Fluid *pFluid, long Nthreads, double *outputs)
+{
+#if defined(COOLPROP_CXX11_THREADS)
+	if (Nthreads < 1){ Nthreads = (long)std::thread::hardware_concurrency(); }
+	if (Nthreads > length){ Nthreads = length; }
+	if (Nthreads > 1)
+	{
+		// Start with an even split of the array, the work-stealing evens out the load
+		std::vector<_PropsSI_work_range> ranges(Nthreads);
+		for (long i = 0; i < Nthreads; i++){
+			ranges[i].begin = length*i/Nthreads;
+			ranges[i].end = length*(i+1)/Nthreads;
+		}
+		std::vector<long> Nfail(Nthreads, 0);
+		std::vector<std::string> errstr(Nthreads);
+		std::vector<std::thread> threads;
+		// Reserved up front so that push_back cannot throw with a started thread in hand
+		threads.reserve(Nthreads-1);
+		try{
+			for (int i = 1; i < Nthreads; i++){
+				threads.push_back(std::thread(_PropsSI_array_worker,i,&ranges,pFluid,iOutput,iName1,Prop1,iName2,Prop2,outputs,&(Nfail[i]),&(errstr[i])));
+			}
+		}
+		catch(std::exception &){
+			// A thread could not be started.  The workers that are running steal the ranges of the others, so 
+			// all the points are still evaluated
+		}
+		// The calling thread is worker 0
+		_PropsSI_array_worker(0,&ranges,pFluid,iOutput,iName1,Prop1,iName2,Prop2,outputs,&(Nfail[0]),&(errstr[0]));
+		for (unsigned int i = 0; i < threads.size(); i++){
+			threads[i].join();
+		}
+		long Nfail_total = 0;
+		for (int i = 0; i < Nthreads; i++)
+		{
+			Nfail_total += Nfail[i];
+			if (!errstr[i].empty()){ err_string = errstr[i]; }
+		}
+		return Nfail_total;
+	}
+#endif
+	return _CoolProp_Fluid_PropsSI_array(iOutput,iName1,Prop1,iName2,Prop2,length,pFluid,outputs);
+}
+EXPORT_CODE long CONVENTION IPropsSIArray(long iOutput, long iName1, const double *Prop1, long iName2, const double *Prop2, long length, long iFluid, double *outputs)
+{
+	Fluid *pFluid = Fluids.get_fluid(iFluid);
+	if (pFluid == NULL){
+		err_string=std::string("CoolProp error: ").append(format("%d is an invalid fluid index to IPropsSIArray",iFluid));
+		for (long i = 0; i < length; i++){ outputs[i] = _HUGE; }
+		return length;
+	}
+	return _CoolProp_Fluid_PropsSI_array(iOutput,iName1,Prop1,iName2,Prop2,length,pFluid,outputs);
+}
+EXPORT_CODE long CONVENTION IPropsSIArrayParallel(long iOutput, long iName1, const double *Prop1, long iName2, const double *Prop2, long length, long iFluid, long Nthreads, double *outputs)
+{
+	Fluid *pFluid = Fluids.get_fluid(iFluid);
+	if (pFluid == NULL){
+		err_string=std::string("CoolProp error: ").append(format("%d is an invalid fluid index to IPropsSIArrayParallel",iFluid));
+		for (long i = 0; i < length; i++){ outputs[i] = _HUGE; }
+		return length;
+	}
+	return _CoolProp_Fluid_PropsSI_array_parallel(iOutput,iName1,Prop1,iName2,Prop2,length,pFluid,Nthreads,outputs);
+}
+/// Evaluate several outputs at the same state point of a CoolProp fluid.  The state class is only
+/// updated once, and then each of the outputs is obtained from it with keyed_output
+void _CoolProp_Fluid_PropsSI_multi(const long *iOutputs, long Noutputs, long iName1, double Prop1, long iName2, double Prop2, Fluid *pFluid, double *outputs)
+{
+	PooledCoolPropStateSI pooled_CPS(pFluid);
+	CoolPropStateClassSI &CPS = *pooled_CPS;
+	bool updated = false;
+	for (long i = 0; i < Noutputs; i++)
+	{
+		if (_is_state_independent_output(iOutputs[i])){
+			outputs[i] = _CoolProp_Fluid_PropsSI(iOutputs[i],iName1,Prop1,iName2,Prop2,pFluid);
+		}
+		else{
+			if (!updated){
+				CPS.update(iName1,Prop1,iName2,Prop2);
+				updated = true;
+			}
+			outputs[i] = CPS.keyed_output(iOutputs[i]);
+		}
+	}
+}
+EXPORT_CODE long CONVENTION IPropsSIMulti(const long *iOutputs, long Noutputs, long iName1, double Prop1, long iName2, double Prop2, long iFluid, double *outputs)
+{
+	Fluid *pFluid = Fluids.get_fluid(iFluid);
+	for (long i = 0; i < Noutputs; i++){ outputs[i] = _HUGE; }
+	if (pFluid == NULL){
+		err_string=std::string("CoolProp error: ").append(format("%d is an invalid fluid index to IPropsSIMulti",iFluid));
+		return Noutputs;
+	}
+	try{
+		_CoolProp_Fluid_PropsSI_multi(iOutputs,Noutputs,iName1,Prop1,iName2,Prop2,pFluid,outputs);
+		long Nfail = 0;
+		for (long i = 0; i < Noutputs; i++){ if (!ValidNumber(outputs[i])){ Nfail++; } }
+		return Nfail;
+	}
+	catch(std::exception &e){
+		err_string=std::string("CoolProp error: ").append(e.what());
+	}
+	catch(...){
+		err_string=std::string("CoolProp error: Indeterminate error");
+	}
+	for (long i = 0; i < Noutputs; i++){ outputs[i] = _HUGE; }
+	return Noutputs;
+}
+std::vector<double> PropsSIMulti(std::vector<std::string> Outputs, std::string Name1, double Prop1, std::string Name2, double Prop2, std::string Ref)
+{
+	std::vector<double> outputs(Outputs.size(), _HUGE);
+	try{
+		if (IsCoolPropFluid(Ref))
+		{
+			std::vector<long> iOutputs(Outputs.size());
+			for (unsigned int i = 0; i < Outputs.size(); i++)
+			{
+				iOutputs[i] = get_param_index(Outputs[i]);
+				if (iOutputs[i] < 0)
+					throw ValueError(format("Your output key [%s] is not valid. (names are case sensitive)",Outputs[i].c_str()));
+			}
+			long iName1 = get_param_index(Name1);
+			if (iName1<0) 
+				throw ValueError(format("Your input key #1 [%s] is not valid. (names are case sensitive)",Name1.c_str()));
+			long iName2 = get_param_index(Name2);
+			if (iName2<0) 
+				throw ValueError(format("Your input key #2 [%s] is not valid. (names are case sensitive)",Name2.c_str()));
+			if (!Outputs.empty()){
+				_CoolProp_Fluid_PropsSI_multi(&(iOutputs[0]),(long)iOutputs.size(),iName1,Prop1,iName2,Prop2,Fluids.get_fluid(Ref),&(outputs[0]));
+			}
+		}
+		else
+		{
+			// No state class for the other fluid types, fall back to one call per output
+			for (unsigned int i = 0; i < Outputs.size(); i++)
+			{
+				outputs[i] = _PropsSI(Outputs[i],Name1,Prop1,Name2,Prop2,Ref);
+			}
+		}
+	}
+	catch(const std::exception& e){
+		set_err_string(std::string("CoolProp error: ").append(e.what()));
+		outputs.assign(Outputs.size(), _HUGE);
+	}
+	catch(...){
+		set_err_string(std::string("CoolProp error: Indeterminate error"));
+		outputs.assign(Outputs.size(), _HUGE);
+	}
+	return outputs;
+}
+long PropsSIArray(std::string Output, std::string Name1, const double *Prop1, std::string Name2, const double *Prop2, long length, std::string Ref, double *outputs)
+{
+	if (IsCoolPropFluid(Ref))
+	{
+		// Resolve the keys and the fluid only once for the whole array
+		long iOutput = get_param_index(Output), iName1 = get_param_index(Name1), iName2 = get_param_index(Name2);
+		if (iOutput < 0 || iName1 < 0 || iName2 < 0)
+		{
+			err_string=std::string("CoolProp error: ").append(format("One of the keys [%s,%s,%s] is not valid. (names are case sensitive)",Output.c_str(),Name1.c_str(),Name2.c_str()));
+			for (long i = 0; i < length; i++){ outputs[i] = _HUGE; }
+			return length;
+		}
+		return _CoolProp_Fluid_PropsSI_array(iOutput,iName1,Prop1,iName2,Prop2,length,Fluids.get_fluid(Ref),outputs);
+	}
+	else
+	{
+		// REFPROP, brines and incompressibles do not have a state class; call PropsSI point by point
+		long Nfail = 0;
+		for (long i = 0; i < length; i++)
+		{
+			outputs[i] = PropsSI(Output,Name1,Prop1[i],Name2,Prop2[i],Ref);
+			if (!ValidNumber(outputs[i])){ Nfail++; }
+		}
+		return Nfail;
+	}
+}
 double Props(std::string Output, std::string Name1, double Prop1, std::string Name2, double Prop2, std::string Ref)
 {
 	// Go to the std::string version
@@ -1002,7 +1275,7 @@ double DerivTerms(std::string Term, double T, double rho, std::string Fluidname)
 	    */
 	    if (IsCoolPropFluid(Fluidname))
 		{
-			pFluid = Fluids.get_fluid(Fluidname);
+			Fluid *pFluid = Fluids.get_fluid(Fluidname);
 			// for compatibility, replace B and C with VB and VC
 			if ((!Term.compare("B")) || (!Term.compare("C"))) {
 				Term = std::string("V").append(Term);
@@ -1091,7 +1364,7 @@ int set_reference_stateP(Fluid *pFluid, std::string reference_state)
 }
 int set_reference_stateD(std::string Ref, double T, double rho, double h0, double s0)
 {
-	pFluid=Fluids.get_fluid(Ref);
+	Fluid *pFluid=Fluids.get_fluid(Ref);
 	if (pFluid!=NULL)
 	{
 		CoolPropStateClassSI CPS(pFluid);
@@ -1113,7 +1386,7 @@ int set_reference_stateD(std::string Ref, double T, double rho, double h0, doubl
 
 std::string get_BibTeXKey(std::string Ref, std::string item)
 {
-	pFluid=Fluids.get_fluid(Ref);
+	Fluid *pFluid=Fluids.get_fluid(Ref);
 	if (pFluid!=NULL)
 	{
 		
@@ -1157,6 +1430,17 @@ std::string get_global_param_string(std::string ParamName)
 	{
 		return Fluids.FluidList();
 	}
+	else if (!ParamName.compare("solver_stats"))
+	{
+		std::string out = "fluid,routine,calls,iterations,fallbacks,failures,seconds\n";
+		for (unsigned int i = 0; i < Fluids.FluidsList.size(); i++)
+		{
+			Fluid *pFluid = Fluids.FluidsList[i];
+			if (!pFluid->solver_stats.empty()){ out += pFluid->solver_stats.to_string(pFluid->get_name()); }
+		}
+		out += unattributed_solver_stats.to_string("(none)");
+		return out;
+	}
 	else
 	{
 		return format("Input value [%s] is invalid",ParamName.c_str()).c_str();
@@ -1165,7 +1449,7 @@ std::string get_global_param_string(std::string ParamName)
 std::string get_fluid_param_string(std::string FluidName, std::string ParamName)
 {
 	try{
-		pFluid = Fluids.get_fluid(FluidName);
+		Fluid *pFluid = Fluids.get_fluid(FluidName);
 		// Didn't work
 		if (pFluid == NULL){
 			err_string=std::string("CoolProp error: ").append(format("%s is an invalid fluid for get_fluid_param_string",FluidName.c_str()));
@@ -1202,6 +1486,10 @@ std::string get_fluid_param_string(std::string FluidName, std::string ParamName)
 					throw ValueError("TTSE mode is invalid");
 				}
 			}
+			else if (!ParamName.compare("solver_stats"))
+			{
+				return "fluid,routine,calls,iterations,fallbacks,failures,seconds\n" + pFluid->solver_stats.to_string(pFluid->get_name());
+			}
 			else
 			{
 				return format("Input value [%s] is invalid for Fluid [%s]",ParamName.c_str(),FluidName.c_str()).c_str();
@@ -1216,6 +1504,26 @@ std::string get_fluid_param_string(std::string FluidName, std::string ParamName)
 		return(std::string("CoolProp error: Indeterminate error"));
 	}
 }
+EXPORT_CODE void CONVENTION enable_solver_stats(void)
+{
+	solver_stats_enabled = true;
+}
+EXPORT_CODE bool CONVENTION isenabled_solver_stats(void)
+{
+	return solver_stats_enabled;
+}
+EXPORT_CODE void CONVENTION disable_solver_stats(void)
+{
+	solver_stats_enabled = false;
+}
+EXPORT_CODE void CONVENTION reset_solver_stats(void)
+{
+	for (unsigned int i = 0; i < Fluids.FluidsList.size(); i++)
+	{
+		Fluids.FluidsList[i]->solver_stats.reset();
+	}
+	unattributed_solver_stats.reset();
+}
 
 
 #ifndef DISABLE_CATCH
@@ -1248,4 +1556,307 @@ TEST_CASE("Check ancillaries and surface tension", "[fast]" )
         REQUIRE_NOTHROW(_PropsSI("psatVanc","T",300,"D",1,"Propane"));
 	}
 }
-#endif
\ No newline at end of file
+TEST_CASE("Vectorized PropsSI", "[fast]" ) 
+{
+	double T[] = {250, 300, 350, -1, 400};
+	double p[] = {101325, 101325, 2e6, 101325, 5e6};
+	double out[5];
+	SECTION("matches PropsSI")
+	{
+		long Nfail = PropsSIArray("H","T",T,"P",p,5,"R134a",out);
+		CHECK(Nfail == 1);
+		for (int i = 0; i < 5; i++)
+		{
+			if (i == 3){
+				CHECK(!ValidNumber(out[i]));
+			}
+			else{
+				CHECK(fabs(out[i]/PropsSI("H","T",T[i],"P",p[i],"R134a")-1) < 1e-12);
+			}
+		}
+	}
+	SECTION("state-independent output")
+	{
+		CHECK(PropsSIArray("Tcrit","T",T,"P",p,5,"R134a",out) == 0);
+		CHECK(fabs(out[4] - Props1SI("R134a","Tcrit")) < 1e-12);
+	}
+	SECTION("bad inputs")
+	{
+		CHECK(PropsSIArray("H","T",T,"P",p,5,"R134aXXX",out) == 5);
+		CHECK(PropsSIArray("H","TT",T,"P",p,5,"R134a",out) == 5);
+		CHECK(IPropsSIArray(iH,iT,T,iP,p,5,-1,out) == 5);
+	}
+}
+TEST_CASE("Multiple outputs from one state update", "[fast]" ) 
+{
+	std::vector<std::string> outputs;
+	outputs.push_back("T"); outputs.push_back("S"); outputs.push_back("D"); outputs.push_back("C"); 
+	outputs.push_back("V"); outputs.push_back("L"); outputs.push_back("Tcrit");
+	SECTION("matches PropsSI")
+	{
+		std::vector<double> vals = PropsSIMulti(outputs,"P",2e6,"H",450e3,"R134a");
+		REQUIRE(vals.size() == outputs.size());
+		for (unsigned int i = 0; i < outputs.size(); i++)
+		{
+			CHECK(fabs(vals[i]/PropsSI(outputs[i],"P",2e6,"H",450e3,"R134a")-1) < 1e-12);
+		}
+	}
+	SECTION("index version")
+	{
+		long iOutputs[] = {iT, iS, iD};
+		double vals[3];
+		long iFluid = get_Fluid_index("R134a");
+		CHECK(IPropsSIMulti(iOutputs,3,iP,2e6,iH,450e3,iFluid,vals) == 0);
+		CHECK(fabs(vals[1]/PropsSI("S","P",2e6,"H",450e3,"R134a")-1) < 1e-12);
+		CHECK(IPropsSIMulti(iOutputs,3,iP,2e6,iH,450e3,-1,vals) == 3);
+		CHECK(!ValidNumber(vals[0]));
+		CHECK(IPropsSIMulti(iOutputs,3,iP,-1,iH,450e3,iFluid,vals) == 3);
+		CHECK(!ValidNumber(vals[1]));
+	}
+	SECTION("bad inputs")
+	{
+		std::vector<double> vals = PropsSIMulti(outputs,"P",2e6,"HH",450e3,"R134a");
+		REQUIRE(vals.size() == outputs.size());
+		CHECK(!ValidNumber(vals[0]));
+	}
+}
+#if defined(COOLPROP_CXX11_THREADS)
+static void _concurrent_PropsSI_worker(std::vector<double> *out)
+{
+	const char *fluids[] = {"R32", "n-Butane", "Nitrogen"};
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 20; j++)
+		{
+			double p = 2e5 + 5e4*j;
+			double h = PropsSI("H","P",p,"Q",0.5,fluids[i]);
+			out->push_back(h);
+			out->push_back(PropsSI("T","P",p,"H",h,fluids[i]));
+			out->push_back(PropsSI("V","P",p,"T",400,fluids[i]));
+		}
+	}
+	// Generate an error, the error string of other threads is not affected
+	PropsSI("H","P",-1,"Q",0.5,"R32");
+}
+TEST_CASE("Concurrent PropsSI calls", "[fast][threads]")
+{
+	const int Nthreads = 4;
+	std::vector<std::vector<double> > outputs(Nthreads);
+	get_global_param_string("errstring"); // Clear the error string of this thread
+	std::vector<std::thread> threads;
+	for (int i = 0; i < Nthreads; i++){
+		threads.push_back(std::thread(_concurrent_PropsSI_worker, &(outputs[i])));
+	}
+	for (int i = 0; i < Nthreads; i++){
+		threads[i].join();
+	}
+	CHECK(get_global_param_string("errstring").empty());
+
+	// Serial reference values
+	std::vector<double> reference;
+	_concurrent_PropsSI_worker(&reference);
+	CHECK(!get_global_param_string("errstring").empty());
+	for (int i = 0; i < Nthreads; i++)
+	{
+		REQUIRE(outputs[i].size() == reference.size());
+		bool same = true;
+		for (unsigned int j = 0; j < reference.size(); j++){
+			if (outputs[i][j] != reference[j]){ same = false; }
+		}
+		CHECK(same);
+	}
+}
+#endif
+TEST_CASE("Parallel vectorized PropsSI", "[fast][threads]")
+{
+	// A p-h grid that covers subcooled, two-phase and superheated states
+	std::vector<double> p, h;
+	for (int i = 0; i < 10; i++){
+		for (int j = 0; j < 10; j++){
+			p.push_back(2e5+3e5*i);
+			h.push_back(150e3+30e3*j);
+		}
+	}
+	p[17] = -1; // Bad point
+	long iFluid = get_Fluid_index("R134a");
+	std::vector<double> serial(p.size()), parallel(p.size());
+	long Nfail_serial = IPropsSIArray(iT,iP,&(p[0]),iH,&(h[0]),(long)p.size(),iFluid,&(serial[0]));
+	CHECK(Nfail_serial == 1);
+	for (long Nthreads = 1; Nthreads <= 4; Nthreads++)
+	{
+		long Nfail = IPropsSIArrayParallel(iT,iP,&(p[0]),iH,&(h[0]),(long)p.size(),iFluid,Nthreads,&(parallel[0]));
+		CHECK(Nfail == Nfail_serial);
+		CHECK(!get_global_param_string("errstring").empty());
+		bool same = true;
+		for (unsigned int i = 0; i < p.size(); i++){
+			if (i != 17 && parallel[i] != serial[i]){ same = false; }
+		}
+		CHECK(same);
+	}
+	CHECK(IPropsSIArrayParallel(iT,iP,&(p[0]),iH,&(h[0]),(long)p.size(),-1,2,&(parallel[0])) == (long)p.size());
+	SECTION("more threads than points")
+	{
+		double out[3];
+		CHECK(IPropsSIArrayParallel(iT,iP,&(p[20]),iH,&(h[20]),3,iFluid,8,out) == 0);
+		for (int i = 0; i < 3; i++){ CHECK(out[i] == serial[20+i]); }
+	}
+	SECTION("no points")
+	{
+		double out = -1;
+		CHECK(IPropsSIArrayParallel(iT,iP,&(p[0]),iH,&(h[0]),0,iFluid,4,&out) == 0);
+		CHECK(out == -1);
+	}
+}
+TEST_CASE("Incompressible fluids with enthalpy and pressure as inputs", "[fast]")
+{
+	const char *fluids[] = {"TD12", "DowQ", "DEB", "AS20", "MEG-30%", "MPG-0.4", "ZiAC-50%", "LiBr-0.3"};
+	const double T[] = {300, 310, 290, 280, 300, 310, 290, 350};
+	double p = 5e5;
+	for (int i = 0; i < 8; i++)
+	{
+		std::string name = fluids[i];
+		CAPTURE(name);
+		double h = _PropsSI("H","T",T[i],"P",p,name);
+		CAPTURE(h);
+		CHECK(fabs(_PropsSI("T","H",h,"P",p,name) - T[i]) < 1e-6);
+		CHECK(fabs(_PropsSI("T","P",p,"H",h,name) - T[i]) < 1e-6);
+	}
+	CHECK_THROWS(_PropsSI("T","H",1e9,"P",p,"TD12"));
+}
+TEST_CASE("Saturated enthalpy and entropy ancillary curves", "[fast]")
+{
+	const char *names[] = {"Water", "R134a", "CO2"};
+	for (int n = 0; n < 3; n++)
+	{
+		Fluid *pFluid = get_fluid(get_Fluid_index(names[n]));
+		double Tr = pFluid->reduce.T, Tmin = std::max(pFluid->params.Ttriple, pFluid->limits.Tmin)+1e-6;
+		double T[] = {Tmin+0.5, 0.5*(Tmin+Tr), Tr-1, Tr-0.01, Tr-1e-5};
+		// The ancillary densities are not smooth right at the critical point
+		double tol[] = {1e-7, 1e-7, 1e-7, 1e-7, 1e-4};
+		for (int i = 0; i < 5; i++)
+		{
+			CAPTURE(names[n]);
+			CAPTURE(T[i]);
+			double rhoL = pFluid->rhosatL(T[i]), rhoV = pFluid->rhosatV(T[i]);
+			CHECK(fabs(pFluid->hsatL_anc(T[i])-pFluid->enthalpy_Trho(T[i],rhoL)) < tol[i]*pFluid->R()*Tr);
+			CHECK(fabs(pFluid->hsatV_anc(T[i])-pFluid->enthalpy_Trho(T[i],rhoV)) < tol[i]*pFluid->R()*Tr);
+			CHECK(fabs(pFluid->ssatL_anc(T[i])-pFluid->entropy_Trho(T[i],rhoL)) < tol[i]*pFluid->R());
+			CHECK(fabs(pFluid->ssatV_anc(T[i])-pFluid->entropy_Trho(T[i],rhoV)) < tol[i]*pFluid->R());
+		}
+	}
+}
+TEST_CASE("Table of conformal states for the ECS transport properties", "[fast]")
+{
+	Fluid *pFluid = get_fluid(get_Fluid_index("R245fa"));
+	double T[] = {250, 300, 350, 400, 300};
+	double p[] = {1e6, 1e6, 3e6, 3e6, 20e6};
+	double visc[5], cond[5];
+	pFluid->disable_ECS_LUT();
+	for (int i = 0; i < 5; i++)
+	{
+		double rho = _PropsSI("D","T",T[i],"P",p[i],"R245fa");
+		visc[i] = pFluid->viscosity_Trho(T[i],rho);
+		cond[i] = pFluid->conductivity_Trho(T[i],rho);
+	}
+	pFluid->set_ECS_LUT_size(40,40);
+	pFluid->enable_ECS_LUT();
+	CHECK(pFluid->isenabled_ECS_LUT());
+	for (int i = 0; i < 5; i++)
+	{
+		CAPTURE(T[i]);
+		CAPTURE(p[i]);
+		double rho = _PropsSI("D","T",T[i],"P",p[i],"R245fa");
+		CHECK(fabs(pFluid->viscosity_Trho(T[i],rho)/visc[i]-1) < 1e-6);
+		CHECK(fabs(pFluid->conductivity_Trho(T[i],rho)/cond[i]-1) < 1e-6);
+	}
+	CHECK(pFluid->ECS_LUT.built);
+	// Resizing a built table rebuilds it with the new size
+	pFluid->set_ECS_LUT_size(30,30);
+	CHECK(!pFluid->ECS_LUT.built);
+	double rho = _PropsSI("D","T",T[1],"P",p[1],"R245fa");
+	CHECK(fabs(pFluid->viscosity_Trho(T[1],rho)/visc[1]-1) < 1e-6);
+	CHECK(pFluid->ECS_LUT.T0_T.size() == 30*30);
+	pFluid->disable_ECS_LUT();
+}
+TEST_CASE("Cache of the saturation curve", "[fast]")
+{
+	Fluid *pFluid = get_fluid(get_Fluid_index("R134a"));
+	double T[] = {170, 250, 300, 350, 374};
+	double psat[5], rhoL[5], rhoV[5], pL, pV;
+	pFluid->disable_saturation_cache();
+	for (int i = 0; i < 5; i++)
+	{
+		pFluid->saturation_T(T[i],false,psat[i],pV,rhoL[i],rhoV[i]);
+	}
+	pFluid->enable_saturation_cache();
+	CHECK(pFluid->isenabled_saturation_cache());
+	for (int i = 0; i < 5; i++)
+	{
+		CAPTURE(T[i]);
+		double TL, TV, rL, rV;
+		pFluid->saturation_T(T[i],false,pL,pV,rL,rV);
+		CHECK(fabs(pL/psat[i]-1) < 1e-9);
+		CHECK(fabs(rL/rhoL[i]-1) < 1e-9);
+		CHECK(fabs(rV/rhoV[i]-1) < 1e-9);
+		pFluid->saturation_p(psat[i],false,TL,TV,rL,rV);
+		CHECK(fabs(TL/T[i]-1) < 1e-9);
+		CHECK(fabs(rV/rhoV[i]-1) < 1e-8);
+		SaturationCacheState state;
+		if (pFluid->saturation_cache_T(T[i],state))
+		{
+			CHECK(fabs(state.p/psat[i]-1) < 1e-9);
+			CHECK(fabs(state.rhoV/rhoV[i]-1) < 1e-9);
+		}
+	}
+	CHECK(pFluid->SaturationCache.built);
+	pFluid->disable_saturation_cache();
+}
+class _NoRootFunc : public FuncWrapper1D
+{
+public:
+	double call(double x){ return x*x+1; };
+};
+TEST_CASE("Solver statistics", "[fast]")
+{
+	Fluid *pFluid = get_fluid(get_Fluid_index("R134a"));
+	double T, rho, rhoL, rhoV, TL, TV;
+	SolverStatsEntry &ph = pFluid->solver_stats.entries[SOLVER_STATS_TEMPERATURE_PH];
+	reset_solver_stats();
+
+	// Nothing is recorded unless enabled
+	pFluid->temperature_ph(1e6, 200e3, T, rho, rhoL, rhoV, TL, TV);
+	CHECK(pFluid->solver_stats.empty());
+
+	enable_solver_stats();
+	CHECK(isenabled_solver_stats());
+	pFluid->temperature_ph(1e6, 200e3, T, rho, rhoL, rhoV, TL, TV);
+	CHECK(ph.calls == 1);
+	CHECK(ph.iterations > 0);
+	CHECK(ph.failures == 0);
+	CHECK(ph.nanoseconds > 0);
+	CHECK(get_fluid_param_string("R134a","solver_stats").find("\nR134a,temperature_ph,1,") != std::string::npos);
+	CHECK(get_global_param_string("solver_stats").find("\nR134a,temperature_ph,1,") != std::string::npos);
+
+	// The solvers are attributed to the fluid whose routine calls them
+	pFluid->saturation_p(5e5, false, TL, TV, rhoL, rhoV);
+	CHECK(pFluid->solver_stats.entries[SOLVER_STATS_SATURATION_P].calls == 1);
+	CHECK(pFluid->solver_stats.entries[SOLVER_STATS_SECANT].calls == 1);
+	CHECK(pFluid->solver_stats.entries[SOLVER_STATS_SECANT].iterations > 0);
+
+	// Or to no fluid, and an exception counts as a failure
+	_NoRootFunc f;
+	std::string errstr;
+	CHECK_THROWS(Brent(&f, 0, 1, 1e-16, 1e-10, 100, &errstr));
+	CHECK(unattributed_solver_stats.entries[SOLVER_STATS_BRENT].calls == 1);
+	CHECK(unattributed_solver_stats.entries[SOLVER_STATS_BRENT].failures == 1);
+	CHECK(pFluid->solver_stats.entries[SOLVER_STATS_BRENT].failures == 0);
+
+	disable_solver_stats();
+	pFluid->temperature_ph(1e6, 200e3, T, rho, rhoL, rhoV, TL, TV);
+	CHECK(ph.calls == 1);
+
+	reset_solver_stats();
+	CHECK(pFluid->solver_stats.empty());
+	CHECK(get_global_param_string("solver_stats") == "fluid,routine,calls,iterations,fallbacks,failures,seconds\n");
+}
+#endif
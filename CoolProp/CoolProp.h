@@ -68,6 +68,28 @@ You might want to start by looking at CoolProp.h
 	/// @param FluidName The fluid name
     double PropsSI(std::string Output,std::string Name1, double Prop1, std::string Name2, double Prop2, std::string FluidName);
 
+	/// Return a value that depends on the thermodynamic state for a vector of state points
+	/// @param Output The output parameter, one of "T","D","H",etc.
+	/// @param Name1 The first state variable name, one of "T","D","H",etc.
+	/// @param Prop1 Array of the first state variable values
+	/// @param Name2 The second state variable name, one of "T","D","H",etc.
+	/// @param Prop2 Array of the second state variable values
+	/// @param length The number of state points
+	/// @param FluidName The fluid name
+	/// @param outputs Array of length \a length that is filled with the outputs, _HUGE where the point could not be evaluated
+	/// @returns The number of state points that could not be evaluated
+	long PropsSIArray(std::string Output, std::string Name1, const double *Prop1, std::string Name2, const double *Prop2, long length, std::string FluidName, double *outputs);
+
+	/// Return several values that depend on the thermodynamic state from a single state update
+	/// @param Outputs The output parameters, each one of "T","D","H",etc.
+	/// @param Name1 The first state variable name, one of "T","D","H",etc.
+	/// @param Prop1 The first state variable value
+	/// @param Name2 The second state variable name, one of "T","D","H",etc.
+	/// @param Prop2 The second state variable value
+	/// @param FluidName The fluid name
+	/// @returns The values in the same order as Outputs, all _HUGE if there was an error
+	std::vector<double> PropsSIMulti(std::vector<std::string> Outputs, std::string Name1, double Prop1, std::string Name2, double Prop2, std::string FluidName);
+
 	/// Return some low level derivative terms, see source for a complete list
 	/// @param Term String, some options are "phir" (residual Helmholtz energy),"dphir_dDelta", "dphir_dTau", etc.
 	/// @param T Temperature [K]
@@ -101,12 +123,13 @@ You might want to start by looking at CoolProp.h
 	long getFluidType(std::string FluidName);
 
 	/// Get a globally-defined string
-	/// @param ParamName A string, one of "version", "errstring", "warnstring", "gitrevision", "FluidsList", "fluids_list"
-	/// @returns str The string, or an error message if not valid input
+	/// @param ParamName A string, one of "version", "errstring", "warnstring", "gitrevision", "FluidsList", "fluids_list", "solver_stats"
+	/// @returns str The string, or an error message if not valid input.  For "solver_stats", the lines "fluid,routine,calls,iterations,fallbacks,failures,seconds" 
+	/// for each routine that has been called since the last call to reset_solver_stats() (see enable_solver_stats())
 	std::string get_global_param_string(std::string ParamName);
 	/// Get a string for a value from a fluid (numerical values can be obtained from Props1 function)
 	/// @param FluidName The name of the fluid
-	/// @param ParamName A string, one of "aliases", "CAS", "CAS_number", "ASHRAE34", "REFPROPName","REFPROP_name", "TTSE_mode"		
+	/// @param ParamName A string, one of "aliases", "CAS", "CAS_number", "ASHRAE34", "REFPROPName","REFPROP_name", "TTSE_mode", "solver_stats"		
 	/// @returns str The string, or an error message if not valid input
 	std::string get_fluid_param_string(std::string FluidName, std::string ParamName);
 	/// Return the phase of the given state point with temperature, pressure as inputs
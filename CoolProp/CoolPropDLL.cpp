@@ -61,6 +61,10 @@ EXPORT_CODE double CONVENTION PropsSI(const char *Output, const char *Name1, dou
 {
     return PropsSI(std::string(Output),Name1,Prop1,Name2,Prop2,FluidName);
 }
+EXPORT_CODE long CONVENTION PropsSIArray(const char *Output, const char *Name1, const double *Prop1, const char *Name2, const double *Prop2, long length, const char *Ref, double *outputs)
+{
+    return PropsSIArray(std::string(Output),std::string(Name1),Prop1,std::string(Name2),Prop2,length,std::string(Ref),outputs);
+}
 EXPORT_CODE double CONVENTION K2F(double T)
 { return T * 9 / 5 - 459.67; }
 
@@ -207,6 +211,13 @@ EXPORT_CODE bool CONVENTION set_TTSESinglePhase_LUT_size(const char *FluidName,
 	pFluid->set_TTSESinglePhase_LUT_size(Np,Nh);
 	return true;
 }
+/// Over-ride the number of threads used to build the single-phase LUT
+EXPORT_CODE bool CONVENTION set_TTSE_LUT_build_threads(const char *FluidName, int Nthreads){
+	long iFluid = get_Fluid_index(FluidName); if (iFluid<0){ return false;};
+	Fluid *pFluid = get_fluid(iFluid);
+	pFluid->set_TTSE_LUT_build_threads(Nthreads);
+	return true;
+}
 /// Over-ride the default range of the single-phase LUT
 EXPORT_CODE bool CONVENTION set_TTSESinglePhase_LUT_range(const char *FluidName, double hmin, double hmax, double pmin, double pmax){
 	long iFluid = get_Fluid_index(FluidName); if (iFluid<0){ return false;};
@@ -228,6 +239,53 @@ EXPORT_CODE bool CONVENTION get_TTSESinglePhase_LUT_range(const char *FluidName,
 		return true;
 	}
 }
+/// Enable the table of conformal states used by the ECS transport properties
+EXPORT_CODE bool CONVENTION enable_ECS_LUT(const char *FluidName){
+	long iFluid = get_Fluid_index(FluidName); if (iFluid<0){ return false;};
+	Fluid *pFluid = get_fluid(iFluid);
+	pFluid->enable_ECS_LUT();
+	return true;
+}
+/// Check if the table of conformal states is enabled
+EXPORT_CODE bool CONVENTION isenabled_ECS_LUT(const char *FluidName){
+	long iFluid = get_Fluid_index(FluidName); if (iFluid<0){ return false;};
+	Fluid *pFluid = get_fluid(iFluid);
+	return pFluid->isenabled_ECS_LUT();
+}
+/// Disable the table of conformal states
+EXPORT_CODE bool CONVENTION disable_ECS_LUT(const char *FluidName){
+	long iFluid = get_Fluid_index(FluidName); if (iFluid<0){ return false;};
+	Fluid *pFluid = get_fluid(iFluid);
+	pFluid->disable_ECS_LUT();
+	return true;
+}
+/// Over-ride the default size of the table of conformal states
+EXPORT_CODE bool CONVENTION set_ECS_LUT_size(const char *FluidName, int NT, int Nrho){
+	long iFluid = get_Fluid_index(FluidName); if (iFluid<0){ return false;};
+	Fluid *pFluid = get_fluid(iFluid);
+	pFluid->set_ECS_LUT_size(NT,Nrho);
+	return true;
+}
+/// Enable the cache of the saturation curve
+EXPORT_CODE bool CONVENTION enable_saturation_cache(const char *FluidName){
+	long iFluid = get_Fluid_index(FluidName); if (iFluid<0){ return false;};
+	Fluid *pFluid = get_fluid(iFluid);
+	pFluid->enable_saturation_cache();
+	return true;
+}
+/// Check if the cache of the saturation curve is enabled
+EXPORT_CODE bool CONVENTION isenabled_saturation_cache(const char *FluidName){
+	long iFluid = get_Fluid_index(FluidName); if (iFluid<0){ return false;};
+	Fluid *pFluid = get_fluid(iFluid);
+	return pFluid->isenabled_saturation_cache();
+}
+/// Disable the cache of the saturation curve
+EXPORT_CODE bool CONVENTION disable_saturation_cache(const char *FluidName){
+	long iFluid = get_Fluid_index(FluidName); if (iFluid<0){ return false;};
+	Fluid *pFluid = get_fluid(iFluid);
+	pFluid->disable_saturation_cache();
+	return true;
+}
 
 /// Returns the value for the integer flag corresponding to the current set of units
 /// @returns val The integer value for the current set of units, one of enumerated values UNIT_SYSTEM_SI, UNIT_SYSTEM_KSI (see GlobalConstants.h)
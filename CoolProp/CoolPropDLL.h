@@ -19,6 +19,25 @@
     EXPORT_CODE double CONVENTION PropsSI(const char *Output,const char *Name1, double  Prop1, const char *Name2, double  Prop2, const char *Ref);
 
     EXPORT_CODE double CONVENTION IPropsSI(long iOutput, long iName1, double Prop1, long iName2, double Prop2, long iFluid);
+    /// Return a value that depends on the thermodynamic state for a vector of state points (in SI units)
+	/// The parameter and fluid indices are only resolved once, and the same state class is re-used for all the points
+	/// @param length The number of state points in Prop1, Prop2 and outputs
+	/// @param outputs Filled with the outputs, _HUGE where the point could not be evaluated
+	/// @returns The number of state points that could not be evaluated
+    EXPORT_CODE long CONVENTION IPropsSIArray(long iOutput, long iName1, const double *Prop1, long iName2, const double *Prop2, long length, long iFluid, double *outputs);
+    /// Return several values that depend on the thermodynamic state from a single state update (in SI units)
+	/// @param iOutputs Array of output parameter indices
+	/// @param Noutputs The number of outputs
+	/// @param outputs Filled with the outputs in the same order as iOutputs, all _HUGE if there was an error
+	/// @returns The number of outputs that could not be evaluated, 0 if successful (see the "errstring" global parameter)
+    EXPORT_CODE long CONVENTION IPropsSIMulti(const long *iOutputs, long Noutputs, long iName1, double Prop1, long iName2, double Prop2, long iFluid, double *outputs);
+    /// Parallel version of IPropsSIArray.  The points are split between several threads, each with its own state class,
+	/// and idle threads steal work from the others since two-phase and near-critical points are much more expensive
+	/// @param Nthreads The number of threads to use, the number of hardware threads if less than one
+	/// @returns The number of state points that could not be evaluated
+    EXPORT_CODE long CONVENTION IPropsSIArrayParallel(long iOutput, long iName1, const double *Prop1, long iName2, const double *Prop2, long length, long iFluid, long Nthreads, double *outputs);
+    /// String-keyed version of IPropsSIArray
+    EXPORT_CODE long CONVENTION PropsSIArray(const char *Output, const char *Name1, const double *Prop1, const char *Name2, const double *Prop2, long length, const char *Ref, double *outputs);
 
 	// They can only use data types that play well with DLL wrapping (int, long, double, char*, void, etc.)
 	EXPORT_CODE double CONVENTION PropsS(const char *Output,const char *Name1, double  Prop1, const char *Name2, double  Prop2, const char *Ref);
@@ -94,6 +113,8 @@
 	EXPORT_CODE bool CONVENTION set_TTSESat_LUT_size(const char *FluidName, int);
 	/// Over-ride the default size of the single-phase LUT
 	EXPORT_CODE bool CONVENTION set_TTSESinglePhase_LUT_size(const char *FluidName, int Np, int Nh);
+	/// Over-ride the number of threads used to build the single-phase LUT, the number of hardware threads if less than one
+	EXPORT_CODE bool CONVENTION set_TTSE_LUT_build_threads(const char *FluidName, int Nthreads);
 	/// Over-ride the default range of the single-phase LUT
 	EXPORT_CODE bool CONVENTION set_TTSESinglePhase_LUT_range(const char *FluidName, double hmin, double hmax, double pmin, double pmax);
 	/// Get the current range of the single-phase LUT
@@ -101,6 +122,42 @@
 	/// Set the TTSE mode (normal or bicubic)
 	EXPORT_CODE int CONVENTION set_TTSE_mode(const char *FluidName, const char * Value);
 
+	/// -------------------------------------------
+	///     Table of the ECS conformal states
+	/// -------------------------------------------
+	/// Enable the table of conformal states used by the ECS transport properties
+	EXPORT_CODE bool CONVENTION enable_ECS_LUT(const char *FluidName);
+	/// Check if the table of conformal states is enabled
+	EXPORT_CODE bool CONVENTION isenabled_ECS_LUT(const char *FluidName);
+	/// Disable the table of conformal states
+	EXPORT_CODE bool CONVENTION disable_ECS_LUT(const char *FluidName);
+	/// Over-ride the default size of the table of conformal states
+	EXPORT_CODE bool CONVENTION set_ECS_LUT_size(const char *FluidName, int NT, int Nrho);
+
+	/// -------------------------------------------
+	///     Cache of the saturation curve
+	/// -------------------------------------------
+	/// Enable the cache of the saturation curve, built on first use
+	EXPORT_CODE bool CONVENTION enable_saturation_cache(const char *FluidName);
+	/// Check if the cache of the saturation curve is enabled
+	EXPORT_CODE bool CONVENTION isenabled_saturation_cache(const char *FluidName);
+	/// Disable the cache of the saturation curve
+	EXPORT_CODE bool CONVENTION disable_saturation_cache(const char *FluidName);
+
+	/// -------------------------------------------
+	///     Solver statistics
+	/// -------------------------------------------
+	/// Start recording the number of calls, iterations, fallbacks and failures and the time of the solvers of each fluid.
+	/// The statistics are returned by get_global_param_string("solver_stats") for all the fluids, or by 
+	/// get_fluid_param_string(FluidName, "solver_stats") for one fluid
+	EXPORT_CODE void CONVENTION enable_solver_stats(void);
+	/// Check if the solver statistics are recorded
+	EXPORT_CODE bool CONVENTION isenabled_solver_stats(void);
+	/// Stop recording the solver statistics; the counters are kept
+	EXPORT_CODE void CONVENTION disable_solver_stats(void);
+	/// Set the solver statistics of all the fluids to zero
+	EXPORT_CODE void CONVENTION reset_solver_stats(void);
+
 	EXPORT_CODE int CONVENTION set_reference_stateS(const char *Ref, const char *reference_state);
 	EXPORT_CODE int CONVENTION set_reference_stateD(const char *Ref, double T, double rho, double h0, double s0);
 
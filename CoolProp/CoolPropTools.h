@@ -71,6 +71,32 @@
 #endif
 #endif
 
+// Thread support.  With a C++11 compiler, the per-call error strings are thread-local and the lazily-built 
+// data of the fluids is protected by locks, so that PropsSI can be called from several threads at once.  
+// Define COOLPROP_NO_THREADS to fall back to the non-thread-safe behavior of older compilers
+#if !defined(COOLPROP_NO_THREADS) && (__cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900))
+#  define COOLPROP_CXX11_THREADS
+#endif
+#if defined(COOLPROP_CXX11_THREADS)
+#  include <mutex>
+#  include <atomic>
+#  define COOLPROP_THREAD_LOCAL thread_local
+	typedef std::mutex CoolPropMutex;
+	typedef std::lock_guard<std::mutex> CoolPropLockGuard;
+	typedef std::recursive_mutex CoolPropRecursiveMutex;
+	typedef std::lock_guard<std::recursive_mutex> CoolPropRecursiveLockGuard;
+	typedef std::atomic<bool> CoolPropAtomicBool;
+	typedef std::atomic<int> CoolPropAtomicInt;
+#else
+#  define COOLPROP_THREAD_LOCAL
+	struct CoolPropMutex{ void lock(){}; void unlock(){}; };
+	struct CoolPropLockGuard{ CoolPropLockGuard(CoolPropMutex &){}; };
+	typedef CoolPropMutex CoolPropRecursiveMutex;
+	typedef CoolPropLockGuard CoolPropRecursiveLockGuard;
+	typedef bool CoolPropAtomicBool;
+	typedef int CoolPropAtomicInt;
+#endif
+
 	#if defined(_MSC_VER)
 	// Microsoft version of math.h doesn't include acosh or asinh, so we just define them here.
 	// It was included from Visual Studio 2013 
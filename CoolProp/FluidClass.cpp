@@ -42,6 +42,8 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+// The Helmholtz cache lives in the Fluid and is shared by every caller, so it is turned off (and never written)
+// to keep concurrent evaluations of the same fluid from racing
 static const bool use_cache = false;
 static bool UseCriticalSpline = true;
 
@@ -241,9 +243,11 @@ double Fluid::phir(double tau, double delta)
 		double summer = 0;
 		for (std::vector<phi_BC*>::iterator it = phirlist.begin(); it != phirlist.end(); it++)
 			summer += (*it)->base(tau,delta);
-		cache.phir.tau = tau;
-		cache.phir.delta = delta;
-		cache.phir.cached_val = summer;
+		if (use_cache){
+			cache.phir.tau = tau;
+			cache.phir.delta = delta;
+			cache.phir.cached_val = summer;
+		}
 		return summer;
 	}
 }
@@ -263,9 +267,11 @@ double Fluid::dphir_dDelta(double tau, double delta)
 		{
 			summer += (*it)->dDelta(tau,delta);
 		}
-		cache.dphir_dDelta.tau = tau;
-		cache.dphir_dDelta.delta = delta;
-		cache.dphir_dDelta.cached_val = summer;
+		if (use_cache){
+			cache.dphir_dDelta.tau = tau;
+			cache.dphir_dDelta.delta = delta;
+			cache.dphir_dDelta.cached_val = summer;
+		}
 		return summer;
 	}
 }
@@ -282,9 +288,11 @@ double Fluid::d2phir_dDelta2(double tau, double delta)
 		{
 			summer += (*it)->dDelta2(tau,delta);
 		}
-		cache.d2phir_dDelta2.tau = tau;
-		cache.d2phir_dDelta2.delta = delta;
-		cache.d2phir_dDelta2.cached_val = summer;
+		if (use_cache){
+			cache.d2phir_dDelta2.tau = tau;
+			cache.d2phir_dDelta2.delta = delta;
+			cache.d2phir_dDelta2.cached_val = summer;
+		}
 		return summer;
 	}
 }
@@ -299,9 +307,11 @@ double Fluid::dphir_dTau(double tau, double delta)
 		double summer = 0;
 		for (std::vector<phi_BC*>::iterator it = phirlist.begin(); it != phirlist.end(); it++)
 			summer += (*it)->dTau(tau,delta);
-		cache.dphir_dTau.tau = tau;
-		cache.dphir_dTau.delta = delta;
-		cache.dphir_dTau.cached_val = summer;
+		if (use_cache){
+			cache.dphir_dTau.tau = tau;
+			cache.dphir_dTau.delta = delta;
+			cache.dphir_dTau.cached_val = summer;
+		}
 		return summer;
 	}
 }
@@ -316,9 +326,11 @@ double Fluid::d2phir_dTau2(double tau, double delta)
 		double summer = 0;
 		for (std::vector<phi_BC*>::iterator it = phirlist.begin(); it != phirlist.end(); it++)
 			summer += (*it)->dTau2(tau,delta);
-		cache.d2phir_dTau2.tau = tau;
-		cache.d2phir_dTau2.delta = delta;
-		cache.d2phir_dTau2.cached_val = summer;
+		if (use_cache){
+			cache.d2phir_dTau2.tau = tau;
+			cache.d2phir_dTau2.delta = delta;
+			cache.d2phir_dTau2.cached_val = summer;
+		}
 		return summer;
 	}
 }
@@ -333,9 +345,11 @@ double Fluid::d2phir_dDelta_dTau(double tau, double delta)
 		double summer = 0;
 		for (std::vector<phi_BC*>::iterator it = phirlist.begin(); it != phirlist.end(); it++)
 			summer += (*it)->dDelta_dTau(tau,delta);
-		cache.d2phir_dDelta_dTau.tau = tau;
-		cache.d2phir_dDelta_dTau.delta = delta;
-		cache.d2phir_dDelta_dTau.cached_val = summer;
+		if (use_cache){
+			cache.d2phir_dDelta_dTau.tau = tau;
+			cache.d2phir_dDelta_dTau.delta = delta;
+			cache.d2phir_dDelta_dTau.cached_val = summer;
+		}
 		return summer;
 	}
 }
@@ -371,6 +385,19 @@ double Fluid::d3phir_dDelta2_dTau(double tau, double delta)
 	return summer;
 }
 
+//--------------------------------------------
+//    All the derivatives at once
+//--------------------------------------------
+FluidHelmholtzDerivatives Fluid::Helmholtz_derivatives(double tau, double delta, int max_order)
+{
+	FluidHelmholtzDerivatives derivs;
+	for (std::vector<phi_BC*>::iterator it = phirlist.begin(); it != phirlist.end(); it++)
+		(*it)->all(tau, delta, derivs.phir, max_order);
+	for (std::vector<phi_BC*>::iterator it = phi0list.begin(); it != phi0list.end(); it++)
+		(*it)->all(tau, delta, derivs.phi0, max_order);
+	return derivs;
+}
+
 //--------------------------------------------
 //    Ideal Gas Part
 //--------------------------------------------
@@ -724,6 +751,7 @@ double Fluid::density_Tp(double T, double p)
 
 double Fluid::density_Tp(double T, double p, double rho_guess)
 {
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_DENSITY_TP);
     long double tau,dpdrho__constT,dpddelta__constT, error=999,R,p_EOS,rho,change=999;
 
     R = params.R_u/params.molemass*1000; // SI units are used internally
@@ -761,6 +789,7 @@ double Fluid::density_Tp(double T, double p, double rho_guess)
 		delta -= change;
 
 		iter++;
+		stats.iteration();
 		
         if (iter>50)
         {
@@ -939,6 +968,7 @@ void Fluid::saturation_h(double h, double Tmin, double Tmax, int Q, double &Tsat
 
 void Fluid::saturation_T(double T, bool UseLUT, double &psatLout, double &psatVout, double &rhosatLout, double &rhosatVout)
 {
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_SATURATION_T);
 	double p;
 	if (get_debug_level()>5){
 		std::cout << format("%s:%d: Fluid::saturation_T(%g,%d) \n",__FILE__,__LINE__,T,UseLUT).c_str();
@@ -962,6 +992,16 @@ void Fluid::saturation_T(double T, bool UseLUT, double &psatLout, double &psatVo
 				psatVout = psatLout;
 				return;
 			}
+
+			SaturationCacheState state;
+			if (saturation_cache_T(T, state))
+			{
+				rhosatLout = state.rhoL;
+				rhosatVout = state.rhoV;
+				psatLout = state.p;
+				psatVout = state.p;
+				return;
+			}
 			
 			try{
 				// Reduce omega in uniform steps
@@ -975,6 +1015,7 @@ void Fluid::saturation_T(double T, bool UseLUT, double &psatLout, double &psatVo
 					catch (std::exception)
 					{
 						omega -= 0.3;
+						stats.fallback();
 					}
 				}
 				while(omega > 0);
@@ -1002,6 +1043,7 @@ void Fluid::saturation_T(double T, bool UseLUT, double &psatLout, double &psatVo
 						catch (std::exception)
 						{
 							omega -= 0.3;
+							stats.fallback();
 						}
 					}
 					while(omega > 0);
@@ -1013,7 +1055,7 @@ void Fluid::saturation_T(double T, bool UseLUT, double &psatLout, double &psatVo
 					}
 				}
 				catch (std::exception){
-
+					stats.fallback();
 					rhosatPure_Brent(T,rhosatLout,rhosatVout,p);
 					psatLout = p;
 					psatVout = p;
@@ -1045,6 +1087,7 @@ void Fluid::saturation_T(double T, bool UseLUT, double &psatLout, double &psatVo
 		}
 		catch (std::exception &){
 			// Near the critical point, the behavior is not very nice, so we will just use the ancillary near the critical point
+			stats.fallback();
 			rhosatLout = rhosatL(T);
 			rhosatVout = rhosatV(T);
 		}
@@ -1055,6 +1098,7 @@ void Fluid::saturation_T(double T, bool UseLUT, double &psatLout, double &psatVo
 
 void Fluid::rhosatPure_Brent(double T, double &rhoLout, double &rhoVout, double &pout)
 {
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_RHOSATPURE_BRENT);
 	/*
 	Use Brent's method around when Akasaka's method fails.  Slow but reliable
 	*/
@@ -1119,6 +1163,7 @@ public:
 
 void Fluid::rhosatPure_BrentrhoV(double T, double &rhoLout, double &rhoVout, double &pout)
 {
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_RHOSATPURE_BRENTRHOV);
 	rhosatPure_BrentrhoVResidClass SF = rhosatPure_BrentrhoVResidClass(T,this);
 
 	std::string errstr;
@@ -1132,6 +1177,7 @@ void Fluid::rhosatPure_BrentrhoV(double T, double &rhoLout, double &rhoVout, dou
 /// saturation calcs
 void Fluid::rhosatPure_Akasaka(double T, double &rhoLout, double &rhoVout, double &pout, double omega = 1.0, bool use_guesses)
 {
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_RHOSATPURE_AKASAKA);
 	/*
 	This function implements the method of Akasaka 
 
@@ -1233,6 +1279,7 @@ void Fluid::rhosatPure_Akasaka(double T, double &rhoLout, double &rhoVout, doubl
 			throw ValueError(format("rhosatPure_Akasaka failed"));
 		}
 		iter++;
+		stats.iteration();
 		if (iter > 100)
 		{
 			throw SolutionError(format("Akasaka solver did not converge after 100 iterations"));
@@ -1276,6 +1323,7 @@ void Fluid::saturation_VdW(double T, double &rhoL, double &rhoV, double &p, doub
 }
 void Fluid::rhosatPure(double T, double &rhoLout, double &rhoVout, double &pout, double omega = 1.0, bool use_guesses = false)
 {
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_RHOSATPURE);
     // Only works for pure fluids (no blends)
     // At equilibrium, saturated vapor and saturated liquid are at the same pressure and the same Gibbs energy
     double rhoL,rhoV,p=_HUGE,error=999,x1=0,x2=0,x3,y1=0,y2,f,p_guess;
@@ -1322,6 +1370,7 @@ void Fluid::rhosatPure(double T, double &rhoLout, double &rhoVout, double &pout,
             y1=y2; x1=x2; x2=x3;
         }
         iter++;
+        stats.iteration();
         if (iter>100)
         {
         	//ERROR
@@ -1340,30 +1389,30 @@ bool isBetween(double x1,double x2, double x)
 	else return false;
 }
 
-// Ancillary equations composed by interpolating within 50-point 
-// curve that is calculated once
+// Ancillary equations composed by evaluating the piecewise Chebyshev
+// expansions that are calculated once
 double Fluid::hsatV_anc(double T)
 {
 	if (!h_ancillary->built) 
-		h_ancillary->build(50);
+		h_ancillary->build();
 	return h_ancillary->interpolateV(T);
 }
 double Fluid::ssatV_anc(double T)
 {
 	if (!s_ancillary->built) 
-		s_ancillary->build(50);
+		s_ancillary->build();
 	return s_ancillary->interpolateV(T);
 }
 double Fluid::hsatL_anc(double T)
 {
 	if (!h_ancillary->built) 
-		h_ancillary->build(50);
+		h_ancillary->build();
 	return h_ancillary->interpolateL(T);
 }
 double Fluid::ssatL_anc(double T)
 {
 	if (!s_ancillary->built) 
-		s_ancillary->build(50);
+		s_ancillary->build();
 	return s_ancillary->interpolateL(T);
 }
 
@@ -1669,7 +1718,8 @@ double Fluid::temperature_prho(double p, double rho, double T0)
 	// solve for T to yield the desired pressure
 	double error, T, drdT, r;
 	int iter = 0;
-	CoolPropStateClassSI CPS(this);
+	PooledCoolPropStateSI pooled_CPS(this);
+	CoolPropStateClassSI &CPS = *pooled_CPS;
 
 	T = T0;
 	CPS.update(iT,T,iD,rho);
@@ -1697,6 +1747,7 @@ double Fluid::temperature_prho(double p, double rho, double T0)
 
 void Fluid::temperature_ph(double p, double h, double &Tout, double &rhoout, double &rhoLout, double &rhoVout, double &TsatLout, double &TsatVout, double T0, double rho0)
 {
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_TEMPERATURE_PH);
 	int iter;
 	bool failed = false;
 	double A[2][2], B[2][2],T_guess, omega = 1.0;
@@ -1839,7 +1890,8 @@ void Fluid::temperature_ph(double p, double h, double &Tout, double &rhoout, dou
 				//**************************************************
 				// Step 2: Not far away from saturation (or it is two-phase) - need to solve saturation as a function of p :( - this is slow
 				//**************************************************
- 				CoolPropStateClassSI sat(name);
+				PooledCoolPropStateSI pooled_sat(this);
+				CoolPropStateClassSI &sat = *pooled_sat;
 				sat.update(iP, p, iQ, 0);
 				
 				rhoL = sat.rhoL();
@@ -1916,6 +1968,7 @@ void Fluid::temperature_ph(double p, double h, double &Tout, double &rhoout, dou
 					}
 					catch(std::exception &e)
 					{
+						stats.fallback();
 						T_guess = TsatL;
 						rho_guess = rhoLout;
 					}
@@ -1998,6 +2051,7 @@ void Fluid::temperature_ph(double p, double h, double &Tout, double &rhoout, dou
 		}
 
 		iter+=1;
+		stats.iteration();
 		if (iter>100)
 		{
 			throw SolutionError(format("Thp did not converge with inputs p=%g h=%g for fluid %s",p,h,(char*)name.c_str()));
@@ -2011,8 +2065,9 @@ void Fluid::temperature_ph(double p, double h, double &Tout, double &rhoout, dou
 	rhoout = delta*reduce.rho;
 }
 
-void Fluid::temperature_ps(double p, double s, double &Tout, double &rhoout, double &rhoLout, double &rhoVout, double &TsatLout, double &TsatVout)
+void Fluid::temperature_ps(double p, double s, double &Tout, double &rhoout, double &rhoLout, double &rhoVout, double &TsatLout, double &TsatVout, double T0, double rho0)
 {
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_TEMPERATURE_PS);
 	int iter;
 	double A[2][2], B[2][2],T_guess;
 	double dar_ddelta,da0_dtau,d2a0_dtau2,dar_dtau,d2ar_ddelta_dtau,d2ar_ddelta2,d2ar_dtau2,d2a0_ddelta_dtau,a0,ar,da0_ddelta;
@@ -2020,8 +2075,15 @@ void Fluid::temperature_ps(double p, double s, double &Tout, double &rhoout, dou
     double rhoL, rhoV, ssatL,ssatV,TsatL,TsatV,tau,delta,worst_error;
 	double s_guess, sc, rho_guess;
 	double ssat_tol = 1;
+	// A starting set of temperature and density are provided, use them as the guess value
+	// Their default values are -1 and -1, which are unphysical values
+	if (T0 > 0 && rho0 > 0)
+	{
+		T_guess = T0;
+		delta = rho0/reduce.rho;
+	}
 	// It is supercritical pressure	(or just below the critical pressure)
-	if (p > 0.999*crit.p.Pa) 
+	else if (p > 0.999*crit.p.Pa) 
 	{
 		sc = entropy_Trho(crit.T+0.001,crit.rho);
 		if (s > sc)
@@ -2099,7 +2161,8 @@ void Fluid::temperature_ps(double p, double s, double &Tout, double &rhoout, dou
 			//**************************************************
 			// Step 2: Not far away from saturation (or it is two-phase) - need to solve saturation as a function of p :( - this is slow
 			//**************************************************
-			CoolPropStateClassSI sat(name);
+			PooledCoolPropStateSI pooled_sat(this);
+			CoolPropStateClassSI &sat = *pooled_sat;
 			sat.update(iP,p,iQ,0);
 			rhoL = sat.rhoL();
 			rhoV = sat.rhoV();
@@ -2206,6 +2269,7 @@ void Fluid::temperature_ps(double p, double s, double &Tout, double &rhoout, dou
             worst_error=fabs(f2);
 
 		iter+=1;
+		stats.iteration();
 		if (iter>100)
 		{
 			throw SolutionError(format("Tsp did not converge with inputs p=%g s=%g for fluid %s",p,s,(char*)name.c_str()));
@@ -2248,8 +2312,9 @@ public:
 	};
 };
 
-void Fluid::temperature_hs(double h, double s, double &Tout, double &rhoout, double &rhoLout, double &rhoVout, double &TsatLout, double &TsatVout)
+void Fluid::temperature_hs(double h, double s, double &Tout, double &rhoout, double &rhoLout, double &rhoVout, double &TsatLout, double &TsatVout, double T0, double rho0)
 {
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_TEMPERATURE_HS);
 	bool singlephase_initialized = false;
 	int iter;
 	double A[2][2], B[2][2], T_guess;
@@ -2274,6 +2339,14 @@ void Fluid::temperature_hs(double h, double s, double &Tout, double &rhoout, dou
 		Tout = crit.T; rhoout = crit.rho; rhoLout = crit.rho; rhoVout = crit.rho; TsatLout = crit.T; TsatVout = crit.T;
 		return;
 	}
+	// A starting set of temperature and density are provided, use them as the guess value
+	// Their default values are -1 and -1, which are unphysical values
+	else if (T0 > 0 && rho0 > 0)
+	{
+		rho_guess = rho0;
+		T_guess = T0;
+		singlephase_initialized = true;
+	}
 	// If above the maximum enthalpy, no need to do any saturation calls, just determine 
 	// your state using interval bisection on the pressure using the p-h code (slow)
 	else if (h > HS.hmax)
@@ -2328,6 +2401,7 @@ void Fluid::temperature_hs(double h, double s, double &Tout, double &rhoout, dou
 			}
 			catch(std::exception &)
 			{
+				stats.fallback();
 				// Split the range into two pieces
 				try
 				{
@@ -2336,6 +2410,7 @@ void Fluid::temperature_hs(double h, double s, double &Tout, double &rhoout, dou
 				}
 				catch(std::exception)
 				{
+					stats.fallback();
 					try
 					{
 						Tout = Brent(&SatFunc, (limits.Tmin+crit.T)/2.0, crit.T-1e-4, 1e-16, 1e-8, 100, &errstr);
@@ -2343,6 +2418,7 @@ void Fluid::temperature_hs(double h, double s, double &Tout, double &rhoout, dou
 					}
 					catch (std::exception)
 					{
+						stats.fallback();
 						try{
 							Tout = Brent(&SatFunc, limits.Tmin, (limits.Tmin+crit.T)/2.0, 1e-16, 1e-8, 100, &errstr);
 							if (SatFunc.Q > 1+1e-8 || SatFunc.Q < 0-1e-8){ throw ValueError("Solution must be within the two-phase region"); } 
@@ -2683,6 +2759,7 @@ void Fluid::temperature_hs(double h, double s, double &Tout, double &rhoout, dou
             worst_error=fabs(f2);
 
 		iter += 1;
+		stats.iteration();
 		if (iter>100)
 		{
 			throw SolutionError(format("Ths did not converge with inputs h=%g s=%g for fluid %s",h,s,(char*)name.c_str()));
@@ -2789,6 +2866,361 @@ void Fluid::density_Ts(double T, double s, double &rhoout, double &pout, double
 	}
 }
 
+/// The internal energy (iOther = iU) or enthalpy (iOther = iH) at T,rho for a state that can be two-phase
+class rhoEnergyFuncClass : public FuncWrapper1D
+{
+private:
+	Fluid *pFluid;
+	long iOther;
+	double rho, value;
+public:
+	double pL, pV, rhoL, rhoV;
+	bool TwoPhase;
+	rhoEnergyFuncClass(Fluid *pFluid, long iOther, double rho, double value) : pFluid(pFluid), iOther(iOther), rho(rho), value(value){ TwoPhase = false; };
+	double energy(double T, double rho)
+	{
+		return (iOther == iU) ? pFluid->internal_energy_Trho(T, rho) : pFluid->enthalpy_Trho(T, rho);
+	};
+	double call(double T)
+	{
+		TwoPhase = (pFluid->phase_Trho_indices(T, rho, pL, pV, rhoL, rhoV) == iTwoPhase);
+		if (TwoPhase)
+		{
+			double Q = (1/rho-1/rhoL)/(1/rhoV-1/rhoL);
+			return energy(T, rhoL) + Q*(energy(T, rhoV) - energy(T, rhoL)) - value;
+		}
+		return energy(T, rho) - value;
+	};
+};
+
+void Fluid::temperature_rho_energy(long iOther, double rho, double value, double &Tout, double &pout, double &rhoLout, double &rhoVout, double &psatLout, double &psatVout, double T0)
+{
+	if (iOther != iU && iOther != iH){ throw ValueError(format("iOther [%d] must be iU or iH", iOther)); }
+	if (!(rho > 0)){ throw ValueError(format("Your density [%g kg/m^3] must be greater than zero", rho)); }
+	rhoLout = _HUGE;
+	rhoVout = _HUGE;
+	psatLout = _HUGE;
+	psatVout = _HUGE;
+
+	// The state is solved first as a single-phase state by Newton's method in tau at fixed delta:
+	//
+	//   u/(R*Tr) = dphi0_dTau + dphir_dTau
+	//   h/(R*Tr) = (1+delta*dphir_dDelta)/tau + dphi0_dTau + dphir_dTau
+	//
+	// If the solution is a stable single-phase state it is the only solution since the energy increases 
+	// with temperature along an isochore, also through the two-phase region
+	double delta = rho/reduce.rho, RTr = R()*reduce.T;
+	double tau_min = reduce.T/(2*limits.Tmax), tau_max = reduce.T/limits.Tmin;
+	double tau = (T0 > 0) ? reduce.T/T0 : reduce.T/crit.T, dtau = 1;
+	bool converged = false;
+	FluidHelmholtzDerivatives derivs;
+	for (int iter = 0; iter < 50; iter++)
+	{
+		derivs = Helmholtz_derivatives(tau, delta, 2);
+		double f, dfdtau;
+		if (iOther == iU)
+		{
+			f = RTr*(derivs.phi0.dTau + derivs.phir.dTau) - value;
+			dfdtau = RTr*(derivs.phi0.dTau2 + derivs.phir.dTau2);
+		}
+		else
+		{
+			double Z = 1 + delta*derivs.phir.dDelta;
+			f = RTr*(Z/tau + derivs.phi0.dTau + derivs.phir.dTau) - value;
+			dfdtau = RTr*(-Z/tau/tau + delta*derivs.phir.dDelta_dTau/tau + derivs.phi0.dTau2 + derivs.phir.dTau2);
+		}
+		if (converged){ break; }
+		// The energy decreases with tau unless the state is unstable
+		if (!ValidNumber(f) || !(dfdtau < 0)){ break; }
+		dtau = -f/dfdtau;
+		if (!(tau+dtau > tau_min && tau+dtau < tau_max)){ break; }
+		tau += dtau;
+		// One more evaluation for the pressure at the solution
+		if (fabs(dtau) < 1e-12*tau){ converged = true; }
+	}
+	if (converged)
+	{
+		Tout = reduce.T/tau;
+		if (Tout >= crit.T || phase_Trho_indices(Tout, rho, psatLout, psatVout, rhoLout, rhoVout) != iTwoPhase)
+		{
+			pout = rho*R()*Tout*(1 + delta*derivs.phir.dDelta);
+			rhoLout = _HUGE;
+			rhoVout = _HUGE;
+			return;
+		}
+	}
+
+	// Two-phase (or the Newton iterations did not converge): the energy along the isochore including the 
+	// two-phase region is solved for the temperature
+	rhoEnergyFuncClass f(this, iOther, rho, value);
+	std::string errstr;
+	Tout = Brent(&f, limits.Tmin, crit.T, 1e-12, 1e-10, 100, &errstr);
+	if (errstr.size() > 0){ throw SolutionError(format("temperature_rho_energy failed for rho = %g, value = %g: %s", rho, value, errstr.c_str())); }
+	// The saturation state at the solution, which is not necessarily the last one that was evaluated
+	f.call(Tout);
+	if (f.TwoPhase)
+	{
+		rhoLout = f.rhoL;
+		rhoVout = f.rhoV;
+		psatLout = f.pL;
+		psatVout = f.pV;
+		double Q = (1/rho-1/rhoLout)/(1/rhoVout-1/rhoLout);
+		pout = Q*psatVout + (1-Q)*psatLout;
+	}
+	else
+	{
+		pout = pressure_Trho(Tout, rho);
+	}
+}
+
+void Fluid::temperature_rhou(double rho, double u, double &Tout, double &pout, double &rhoLout, double &rhoVout, double &psatLout, double &psatVout, double T0)
+{
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_TEMPERATURE_RHOU);
+	temperature_rho_energy(iU, rho, u, Tout, pout, rhoLout, rhoVout, psatLout, psatVout, T0);
+}
+
+void Fluid::temperature_rhoh(double rho, double h, double &Tout, double &pout, double &rhoLout, double &rhoVout, double &psatLout, double &psatVout, double T0)
+{
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_TEMPERATURE_RHOH);
+	temperature_rho_energy(iH, rho, h, Tout, pout, rhoLout, rhoVout, psatLout, psatVout, T0);
+}
+
+/// The internal energy (iOther = iU) or enthalpy (iOther = iH) as a function of the density at constant temperature
+class TEnergyFuncClass : public FuncWrapper1D
+{
+private:
+	Fluid *pFluid;
+	long iOther;
+	double T, value, tau;
+	FluidHelmholtzDerivatives derivs;
+public:
+	TEnergyFuncClass(Fluid *pFluid, long iOther, double T, double value) : pFluid(pFluid), iOther(iOther), T(T), value(value){ tau = pFluid->reduce.T/T; };
+	double call(double rho)
+	{
+		double delta = rho/pFluid->reduce.rho;
+		derivs = pFluid->Helmholtz_derivatives(tau, delta, 2);
+		double e = tau*(derivs.phi0.dTau + derivs.phir.dTau);
+		if (iOther == iH){ e += 1 + delta*derivs.phir.dDelta; }
+		return pFluid->R()*T*e - value;
+	};
+	/// The derivative with respect to the density at the density of the last call
+	double deriv(double rho)
+	{
+		double delta = rho/pFluid->reduce.rho;
+		double de = tau*derivs.phir.dDelta_dTau;
+		if (iOther == iH){ de += derivs.phir.dDelta + delta*derivs.phir.dDelta2; }
+		return pFluid->R()*T*de/pFluid->reduce.rho;
+	};
+};
+
+void Fluid::density_T_energy(long iOther, double T, double value, double &rhoout, double &pout, double &rhoLout, double &rhoVout, double &psatLout, double &psatVout)
+{
+	if (iOther != iU && iOther != iH){ throw ValueError(format("iOther [%d] must be iU or iH", iOther)); }
+	if (T < limits.Tmin){ throw ValueError(format("Your temperature [%g K] is below the minimum temp [%g K]", T, limits.Tmin)); }
+	rhoLout = _HUGE;
+	rhoVout = _HUGE;
+	psatLout = _HUGE;
+	psatVout = _HUGE;
+
+	TEnergyFuncClass f(this, iOther, T, value);
+	// The density where the search for the bracket starts
+	double a;
+	if (T >= crit.T)
+	{
+		a = crit.rho;
+	}
+	else
+	{
+		// First try to define the phase with the ancillary equations, if we are far enough away from saturation
+		double rhoL = rhosatL(T), rhoV = rhosatV(T);
+		double eL = f.call(rhoL)+value, eV = f.call(rhoV)+value;
+		if (value < eL - 0.05*(eV-eL))
+		{
+			a = rhoL;
+		}
+		else if (value > eV + 0.05*(eV-eL))
+		{
+			a = rhoV;
+		}
+		else
+		{
+			// Close to saturation or two-phase; the saturation state is the boundary of the single-phase bracket
+			saturation_T(T, enabled_TTSE_LUT, psatLout, psatVout, rhoLout, rhoVout);
+			eL = f.call(rhoLout)+value;
+			eV = f.call(rhoVout)+value;
+			double Q = (value-eL)/(eV-eL);
+			if (Q >= -100*DBL_EPSILON && Q <= 1+100*DBL_EPSILON)
+			{
+				// Two-phase, return the quality weighted values
+				rhoout = 1/(Q/rhoVout+(1-Q)/rhoLout);
+				pout = Q*psatVout+(1-Q)*psatLout;
+				return;
+			}
+			a = (Q < 0) ? rhoLout : rhoVout;
+			rhoLout = _HUGE;
+			rhoVout = _HUGE;
+		}
+	}
+
+	// Along an isotherm the energy mostly decreases with density, so the bracket is grown towards higher 
+	// densities if the energy is too large and towards lower densities otherwise
+	double a0 = a, fa = f.call(a), fa0 = fa, b = a, fb = fa;
+	double factor = (fa > 0) ? 1.05 : 0.5;
+	for (int i = 0; i < 40 && fa*fb > 0; i++)
+	{
+		a = b;
+		fa = fb;
+		b *= factor;
+		fb = f.call(b);
+	}
+	if (fa*fb > 0 && T >= crit.T && fa0 < 0)
+	{
+		// Above the critical temperature the enthalpy increases with density again at liquid-like densities
+		a = a0; fa = fa0; b = a0; fb = fa0;
+		for (int i = 0; i < 40 && fa*fb > 0; i++)
+		{
+			a = b;
+			fa = fb;
+			b *= 1.05;
+			fb = f.call(b);
+		}
+	}
+	if (fa*fb > 0 || !ValidNumber(fb))
+	{
+		throw SolutionError(format("No solution found for T = %g, value = %g for fluid %s", T, value, name.c_str()));
+	}
+	std::string errstr;
+	double rho0 = a-fa*(b-a)/(fb-fa);
+	rhoout = (fa < 0) ? BracketedNewton(&f, a, b, rho0, 1e-12*rho0, 100, &errstr) : BracketedNewton(&f, b, a, rho0, 1e-12*rho0, 100, &errstr);
+	if (errstr.size() > 0){ throw SolutionError(format("density_T_energy failed for T = %g, value = %g: %s", T, value, errstr.c_str())); }
+	pout = pressure_Trho(T, rhoout);
+}
+
+void Fluid::density_Tu(double T, double u, double &rhoout, double &pout, double &rhoLout, double &rhoVout, double &psatLout, double &psatVout)
+{
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_DENSITY_TU);
+	density_T_energy(iU, T, u, rhoout, pout, rhoLout, rhoVout, psatLout, psatVout);
+}
+
+void Fluid::density_Th(double T, double h, double &rhoout, double &pout, double &rhoLout, double &rhoVout, double &psatLout, double &psatVout)
+{
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_DENSITY_TH);
+	density_T_energy(iH, T, h, rhoout, pout, rhoLout, rhoVout, psatLout, psatVout);
+}
+
+/// The internal energy as a function of the temperature at constant pressure; the density of one call is the 
+/// guess for the density of the next one
+class pEnergyFuncClass : public FuncWrapper1D
+{
+private:
+	Fluid *pFluid;
+	double p, u;
+	FluidHelmholtzDerivatives derivs;
+public:
+	double rho;
+	pEnergyFuncClass(Fluid *pFluid, double p, double u, double rho) : pFluid(pFluid), p(p), u(u), rho(rho){};
+	double call(double T)
+	{
+		rho = pFluid->density_Tp(T, p, rho);
+		derivs = pFluid->Helmholtz_derivatives(pFluid->reduce.T/T, rho/pFluid->reduce.rho, 2);
+		return pFluid->R()*pFluid->reduce.T*(derivs.phi0.dTau + derivs.phir.dTau) - u;
+	};
+	/// The derivative with respect to the temperature at the temperature of the last call
+	double deriv(double T)
+	{
+		double tau = pFluid->reduce.T/T, delta = rho/pFluid->reduce.rho, R = pFluid->R();
+		double cv = -R*tau*tau*(derivs.phi0.dTau2 + derivs.phir.dTau2);
+		double dpdT = rho*R*(1 + delta*derivs.phir.dDelta - delta*tau*derivs.phir.dDelta_dTau);
+		double dpdrho = R*T*(1 + 2*delta*derivs.phir.dDelta + delta*delta*derivs.phir.dDelta2);
+		double dudrho = R*pFluid->reduce.T*derivs.phir.dDelta_dTau/pFluid->reduce.rho;
+		return cv - dudrho*dpdT/dpdrho;
+	};
+};
+
+void Fluid::temperature_pu(double p, double u, double &Tout, double &rhoout, double &rhoLout, double &rhoVout, double &TsatLout, double &TsatVout)
+{
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_TEMPERATURE_PU);
+	rhoLout = _HUGE;
+	rhoVout = _HUGE;
+	TsatLout = _HUGE;
+	TsatVout = _HUGE;
+
+	// The temperature and density where the search for the bracket starts
+	double a, rho_guess;
+	if (p >= crit.p.Pa || p <= params.ptriple)
+	{
+		a = 1.1*crit.T;
+		rho_guess = density_Tp(a, p);
+	}
+	else
+	{
+		// First try to define the phase with the ancillary equations, if we are far enough away from saturation
+		double TsatL = Tsat_anc(p,0), TsatV = (pure()) ? TsatL : Tsat_anc(p,1);
+		double rhoL = rhosatL(TsatL), rhoV = rhosatV(TsatV);
+		double uL = internal_energy_Trho(TsatL, rhoL), uV = internal_energy_Trho(TsatV, rhoV);
+		if (u < uL - 0.05*(uV-uL))
+		{
+			a = TsatL;
+			rho_guess = rhoL;
+		}
+		else if (u > uV + 0.05*(uV-uL))
+		{
+			a = TsatV;
+			rho_guess = rhoV;
+		}
+		else
+		{
+			// Close to saturation or two-phase; the saturation state is the boundary of the single-phase bracket
+			PooledCoolPropStateSI pooled_sat(this);
+			CoolPropStateClassSI &sat = *pooled_sat;
+			sat.update(iP, p, iQ, 0);
+			rhoL = sat.rhoL();
+			rhoV = sat.rhoV();
+			TsatL = sat.TL();
+			TsatV = sat.TV();
+			uL = sat.hL() - p/rhoL;
+			uV = sat.hV() - p/rhoV;
+			double Q = (u-uL)/(uV-uL);
+			if (Q >= -100*DBL_EPSILON && Q <= 1+100*DBL_EPSILON)
+			{
+				// Two-phase, return the quality weighted values
+				rhoLout = rhoL;
+				rhoVout = rhoV;
+				TsatLout = TsatL;
+				TsatVout = TsatV;
+				Tout = Q*TsatV+(1-Q)*TsatL;
+				rhoout = 1/(Q/rhoV+(1-Q)/rhoL);
+				return;
+			}
+			a = (Q < 0) ? TsatL : TsatV;
+			rho_guess = (Q < 0) ? rhoL : rhoV;
+		}
+	}
+
+	// The internal energy increases with temperature at constant pressure, so the bracket is grown towards 
+	// lower temperatures if the energy is too large and towards higher temperatures otherwise
+	pEnergyFuncClass f(this, p, u, rho_guess);
+	double fa = f.call(a), b = a, fb = fa;
+	for (int i = 0; i < 40 && fa*fb > 0 && !(fa > 0 && b <= limits.Tmin); i++)
+	{
+		a = b;
+		fa = fb;
+		b = (fa > 0) ? std::max(0.9*b, limits.Tmin) : 1.2*b;
+		fb = f.call(b);
+	}
+	if (fa*fb > 0 || !ValidNumber(fb))
+	{
+		throw SolutionError(format("No solution found for p = %g, u = %g for fluid %s", p, u, name.c_str()));
+	}
+	std::string errstr;
+	double T0 = a-fa*(b-a)/(fb-fa);
+	Tout = (fa < 0) ? BracketedNewton(&f, a, b, T0, 1e-12*T0, 100, &errstr) : BracketedNewton(&f, b, a, T0, 1e-12*T0, 100, &errstr);
+	if (errstr.size() > 0){ throw SolutionError(format("temperature_pu failed for p = %g, u = %g: %s", p, u, errstr.c_str())); }
+	// The density at the solution, which is not necessarily the last one that was evaluated
+	f.call(Tout);
+	rhoout = f.rho;
+}
+
 double Fluid::Tsat_anc(double p, double Q)
 {
 	// This one only uses the ancillary equations
@@ -3024,6 +3456,7 @@ public:
 
 void Fluid::saturation_p(double p, bool UseLUT, double &TsatL, double &TsatV, double &rhoLout, double &rhoVout)
 {
+	SolverStatsScope stats(solver_stats, SOLVER_STATS_SATURATION_P);
 	double Tsat,rhoL,rhoV;
 
 	// Pseudo-critical pressure based on critical density and temperature
@@ -3051,6 +3484,16 @@ void Fluid::saturation_p(double p, bool UseLUT, double &TsatL, double &TsatV, do
 		}
 		else
 		{
+			SaturationCacheState state;
+			if (saturation_cache_p(p, state))
+			{
+				TsatL = state.T;
+				TsatV = state.T;
+				rhoLout = state.rhoL;
+				rhoVout = state.rhoV;
+				return;
+			}
+
 			//// Use Secant method to find T that gives the same gibbs function in both phases - a la REFPROP SATP function
 			std::string errstr;
 			SaturationPressureGivenResids SPGR = SaturationPressureGivenResids(this,p);
@@ -3072,6 +3515,7 @@ void Fluid::saturation_p(double p, bool UseLUT, double &TsatL, double &TsatV, do
 			}
 			catch(std::exception &) // Whoops that failed...
 			{
+				stats.fallback();
 				errstr.clear();
 				// Now try to get Tsat by using Brent's method on saturation_T calls
 				Saturation_p_IterateSaturationT_Resids SPISTR = Saturation_p_IterateSaturationT_Resids(this,p);
@@ -3434,6 +3878,205 @@ std::vector<double> Fluid::ConformalTemperature(Fluid *InterestFluid, Fluid *Ref
 	return xout;
 };
 
+void ConformalStateLUTClass::build(Fluid *pFluid, Fluid *pReferenceFluid)
+{
+	if (NT < 2 || Nrho < 2){ throw ValueError(format("The table of conformal states must be at least 2x2, not %dx%d",NT,Nrho)); }
+	this->pReferenceFluid = pReferenceFluid;
+	Tmin = pFluid->limits.Tmin;
+	Tmax = pFluid->limits.Tmax;
+	rhomin = 0.25*pFluid->reduce.rho;
+	rhomax = 1.05*pFluid->params.rhoLtriple;
+	T0_T.resize(NT*Nrho);
+	rho0_rho.resize(NT*Nrho);
+
+	// The same starting guess (unity shape factors) as in the ECS transport properties
+	double f = pFluid->reduce.T/pReferenceFluid->reduce.T;
+	double h = (pReferenceFluid->reduce.rho/pReferenceFluid->params.molemass)/(pFluid->reduce.rho/pFluid->params.molemass);
+	for (int i = 0; i < NT; i++)
+	{
+		double T = Tmin + (Tmax-Tmin)*i/(NT-1);
+		for (int j = 0; j < Nrho; j++)
+		{
+			double rho = rhomin + (rhomax-rhomin)*j/(Nrho-1);
+			double T0 = T/f, rho0 = rho/pFluid->params.molemass*h*pReferenceFluid->params.molemass;
+			std::string errstring;
+			std::vector<double> x0;
+			try{
+				x0 = pFluid->ConformalTemperature(pFluid,pReferenceFluid,T,rho,T0,rho0,&errstring);
+			}
+			catch(std::exception &){
+				errstring = "failed";
+			}
+			if (errstring.empty() && ValidNumber(x0[0]) && ValidNumber(x0[1]) && x0[0] > 0 && x0[1] > 0)
+			{
+				T0_T[i*Nrho+j] = x0[0]/T;
+				rho0_rho[i*Nrho+j] = x0[1]/rho;
+			}
+			else
+			{
+				T0_T[i*Nrho+j] = _HUGE;
+				rho0_rho[i*Nrho+j] = _HUGE;
+			}
+		}
+	}
+	built = true;
+}
+
+bool ConformalStateLUTClass::interpolate(double T, double rho, double &T0, double &rho0)
+{
+	double x = (T-Tmin)/(Tmax-Tmin)*(NT-1), y = (rho-rhomin)/(rhomax-rhomin)*(Nrho-1);
+	if (!(x >= 0 && x < NT-1 && y >= 0 && y < Nrho-1)){ return false; }
+	int i = (int)x, j = (int)y;
+	double wx = x-i, wy = y-j;
+	int k = i*Nrho+j;
+	if (T0_T[k] == _HUGE || T0_T[k+1] == _HUGE || T0_T[k+Nrho] == _HUGE || T0_T[k+Nrho+1] == _HUGE){ return false; }
+	T0 = T*((1-wx)*((1-wy)*T0_T[k]+wy*T0_T[k+1])+wx*((1-wy)*T0_T[k+Nrho]+wy*T0_T[k+Nrho+1]));
+	rho0 = rho*((1-wx)*((1-wy)*rho0_rho[k]+wy*rho0_rho[k+1])+wx*((1-wy)*rho0_rho[k+Nrho]+wy*rho0_rho[k+Nrho+1]));
+	return true;
+}
+
+std::vector<double> Fluid::ConformalState(Fluid *ReferenceFluid, double T, double rho, double T0, double rho0, std::string *errstring)
+{
+	if (ECS_LUT.enabled)
+	{
+		if (!ECS_LUT.built)
+		{
+			// Only one thread builds the table, the others wait here and then find it built
+			CoolPropLockGuard guard(ECS_LUT.build_lock);
+			if (!ECS_LUT.built){ ECS_LUT.build(this, ReferenceFluid); }
+		}
+		double T0_LUT, rho0_LUT;
+		if (ECS_LUT.pReferenceFluid == ReferenceFluid && ECS_LUT.interpolate(T, rho, T0_LUT, rho0_LUT))
+		{
+			// Newton steps from the interpolated state on the same residuals and to the same tolerance as ConformalTemperature
+			double tau_j = reduce.T/T, delta_j = rho/reduce.rho;
+			double alpha_j = phir(tau_j,delta_j);
+			double Z_j = 1+delta_j*dphir_dDelta(tau_j,delta_j);
+			for (int iter = 0; iter < 5; iter++)
+			{
+				double tau = ReferenceFluid->reduce.T/T0_LUT, delta = rho0_LUT/ReferenceFluid->reduce.rho;
+				HelmholtzDerivatives d = ReferenceFluid->Helmholtz_derivatives(tau,delta,2).phir;
+				double r0 = alpha_j-d.base;
+				double r1 = Z_j-(1+delta*d.dDelta);
+				if (sqrt(r0*r0+r1*r1) < 1e-10)
+				{
+					std::vector<double> xout(2,T0_LUT);
+					xout[1] = rho0_LUT;
+					return xout;
+				}
+				// Jacobian of the residuals with respect to T0 and rho0
+				double dtau_dT0 = -tau/T0_LUT, ddelta_drho0 = 1/ReferenceFluid->reduce.rho;
+				double J00 = -d.dTau*dtau_dT0;
+				double J01 = -d.dDelta*ddelta_drho0;
+				double J10 = -delta*d.dDelta_dTau*dtau_dT0;
+				double J11 = -(d.dDelta+delta*d.dDelta2)*ddelta_drho0;
+				double det = J00*J11-J01*J10;
+				T0_LUT -= (J11*r0-J01*r1)/det;
+				rho0_LUT -= (J00*r1-J10*r0)/det;
+				if (!ValidNumber(T0_LUT) || !ValidNumber(rho0_LUT) || T0_LUT <= 0 || rho0_LUT <= 0){ break; }
+			}
+		}
+	}
+	return ConformalTemperature(this,ReferenceFluid,T,rho,T0,rho0,errstring);
+}
+
+/// The outputs of the saturation cache as a function of x = sqrt(1-T/Tc), from the full saturation solution
+class SaturationCacheFunction : public ChebyshevFunction
+{
+private:
+	Fluid *pFluid;
+	SaturationCacheClass *pCache;
+public:
+	SaturationCacheFunction(Fluid *pFluid, SaturationCacheClass *pCache) : pFluid(pFluid), pCache(pCache){};
+	void call(double x, std::vector<double> &y)
+	{
+		double T = pCache->Tc*(1-x*x), psatL, psatV, rhoL, rhoV;
+		pFluid->saturation_T(T,false,psatL,psatV,rhoL,rhoV);
+		y.resize(3);
+		y[0] = log(psatL);
+		y[1] = rhoL/pCache->rhoc;
+		y[2] = log(rhoV/pCache->rhoc);
+	};
+};
+
+void SaturationCacheClass::build(Fluid *pFluid)
+{
+	Tc = pFluid->crit.T;
+	rhoc = pFluid->crit.rho;
+	Tmin = pFluid->limits.Tmin;
+	// Above the start of the critical spline the saturation routines use the spline, which is already cheap
+	if (UseCriticalSpline && ValidNumber(pFluid->CriticalSpline_T.Tend) && pFluid->CriticalSpline_T.Tend < Tc)
+		Tmax = pFluid->CriticalSpline_T.Tend;
+	else
+		Tmax = Tc*(1-1e-4);
+
+	// The saturation routines bypass the cache while it is being built
+	building = true;
+	try{
+		SaturationCacheFunction f(pFluid, this);
+		curves.build(f, 3, sqrt(1-Tmax/Tc), sqrt(1-Tmin/Tc), degree, rtol, max_depth);
+	}
+	catch(std::exception &){
+		building = false;
+		throw;
+	}
+	building = false;
+	built = true;
+}
+
+void SaturationCacheClass::evaluate(int i, double x, SaturationCacheState &state)
+{
+	state.rhoL = rhoc*curves.evaluate(i,1,x);
+	state.rhoV = rhoc*exp(curves.evaluate(i,2,x));
+}
+
+bool SaturationCacheClass::evaluate_T(double T, SaturationCacheState &state)
+{
+	if (!(T >= Tmin && T <= Tmax)){ return false; }
+	double x = sqrt(1-T/Tc);
+	int i = curves.interval(x);
+	if (i < 0){ return false; }
+	state.T = T;
+	state.p = exp(curves.evaluate(i,0,x));
+	evaluate(i,x,state);
+	return true;
+}
+
+bool SaturationCacheClass::evaluate_p(double p, SaturationCacheState &state)
+{
+	if (!(p > 0)){ return false; }
+	double x;
+	int i;
+	if (!curves.solve(0,log(p),x,i)){ return false; }
+	state.T = Tc*(1-x*x);
+	state.p = p;
+	evaluate(i,x,state);
+	return true;
+}
+
+bool Fluid::saturation_cache_T(double T, SaturationCacheState &state)
+{
+	if (!SaturationCache.enabled || SaturationCache.building || !pure()){ return false; }
+	if (!SaturationCache.built)
+	{
+		// Only one thread builds the cache, the others wait here and then find it built
+		CoolPropLockGuard guard(SaturationCache.build_lock);
+		if (!SaturationCache.built){ SaturationCache.build(this); }
+	}
+	return SaturationCache.evaluate_T(T, state);
+}
+
+bool Fluid::saturation_cache_p(double p, SaturationCacheState &state)
+{
+	if (!SaturationCache.enabled || SaturationCache.building || !pure()){ return false; }
+	if (!SaturationCache.built)
+	{
+		CoolPropLockGuard guard(SaturationCache.build_lock);
+		if (!SaturationCache.built){ SaturationCache.build(this); }
+	}
+	return SaturationCache.evaluate_p(p, state);
+}
+
 double Fluid::viscosity_ECS_Trho(double T, double rho, Fluid * ReferenceFluid)
 {
 	/*
@@ -3535,7 +4178,7 @@ double Fluid::viscosity_ECS_Trho(double T, double rho, Fluid * ReferenceFluid)
 	double p0 = Z*R()*T0*rho0;
 	if (Z<0.3 || p0>1.1*ReferenceFluid->reduce.p.Pa || rho0>ReferenceFluid->reduce.rho){
 		// Use the code to calculate the conformal state
-		x0=ConformalTemperature(this,ReferenceFluid,T,rho,T0,rho0,&errstring);
+		x0=ConformalState(ReferenceFluid,T,rho,T0,rho0,&errstring);
 		T0=x0[0];
 		rho0=x0[1];
 	}
@@ -3620,7 +4263,7 @@ double Fluid::conductivity_ECS_Trho(double T, double rho, Fluid * ReferenceFluid
 	double p0 = Z*R()*T0*rho0; //[Pa]
 	if (Z<0.3 || p0 > 1.1*ReferenceFluid->reduce.p.Pa || rho0 > ReferenceFluid->reduce.rho){
 		// Use the code to calculate the conformal state
-		x0=ConformalTemperature(this,ReferenceFluid,T,rho,T0,rho0,&errstring);
+		x0=ConformalState(ReferenceFluid,T,rho,T0,rho0,&errstring);
 		T0=x0[0];
 		rho0=x0[1];
 	}
@@ -3645,6 +4288,10 @@ double Fluid::conductivity_ECS_Trho(double T, double rho, Fluid * ReferenceFluid
 
 bool Fluid::build_TTSE_LUT(bool force_build)
 {
+	if (built_TTSE_LUT && !force_build){ return true; }
+
+	// Only one thread builds the tables, the others wait here and then find them built
+	CoolPropLockGuard guard(TTSE_build_lock);
 	if (!built_TTSE_LUT || force_build)
 	{
 		// No value has been set for the parameters
@@ -3674,6 +4321,7 @@ bool Fluid::build_TTSE_LUT(bool force_build)
 
 		TTSESinglePhase = TTSESinglePhaseTableClass(this);
 		TTSESinglePhase.enable_writing_tables_to_files = enable_writing_tables_to_files;
+		TTSESinglePhase.Nthreads_build = Nthreads_TTSE;
 		TTSESinglePhase.set_size_ph(Np_TTSE,Nh_TTSE);
 		// T,rho will mirror the size and range of h,p
 		TTSESinglePhase.set_size_Trho(Np_TTSE, Nh_TTSE);
@@ -3728,6 +4376,29 @@ void Fluid::disable_TTSE_LUT_writing(void){enable_writing_tables_to_files = fals
 void Fluid::set_TTSESat_LUT_size(int Nsat){Nsat_TTSE = Nsat;};
 /// Over-ride the default size of the single-phase LUT
 void Fluid::set_TTSESinglePhase_LUT_size(int Np, int Nh){Np_TTSE = Np; Nh_TTSE = Nh;};
+/// Over-ride the number of threads used to build the single-phase LUT
+void Fluid::set_TTSE_LUT_build_threads(int Nthreads){Nthreads_TTSE = Nthreads;};
+/// Enable the table of conformal states for the ECS transport properties
+void Fluid::enable_ECS_LUT(void){ECS_LUT.enabled = true;};
+/// Check if the table of conformal states is enabled
+bool Fluid::isenabled_ECS_LUT(void){return ECS_LUT.enabled;};
+/// Disable the table of conformal states
+void Fluid::disable_ECS_LUT(void){ECS_LUT.enabled = false;};
+/// Over-ride the default size of the table of conformal states
+void Fluid::set_ECS_LUT_size(int NT, int Nrho)
+{
+	// The nodes of a table that is already built are for the old size, so it has to be built again
+	CoolPropLockGuard guard(ECS_LUT.build_lock);
+	ECS_LUT.NT = NT;
+	ECS_LUT.Nrho = Nrho;
+	ECS_LUT.built = false;
+};
+/// Enable the cache of the saturation curve
+void Fluid::enable_saturation_cache(void){SaturationCache.enabled = true;};
+/// Check if the cache of the saturation curve is enabled
+bool Fluid::isenabled_saturation_cache(void){return SaturationCache.enabled;};
+/// Disable the cache of the saturation curve
+void Fluid::disable_saturation_cache(void){SaturationCache.enabled = false;};
 /// Over-ride the default range of the single-phase LUT
 void Fluid::set_TTSESinglePhase_LUT_range(double hmin, double hmax, double pmin, double pmax){hmin_TTSE = hmin; hmax_TTSE = hmax; pmin_TTSE = pmin; pmax_TTSE = pmax;};
 /// Get the current range of the single-phase LUT
@@ -3738,58 +4409,98 @@ void AncillaryCurveClass::update(Fluid *_pFluid, std::string Output)
 	pFluid = _pFluid;
 	iOutput = get_param_index(Output);
 }
-int AncillaryCurveClass::build(int N)
+/// The saturated liquid and vapor values of an ancillary curve as a function of x = sqrt(1-T/Tr)
+class AncillaryCurveFunction : public ChebyshevFunction
 {
-	double T,rhoV,rhoL;
-
-	// Output values
-	long iFluid = get_Fluid_index(pFluid->get_name());
-
-	double Tmin	= pFluid->params.Ttriple+1e-6;
-	if (Tmin<pFluid->limits.Tmin)
-		Tmin = pFluid->limits.Tmin+1e-6;
-	double Tmax	= pFluid->reduce.T-10*DBL_EPSILON;
-	for(int i = 0; i<N; i++)
+private:
+	AncillaryCurveClass *pCurve;
+public:
+	AncillaryCurveFunction(AncillaryCurveClass *pCurve) : pCurve(pCurve){};
+	void call(double x, std::vector<double> &y)
 	{
-		T = Tmin+(Tmax-Tmin)/(N-1)*i;
-		xL.push_back(T);
-		xV.push_back(T);
-		rhoL = pFluid->rhosatL(T);
-		rhoV = pFluid->rhosatV(T);
-		// IProps will always return value in standard units, convert to SI
-		if (iOutput==iH)
-		{
-			yL.push_back(pFluid->enthalpy_Trho(T,rhoL));
-			yV.push_back(pFluid->enthalpy_Trho(T,rhoV));
-		}
-		else if (iOutput == iS)
+		Fluid *pFluid = pCurve->pFluid;
+		double T = pCurve->Tr*(1-x*x);
+		double rhoL = pFluid->rhosatL(T);
+		double rhoV = pFluid->rhosatV(T);
+		y.resize(2);
+		if (pCurve->iOutput == iH)
 		{
-			yL.push_back(pFluid->entropy_Trho(T,rhoL));
-			yV.push_back(pFluid->entropy_Trho(T,rhoV));
+			y[0] = pFluid->enthalpy_Trho(T,rhoL);
+			y[1] = pFluid->enthalpy_Trho(T,rhoV);
 		}
 		else
 		{
-			throw ValueError(format("iOutput [%d] in build is invalid", iOutput).c_str());
+			y[0] = pFluid->entropy_Trho(T,rhoL);
+			y[1] = pFluid->entropy_Trho(T,rhoV);
 		}
+	};
+};
+
+int AncillaryCurveClass::build(void)
+{
+	// Another thread might have built it while we were waiting for the lock
+	CoolPropLockGuard guard(build_lock);
+	if (built){ return 1; }
+
+	if (iOutput != iH && iOutput != iS)
+	{
+		throw ValueError(format("iOutput [%d] in build is invalid", iOutput).c_str());
+	}
+	Tmin = pFluid->params.Ttriple+1e-6;
+	if (Tmin<pFluid->limits.Tmin)
+		Tmin = pFluid->limits.Tmin+1e-6;
+	Tr = pFluid->reduce.T;
+	Tmax = Tr-10*DBL_EPSILON;
+
+	// The ancillaries are not smooth at the critical point, so the intervals that reach it are kept even if
+	// they have not converged; they are only used for initial guesses
+	AncillaryCurveFunction f(this);
+	curves.build(f, 2, sqrt(1-Tmax/Tr), sqrt(1-Tmin/Tr), 10, 1e-8, 10, true);
+	if (curves.empty())
+	{
+		throw ValueError(format("The ancillary curve of [%s] could not be built",pFluid->get_name().c_str()));
 	}
 	built = true;
 	return 1;
 }
 
+double AncillaryCurveClass::interpolate(int k, double T)
+{
+	// Slightly outside of the range the expansion at the end is extrapolated
+	double x = (T < Tr) ? sqrt(1-T/Tr) : 0;
+	int i = curves.interval(std::min(std::max(x,curves.xmin),curves.xmax));
+	if (i < 0)
+	{
+		throw ValueError(format("Temperature [%g K] is not covered by the ancillary curve",T));
+	}
+	return curves.evaluate(i,k,x);
+}
+
+double AncillaryCurveClass::reverseinterpolate(int k, double y)
+{
+	double x;
+	int i;
+	if (!curves.solve(k,y,x,i))
+	{
+		throw ValueError(format("Value [%g] is not within the range of the ancillary curve",y));
+	}
+	return Tr*(1-x*x);
+}
+
 double AncillaryCurveClass::interpolateL(double T){
-	return interp1d(&xL,&yL,T);
+	return interpolate(0,T);
 }
 
 double AncillaryCurveClass::interpolateV(double T){
-	return interp1d(&xV,&yV,T);
+	return interpolate(1,T);
 }
 
 double AncillaryCurveClass::reverseinterpolateL(double y){
-	return interp1d(&yL,&xL,y);
+	return reverseinterpolate(0,y);
 }
 
 double AncillaryCurveClass::reverseinterpolateV(double y){
-	return interp1d(&yV,&xV,y);
+	return reverseinterpolate(1,y);
 }
 
 double CriticalSplineStruct_T::interpolate_rho(Fluid *pFluid, int phase, double T)
@@ -3913,7 +4624,7 @@ double CriticalSplineStruct_T::interpolate_rho(Fluid *pFluid, int phase, double
 void rebuild_CriticalSplineConstants_T()
 {
 	UseCriticalSpline = false;
-	FluidsContainer Fluids = FluidsContainer();
+	FluidsContainer Fluids;
 	std::vector<std::string> fluid_names = strsplit(Fluids.FluidList(),',');
 
 	double rhoL=0, rhoV=0, drhodTL=0, drhodTV=0;
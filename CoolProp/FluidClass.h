@@ -11,6 +11,8 @@
 #include "CoolPropTools.h"
 #include "Helmholtz.h"
 #include "TTSE.h"
+#include "Chebyshev.h"
+#include "SolverStats.h"
 #include "Units.h"
 #include "AllFluids.h"
 
@@ -54,23 +56,94 @@ struct FluidLimits
 	double Tmin, Tmax, pmax, rhomax;	
 };
 
+/// Saturated liquid and vapor enthalpy or entropy, evaluated at the densities from the ancillary equations, as
+/// piecewise Chebyshev expansions in x = sqrt(1-T/Tr).  The variable clusters the intervals toward the critical
+/// point, where the curves are steep, and the interval that contains T is found in O(1)
 class AncillaryCurveClass
 {
 public:
 	// Default Constructor
-	AncillaryCurveClass(){built = false;};
+	AncillaryCurveClass(){built = false; pFluid = NULL; iOutput = -1; Tmin = 0; Tmax = 0; Tr = 0;};
 	// Constructor with values
 	AncillaryCurveClass(Fluid *pFluid, std::string Output){built = false; update(pFluid,Output);};
 	void update(Fluid *pFluid, std::string Output);
-	std::vector<double> xL,yL,xV,yV;
-	int build(int N);
+	PiecewiseChebyshevClass curves; ///< Output 0 is the saturated liquid, output 1 the saturated vapor
+	double Tmin, Tmax, Tr;
+	int build(void);
 	long iOutput;
 	Fluid * pFluid;
 	double interpolateL(double T);
 	double interpolateV(double T);
+	/// The temperature at which the saturated liquid has the value y, by inverting the expansion
 	double reverseinterpolateL(double y);
+	/// The temperature at which the saturated vapor has the value y, by inverting the expansion.  Only valid
+	/// where the output is monotonic with temperature, which is not the case for the enthalpy of the vapor
 	double reverseinterpolateV(double y);
-	bool built;
+	CoolPropAtomicBool built;
+	CoolPropMutex build_lock; ///< Held while building so that concurrent first calls only build once
+private:
+	double interpolate(int k, double T);
+	double reverseinterpolate(int k, double y);
+};
+
+/// A table of the conformal state (T0,rho0) of the ECS reference fluid on a grid of temperature and density
+/// of the fluid of interest.  The interpolated state is the starting point for a few Newton steps, which
+/// replaces the full solution for the conformal state in the ECS transport properties
+class ConformalStateLUTClass
+{
+public:
+	ConformalStateLUTClass(){enabled = false; built = false; NT = 100; Nrho = 100; pReferenceFluid = NULL;};
+	/// Build the table for the fluid of interest with the given reference fluid
+	/// @param pFluid Pointer to the fluid of interest
+	/// @param pReferenceFluid Pointer to the ECS reference fluid
+	void build(Fluid *pFluid, Fluid *pReferenceFluid);
+	/// Bilinear interpolation of the conformal state.  Returns false if (T,rho) is outside of the table or next to a node where the conformal state could not be found
+	/// @param T Temperature of the fluid of interest [K]
+	/// @param rho Density of the fluid of interest [kg/m^3]
+	/// @param T0 Conformal temperature of the reference fluid [K]
+	/// @param rho0 Conformal density of the reference fluid [kg/m^3]
+	bool interpolate(double T, double rho, double &T0, double &rho0);
+	bool enabled;
+	int NT, Nrho;
+	double Tmin, Tmax, rhomin, rhomax;
+	Fluid *pReferenceFluid; ///< The reference fluid that the table was built for
+	std::vector<double> T0_T, rho0_rho; ///< T0/T and rho0/rho at the nodes (_HUGE if not found), NT*Nrho values with T varying slowest
+	CoolPropAtomicBool built;
+	CoolPropMutex build_lock; ///< Held while the table is being built
+};
+
+/// A saturation state given by the saturation cache
+struct SaturationCacheState
+{
+	double T, p, rhoL, rhoV;
+};
+
+/// Piecewise Chebyshev expansions of the saturation curve of a pure fluid, built from the full saturation
+/// solution on first use.  The independent variable is x = sqrt(1-T/Tc), in which the saturated densities
+/// are smooth up to the critical point, and the expansions are refined adaptively
+/// until they reproduce the saturation solver to within a relative tolerance.  The cache covers the range
+/// from the minimum temperature to the start of the critical spline (or just below the critical point)
+class SaturationCacheClass
+{
+public:
+	SaturationCacheClass(){enabled = false; built = false; building = false; degree = 14; rtol = 1e-10; max_depth = 12; Tc = 0; Tmin = 0; Tmax = 0; rhoc = 0;};
+	/// Build the expansions for the given fluid
+	void build(Fluid *pFluid);
+	/// The saturation state at the temperature T [K].  Returns false if T is not covered
+	bool evaluate_T(double T, SaturationCacheState &state);
+	/// The saturation state at the pressure p [Pa].  Returns false if p is not covered
+	bool evaluate_p(double p, SaturationCacheState &state);
+	bool enabled;
+	int degree, max_depth;
+	double rtol;
+	double Tc, Tmin, Tmax; ///< The critical temperature and the range that is covered [K]
+	double rhoc; ///< Used to scale the densities to order unity
+	PiecewiseChebyshevClass curves; ///< The outputs are ln(p), rhoL/rhoc, ln(rhoV/rhoc)
+	CoolPropAtomicBool built;
+	CoolPropAtomicBool building; ///< True while the cache is being built, during which the saturation routines bypass it
+	CoolPropMutex build_lock; ///< Held while the cache is being built
+private:
+	void evaluate(int i, double x, SaturationCacheState &state);
 };
 
 struct OnePhaseLUTStruct
@@ -143,6 +216,12 @@ struct FluidCache
 	FluidCacheElement phir,dphir_dDelta,dphir_dTau,d2phir_dDelta2,d2phir_dTau2,d2phir_dDelta_dTau;
 };
 
+/// All the derivatives of the residual and ideal-gas parts of the Helmholtz energy at one state
+struct FluidHelmholtzDerivatives
+{
+	HelmholtzDerivatives phir, phi0;
+};
+
 /// Fluid is the abstract base class that is employed by all the other fluids
 class Fluid
 {
@@ -167,9 +246,15 @@ class Fluid
 		/// @param p Pressure [kPa(abs)]
 		double _get_rho_guess(double T, double p); 
 
+		/// The common part of temperature_rhou (iOther = iU) and temperature_rhoh (iOther = iH)
+		void temperature_rho_energy(long iOther, double rho, double value, double &Tout, double &pout, double &rhoLout, double &rhoVout, double &psatLout, double &psatVout, double T0);
+		/// The common part of density_Tu (iOther = iU) and density_Th (iOther = iH)
+		void density_T_energy(long iOther, double T, double value, double &rhoout, double &pout, double &rhoLout, double &rhoVout, double &psatLout, double &psatVout);
+
 		// The boundaries for the TTSE
 		double hmin_TTSE, hmax_TTSE, pmin_TTSE, pmax_TTSE;
 		unsigned int Nsat_TTSE, Nh_TTSE, Np_TTSE;
+		int Nthreads_TTSE; ///< Number of threads used to build the TTSE LUT, the number of hardware threads if less than one
     public:
 
 		BibTeXKeysStruct BibTeXKeys;
@@ -193,6 +278,7 @@ class Fluid
 			Nsat_TTSE = 400;
 			Nh_TTSE = 200;
 			Np_TTSE = 200;
+			Nthreads_TTSE = 0;
 			hmin_TTSE = _HUGE;
 			hmax_TTSE = _HUGE;
 			pmin_TTSE = _HUGE;
@@ -206,12 +292,18 @@ class Fluid
 
 			ECSReferenceFluid = "R134a";
 			ECS_qd = 1/(0.5e-9);
+			loaded = false;
+			loading = false;
 		};
 		virtual ~Fluid();
 
 		// Some post-loading things happen here
 		void post_load(rapidjson::Document &JSON, rapidjson::Document &JSON_CAS);
 
+		/// True once post_load has been run (or is not needed), set by the FluidsContainer
+		CoolPropAtomicBool loaded;
+		bool loading; ///< True while the FluidsContainer is loading the fluid
+
 		void add_alias(std::string alias){ aliases.push_back(alias);};
 
 		// Fluid-specific parameters
@@ -276,6 +368,11 @@ class Fluid
 		virtual double d3phi0_dDelta_dTau2(double tau, double delta){return 0;};
 		virtual double d3phi0_dTau3(double tau, double delta);
 
+		/// All the derivatives of the residual and ideal-gas Helmholtz energy up to max_order (third order at most), 
+		/// evaluated in one pass through each list of terms rather than one pass per derivative.  
+		/// Some higher derivatives may be filled as well if they come for free
+		virtual FluidHelmholtzDerivatives Helmholtz_derivatives(double tau, double delta, int max_order = 3);
+
 		// These thermodynamic properties as a function of temperature and density are
 		// provided by the base class
 		double pressure_Trho(double T, double rho);
@@ -306,6 +403,50 @@ class Fluid
 		/// @param rhoVout Saturated vapor density [kg/m^3]
 		virtual void density_Ts(double T, double s, double &rhoout, double &pout, double &rhoLout, double &rhoVout, double &psatLout, double &psatVout);
 
+		/// Temperature as a function of density and internal energy, for the density-based solvers
+		/// @param rho Density [kg/m^3]
+		/// @param u Internal energy [J/kg]
+		/// @param Tout Temperature [K]
+		/// @param pout Pressure [Pa]
+		/// @param rhoLout Saturated liquid density [kg/m^3], _HUGE if the state is single-phase
+		/// @param rhoVout Saturated vapor density [kg/m^3], _HUGE if the state is single-phase
+		/// @param psatLout Saturated liquid pressure [Pa]
+		/// @param psatVout Saturated vapor pressure [Pa]
+		/// @param T0 Starting temperature for the solver, not used if less than zero
+		virtual void temperature_rhou(double rho, double u, double &Tout, double &pout, double &rhoLout, double &rhoVout, double &psatLout, double &psatVout, double T0 = -1);
+
+		/// Temperature as a function of density and enthalpy; see temperature_rhou
+		virtual void temperature_rhoh(double rho, double h, double &Tout, double &pout, double &rhoLout, double &rhoVout, double &psatLout, double &psatVout, double T0 = -1);
+
+		/// Density as a function of temperature and internal energy.  Below the critical temperature, a state 
+		/// between the saturated liquid and vapor is two-phase; otherwise the density is solved between the 
+		/// saturation density and the bound of the region.
+		/// @param T Temperature [K]
+		/// @param u Internal energy [J/kg]
+		/// @param rhoout Density [kg/m^3]
+		/// @param pout Pressure [Pa]
+		/// @param rhoLout Saturated liquid density [kg/m^3], _HUGE if the state is single-phase
+		/// @param rhoVout Saturated vapor density [kg/m^3], _HUGE if the state is single-phase
+		/// @param psatLout Saturated liquid pressure [Pa]
+		/// @param psatVout Saturated vapor pressure [Pa]
+		virtual void density_Tu(double T, double u, double &rhoout, double &pout, double &rhoLout, double &rhoVout, double &psatLout, double &psatVout);
+
+		/// Density as a function of temperature and enthalpy; see density_Tu.  The enthalpy of a compressed 
+		/// liquid can be larger than that of the saturated liquid at the same temperature; such an enthalpy
+		/// gives the two-phase state.
+		virtual void density_Th(double T, double h, double &rhoout, double &pout, double &rhoLout, double &rhoVout, double &psatLout, double &psatVout);
+
+		/// Temperature as a function of pressure and internal energy
+		/// @param p Pressure [Pa]
+		/// @param u Internal energy [J/kg]
+		/// @param Tout Temperature [K]
+		/// @param rhoout Density [kg/m^3]
+		/// @param rhoLout Saturated liquid density [kg/m^3], _HUGE if the state is single-phase
+		/// @param rhoVout Saturated vapor density [kg/m^3], _HUGE if the state is single-phase
+		/// @param TsatLout Saturated liquid temperature [K]
+		/// @param TsatVout Saturated vapor temperature [K]
+		virtual void temperature_pu(double p, double u, double &Tout, double &rhoout, double &rhoLout, double &rhoVout, double &TsatLout, double &TsatVout);
+
 		/// Temperature as a function of pressure and entropy
 		/// @param h Enthalpy [kJ/kg/K]
 		/// @param s Entropy [kJ/kg/K]
@@ -313,7 +454,9 @@ class Fluid
 		/// @param rhoout Density [kg/m^3]
 		/// @param rhoL Saturated liquid density [kg/m^3]
 		/// @param rhoV Saturated vapor density [kg/m^3]
-		virtual void temperature_hs(double h, double s, double &Tout, double &rhoout, double &rhoL, double &rhoV, double &TsatLout, double &TsatVout);
+		/// @param T0 Starting temperature for the solver
+		/// @param rho0 Starting density value for the solver
+		virtual void temperature_hs(double h, double s, double &Tout, double &rhoout, double &rhoL, double &rhoV, double &TsatLout, double &TsatVout, double T0 = -1, double rho0 = -1);
 
 		/// Temperature as a function of pressure and entropy
 		/// @param p Pressure [kPa]
@@ -322,7 +465,9 @@ class Fluid
 		/// @param rhoout Density [kg/m^3]
 		/// @param rhoL Saturated liquid density [kg/m^3]
 		/// @param rhoV Saturated vapor density [kg/m^3]
-		virtual void temperature_ps(double p, double s, double &Tout, double &rhoout, double &rhoL, double &rhoV, double &TsatLout, double &TsatVout);
+		/// @param T0 Starting temperature for the solver
+		/// @param rho0 Starting density value for the solver
+		virtual void temperature_ps(double p, double s, double &Tout, double &rhoout, double &rhoL, double &rhoV, double &TsatLout, double &TsatVout, double T0 = -1, double rho0 = -1);
 		
 		/// Temperature as a function of pressure and enthalpy
 		/// @param p Pressure [kPa]
@@ -401,6 +546,9 @@ class Fluid
 		double density_Tp_PengRobinson(double T, double p, int solution);
 
 		std::vector<double> ConformalTemperature(Fluid *InterestFluid, Fluid *ReferenceFluid,double T, double rho, double T0, double rho0, std::string *errstring);
+		/// The conformal state (T0,rho0) of the reference fluid, from the table of conformal states if it is enabled,
+		/// otherwise (or outside of the table) from ConformalTemperature
+		std::vector<double> ConformalState(Fluid *ReferenceFluid, double T, double rho, double T0, double rho0, std::string *errstring);
 		// Extended corresponding states functions for fluids that do not have their own high-accuracy
 		// transport property implementation
 		virtual void ECSParams(double *e_k, double *sigma);
@@ -581,7 +729,10 @@ class Fluid
 		bool isAlias(std::string name);
 
 		/// Parameters for the Tabular Taylor Series Expansion (TTSE) Method
-		bool enabled_TTSE_LUT, enabled_EXTTP, built_TTSE_LUT, enable_writing_tables_to_files;
+		bool enabled_EXTTP, enable_writing_tables_to_files;
+		CoolPropAtomicBool enabled_TTSE_LUT; ///< Read by the state classes of all the threads, and switched off while the tables are being built
+		CoolPropAtomicBool built_TTSE_LUT;
+		CoolPropMutex TTSE_build_lock; ///< Held while the TTSE tables are being built
 
 		/// Enable the extended two-phase calculations
 		/// If you want to over-ride parameters, must be done before calling this function
@@ -608,6 +759,8 @@ class Fluid
 		void set_TTSESat_LUT_size(int Nsat);
 		/// Over-ride the default size of the single-phase LUT
 		void set_TTSESinglePhase_LUT_size(int Np, int Nh);
+		/// Over-ride the number of threads used to build the single-phase LUT (default is the number of hardware threads)
+		void set_TTSE_LUT_build_threads(int Nthreads);
 		/// Over-ride the default range of the single-phase LUT
 		void set_TTSESinglePhase_LUT_range(double hmin, double hmax, double pmin, double pmax);
 		/// Get the current range of the single-phase LUT
@@ -616,6 +769,37 @@ class Fluid
 		bool build_TTSE_LUT(bool force = false);
 		/// Interpolate within the TTSE LUT
 		double interpolate_in_TTSE_LUT(long iParam, long iInput1, double Input1, long iInput2, double Input2);
+
+		/// Table of the conformal states for the ECS transport properties
+		ConformalStateLUTClass ECS_LUT;
+		/// Enable the table of conformal states for the ECS transport properties, built on first use
+		void enable_ECS_LUT(void);
+		/// Check if the table of conformal states is enabled
+		bool isenabled_ECS_LUT(void);
+		/// Disable the table of conformal states
+		void disable_ECS_LUT(void);
+		/// Over-ride the default size of the table of conformal states.  If the table was already built, it is rebuilt 
+		/// with the new size on next use; this must not be called while other threads use the table
+		void set_ECS_LUT_size(int NT, int Nrho);
+
+		/// Cache of the saturation curve
+		SaturationCacheClass SaturationCache;
+		/// Enable the cache of the saturation curve, built on first use
+		void enable_saturation_cache(void);
+		/// Check if the cache of the saturation curve is enabled
+		bool isenabled_saturation_cache(void);
+		/// Disable the cache of the saturation curve
+		void disable_saturation_cache(void);
+		/// The saturation state at the temperature T [K] from the cache, which is built if needed.
+		/// Returns false if the cache is not enabled or does not cover T
+		bool saturation_cache_T(double T, SaturationCacheState &state);
+		/// The saturation state at the pressure p [Pa] from the cache, which is built if needed.
+		/// Returns false if the cache is not enabled or does not cover p
+		bool saturation_cache_p(double p, SaturationCacheState &state);
+
+		/// The number of calls, iterations, fallbacks and failures and the time of the solvers of this fluid, 
+		/// recorded if the solver statistics are enabled
+		SolverStatsClass solver_stats;
 };
 
 	
@@ -53,6 +53,23 @@ void check_derivatives(phi_BC * phi, double tau, double delta, double ddelta, do
 	double d2phir_dDelta2 = 0;
 }
 
+void phi_BC::all(double tau, double delta, HelmholtzDerivatives &derivs, int max_order)
+{
+	derivs.base += base(tau,delta);
+	if (max_order < 1) return;
+	derivs.dTau += dTau(tau,delta);
+	derivs.dDelta += dDelta(tau,delta);
+	if (max_order < 2) return;
+	derivs.dTau2 += dTau2(tau,delta);
+	derivs.dDelta_dTau += dDelta_dTau(tau,delta);
+	derivs.dDelta2 += dDelta2(tau,delta);
+	if (max_order < 3) return;
+	derivs.dTau3 += dTau3(tau,delta);
+	derivs.dDelta_dTau2 += dDelta_dTau2(tau,delta);
+	derivs.dDelta2_dTau += dDelta2_dTau(tau,delta);
+	derivs.dDelta3 += dDelta3(tau,delta);
+}
+
 // Constructors
 phir_power::phir_power(std::vector<double> n_in,std::vector<double> d_in,std::vector<double> t_in, std::vector<double> l_in, int iStart_in,int iEnd_in)
 {
@@ -123,6 +140,41 @@ void phir_power::cache()
 		{
 			throw ValueError(format("coefficient %0.16f does not round to integer within DBL_EPSILON",l[i]).c_str());
 		}
+		if (l[i] > MAX_L)
+		{
+			throw ValueError(format("power %d of delta in exponential is larger than the maximum of %d",(int)l[i],(int)MAX_L).c_str());
+		}
+	}
+
+	// Pack the coefficients into contiguous rows.  The derivatives of each term with respect to delta are 
+	// the term multiplied by a polynomial in u = delta^l, the coefficients of these polynomials are packed here 
+	// as well so that all() only needs one exponential per term
+	unsigned int N = (iEnd >= iStart && iEnd < n.size()) ? iEnd-iStart+1 : 0;
+	packed.assign(PACKED_NROWS*N, 0.0);
+	l_packed.resize(N);
+	l_max = 0;
+	for (unsigned int k = 0; k < N; k++)
+	{
+		unsigned int i = iStart+k;
+		double ni = n[i], di = d[i], ti = t[i], li = l[i];
+		l_packed[k] = (int)li;
+		l_max = std::max(l_max, l_packed[k]);
+		packed[PACKED_N*N+k] = ni;
+		packed[PACKED_D*N+k] = di;
+		packed[PACKED_T*N+k] = ti;
+		packed[PACKED_T2*N+k] = ti*(ti-1);
+		packed[PACKED_T3*N+k] = ti*(ti-1)*(ti-2);
+		// delta*dA/ddelta = A*(d-l*u)
+		packed[PACKED_D1_1*N+k] = -li;
+		// delta^2*d2A/ddelta2 = A*((d-l*u)*(d-1-l*u)-l^2*u)
+		packed[PACKED_D2_0*N+k] = di*(di-1);
+		packed[PACKED_D2_1*N+k] = -li*(2*di-1)-li*li;
+		packed[PACKED_D2_2*N+k] = li*li;
+		// delta^3*d3A/ddelta3
+		packed[PACKED_D3_0*N+k] = di*(di-1)*(di-2);
+		packed[PACKED_D3_1*N+k] = -2*li+6*di*li-3*di*di*li-3*di*li*li+3*li*li-li*li*li;
+		packed[PACKED_D3_2*N+k] = 3*di*li*li-3*li*li+3*li*li*li;
+		packed[PACKED_D3_3*N+k] = -li*li*li;
 	}
 }
 
@@ -238,6 +290,79 @@ double phir_power::dDelta_dTau(double tau, double delta) throw()
 	return summer;
 }
 
+void phir_power::all(double tau, double delta, HelmholtzDerivatives &derivs, int max_order) throw()
+{
+	const unsigned int N = (unsigned int)l_packed.size();
+	if (N == 0){ return; }
+	const double log_tau = log(tau), log_delta = log(delta);
+
+	// delta^l for each power l, the terms with l = 0 have no exponential in delta^l
+	double pow_delta_l[MAX_L+1];
+	pow_delta_l[0] = 0;
+	for (int k = 1; k <= l_max; k++){ pow_delta_l[k] = (k == 1) ? delta : pow_delta_l[k-1]*delta; }
+
+	const double *nn = &(packed[PACKED_N*N]), *dd = &(packed[PACKED_D*N]), *tt = &(packed[PACKED_T*N]);
+	const double *T2 = &(packed[PACKED_T2*N]), *T3 = &(packed[PACKED_T3*N]), *D1_1 = &(packed[PACKED_D1_1*N]);
+	const double *D2_0 = &(packed[PACKED_D2_0*N]), *D2_1 = &(packed[PACKED_D2_1*N]), *D2_2 = &(packed[PACKED_D2_2*N]);
+	const double *D3_0 = &(packed[PACKED_D3_0*N]), *D3_1 = &(packed[PACKED_D3_1*N]), *D3_2 = &(packed[PACKED_D3_2*N]), *D3_3 = &(packed[PACKED_D3_3*N]);
+	
+	double S = 0, ST = 0, STT = 0, STTT = 0, SD = 0, SDD = 0, SDDD = 0, SDT = 0, SDDT = 0, SDTT = 0;
+	const unsigned int BLOCK = 8;
+	double u[BLOCK], A[BLOCK];
+	for (unsigned int i0 = 0; i0 < N; i0 += BLOCK)
+	{
+		const unsigned int Nb = std::min(BLOCK, N-i0);
+		// Arguments of the exponentials, then the exponentials, then the sums, the first and last loops vectorize
+		for (unsigned int k = 0; k < Nb; k++)
+		{
+			u[k] = pow_delta_l[l_packed[i0+k]];
+			A[k] = tt[i0+k]*log_tau+dd[i0+k]*log_delta-u[k];
+		}
+		for (unsigned int k = 0; k < Nb; k++)
+		{
+			A[k] = nn[i0+k]*exp(A[k]);
+		}
+		for (unsigned int k = 0; k < Nb; k++)
+		{
+			const unsigned int i = i0+k;
+			const double Ak = A[k], uk = u[k];
+			const double D1 = dd[i]+D1_1[i]*uk;
+			const double D2 = D2_0[i]+uk*(D2_1[i]+uk*D2_2[i]);
+			S += Ak;
+			ST += tt[i]*Ak;
+			STT += T2[i]*Ak;
+			SD += D1*Ak;
+			SDD += D2*Ak;
+			SDT += tt[i]*D1*Ak;
+		}
+		if (max_order < 3){ continue; }
+		for (unsigned int k = 0; k < Nb; k++)
+		{
+			const unsigned int i = i0+k;
+			const double Ak = A[k], uk = u[k];
+			const double D1 = dd[i]+D1_1[i]*uk;
+			const double D2 = D2_0[i]+uk*(D2_1[i]+uk*D2_2[i]);
+			const double D3 = D3_0[i]+uk*(D3_1[i]+uk*(D3_2[i]+uk*D3_3[i]));
+			STTT += T3[i]*Ak;
+			SDDD += D3*Ak;
+			SDDT += tt[i]*D2*Ak;
+			SDTT += T2[i]*D1*Ak;
+		}
+	}
+	// Each sum is of the derivatives multiplied by tau^i*delta^j
+	derivs.base += S;
+	derivs.dTau += ST/tau;
+	derivs.dTau2 += STT/(tau*tau);
+	derivs.dDelta += SD/delta;
+	derivs.dDelta2 += SDD/(delta*delta);
+	derivs.dDelta_dTau += SDT/(delta*tau);
+	if (max_order < 3){ return; }
+	derivs.dTau3 += STTT/(tau*tau*tau);
+	derivs.dDelta3 += SDDD/(delta*delta*delta);
+	derivs.dDelta2_dTau += SDDT/(delta*delta*tau);
+	derivs.dDelta_dTau2 += SDTT/(delta*tau*tau);
+}
+
 double phir_power::A(double log_tau, double log_delta, double delta, int i) throw()
 {
 	if (l[i]>0)
@@ -373,6 +498,69 @@ TEST_CASE("Power Helmholtz terms", "[helmholtz],[fast]")
 		REQUIRE(abs(NUM-ANA) < 1e-6);
 	}
 }
+TEST_CASE("All the derivatives of power and Gaussian terms at once", "[helmholtz],[fast]")
+{
+	// Power terms from R134a
+	double n[]={0.0, 0.5586817e-1, 0.4982230e0, 0.2458698e-1, 0.8570145e-3, 0.4788584e-3, -0.1800808e1, 0.2671641e0, -0.4781652e-1, 0.1423987e-1, 0.3324062e0, -0.7485907e-2, 0.1017263e-3, -0.5184567e+0, -0.8692288e-1, 0.2057144e+0, -0.5000457e-2, 0.4603262e-3, -0.3497836e-2, 0.6995038e-2, -0.1452184e-1, -0.1285458e-3};
+	double d[]={0,2,1,3,6,6,1,1,2,5,2,2,4,1,4,1,2,4,1,5,3,10};
+	double t[]={0.0,-1.0/2.0,0.0,0.0,0.0,3.0/2.0,3.0/2.0,2.0,2.0,1.0,3.0,5.0,1.0,5.0,5.0,6.0,10.0,10.0,10.0,18.0,22.0,50.0};
+	double c[]={0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,1.0,1.0,1.0,2.0,2.0,2.0,2.0,2.0,2.0,3.0,3.0,3.0,4.0};
+	phir_power power(n,d,t,c,1,21,22);
+
+	// Gaussian terms from water (IAPWS-95)
+	double ng[] = {0, -0.31306260323435e2, 0.31546140237781e2, -0.25213154341695e4};
+	double dg[] = {0, 3, 3, 3};
+	double tg[] = {0, 0, 1, 4};
+	double alpha[] = {0, 20, 20, 20};
+	double epsilon[] = {0, 1, 1, 1};
+	double beta[] = {0, 150, 150, 250};
+	double gamma[] = {0, 1.21, 1.21, 1.25};
+	phir_gaussian gaussian(ng,dg,tg,alpha,epsilon,beta,gamma,1,3,4);
+
+	phi_BC *terms[] = {&power, &gaussian};
+	double taus[] = {0.5, 1.0, 1.2, 2.5}, deltas[] = {0.01, 0.9, 1.1, 2.8};
+	for (int k = 0; k < 2; k++)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			double tau = taus[i], delta = deltas[i];
+			HelmholtzDerivatives derivs;
+			if (k == 0){ power.all(tau, delta, derivs); } else { gaussian.all(tau, delta, derivs); }
+			phi_BC *phi = terms[k];
+			double expected[] = {phi->base(tau,delta), phi->dTau(tau,delta), phi->dDelta(tau,delta), phi->dTau2(tau,delta), phi->dDelta_dTau(tau,delta), 
+				phi->dDelta2(tau,delta), phi->dTau3(tau,delta), phi->dDelta_dTau2(tau,delta), phi->dDelta2_dTau(tau,delta), phi->dDelta3(tau,delta)};
+			double actual[] = {derivs.base, derivs.dTau, derivs.dDelta, derivs.dTau2, derivs.dDelta_dTau, 
+				derivs.dDelta2, derivs.dTau3, derivs.dDelta_dTau2, derivs.dDelta2_dTau, derivs.dDelta3};
+			for (int j = 0; j < 10; j++)
+			{
+				CAPTURE(k);
+				CAPTURE(i);
+				CAPTURE(j);
+				CHECK(fabs(actual[j]-expected[j]) <= 1e-11*std::max(1.0, fabs(expected[j])));
+			}
+		}
+	}
+	SECTION("the derivatives are added to those already there")
+	{
+		HelmholtzDerivatives derivs;
+		power.all(0.8, 1.3, derivs);
+		gaussian.all(0.8, 1.3, derivs);
+		CHECK(fabs(derivs.dDelta2_dTau-(power.dDelta2_dTau(0.8,1.3)+gaussian.dDelta2_dTau(0.8,1.3))) < 1e-10);
+	}
+	SECTION("the third derivatives are skipped for max_order of 2")
+	{
+		HelmholtzDerivatives derivs2, derivs3;
+		power.all(0.8, 1.3, derivs2, 2);
+		gaussian.all(0.8, 1.3, derivs2, 2);
+		power.all(0.8, 1.3, derivs3);
+		gaussian.all(0.8, 1.3, derivs3);
+		CHECK(derivs2.dDelta2 == derivs3.dDelta2);
+		CHECK(derivs2.dDelta_dTau == derivs3.dDelta_dTau);
+		CHECK(derivs2.dTau2 == derivs3.dTau2);
+		CHECK(derivs2.dDelta3 == 0);
+		CHECK(derivs2.dTau3 == 0);
+	}
+}
 #endif
 
 // Constructors
@@ -921,6 +1109,7 @@ phir_gaussian::phir_gaussian(std::vector<double> n_in, std::vector<double> d_in,
 	gamma=gamma_in;
 	iStart=iStart_in;
 	iEnd=iEnd_in;
+	cache();
 }
 
 phir_gaussian::phir_gaussian(double n_in[], double d_in[],double t_in[], double alpha_in[], 
@@ -936,6 +1125,7 @@ phir_gaussian::phir_gaussian(double n_in[], double d_in[],double t_in[], double
 	gamma=std::vector<double>(gamma_in,gamma_in+N);
 	iStart=iStart_in;
 	iEnd=iEnd_in;
+	cache();
 }
 phir_gaussian::phir_gaussian(const double n_in[], const double d_in[], const double t_in[], const double alpha_in[], 
 							 const double epsilon_in[], const double beta_in[], const double gamma_in[],
@@ -950,6 +1140,23 @@ phir_gaussian::phir_gaussian(const double n_in[], const double d_in[], const dou
 	gamma=std::vector<double>(gamma_in,gamma_in+N);
 	iStart=iStart_in;
 	iEnd=iEnd_in;
+	cache();
+}
+void phir_gaussian::cache()
+{
+	unsigned int N = (iEnd >= iStart && iEnd < n.size()) ? iEnd-iStart+1 : 0;
+	packed.resize(PACKED_NROWS*N);
+	for (unsigned int k = 0; k < N; k++)
+	{
+		unsigned int i = iStart+k;
+		packed[PACKED_N*N+k] = n[i];
+		packed[PACKED_D*N+k] = d[i];
+		packed[PACKED_T*N+k] = t[i];
+		packed[PACKED_ALPHA*N+k] = alpha[i];
+		packed[PACKED_EPSILON*N+k] = epsilon[i];
+		packed[PACKED_BETA*N+k] = beta[i];
+		packed[PACKED_GAMMA*N+k] = gamma[i];
+	}
 }
 
 // Term and its derivatives
@@ -1059,6 +1266,71 @@ double phir_gaussian::dDelta_dTau2(double tau, double delta) throw()
 	}
 	return summer;
 }
+void phir_gaussian::all(double tau, double delta, HelmholtzDerivatives &derivs, int max_order) throw()
+{
+	const unsigned int N = (unsigned int)(packed.size()/PACKED_NROWS);
+	if (N == 0){ return; }
+	const double log_tau = log(tau), log_delta = log(delta);
+	const double *nn = &(packed[PACKED_N*N]), *dd = &(packed[PACKED_D*N]), *tt = &(packed[PACKED_T*N]);
+	const double *aa = &(packed[PACKED_ALPHA*N]), *ee = &(packed[PACKED_EPSILON*N]), *bb = &(packed[PACKED_BETA*N]), *gg = &(packed[PACKED_GAMMA*N]);
+
+	double S = 0, ST = 0, STT = 0, STTT = 0, SD = 0, SDD = 0, SDDD = 0, SDT = 0, SDDT = 0, SDTT = 0;
+	const unsigned int BLOCK = 8;
+	double A[BLOCK];
+	for (unsigned int i0 = 0; i0 < N; i0 += BLOCK)
+	{
+		const unsigned int Nb = std::min(BLOCK, N-i0);
+		// delta^d*tau^t*psi is the exponential of the sum of the logarithms
+		for (unsigned int k = 0; k < Nb; k++)
+		{
+			const unsigned int i = i0+k;
+			A[k] = dd[i]*log_delta+tt[i]*log_tau-aa[i]*(delta-ee[i])*(delta-ee[i])-bb[i]*(tau-gg[i])*(tau-gg[i]);
+		}
+		for (unsigned int k = 0; k < Nb; k++)
+		{
+			A[k] = nn[i0+k]*exp(A[k]);
+		}
+		for (unsigned int k = 0; k < Nb; k++)
+		{
+			const unsigned int i = i0+k;
+			// The logarithm of the term is separable in delta and tau, a_j and b_j are its derivatives of order j 
+			const double a1 = dd[i]/delta-2*aa[i]*(delta-ee[i]), a2 = -dd[i]/(delta*delta)-2*aa[i];
+			const double b1 = tt[i]/tau-2*bb[i]*(tau-gg[i]), b2 = -tt[i]/(tau*tau)-2*bb[i];
+			const double D2 = a1*a1+a2, T2 = b1*b1+b2;
+			const double Ak = A[k];
+			S += Ak;
+			ST += b1*Ak;
+			STT += T2*Ak;
+			SD += a1*Ak;
+			SDD += D2*Ak;
+			SDT += a1*b1*Ak;
+		}
+		if (max_order < 3){ continue; }
+		for (unsigned int k = 0; k < Nb; k++)
+		{
+			const unsigned int i = i0+k;
+			const double a1 = dd[i]/delta-2*aa[i]*(delta-ee[i]), a2 = -dd[i]/(delta*delta)-2*aa[i], a3 = 2*dd[i]/(delta*delta*delta);
+			const double b1 = tt[i]/tau-2*bb[i]*(tau-gg[i]), b2 = -tt[i]/(tau*tau)-2*bb[i], b3 = 2*tt[i]/(tau*tau*tau);
+			const double D2 = a1*a1+a2, D3 = a1*(a1*a1+3*a2)+a3, T2 = b1*b1+b2, T3 = b1*(b1*b1+3*b2)+b3;
+			const double Ak = A[k];
+			STTT += T3*Ak;
+			SDDD += D3*Ak;
+			SDDT += D2*b1*Ak;
+			SDTT += a1*T2*Ak;
+		}
+	}
+	derivs.base += S;
+	derivs.dTau += ST;
+	derivs.dTau2 += STT;
+	derivs.dDelta += SD;
+	derivs.dDelta2 += SDD;
+	derivs.dDelta_dTau += SDT;
+	if (max_order < 3){ return; }
+	derivs.dTau3 += STTT;
+	derivs.dDelta3 += SDDD;
+	derivs.dDelta2_dTau += SDDT;
+	derivs.dDelta_dTau2 += SDTT;
+}
 
 phir_GERG2008_gaussian::phir_GERG2008_gaussian(std::vector<double> n_in, std::vector<double> d_in, std::vector<double> t_in, 
 											   std::vector<double> eta_in, std::vector<double> epsilon_in, std::vector<double> beta_in, std::vector<double> gamma_in,
@@ -1889,6 +2161,20 @@ double phi0_Planck_Einstein::dTau3(double tau, double delta)
 	}
 	return summer;
 }
+void phi0_Planck_Einstein::all(double tau, double /* delta */, HelmholtzDerivatives &derivs, int max_order)
+{
+	for (int i=iStart;i<=iEnd;i++)
+	{
+		// With e = exp(-theta*tau), the derivatives are those above with numerator and denominator multiplied by powers of e
+		double e = exp(-theta[i]*tau), c = 1/(1-e);
+		derivs.base += a[i]*log(1-e);
+		derivs.dTau += a[i]*theta[i]*e*c;
+		derivs.dTau2 -= a[i]*theta[i]*theta[i]*e*c*c;
+		if (max_order >= 3){
+			derivs.dTau3 += a[i]*theta[i]*theta[i]*theta[i]*e*(1+e)*c*c*c;
+		}
+	}
+}
 
 /*
 Maxima code for the term:
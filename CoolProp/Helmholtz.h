@@ -19,6 +19,16 @@
 
 
 
+/// A Helmholtz energy term and all its partial derivatives up to third order with respect to tau and delta, 
+/// evaluated at the same state.  The names are those of the methods of phi_BC that return each of them
+struct HelmholtzDerivatives
+{
+	double base, dTau, dDelta, dTau2, dDelta_dTau, dDelta2, dTau3, dDelta_dTau2, dDelta2_dTau, dDelta3;
+	HelmholtzDerivatives(){ reset(); };
+	/// Set all the derivatives to zero
+	void reset(){ base = dTau = dDelta = dTau2 = dDelta_dTau = dDelta2 = dTau3 = dDelta_dTau2 = dDelta2_dTau = dDelta3 = 0; };
+};
+
 /// This is the abstract base class upon which each residual Helmholtz energy class is built
 class phi_BC{
 public:
@@ -65,6 +75,14 @@ public:
 	/// @param tau Reciprocal reduced temperature where tau=Tc / T
 	/// @param delta Reduced pressure where delta = rho / rhoc 
 	virtual double dDelta3(double tau, double delta) = 0;
+	/// Adds the term and all its derivatives up to max_order to derivs.  The default calls each of the derivative 
+	/// functions, the terms that can share the work between the derivatives override it and may also add the 
+	/// higher derivatives if they come for free
+	/// @param tau Reciprocal reduced temperature where tau=Tc / T
+	/// @param delta Reduced pressure where delta = rho / rhoc 
+	/// @param derivs The derivatives to add to
+	/// @param max_order The highest order of the derivatives that are needed (0 to 3)
+	virtual void all(double tau, double delta, HelmholtzDerivatives &derivs, int max_order = 3);
 };
 
 /// Check the derivatives for a Helmholtz energy term
@@ -88,8 +106,18 @@ if l==0, then
 class phir_power : public phi_BC{
 	
 private:
-	
+	/// Rows of the packed coefficients, each row holds one coefficient for the terms iStart to iEnd
+	enum packed_rows {PACKED_N, PACKED_D, PACKED_T, PACKED_T2, PACKED_T3, 
+		PACKED_D1_1, PACKED_D2_0, PACKED_D2_1, PACKED_D2_2, PACKED_D3_0, PACKED_D3_1, PACKED_D3_2, PACKED_D3_3, PACKED_NROWS};
+	/// The coefficients of the terms and of the polynomials in delta^l of their derivatives, packed by cache() for all()
+	std::vector<double> packed;
+	/// The powers l of the terms iStart to iEnd as integers
+	std::vector<int> l_packed;
+	/// The largest power l
+	int l_max;
 public:
+	/// The largest power of delta in the exponential that all() can handle
+	enum {MAX_L = 16};
 	unsigned int iStart,iEnd;
 	std::vector<double> n, ///< The coefficients multiplying each term
 		                d, ///< The power for the delta terms
@@ -107,7 +135,7 @@ public:
 	phir_power(const double[], const double[], const double[], const double[],int,int,int);
 	phir_power(double[],double[],double[],double[],int,int,int);
 	
-	/// Cache some terms for internal use
+	/// Cache some terms for internal use, must be called again if the coefficients are changed
 	void cache();
 
 	///< Destructor for the phir_power class.  No implementation
@@ -126,6 +154,10 @@ public:
 	double dDelta_dTau2(double tau, double delta) throw();
 	double dTau3(double tau, double delta) throw();
 
+	/// Add the sum of the terms and all their derivatives up to max_order (second or third) to derivs.  
+	/// All the derivatives of a term share the same exponential, so this is much faster than calling each of the derivative functions
+	void all(double tau, double delta, HelmholtzDerivatives &derivs, int max_order = 3) throw();
+
 	/// Vectorized form so iteration happens at c++ level
 	std::vector<double> dDeltaV(std::vector<double> tau, std::vector<double> delta) throw();
 	std::vector<double> dDelta2V(std::vector<double> tau, std::vector<double> delta) throw();
@@ -232,6 +264,12 @@ class phir_gaussian : public phi_BC{
 private:
 	std::vector<double> n,d,t,alpha,epsilon,beta,gamma;
 	unsigned int iStart,iEnd;
+	/// Rows of the packed coefficients, each row holds one coefficient for the terms iStart to iEnd
+	enum packed_rows {PACKED_N, PACKED_D, PACKED_T, PACKED_ALPHA, PACKED_EPSILON, PACKED_BETA, PACKED_GAMMA, PACKED_NROWS};
+	/// The coefficients packed by cache() for all()
+	std::vector<double> packed;
+	/// Pack the coefficients of the terms iStart to iEnd
+	void cache();
 public:
 	// Default Constructor
 	phir_gaussian(){};
@@ -277,7 +315,10 @@ public:
 	double dDelta2_dTau(double tau, double delta) throw();
 	double dDelta_dTau2(double tau, double delta) throw();
 	double dTau3(double tau, double delta) throw();
-	
+
+	/// Add the sum of the terms and all their derivatives up to max_order (second or third) to derivs.  
+	/// All the derivatives of a term share the same exponential, so this is much faster than calling each of the derivative functions
+	void all(double tau, double delta, HelmholtzDerivatives &derivs, int max_order = 3) throw();
 };
 
 /*!
@@ -326,10 +367,10 @@ public:
 	double dDelta_dTau(double tau, double delta);
 	double dTau2(double tau, double delta);
 	
-	double dDelta3(double tau, double delta){throw ValueError();};
-	double dDelta2_dTau(double tau, double delta){throw ValueError();};
-	double dDelta_dTau2(double tau, double delta){throw ValueError();};
-	double dTau3(double tau, double delta){throw ValueError();};
+	double dDelta3(double /*tau*/, double /*delta*/){throw NotImplementedError("The third derivatives of the GERG-2008 gaussian terms are not implemented");};
+	double dDelta2_dTau(double /*tau*/, double /*delta*/){throw NotImplementedError("The third derivatives of the GERG-2008 gaussian terms are not implemented");};
+	double dDelta_dTau2(double /*tau*/, double /*delta*/){throw NotImplementedError("The third derivatives of the GERG-2008 gaussian terms are not implemented");};
+	double dTau3(double /*tau*/, double /*delta*/){throw NotImplementedError("The third derivatives of the GERG-2008 gaussian terms are not implemented");};
 };
 
 /*!
@@ -649,6 +690,8 @@ public:
 	double dDelta_dTau(double tau, double delta){return 0.0;};
 	double dDelta_dTau2(double tau, double delta){return 0.0;};
 	double dDelta3(double tau, double delta){return 0;};
+	/// All the derivatives share the same exponential
+	void all(double tau, double delta, HelmholtzDerivatives &derivs, int max_order = 3);
 };
 
 class phi0_Planck_Einstein2 : public phi_BC{
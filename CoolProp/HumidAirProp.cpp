@@ -16,18 +16,20 @@
 #include "HumidAirProp.h"
 #include "Solvers.h"
 #include "CoolPropTools.h"
+#include "Chebyshev.h"
 
 #include "purefluids/Water.h"
 #include "pseudopurefluids/Air.h"
 
-static WaterClass Water = WaterClass();
-static AirClass Air = AirClass();
+static WaterClass Water;
+static AirClass Air;
 
 enum givens{GIVEN_TDP,GIVEN_HUMRAT,GIVEN_V,GIVEN_TWB,GIVEN_RH,GIVEN_ENTHALPY,GIVEN_T,GIVEN_P,GIVEN_VISC,GIVEN_COND};
+enum outputs{OUTPUT_VDA,OUTPUT_VHA,OUTPUT_Y,OUTPUT_HDA,OUTPUT_HHA,OUTPUT_S,OUTPUT_CP,OUTPUT_CPHA,OUTPUT_TDP,OUTPUT_TWB,OUTPUT_HUMRAT,OUTPUT_RH,OUTPUT_VISC,OUTPUT_COND,OUTPUT_T};
 
 static const char ITc='B';
 static double epsilon=0.621945,R_bar=8.314472;
-static int FlagUseVirialCorrelations=0,FlagUseIsothermCompressCorrelation=0,FlagUseIdealGasEnthalpyCorrelations=0;
+static int FlagUseVirialCorrelations=0,FlagUseIsothermCompressCorrelation=0,FlagUseIdealGasEnthalpyCorrelations=0,FlagUseTabulatedTerms=0;
 double f_factor(double T, double p);
 
 // A couple of convenience functions that are needed quite a lot
@@ -105,89 +107,22 @@ void UseIdealGasEnthalpyCorrelations(int flag)
         printf("UseIdealGasEnthalpyCorrelations takes an integer, either 0 (no) or 1 (yes)\n");
     }
 }
-static double Brent_HAProps_T(char *OutputName, char *Input1Name, double Input1, char *Input2Name, double Input2, double TargetVal, double T_min, double T_max)
+void UseTabulatedTerms(int flag)
 {
-    double T;
-    class BrentSolverResids : public FuncWrapper1D
+    if (flag==0 || flag==1)
     {
-    private:
-        double Input1,Input2,TargetVal;
-        char *OutputName,*Input1Name,*Input2Name;
-    public:
-        double rhoL, rhoV;
-        BrentSolverResids(char *OutputName, char *Input1Name, double Input1, char *Input2Name, double Input2, double TargetVal)
-        {
-            this->OutputName = OutputName;
-            this->Input1Name = Input1Name;
-            this->Input2Name = Input2Name;
-            this->Input1 = Input1;
-            this->Input2 = Input2;
-            this->TargetVal = TargetVal;
-        };
-        ~BrentSolverResids(){};
-        
-        double call(double T){
-            return HAProps(OutputName,(char *)"T",T,Input1Name,Input1,Input2Name,Input2)-TargetVal;
-        }
-    };
-
-    BrentSolverResids *BSR = new BrentSolverResids(OutputName, Input1Name, Input1, Input2Name, Input2, TargetVal);
-
-    std::string errstr;
-    T = Brent(BSR,T_min,T_max,1e-7,1e-4,50,&errstr);
-
-    delete BSR;
-    return T;
-}
-
-static double Secant_HAProps_T(char *OutputName, char *Input1Name, double Input1, char *Input2Name, double Input2, double TargetVal, double T_guess)
-{
-    // Use a secant solve in order to yield a target output value for HAProps by altering T
-    double x1=0,x2=0,x3=0,y1=0,y2=0,eps=5e-7,f=999,T=300,change;
-    int iter=1;
-
-    while ((iter<=3 || (fabs(f)>eps && fabs(change)>1e-10)) && iter<100)
+        FlagUseTabulatedTerms=flag;
+    }        
+    else
     {
-        if (iter==1){x1=T_guess; T=x1;}
-        if (iter==2){x2=T_guess+0.001; T=x2;}
-        if (iter>2) {T=x2;}
-            f=HAProps(OutputName,(char *)"T",T,Input1Name,Input1,Input2Name,Input2)-TargetVal;
-        if (iter==1){y1=f;}
-        if (iter>1)
-        {
-            y2=f;
-            x3=x2-y2/(y2-y1)*(x2-x1);
-            change = y2/(y2-y1)*(x2-x1);
-            y1=y2; x1=x2; x2=x3;
-        }
-        iter=iter+1;
+        printf("UseTabulatedTerms takes an integer, either 0 (no) or 1 (yes)\n");
     }
-    return T;
-}
-
-static double Secant_HAProps_W(const char *OutputName, const char *Input1Name, double Input1, const char *Input2Name, double Input2, double TargetVal, double W_guess)
-{
-    // Use a secant solve in order to yield a target output value for HAProps by altering humidity ratio
-    double x1=0,x2=0,x3=0,y1=0,y2=0,eps=1e-8,f=999,W=0.0001;
-    int iter=1;
-
-    while ((iter<=3 || fabs(f)>eps) && iter<100)
-    {
-        if (iter == 1){x1 = W_guess; W = x1;}
-        if (iter == 2){x2 = W_guess+0.001; W = x2;}
-        if (iter > 2) {W = x2;}
-            f = HAProps(OutputName,(char *)"W",W,Input1Name,Input1,Input2Name,Input2)-TargetVal;
-        if (iter == 1){y1 = f;}
-        if (iter > 1)
-        {
-            y2=f;
-            x3=x2-y2/(y2-y1)*(x2-x1);
-            y1=y2; x1=x2; x2=x3;
-        }
-        iter=iter+1;
-    }
-    return W;
 }
+class HumidAirTerms;
+struct HAPropsInputs;
+static double f_factor(double T, double p, HumidAirTerms &terms);
+static double HenryConstant(double T);
+static double HAProps_nothrow(const HAPropsInputs &in, const double *vals, HumidAirTerms &terms);
 
 // Mixed virial components
 static double _B_aw(double T)
@@ -261,65 +196,250 @@ static double _dC_aww_dT(double T)
 }
 
 
-static double B_m(double T, double psi_w)
+/// Piecewise Chebyshev expansions in temperature of the terms of the model that take the bulk of the time of a state
+/// point, which replace the full equations of state in the fast mode (see UseTabulatedTerms):
+///
+/// - the second and third virial coefficients of dry air and water and their temperature derivatives, from 143.15 K
+///   to 623.15 K.  Only used if the virial correlations are not (see UseVirialCorrelations)
+/// - the saturation pressure, saturated liquid molar volume, isothermal compressibility and Henry constant of water,
+///   which are needed for the enhancement factor and the relative humidity, and the enthalpy of liquid water, which is
+///   needed for the wetbulb temperature, from 273.16 K to 623.15 K
+///
+/// The expansions reproduce the full equations to within a relative error of 1e-10.  The isothermal compressibility and
+/// enthalpy of liquid water at the total pressure are extrapolated from saturation with their first derivatives with
+/// respect to pressure.
+/// Outside of these ranges the full equations are used.  The expansions are built on first use, which takes a fraction
+/// of a second.
+class HumidAirTableClass
 {
-    // Bm has units of m^3/mol
-    double Tj,tau_Air,tau_Water,B_aa,B_ww,B_aw;
-    // NDG for fluid EOS for virial terms
-    Tj=132.6312;
-    tau_Air=Tj/T;
-    tau_Water=Water.reduce.T/T;
-    if (FlagUseVirialCorrelations==1)
+public:
+    HumidAirTableClass(){built = false;};
+    /// B_aa, B_ww [m^3/mol], C_aaa, C_www [m^6/mol^2].  Returns false if T is not covered
+    bool virials(double T, double *BC){ return evaluate(virial_curves, T, 0, BC); };
+    /// The derivatives with respect to temperature of B_aa, B_ww [m^3/mol/K], C_aaa, C_www [m^6/mol^2/K].  Returns false if T is not covered
+    bool virials_dT(double T, double *dBC){ return evaluate(virial_curves, T, 4, dBC); };
+    /// Saturation pressure of water [Pa].  Returns false if T is not covered
+    bool p_ws(double T, double &p_ws);
+    /// Saturation temperature of water [K] at the pressure p_ws [Pa].  Returns false if p_ws is not covered
+    bool T_ws(double p_ws, double &T);
+    /// Saturation pressure [Pa], saturated liquid molar volume [m^3/mol], isothermal compressibility of the liquid at
+    /// the pressure p [Pa] in [1/Pa] and Henry constant [1/Pa] of water.  Returns false if T is not covered
+    bool water(double T, double p, double &p_ws, double &vbar_ws, double &k_T, double &beta_H);
+    /// Enthalpy of liquid water [kJ/kg] at T and the pressure p [kPa].  Returns false if T is not covered, or if
+    /// water is not liquid at p
+    bool h_w(double T, double p, double &h);
+private:
+    PiecewiseChebyshevClass virial_curves; ///< 1e6*B_aa, 1e6*B_ww, 1e12*C_aaa, 1e12*C_www and their derivatives, as functions of T
+    PiecewiseChebyshevClass water_curves; ///< ln(p_ws), ln(vbar_ws), ln(k_T), ln(beta_H), 1e9*dln(k_T)/dp, h_L, 1e3*(dh/dp)_T, as functions of T
+    CoolPropAtomicBool built;
+    CoolPropMutex build_lock; ///< Held while the expansions are being built
+    void build();
+    bool evaluate(PiecewiseChebyshevClass &curves, double T, int k0, double *y);
+};
+
+/// The pure virial coefficients in cm^3/mol and cm^6/mol^2, so that they are of order unity or larger
+class HumidAirVirialFunction : public ChebyshevFunction
+{
+public:
+    void call(double T, std::vector<double> &y)
+    {
+        y.resize(8);
+        y[0] = B_Air(T)*MM_Air()*1e3;
+        y[1] = B_Water(T)*MM_Water()*1e3;
+        y[2] = C_Air(T)*MM_Air()*MM_Air()*1e6;
+        y[3] = C_Water(T)*MM_Water()*MM_Water()*1e6;
+        y[4] = dBdT_Air(T)*MM_Air()*1e3;
+        y[5] = dBdT_Water(T)*MM_Water()*1e3;
+        y[6] = dCdT_Air(T)*MM_Air()*MM_Air()*1e6;
+        y[7] = dCdT_Water(T)*MM_Water()*MM_Water()*1e6;
+    };
+};
+
+class HumidAirWaterFunction : public ChebyshevFunction
+{
+public:
+    void call(double T, std::vector<double> &y)
+    {
+        y.resize(7);
+        double rhoL = Props("D","T",T,"Q",0,"Water");
+        double k_T = DerivTerms((char *)"IsothermalCompressibility",T,rhoL,(char *)"Water")/1000; //[1/Pa]
+        y[0] = log(PropsSI("P","T",T,"Q",0,"Water"));
+        y[1] = log(1.0/rhoL*MM_Water()/1000);
+        y[2] = log(k_T);
+        y[3] = log(HenryConstant(T));
+        // With k_T = 1/(rho*R*T*A) and A = 1+2*delta*dphir_dDelta+delta^2*d2phir_dDelta2, 
+        // dln(k_T)/dp = -k_T*(1+delta/A*dA/ddelta)
+        double tau = Water.crit.T/T, delta = rhoL/Water.crit.rho;
+        double dphir_dDelta = Water.dphir_dDelta(tau,delta), d2phir_dDelta2 = Water.d2phir_dDelta2(tau,delta);
+        double A = 1+2*delta*dphir_dDelta+delta*delta*d2phir_dDelta2;
+        double dA_dDelta = 2*dphir_dDelta+4*delta*d2phir_dDelta2+delta*delta*Water.d3phir_dDelta3(tau,delta);
+        y[4] = -k_T*(1+delta/A*dA_dDelta)*1e9;
+        // (dh/dp)_T = (dh/drho)_T/(dp/drho)_T [m^3/kg = kJ/kg/kPa]
+        y[5] = Props("H","T",T,"Q",0,"Water");
+        y[6] = (tau*Water.d2phir_dDelta_dTau(tau,delta)+dphir_dDelta+delta*d2phir_dDelta2)/(Water.crit.rho*A)*1e3;
+    };
+};
+
+void HumidAirTableClass::build()
+{
+    // Only one thread builds the expansions, the others wait here and then find them built
+    CoolPropLockGuard guard(build_lock);
+    if (built){ return; }
+    HumidAirVirialFunction virial_function;
+    HumidAirWaterFunction water_function;
+    virial_curves.build(virial_function, 8, 143.15, 623.15, 12, 1e-10, 10);
+    water_curves.build(water_function, 7, 273.16, 623.15, 12, 1e-10, 10);
+    built = true;
+}
+
+bool HumidAirTableClass::evaluate(PiecewiseChebyshevClass &curves, double T, int k0, double *y)
+{
+    if (!built){ build(); }
+    int i = curves.interval(T);
+    if (i < 0){ return false; }
+    y[0] = curves.evaluate(i,k0,T)/1e6;
+    y[1] = curves.evaluate(i,k0+1,T)/1e6;
+    y[2] = curves.evaluate(i,k0+2,T)/1e12;
+    y[3] = curves.evaluate(i,k0+3,T)/1e12;
+    return true;
+}
+
+bool HumidAirTableClass::p_ws(double T, double &p_ws)
+{
+    if (!built){ build(); }
+    int i = water_curves.interval(T);
+    if (i < 0){ return false; }
+    p_ws = exp(water_curves.evaluate(i,0,T));
+    return true;
+}
+
+bool HumidAirTableClass::T_ws(double p_ws, double &T)
+{
+    if (!built){ build(); }
+    int i;
+    return water_curves.solve(0, log(p_ws), T, i);
+}
+
+bool HumidAirTableClass::water(double T, double p, double &p_ws, double &vbar_ws, double &k_T, double &beta_H)
+{
+    if (!built){ build(); }
+    int i = water_curves.interval(T);
+    if (i < 0){ return false; }
+    p_ws = exp(water_curves.evaluate(i,0,T));
+    vbar_ws = exp(water_curves.evaluate(i,1,T));
+    k_T = exp(water_curves.evaluate(i,2,T)+water_curves.evaluate(i,4,T)/1e9*(p-p_ws));
+    beta_H = exp(water_curves.evaluate(i,3,T));
+    return true;
+}
+
+bool HumidAirTableClass::h_w(double T, double p, double &h)
+{
+    if (!built){ build(); }
+    int i = water_curves.interval(T);
+    if (i < 0){ return false; }
+    double p_ws = exp(water_curves.evaluate(i,0,T))/1000; //[kPa]
+    if (p < p_ws){ return false; }
+    h = water_curves.evaluate(i,5,T)+water_curves.evaluate(i,6,T)/1e3*(p-p_ws);
+    return true;
+}
+
+static HumidAirTableClass HumidAirTable;
+
+/// Saturation pressure of water over liquid water [kPa], from the expansions in the fast mode
+static double SaturationPressureWater(double T)
+{
+    double p_ws;
+    if (FlagUseTabulatedTerms && HumidAirTable.p_ws(T, p_ws))
     {
-        B_aa=-0.000721183853646 +1.142682674467e-05*T -8.838228412173e-08*pow(T,2) 
-        +4.104150642775e-10*pow(T,3) -1.192780880645e-12*pow(T,4) +2.134201312070e-15*pow(T,5) 
-        -2.157430412913e-18*pow(T,6) +9.453830907795e-22*pow(T,7);
-        B_ww=-10.8963128394 +2.439761625859e-01*T -2.353884845100e-03*pow(T,2) 
-        +1.265864734412e-05*pow(T,3) -4.092175700300e-08*pow(T,4) +7.943925411344e-11*pow(T,5) 
-        -8.567808759123e-14*pow(T,6) +3.958203548563e-17*pow(T,7);
+        return p_ws/1000;
     }
-    else
+    return Props("P","T",T,"Q",0,"Water");
+}
+
+/// Saturation temperature of water [K] at the pressure p [kPa], from the expansions in the fast mode
+static double SaturationTemperatureWater(double p)
+{
+    double T;
+    if (FlagUseTabulatedTerms && HumidAirTable.T_ws(p*1000, T))
     {
-        B_aa=B_Air(T)*MM_Air()/1e3; //[m^3/kg] to [m^3/mol]
-        B_ww=B_Water(T)*MM_Water()/1e3; //[m^3/kg] to [m^3/mol]
+        return T;
     }
-    
-    B_aw=_B_aw(T)/1e3; //[dm^3/mol] to [m^3/mol]
-    return pow(1-psi_w,2)*B_aa+2*(1-psi_w)*psi_w*B_aw+psi_w*psi_w*B_ww;
+    return Props("T","P",p,"Q",1.0,"Water");
 }
 
-static double dB_m_dT(double T, double psi_w)
+/// The terms of the model that only depend on temperature, or on temperature and pressure: the virial coefficients
+/// of dry air and water and the cross coefficients, from which the mixture coefficients follow for any mole fraction
+/// of water, the saturation pressure of water and the enhancement factor.  They are only recomputed when the
+/// temperature (or the pressure) changes, so that all the properties of one state point, or of state points at the
+/// same temperature, share them
+class HumidAirTerms
 {
-    //dBm_dT has units of m^3/mol/K
-    double Tj,tau_Air,tau_Water,dB_dT_aa,dB_dT_ww,dB_dT_aw;
-    // NDG for fluid EOS for virial terms
-    Tj=132.6312;
-    tau_Air=Tj/T;
-    tau_Water=Water.reduce.T/T;
-    if (FlagUseVirialCorrelations)
+public:
+    HumidAirTerms(){T = -1; T_dT = -1; T_ws = -1; T_f = -1; p_f = -1;};
+    /// Mixture second virial coefficient [m^3/mol]
+    double B_m(double T, double psi_w)
     {
-        dB_dT_aa=1.65159324353e-05 -3.026130954749e-07*T +2.558323847166e-09*pow(T,2) -1.250695660784e-11*pow(T,3) +3.759401946106e-14*pow(T,4) -6.889086380822e-17*pow(T,5) +7.089457032972e-20*pow(T,6) -3.149942145971e-23*pow(T,7);
-        dB_dT_ww=0.65615868848 -1.487953162679e-02*T +1.450134660689e-04*pow(T,2) -7.863187630094e-07*pow(T,3) +2.559556607010e-09*pow(T,4) -4.997942221914e-12*pow(T,5) +5.417678681513e-15*pow(T,6) -2.513856275241e-18*pow(T,7);
-    }
-    else
+        update(T);
+        return pow(1-psi_w,2)*B_aa+2*(1-psi_w)*psi_w*B_aw+psi_w*psi_w*B_ww;
+    };
+    /// Temperature derivative of the mixture second virial coefficient [m^3/mol/K]
+    double dB_m_dT(double T, double psi_w)
     {
-        dB_dT_aa=dBdT_Air(T)*MM_Air()/1e3; //[m^3/kg] to [m^3/mol]
-        dB_dT_ww=dBdT_Water(T)*MM_Water()/1e3; //[m^3/kg] to [m^3/mol]
-    }
-        dB_dT_aw=_dB_aw_dT(T)/1e3; //[dm^3/mol] to [m^3/mol]
-    return pow(1-psi_w,2)*dB_dT_aa+2*(1-psi_w)*psi_w*dB_dT_aw+psi_w*psi_w*dB_dT_ww;
-}
+        update_dT(T);
+        return pow(1-psi_w,2)*dB_dT_aa+2*(1-psi_w)*psi_w*dB_dT_aw+psi_w*psi_w*dB_dT_ww;
+    };
+    /// Mixture third virial coefficient [m^6/mol^2]
+    double C_m(double T, double psi_w)
+    {
+        update(T);
+        return pow(1-psi_w,3)*C_aaa+3*pow(1-psi_w,2)*psi_w*C_aaw+3*(1-psi_w)*psi_w*psi_w*C_aww+pow(psi_w,3)*C_www;
+    };
+    /// Temperature derivative of the mixture third virial coefficient [m^6/mol^2/K]
+    double dC_m_dT(double T, double psi_w)
+    {
+        update_dT(T);
+        return pow(1-psi_w,3)*dC_dT_aaa+3*pow(1-psi_w,2)*psi_w*dC_dT_aaw+3*(1-psi_w)*psi_w*psi_w*dC_dT_aww+pow(psi_w,3)*dC_dT_www;
+    };
+    /// Saturation pressure of water over liquid water, or sublimation pressure over ice below the triple point [kPa]
+    double p_ws(double T)
+    {
+        if (T != T_ws)
+        {
+            _p_ws = (T>=273.16) ? SaturationPressureWater(T) : psub_Ice(T);
+            T_ws = T;
+        }
+        return _p_ws;
+    };
+    /// Enhancement factor [-]
+    double f(double T, double p)
+    {
+        if (T != T_f || p != p_f)
+        {
+            _f = f_factor(T,p,*this);
+            T_f = T; p_f = p;
+        }
+        return _f;
+    };
+private:
+    double T, B_aa, B_ww, B_aw, C_aaa, C_www, C_aaw, C_aww;
+    double T_dT, dB_dT_aa, dB_dT_ww, dB_dT_aw, dC_dT_aaa, dC_dT_www, dC_dT_aaw, dC_dT_aww;
+    double T_ws, _p_ws, T_f, p_f, _f;
+    void update(double T);
+    void update_dT(double T);
+    friend double f_factor(double T, double p, HumidAirTerms &terms);
+};
 
-static double C_m(double T, double psi_w)
+void HumidAirTerms::update(double T)
 {
-    // Cm has units of m^6/mol^2
-    double Tj,tau_Air,tau_Water,C_aaa,C_www,C_aww,C_aaw;
-    // NDG for fluid EOS for virial terms
-    Tj=132.6312;
-    tau_Air=Tj/T;
-    tau_Water=Water.reduce.T/T;
-    if (FlagUseVirialCorrelations)
+    if (T == this->T){ return; }
+    if (FlagUseVirialCorrelations==1)
     {
+        B_aa=-0.000721183853646 +1.142682674467e-05*T -8.838228412173e-08*pow(T,2) 
+        +4.104150642775e-10*pow(T,3) -1.192780880645e-12*pow(T,4) +2.134201312070e-15*pow(T,5) 
+        -2.157430412913e-18*pow(T,6) +9.453830907795e-22*pow(T,7);
+        B_ww=-10.8963128394 +2.439761625859e-01*T -2.353884845100e-03*pow(T,2) 
+        +1.265864734412e-05*pow(T,3) -4.092175700300e-08*pow(T,4) +7.943925411344e-11*pow(T,5) 
+        -8.567808759123e-14*pow(T,6) +3.958203548563e-17*pow(T,7);
         C_aaa=1.29192158975e-08 -1.776054020409e-10*T +1.359641176409e-12*pow(T,2) 
         -6.234878717893e-15*pow(T,3) +1.791668730770e-17*pow(T,4) -3.175283581294e-20*pow(T,5) 
         +3.184306136120e-23*pow(T,6) -1.386043640106e-26*pow(T,7);
@@ -329,37 +449,80 @@ static double C_m(double T, double psi_w)
     }
     else
     {
-        C_aaa=C_Air(T)*MM_Air()*MM_Air()/1e6; //[m^6/kg^2] to [m^6/mol^2]
-        C_www=C_Water(T)*MM_Water()*MM_Water()/1e6; //[m^6/kg^2] to [m^6/mol^2]
+        double BC[4];
+        if (FlagUseTabulatedTerms && HumidAirTable.virials(T, BC))
+        {
+            B_aa=BC[0]; B_ww=BC[1]; C_aaa=BC[2]; C_www=BC[3];
+        }
+        else
+        {
+            B_aa=B_Air(T)*MM_Air()/1e3; //[m^3/kg] to [m^3/mol]
+            B_ww=B_Water(T)*MM_Water()/1e3; //[m^3/kg] to [m^3/mol]
+            C_aaa=C_Air(T)*MM_Air()*MM_Air()/1e6; //[m^6/kg^2] to [m^6/mol^2]
+            C_www=C_Water(T)*MM_Water()*MM_Water()/1e6; //[m^6/kg^2] to [m^6/mol^2]
+        }
     }
+    B_aw=_B_aw(T)/1e3; //[dm^3/mol] to [m^3/mol]
     C_aaw=_C_aaw(T)/1e6; //[dm^6/mol] to [m^6/mol^2]
     C_aww=_C_aww(T)/1e6; //[dm^6/mol] to [m^6/mol^2]
-    return pow(1-psi_w,3)*C_aaa+3*pow(1-psi_w,2)*psi_w*C_aaw+3*(1-psi_w)*psi_w*psi_w*C_aww+pow(psi_w,3)*C_www;
+    this->T = T;
 }
 
-static double dC_m_dT(double T, double psi_w)
+void HumidAirTerms::update_dT(double T)
 {
-    // dCm_dT has units of m^6/mol^2/K
-    
-    double Tj,tau_Air,tau_Water,dC_dT_aaa,dC_dT_www,dC_dT_aww,dC_dT_aaw;
-    // NDG for fluid EOS for virial terms
-    Tj=132.6312;
-    tau_Air=Tj/T;
-    tau_Water=Water.reduce.T/T;
+    if (T == this->T_dT){ return; }
     if (FlagUseVirialCorrelations)
     {
+        dB_dT_aa=1.65159324353e-05 -3.026130954749e-07*T +2.558323847166e-09*pow(T,2) -1.250695660784e-11*pow(T,3) +3.759401946106e-14*pow(T,4) -6.889086380822e-17*pow(T,5) +7.089457032972e-20*pow(T,6) -3.149942145971e-23*pow(T,7);
+        dB_dT_ww=0.65615868848 -1.487953162679e-02*T +1.450134660689e-04*pow(T,2) -7.863187630094e-07*pow(T,3) +2.559556607010e-09*pow(T,4) -4.997942221914e-12*pow(T,5) +5.417678681513e-15*pow(T,6) -2.513856275241e-18*pow(T,7);
         dC_dT_aaa=-2.46582342273e-10 +4.425401935447e-12*T -3.669987371644e-14*pow(T,2) +1.765891183964e-16*pow(T,3) -5.240097805744e-19*pow(T,4) +9.502177003614e-22*pow(T,5) -9.694252610339e-25*pow(T,6) +4.276261986741e-28*pow(T,7);
         dC_dT_www=0.0984601196142 -2.356713397262e-03*T +2.409113323685e-05*pow(T,2) -1.363083778715e-07*pow(T,3) +4.609623799524e-10*pow(T,4) -9.316416405390e-13*pow(T,5) +1.041909136255e-15*pow(T,6) -4.973918480607e-19*pow(T,7);
     }
     else
     {
-        dC_dT_aaa=dCdT_Air(T)*MM_Air()*MM_Air()/1e6; //[m^6/kg^2] to [m^6/mol^2]
-        dC_dT_www=dCdT_Water(T)*MM_Water()*MM_Water()/1e6; //[m^6/kg^2] to [m^6/mol^2]
+        double dBC[4];
+        if (FlagUseTabulatedTerms && HumidAirTable.virials_dT(T, dBC))
+        {
+            dB_dT_aa=dBC[0]; dB_dT_ww=dBC[1]; dC_dT_aaa=dBC[2]; dC_dT_www=dBC[3];
+        }
+        else
+        {
+            dB_dT_aa=dBdT_Air(T)*MM_Air()/1e3; //[m^3/kg] to [m^3/mol]
+            dB_dT_ww=dBdT_Water(T)*MM_Water()/1e3; //[m^3/kg] to [m^3/mol]
+            dC_dT_aaa=dCdT_Air(T)*MM_Air()*MM_Air()/1e6; //[m^6/kg^2] to [m^6/mol^2]
+            dC_dT_www=dCdT_Water(T)*MM_Water()*MM_Water()/1e6; //[m^6/kg^2] to [m^6/mol^2]
+        }
     }
+    dB_dT_aw=_dB_aw_dT(T)/1e3; //[dm^3/mol] to [m^3/mol]
     dC_dT_aaw=_dC_aaw_dT(T)/1e6; //[dm^6/mol] to [m^6/mol^2]
     dC_dT_aww=_dC_aww_dT(T)/1e6; //[dm^6/mol] to [m^6/mol^2]
-    return pow(1-psi_w,3)*dC_dT_aaa+3*pow(1-psi_w,2)*psi_w*dC_dT_aaw+3*(1-psi_w)*psi_w*psi_w*dC_dT_aww+pow(psi_w,3)*dC_dT_www;
+    this->T_dT = T;
+}
+
+static double B_m(double T, double psi_w)
+{
+    HumidAirTerms terms;
+    return terms.B_m(T,psi_w);
 }
+static double dB_m_dT(double T, double psi_w)
+{
+    HumidAirTerms terms;
+    return terms.dB_m_dT(T,psi_w);
+}
+static double C_m(double T, double psi_w)
+{
+    HumidAirTerms terms;
+    return terms.C_m(T,psi_w);
+}
+static double dC_m_dT(double T, double psi_w)
+{
+    HumidAirTerms terms;
+    return terms.dC_m_dT(T,psi_w);
+}
+double MolarVolume(double T, double p, double psi_w, HumidAirTerms &terms);
+double MolarEnthalpy(double T, double p, double psi_w, double v_bar, HumidAirTerms &terms);
+double MassEnthalpy(double T, double p, double psi_w, HumidAirTerms &terms);
+double MolarEntropy(double T, double p, double psi_w, double v_bar, HumidAirTerms &terms);
 double HumidityRatio(double psi_w)
 {
     return psi_w*epsilon/(1-psi_w);
@@ -380,6 +543,11 @@ static double HenryConstant(double T)
 }
 
 double f_factor(double T, double p)
+{
+    HumidAirTerms terms;
+    return f_factor(T, p, terms);
+}
+static double f_factor(double T, double p, HumidAirTerms &terms)
 {
     double f=0,Rbar=8.314371,eps=1e-8,Tj;
     double x1=0,x2=0,x3,y1=0,y2,change=_HUGE;
@@ -392,7 +560,16 @@ double f_factor(double T, double p)
     p*=1000;
     
     // Saturation pressure [Pa]
-    if (T>273.16)
+    if (T>273.16 && FlagUseTabulatedTerms && HumidAirTable.water(T,p,p_ws,vbar_ws,k_T,beta_H))
+    {
+        // It is liquid water, from the expansions in the fast mode
+        if (FlagUseIsothermCompressCorrelation)
+        {
+            k_T = 1.6261876614E-22*pow(T,6) - 3.3016385196E-19*pow(T,5) + 2.7978984577E-16*pow(T,4)
+                - 1.2672392901E-13*pow(T,3) + 3.2382864853E-11*pow(T,2) - 4.4318979503E-09*T + 2.5455947289E-07;
+        }
+    }
+    else if (T>273.16)
     {
         // It is liquid water
         p_ws=PropsSI("P","T",T,"Q",0,"Water");
@@ -429,31 +606,10 @@ double f_factor(double T, double p)
     Tj=132.6312;
     tau_Air=Tj/T;
     tau_Water=Water.reduce.T/T;
-    if (FlagUseVirialCorrelations)
-    {
-        B_aa=-0.000721183853646 +1.142682674467e-05*T -8.838228412173e-08*pow(T,2) 
-        +4.104150642775e-10*pow(T,3) -1.192780880645e-12*pow(T,4) +2.134201312070e-15*pow(T,5) 
-        -2.157430412913e-18*pow(T,6) +9.453830907795e-22*pow(T,7);
-        B_ww=-10.8963128394 +2.439761625859e-01*T -2.353884845100e-03*pow(T,2) 
-        +1.265864734412e-05*pow(T,3) -4.092175700300e-08*pow(T,4) +7.943925411344e-11*pow(T,5) 
-        -8.567808759123e-14*pow(T,6) +3.958203548563e-17*pow(T,7);
-        C_aaa=1.29192158975e-08 -1.776054020409e-10*T +1.359641176409e-12*pow(T,2) 
-        -6.234878717893e-15*pow(T,3) +1.791668730770e-17*pow(T,4) -3.175283581294e-20*pow(T,5) 
-        +3.184306136120e-23*pow(T,6) -1.386043640106e-26*pow(T,7);
-        C_www=-0.580595811134 +1.365952762696e-02*T -1.375986293288e-04*pow(T,2) 
-        +7.687692259692e-07*pow(T,3) -2.571440816920e-09*pow(T,4) +5.147432221082e-12*pow(T,5) 
-        -5.708156494894e-15*pow(T,6) +2.704605721778e-18*pow(T,7);
-    }
-    else
-    {
-        B_aa=B_Air(T)*MM_Air()/1e3; //[m^3/kg] to [m^3/mol]
-        C_aaa=C_Air(T)*MM_Air()*MM_Air()/1e6; //[m^6/kg^2] to [m^6/mol^2]
-        B_ww=B_Water(T)*MM_Water()/1e3; //[m^3/kg] to [m^3/mol]
-        C_www=C_Water(T)*MM_Water()*MM_Water()/1e6; //[m^6/kg^2] to [m^6/mol^2]
-    }
-    B_aw=_B_aw(T)/1e3; //[dm^3/mol] to [m^3/mol]
-    C_aaw=_C_aaw(T)/1e6; //[dm^6/mol] to [m^6/mol^2]
-    C_aww=_C_aww(T)/1e6; //[dm^6/mol] to [m^6/mol^2]
+    // The virial coefficients at T, shared with the other properties at T
+    terms.update(T);
+    B_aa=terms.B_aa; B_ww=terms.B_ww; B_aw=terms.B_aw;
+    C_aaa=terms.C_aaa; C_www=terms.C_www; C_aaw=terms.C_aaw; C_aww=terms.C_aww;
     
     // Use a little secant loop to find f iteratively
     // Start out with a guess value of 1 for f
@@ -559,6 +715,11 @@ double Conductivity(double T, double p, double psi_w)
     return (1-psi_w)*k_a/((1-psi_w)+psi_w*Phi_av)+psi_w*k_w/(psi_w+(1-psi_w)*Phi_va);
 }
 double MolarVolume(double T, double p, double psi_w)
+{
+    HumidAirTerms terms;
+    return MolarVolume(T, p, psi_w, terms);
+}
+double MolarVolume(double T, double p, double psi_w, HumidAirTerms &terms)
 {
     // Output in m^3/mol
     int iter;
@@ -572,8 +733,8 @@ double MolarVolume(double T, double p, double psi_w)
     v_bar0=R_bar*T/p/1000;
     
     //Bring outside the loop since not a function of v_bar
-    Bm=B_m(T,psi_w);
-    Cm=C_m(T,psi_w);
+    Bm=terms.B_m(T,psi_w);
+    Cm=terms.C_m(T,psi_w);
 
     iter=1; eps=1e-8; resid=999;
     while ((iter<=3 || fabs(resid)>eps) && iter<100)
@@ -649,6 +810,11 @@ double IdealGasMolarEntropy_Air(double T, double v_bar_a)
 }
 
 double MolarEnthalpy(double T, double p, double psi_w, double v_bar)
+{
+    HumidAirTerms terms;
+    return MolarEnthalpy(T, p, psi_w, v_bar, terms);
+}
+double MolarEnthalpy(double T, double /*p*/, double psi_w, double v_bar, HumidAirTerms &terms)
 {
     // In units of kJ/kmol
     
@@ -673,19 +839,29 @@ double MolarEnthalpy(double T, double p, double psi_w, double v_bar)
     hbar_a=IdealGasMolarEnthalpy_Air(T,v_bar);
     }
     
-    hbar=hbar_0+(1-psi_w)*hbar_a+psi_w*hbar_w+R_bar*T*((B_m(T,psi_w)-T*dB_m_dT(T,psi_w))/v_bar+(C_m(T,psi_w)-T/2.0*dC_m_dT(T,psi_w))/(v_bar*v_bar));
+    hbar=hbar_0+(1-psi_w)*hbar_a+psi_w*hbar_w+R_bar*T*((terms.B_m(T,psi_w)-T*terms.dB_m_dT(T,psi_w))/v_bar+(terms.C_m(T,psi_w)-T/2.0*terms.dC_m_dT(T,psi_w))/(v_bar*v_bar));
     return hbar; //[kJ/kmol]
 }
 double MassEnthalpy(double T, double p, double psi_w)
 {
-    double v_bar = MolarVolume(T, p, psi_w); //[m^3/mol_ha]
-    double h_bar = MolarEnthalpy(T, p, psi_w, v_bar); //[kJ/kmol_ha]
+    HumidAirTerms terms;
+    return MassEnthalpy(T, p, psi_w, terms);
+}
+double MassEnthalpy(double T, double p, double psi_w, HumidAirTerms &terms)
+{
+    double v_bar = MolarVolume(T, p, psi_w, terms); //[m^3/mol_ha]
+    double h_bar = MolarEnthalpy(T, p, psi_w, v_bar, terms); //[kJ/kmol_ha]
     double W = HumidityRatio(psi_w); //[kg_w/kg_da]
     double M_ha = MM_Water()*psi_w+(1-psi_w)*28.966;
     return h_bar*(1+W)/M_ha; //[kJ/kg_da]
 }
 
 double MolarEntropy(double T, double p, double psi_w, double v_bar)
+{
+    HumidAirTerms terms;
+    return MolarEntropy(T, p, psi_w, v_bar, terms);
+}
+double MolarEntropy(double T, double p, double psi_w, double v_bar, HumidAirTerms &terms)
 {
     // In units of kJ/kmol/K
 
@@ -702,12 +878,12 @@ double MolarEntropy(double T, double p, double psi_w, double v_bar)
 
     //Calculate vbar_a, the molar volume of dry air
     // B_m, C_m, etc. functions take care of the units
-    Baa = B_m(T,0); 
-    B = B_m(T,psi_w);
-    dBdT = dB_m_dT(T,psi_w);
-    Caaa = C_m(T,0);
-    C = C_m(T,psi_w);
-    dCdT = dC_m_dT(T,psi_w);
+    Baa = terms.B_m(T,0); 
+    B = terms.B_m(T,psi_w);
+    dBdT = terms.dB_m_dT(T,psi_w);
+    Caaa = terms.C_m(T,0);
+    C = terms.C_m(T,psi_w);
+    dCdT = terms.dC_m_dT(T,psi_w);
 
     vbar_a_guess = R_bar_Lem*T/p; //[m^3/mol] since p in [kPa]
     
@@ -771,7 +947,7 @@ double DewpointTemperature(double T, double p, double psi_w)
 
     // 0.61165... is the triple point pressure of water in kPa
     if (p_w > 0.6116547241637944){
-        T0 = Props("T","P",p_w,"Q",1.0,"Water");
+        T0 = SaturationTemperatureWater(p_w);
     }
     else{
         T0 = 268;
@@ -789,7 +965,7 @@ double DewpointTemperature(double T, double p, double psi_w)
             if (Tdp >= 273.16)
             {
                 // Saturation pressure at dewpoint [kPa]
-                p_ws_dp=Props("P","T",Tdp,"Q",0,"Water");
+                p_ws_dp=SaturationPressureWater(Tdp);
             }
             else
             {
@@ -817,6 +993,7 @@ class WetBulbSolver : public FuncWrapper1D
 {
 private:
     double _T,_p,_W,LHS,v_bar_w,M_ha;
+    HumidAirTerms terms_wb; ///< The terms at the wetbulb temperature, shared by its enhancement factor, molar volume and enthalpy
 public:
     WetBulbSolver(double T, double p, double psi_w){
         _T = T;
@@ -824,9 +1001,10 @@ public:
         _W = epsilon*psi_w/(1-psi_w);
 
         //These things are all not a function of Twb
-        v_bar_w = MolarVolume(T,p,psi_w);
+        HumidAirTerms terms;
+        v_bar_w = MolarVolume(T,p,psi_w,terms);
         M_ha = MM_Water()*psi_w+(1-psi_w)*28.966;
-        LHS = MolarEnthalpy(T,p,psi_w,v_bar_w)*(1+_W)/M_ha;
+        LHS = MolarEnthalpy(T,p,psi_w,v_bar_w,terms)*(1+_W)/M_ha;
     };
     ~WetBulbSolver(){};
     double call(double Twb)
@@ -835,11 +1013,11 @@ public:
         double f_wb,p_ws_wb,p_s_wb,W_s_wb,h_w,M_ha_wb,psi_wb,v_bar_wb;
 
         // Enhancement Factor at wetbulb temperature [-]
-        f_wb=f_factor(Twb,_p);
+        f_wb=terms_wb.f(Twb,_p);
         if (Twb > 273.16)
         {
             // Saturation pressure at wetbulb temperature [kPa]
-            p_ws_wb=Props("P","T",Twb,"Q",0,"Water");
+            p_ws_wb=SaturationPressureWater(Twb);
         }
         else
         {
@@ -856,7 +1034,10 @@ public:
         if (Twb > 273.16)
         {
             // Enthalpy of water [kJ/kg_water]
-            h_w=Props("H","T",Twb,"P",_p,"Water");
+            if (!FlagUseTabulatedTerms || !HumidAirTable.h_w(Twb,_p,h_w))
+            {
+                h_w=Props("H","T",Twb,"P",_p,"Water");
+            }
         }
         else
         {
@@ -866,8 +1047,8 @@ public:
         // Mole masses of wetbulb and humid air
         
         M_ha_wb=MM_Water()*psi_wb+(1-psi_wb)*28.966;
-        v_bar_wb=MolarVolume(Twb,_p,psi_wb);
-        double RHS = (MolarEnthalpy(Twb,_p,psi_wb,v_bar_wb)*(1+W_s_wb)/M_ha_wb+(_W-W_s_wb)*h_w);
+        v_bar_wb=MolarVolume(Twb,_p,psi_wb,terms_wb);
+        double RHS = (MolarEnthalpy(Twb,_p,psi_wb,v_bar_wb,terms_wb)*(1+W_s_wb)/M_ha_wb+(_W-W_s_wb)*h_w);
         if (!ValidNumber(LHS-RHS)){throw ValueError();}
         return LHS - RHS;
     }
@@ -904,7 +1085,7 @@ double WetbulbTemperature(double T, double p, double psi_w)
     // If the temperature is above the saturation temperature corresponding to the atmospheric pressure,
     // then the maximum value for the wetbulb temperature is the saturation temperature
     double Tmax = T;
-    double Tsat = Props("T","P",p,"Q",1.0,"Water");
+    double Tsat = SaturationTemperatureWater(p);
     if (T >= Tsat)
     {
         Tmax = Tsat;
@@ -969,19 +1150,13 @@ static int Name2Type(const char *Name)
         printf("Sorry, your input [%s] was not understood to Name2Type in HumAir.c. Acceptable values are T,P,R,W,D,B,H,M,K and aliases thereof\n",Name);
         return -1;
 }
-int TypeMatch(int TypeCode, const char *Input1Name, const char *Input2Name, const char *Input3Name)
+static double MoleFractionWater(double T, double p, int HumInput, double InVal, HumidAirTerms &terms);
+double MoleFractionWater(double T, double p, int HumInput, double InVal)
 {
-    // Return the index of the input variable that matches the input, otherwise return -1 for failure
-    if (TypeCode==Name2Type(Input1Name))
-        return 1;
-    if (TypeCode==Name2Type(Input2Name))
-        return 2;
-    if (TypeCode==Name2Type(Input3Name))
-        return 3;
-    else
-        return -1;
+    HumidAirTerms terms;
+    return MoleFractionWater(T, p, HumInput, InVal, terms);
 }
-double MoleFractionWater(double T, double p, int HumInput, double InVal)
+static double MoleFractionWater(double T, double p, int HumInput, double InVal, HumidAirTerms &terms)
 {
     double p_ws,f,W,epsilon=0.621945,Tdp,p_ws_dp,f_dp,p_w_dp,p_s,RH;
     
@@ -992,19 +1167,10 @@ double MoleFractionWater(double T, double p, int HumInput, double InVal)
     }
     else if (HumInput==GIVEN_RH)
     {
-        if (T>=273.16)
-        {
-            // Saturation pressure [kPa]
-            p_ws=Props("P","T",T,"Q",0,"Water");
-        }
-        else
-        {
-            // Sublimation pressure [kPa]
-            p_ws=psub_Ice(T);
-            
-        }
+        // Saturation pressure, or sublimation pressure below the triple point [kPa]
+        p_ws=terms.p_ws(T);
         // Enhancement Factor [-]
-        f=f_factor(T,p);
+        f=terms.f(T,p);
 
         // Saturation pressure [kPa]
         p_s=f*p_ws;
@@ -1018,7 +1184,7 @@ double MoleFractionWater(double T, double p, int HumInput, double InVal)
         // Saturation pressure at dewpoint [kPa]
         if (Tdp>=273.16)
         {
-            p_ws_dp=Props("P","T",Tdp,"Q",0,"Water");
+            p_ws_dp=SaturationPressureWater(Tdp);
         }
         else{
             // Sublimation pressure [kPa]
@@ -1038,22 +1204,19 @@ double MoleFractionWater(double T, double p, int HumInput, double InVal)
     }
 }
 
+static double RelativeHumidity(double T, double p, double psi_w, HumidAirTerms &terms);
 double RelativeHumidity(double T, double p, double psi_w)
+{
+    HumidAirTerms terms;
+    return RelativeHumidity(T, p, psi_w, terms);
+}
+static double RelativeHumidity(double T, double p, double psi_w, HumidAirTerms &terms)
 {
     double p_ws,f,p_s,W;
-    if (T>=273.16)
-    {
-        // Saturation pressure [kPa]
-        p_ws=Props("P","T",T,"Q",0,"Water");
-    }
-    else
-    {
-        // sublimation pressure [kPa]
-        p_ws=psub_Ice(T);
-        
-    }
+    // Saturation pressure, or sublimation pressure below the triple point [kPa]
+    p_ws=terms.p_ws(T);
     // Enhancement Factor [-]
-    f=f_factor(T,p);
+    f=terms.f(T,p);
 
     // Saturation pressure [kPa]
     p_s=f*p_ws;
@@ -1062,283 +1225,367 @@ double RelativeHumidity(double T, double p, double psi_w)
     // Find relative humidity using W/e=phi*p_s/(p-phi*p_s)
     return W/epsilon*p/(p_s*(1+W/epsilon));
 }
-EXPORT_CODE double CONVENTION HAProps(const char *OutputName, const char *Input1Name, double Input1, const char *Input2Name, double Input2, const char *Input3Name, double Input3)
+static int Name2Output(const char *Name)
 {
-    try
-    {
-        int In1Type, In2Type, In3Type,iT,iW,iTdp,iRH,ip,Type1,Type2;
-        double vals[3],p,T,RH,W,Tdp,psi_w,M_ha,v_bar,h_bar,s_bar,MainInputValue,SecondaryInputValue,T_guess;
-        double Value1,Value2,W_guess;
-        char MainInputName[100], SecondaryInputName[100],Name1[100],Name2[100];
-        
-        vals[0]=Input1;
-        vals[1]=Input2;
-        vals[2]=Input3;
-        
-        // First figure out what kind of inputs you have, convert names to Macro expansions
-        In1Type=Name2Type(Input1Name);
-        In2Type=Name2Type(Input2Name);
-        In3Type=Name2Type(Input3Name);
-        
-        // Pressure must be included
-        ip=TypeMatch(GIVEN_P,Input1Name,Input2Name,Input3Name);
-        if (ip>0)
-            p=vals[ip-1];
-        else
-            return -1000;
+    if (!strcmp(Name,"Vda") || !strcmp(Name,"V"))
+        return OUTPUT_VDA;
+    else if (!strcmp(Name,"Vha"))
+        return OUTPUT_VHA;
+    else if (!strcmp(Name,"Y"))
+        return OUTPUT_Y;
+    else if (!strcmp(Name,"Hda") || !strcmp(Name,"H"))
+        return OUTPUT_HDA;
+    else if (!strcmp(Name,"Hha"))
+        return OUTPUT_HHA;
+    else if (!strcmp(Name,"S") || !strcmp(Name,"Entropy"))
+        return OUTPUT_S;
+    else if (!strcmp(Name,"C") || !strcmp(Name,"cp"))
+        return OUTPUT_CP;
+    else if (!strcmp(Name,"Cha") || !strcmp(Name,"cp_ha"))
+        return OUTPUT_CPHA;
+    else if (!strcmp(Name,"Tdp") || !strcmp(Name,"D"))
+        return OUTPUT_TDP;
+    else if (!strcmp(Name,"Twb") || !strcmp(Name,"T_wb") || !strcmp(Name,"WetBulb") || !strcmp(Name,"B"))
+        return OUTPUT_TWB;
+    else if (!strcmp(Name,"Omega") || !strcmp(Name,"HumRat") || !strcmp(Name,"W"))
+        return OUTPUT_HUMRAT;
+    else if (!strcmp(Name,"RH") || !strcmp(Name,"RelHum") || !strcmp(Name,"R"))
+        return OUTPUT_RH;
+    else if (!strcmp(Name,"mu") || !strcmp(Name,"Visc") || !strcmp(Name,"M"))
+        return OUTPUT_VISC;
+    else if (!strcmp(Name,"k") || !strcmp(Name,"Conductivity") || !strcmp(Name,"K"))
+        return OUTPUT_COND;
+    else if (!strcmp(Name,"Tdb") || !strcmp(Name,"T_db") || !strcmp(Name,"T"))
+        return OUTPUT_T;
+    else
+        return -1;
+}
 
-        // -----------------------------------------------------------------------------------------------------
-        // Check whether the remaining values give explicit solution for mole fraction of water - nice and fast
-        // -----------------------------------------------------------------------------------------------------
-        
-        // Find the codes if they are there
-        iT=       TypeMatch(GIVEN_T,Input1Name,Input2Name,Input3Name);
-        iRH=     TypeMatch(GIVEN_RH,Input1Name,Input2Name,Input3Name);
-        iW=  TypeMatch(GIVEN_HUMRAT,Input1Name,Input2Name,Input3Name);
-        iTdp=   TypeMatch(GIVEN_TDP,Input1Name,Input2Name,Input3Name);
-        
-        if (iT>0) // Found T (or alias) as an input
-        {
-            T=vals[iT-1];
-            if (iRH>0) //Relative Humidity is provided
-            {
-                RH=vals[iRH-1];
-                psi_w=MoleFractionWater(T,p,GIVEN_RH,RH);
-            }
-            else if (iW>0)
-            {
-                W=vals[iW-1];
-                psi_w=MoleFractionWater(T,p,GIVEN_HUMRAT,W);
-            }
-            else if (iTdp>0)
-            {
-                Tdp=vals[iTdp-1];
-                psi_w=MoleFractionWater(T,p,GIVEN_TDP,Tdp);
-            }
-            else
-            {
-                // Temperature and pressure are known, figure out which variable holds the other value
-                if (In1Type!=GIVEN_T && In1Type!=GIVEN_P)
-                {
-                    strcpy(SecondaryInputName,Input1Name);
-                    SecondaryInputValue=Input1;
-                }
-                else if (In2Type!=GIVEN_T && In2Type!=GIVEN_P)
-                {
-                    strcpy(SecondaryInputName,Input2Name);
-                    SecondaryInputValue=Input2;
-                }
-                else if (In3Type!=GIVEN_T && In3Type!=GIVEN_P)
-                {
-                    strcpy(SecondaryInputName,Input3Name);
-                    SecondaryInputValue=Input3;
-                }
-                else{
-                    return _HUGE;
-                }
-                // Find the value for W
-                W_guess=0.0001;
-                W=Secant_HAProps_W(SecondaryInputName,"P",p,"T",T,SecondaryInputValue,W_guess);
-                // Mole fraction of water
-                psi_w=MoleFractionWater(T,p,GIVEN_HUMRAT,W);
-                // And on to output...
-            }
-        }
-        else
-        {
-            // Need to iterate to find dry bulb temperature since temperature is not provided
-            
-            // Pick one input, and alter T to match the other input
-            
-            // Get the variables and their values that are NOT pressure for simplicity
-            // because you know you need pressure as an input and you already have
-            // its value in variable p
-            if (ip==1) // Pressure is in slot 1
-            {
-                strcpy(Name1,Input2Name);
-                Value1=Input2;
-                strcpy(Name2,Input3Name);
-                Value2=Input3;
-            }
-            else if (ip==2) // Pressure is in slot 2
-            {
-                strcpy(Name1,Input1Name);
-                Value1=Input1;
-                strcpy(Name2,Input3Name);
-                Value2=Input3;
-            }
-            else if (ip==3) // Pressure is in slot 3
-            {
-                strcpy(Name1,Input1Name);
-                Value1=Input1;
-                strcpy(Name2,Input2Name);
-                Value2=Input2;
-            }
-            else{
-            return _HUGE;
-            }
-                
-            // Get the integer type codes
-            Type1=Name2Type(Name1);
-            Type2=Name2Type(Name2);
-            
-            // First, if one of the inputs is something that can potentially yield 
-            // an explicit solution at a given iteration of the solver, use it
-            if (Type1==GIVEN_RH || Type1==GIVEN_HUMRAT || Type1==GIVEN_TDP)
-            {
-                // First input variable is a "nice" one
-                
-                // MainInput is the one that you are using in the call to HAProps
-                MainInputValue=Value1;
-                strcpy(MainInputName,Name1);
-                // SecondaryInput is the one that you are trying to match
-                SecondaryInputValue=Value2;
-                strcpy(SecondaryInputName,Name2);
-            }
-            else if (Type2==GIVEN_RH || Type2==GIVEN_HUMRAT || Type2==GIVEN_TDP)
-            {
-                // Second input variable is a "nice" one
-                
-                // MainInput is the one that you are using in the call to HAProps
-                MainInputValue=Value2;
-                strcpy(MainInputName,Name2);
-                // SecondaryInput is the one that you are trying to match
-                SecondaryInputValue=Value1;
-                strcpy(SecondaryInputName,Name1);
-            }
-            else
-            {
-                printf("Sorry, but currently at least one of the variables as an input to HAProps() must be temperature, relative humidity, humidity ratio, or dewpoint\n  Eventually will add a 2-D NR solver to find T and psi_w simultaneously, but not included now\n");
-                return -1000;
-            }
+/// The combination of inputs and output of HAProps, resolved from the names once so that it can be used for many state points
+struct HAPropsInputs
+{
+    int iOutput; ///< The output, one of the outputs enum, -1 if not understood
+    int Type[3]; ///< The type of each input, one of the givens enum, -1 if not understood
+    int AsOutput[3]; ///< Each input as an output, used to match it when iterating, -1 if not understood
+    int ip,iT,iRH,iW,iTdp; ///< The slot (1-based) of the pressure, temperature and humidity inputs, -1 if not given
+    int iSecondary; ///< If T is given without a humidity input, the slot of the input that is matched by varying W, otherwise -1
+    int iMain; ///< If T is not given, the slot of the humidity input that is held fixed while varying T, otherwise -1
+    int iTarget; ///< If T is not given, the slot of the input that is matched by varying T, otherwise -1
+};
 
-            double T_min = 210;
-            double T_max = 450;
+static int TypeSlot(int TypeCode, const int Type[3])
+{
+    // Return the slot of the input of this type, otherwise return -1 for failure
+    for (int i = 0; i < 3; i++)
+    {
+        if (Type[i] == TypeCode){ return i+1; }
+    }
+    return -1;
+}
 
-            T = -1;
+static HAPropsInputs HAPropsResolve(int iOutput, int Type1, int Type2, int Type3, int AsOutput1 = -1, int AsOutput2 = -1, int AsOutput3 = -1)
+{
+    HAPropsInputs in;
+    in.iOutput = iOutput;
+    in.Type[0] = Type1; in.Type[1] = Type2; in.Type[2] = Type3;
+    in.AsOutput[0] = AsOutput1; in.AsOutput[1] = AsOutput2; in.AsOutput[2] = AsOutput3;
+    in.ip = TypeSlot(GIVEN_P,in.Type);
+    in.iT = TypeSlot(GIVEN_T,in.Type);
+    in.iRH = TypeSlot(GIVEN_RH,in.Type);
+    in.iW = TypeSlot(GIVEN_HUMRAT,in.Type);
+    in.iTdp = TypeSlot(GIVEN_TDP,in.Type);
+    in.iSecondary = -1;
+    in.iMain = -1;
+    in.iTarget = -1;
+    if (in.ip < 0){ return in; }
 
-            // First try to use the secant solver to find T at a few different temperatures
-            for (T_guess = 210; T_guess < 450; T_guess += 60)
-            {
-                try{
-                    T = Secant_HAProps_T(SecondaryInputName,(char *)"P",p,MainInputName,MainInputValue,SecondaryInputValue,T_guess);
-                    double val = HAProps(SecondaryInputName,(char *)"T",T,(char *)"P",p,MainInputName,MainInputValue);
-                    if (!ValidNumber(T) || !ValidNumber(val) || !(T_min < T && T < T_max) || fabs(val-SecondaryInputValue)>1e-6)
-                    { 
-                        throw ValueError(); 
-                    }
-                    else
-                    {
-                        break;
-                    }
-                }
-                catch (std::exception &){};
-            }
-            
-            if (T < 0) // No solution found using secant
-            {
-                // Use the Brent's method solver to find T
-                T = Brent_HAProps_T(SecondaryInputName,(char *)"P",p,MainInputName,MainInputValue,SecondaryInputValue,T_min,T_max);
-            }
-            
-            // If you want the temperature, return it
-            if (Name2Type(OutputName)==GIVEN_T)
-                return T;
-            else
+    if (in.iT > 0)
+    {
+        if (in.iRH < 0 && in.iW < 0 && in.iTdp < 0)
+        {
+            // Temperature and pressure are known, figure out which variable holds the other value
+            for (int i = 0; i < 3; i++)
             {
-                // Otherwise, find psi_w for further calculations in the following section
-                W=HAProps((char *)"W",(char *)"T",T,(char *)"P",p,MainInputName,MainInputValue);
-                psi_w=MoleFractionWater(T,p,GIVEN_HUMRAT,W);
+                if (in.Type[i] != GIVEN_T && in.Type[i] != GIVEN_P){ in.iSecondary = i+1; break; }
             }
         }
-        M_ha=(1-psi_w)*28.966+MM_Water()*psi_w; //[kg_ha/kmol_ha]
-        
-        // -----------------------------------------------------------------
-        // Calculate and return the desired value for known set of T,p,psi_w
-        // -----------------------------------------------------------------
-        if (!strcmp(OutputName,"Vda") || !strcmp(OutputName,"V"))
-        {
-            v_bar=MolarVolume(T,p,psi_w); //[m^3/mol_ha]
-            W=HumidityRatio(psi_w);
-            return v_bar*(1+W)/M_ha*1000; //[m^3/kg_da]
-        }
-        else if (!strcmp(OutputName,"Vha"))
+    }
+    else
+    {
+        // The two inputs that are not pressure, in order
+        int i1 = (in.ip == 1) ? 2 : 1, i2 = (in.ip == 3) ? 2 : 3;
+        int Type1 = in.Type[i1-1], Type2 = in.Type[i2-1];
+        // If one of the inputs is something that can potentially yield an explicit 
+        // solution at a given iteration of the solver, hold it fixed and match the other one
+        if (Type1==GIVEN_RH || Type1==GIVEN_HUMRAT || Type1==GIVEN_TDP)
         {
-            v_bar=MolarVolume(T,p,psi_w); //[m^3/mol_ha]
-            return v_bar/M_ha*1000; //[m^3/kg_ha]
+            in.iMain = i1;
+            in.iTarget = i2;
         }
-        else if (!strcmp(OutputName,"Y"))
+        else if (Type2==GIVEN_RH || Type2==GIVEN_HUMRAT || Type2==GIVEN_TDP)
         {
-            return psi_w; //[mol_w/mol]
+            in.iMain = i2;
+            in.iTarget = i1;
         }
-        else if (!strcmp(OutputName,"Hda") || !strcmp(OutputName,"H"))
-        {
-            return MassEnthalpy(T,p,psi_w);
+    }
+    return in;
+}
+
+static HAPropsInputs HAPropsResolve(const char *OutputName, const char *Input1Name, const char *Input2Name, const char *Input3Name)
+{
+    return HAPropsResolve(Name2Output(OutputName), Name2Type(Input1Name), Name2Type(Input2Name), Name2Type(Input3Name), 
+                          Name2Output(Input1Name), Name2Output(Input2Name), Name2Output(Input3Name));
+}
+
+static double Brent_HAProps_T(const HAPropsInputs &in, double p, double MainInputValue, double TargetVal, double T_min, double T_max, HumidAirTerms &terms)
+{
+    double T;
+    class BrentSolverResids : public FuncWrapper1D
+    {
+    private:
+        const HAPropsInputs &in;
+        double p,MainInputValue,TargetVal;
+        HumidAirTerms &terms;
+    public:
+        BrentSolverResids(const HAPropsInputs &in, double p, double MainInputValue, double TargetVal, HumidAirTerms &terms)
+            : in(in), p(p), MainInputValue(MainInputValue), TargetVal(TargetVal), terms(terms){};
+        ~BrentSolverResids(){};
+        
+        double call(double T){
+            double vals[3] = {T, p, MainInputValue};
+            return HAProps_nothrow(in,vals,terms)-TargetVal;
         }
-        else if (!strcmp(OutputName,"Hha"))
+    };
+
+    BrentSolverResids BSR(in, p, MainInputValue, TargetVal, terms);
+
+    std::string errstr;
+    T = Brent(&BSR,T_min,T_max,1e-7,1e-4,50,&errstr);
+    return T;
+}
+
+static double Secant_HAProps_T(const HAPropsInputs &in, double p, double MainInputValue, double TargetVal, double T_guess, HumidAirTerms &terms)
+{
+    // Use a secant solve in order to yield a target output value for HAProps by altering T
+    double x1=0,x2=0,x3=0,y1=0,y2=0,eps=5e-7,f=999,T=300,change;
+    int iter=1;
+
+    while ((iter<=3 || (fabs(f)>eps && fabs(change)>1e-10)) && iter<100)
+    {
+        if (iter==1){x1=T_guess; T=x1;}
+        if (iter==2){x2=T_guess+0.001; T=x2;}
+        if (iter>2) {T=x2;}
+            double vals[3] = {T, p, MainInputValue};
+            f=HAProps_nothrow(in,vals,terms)-TargetVal;
+        if (iter==1){y1=f;}
+        if (iter>1)
         {
-            v_bar=MolarVolume(T,p,psi_w); //[m^3/mol_ha]
-            h_bar=MolarEnthalpy(T,p,psi_w,v_bar); //[kJ/kmol_ha]
-            return h_bar/M_ha; //[kJ/kg_ha]
+            y2=f;
+            x3=x2-y2/(y2-y1)*(x2-x1);
+            change = y2/(y2-y1)*(x2-x1);
+            y1=y2; x1=x2; x2=x3;
         }
-        else if (!strcmp(OutputName,"S") || !strcmp(OutputName,"Entropy"))
+        iter=iter+1;
+    }
+    return T;
+}
+
+static double Secant_HAProps_W(const HAPropsInputs &in, double p, double T, double TargetVal, double W_guess, HumidAirTerms &terms)
+{
+    // Use a secant solve in order to yield a target output value for HAProps by altering humidity ratio
+    double x1=0,x2=0,x3=0,y1=0,y2=0,eps=1e-8,f=999,W=0.0001;
+    int iter=1;
+
+    while ((iter<=3 || fabs(f)>eps) && iter<100)
+    {
+        if (iter == 1){x1 = W_guess; W = x1;}
+        if (iter == 2){x2 = W_guess+0.001; W = x2;}
+        if (iter > 2) {W = x2;}
+            double vals[3] = {W, p, T};
+            f = HAProps_nothrow(in,vals,terms)-TargetVal;
+        if (iter == 1){y1 = f;}
+        if (iter > 1)
         {
-            v_bar=MolarVolume(T,p,psi_w); //[m^3/mol_ha]
-            s_bar=MolarEntropy(T,p,psi_w,v_bar); //[kJ/kmol_ha]
-            W=HumidityRatio(psi_w); //[kg_w/kg_da]
-            return s_bar*(1+W)/M_ha; //[kJ/kg_da]
+            y2=f;
+            x3=x2-y2/(y2-y1)*(x2-x1);
+            y1=y2; x1=x2; x2=x3;
         }
-        else if (!strcmp(OutputName,"C") || !strcmp(OutputName,"cp"))
-        {
-            double v_bar1,v_bar2,h_bar1,h_bar2, cp_bar, dT = 1e-3;
-            v_bar1=MolarVolume(T-dT,p,psi_w); //[m^3/mol_ha]
-            h_bar1=MolarEnthalpy(T-dT,p,psi_w,v_bar1); //[kJ/kmol_ha]
-            v_bar2=MolarVolume(T+dT,p,psi_w); //[m^3/mol_ha]
-            h_bar2=MolarEnthalpy(T+dT,p,psi_w,v_bar2); //[kJ/kmol_ha]
-            W=HumidityRatio(psi_w); //[kg_w/kg_da]
-            cp_bar = (h_bar2-h_bar1)/(2*dT);
+        iter=iter+1;
+    }
+    return W;
+}
+
+/// The output for known T,p,psi_w
+static double _HAProps_Tppsi(int iOutput, double T, double p, double psi_w, HumidAirTerms &terms)
+{
+    double M_ha,v_bar,h_bar,s_bar,W;
+    M_ha=(1-psi_w)*28.966+MM_Water()*psi_w; //[kg_ha/kmol_ha]
+
+    switch (iOutput)
+    {
+    case OUTPUT_VDA:
+        v_bar=MolarVolume(T,p,psi_w,terms); //[m^3/mol_ha]
+        W=HumidityRatio(psi_w);
+        return v_bar*(1+W)/M_ha*1000; //[m^3/kg_da]
+    case OUTPUT_VHA:
+        v_bar=MolarVolume(T,p,psi_w,terms); //[m^3/mol_ha]
+        return v_bar/M_ha*1000; //[m^3/kg_ha]
+    case OUTPUT_Y:
+        return psi_w; //[mol_w/mol]
+    case OUTPUT_HDA:
+        return MassEnthalpy(T,p,psi_w,terms);
+    case OUTPUT_HHA:
+        v_bar=MolarVolume(T,p,psi_w,terms); //[m^3/mol_ha]
+        h_bar=MolarEnthalpy(T,p,psi_w,v_bar,terms); //[kJ/kmol_ha]
+        return h_bar/M_ha; //[kJ/kg_ha]
+    case OUTPUT_S:
+        v_bar=MolarVolume(T,p,psi_w,terms); //[m^3/mol_ha]
+        s_bar=MolarEntropy(T,p,psi_w,v_bar,terms); //[kJ/kmol_ha]
+        W=HumidityRatio(psi_w); //[kg_w/kg_da]
+        return s_bar*(1+W)/M_ha; //[kJ/kg_da]
+    case OUTPUT_CP:
+    case OUTPUT_CPHA:
+    {
+        double v_bar1,v_bar2,h_bar1,h_bar2, cp_bar, dT = 1e-3;
+        v_bar1=MolarVolume(T-dT,p,psi_w,terms); //[m^3/mol_ha]
+        h_bar1=MolarEnthalpy(T-dT,p,psi_w,v_bar1,terms); //[kJ/kmol_ha]
+        v_bar2=MolarVolume(T+dT,p,psi_w,terms); //[m^3/mol_ha]
+        h_bar2=MolarEnthalpy(T+dT,p,psi_w,v_bar2,terms); //[kJ/kmol_ha]
+        W=HumidityRatio(psi_w); //[kg_w/kg_da]
+        cp_bar = (h_bar2-h_bar1)/(2*dT);
+        if (iOutput == OUTPUT_CP)
             return cp_bar*(1+W)/M_ha; //[kJ/kg_da]
-        }
-        else if (!strcmp(OutputName,"Cha") || !strcmp(OutputName,"cp_ha"))
-        {
-            double v_bar1,v_bar2,h_bar1,h_bar2, cp_bar, dT = 1e-3;
-            v_bar1=MolarVolume(T-dT,p,psi_w); //[m^3/mol_ha]
-            h_bar1=MolarEnthalpy(T-dT,p,psi_w,v_bar1); //[kJ/kmol_ha]
-            v_bar2=MolarVolume(T+dT,p,psi_w); //[m^3/mol_ha]
-            h_bar2=MolarEnthalpy(T+dT,p,psi_w,v_bar2); //[kJ/kmol_ha]
-            W=HumidityRatio(psi_w); //[kg_w/kg_da]
-            cp_bar = (h_bar2-h_bar1)/(2*dT);
+        else
             return cp_bar/M_ha; //[kJ/kg_da]
+    }
+    case OUTPUT_TDP:
+        return DewpointTemperature(T,p,psi_w); //[K]
+    case OUTPUT_TWB:
+        return WetbulbTemperature(T,p,psi_w); //[K]
+    case OUTPUT_HUMRAT:
+        return HumidityRatio(psi_w);
+    case OUTPUT_RH:
+        return RelativeHumidity(T,p,psi_w,terms);
+    case OUTPUT_VISC:
+        return Viscosity(T,p,psi_w);
+    case OUTPUT_COND:
+        return Conductivity(T,p,psi_w);
+    default:
+        return -1000;
+    }
+}
+
+/// HAProps for inputs that have already been resolved.  The virial coefficients are shared with the caller so 
+/// that they are re-used for state points at the same temperature
+static double _HAProps(const HAPropsInputs &in, const double *vals, HumidAirTerms &terms)
+{
+    double p,T,psi_w,W,W_guess,T_guess;
+
+    // Pressure must be included
+    if (in.ip>0)
+        p=vals[in.ip-1];
+    else
+        return -1000;
+
+    // -----------------------------------------------------------------------------------------------------
+    // Check whether the remaining values give explicit solution for mole fraction of water - nice and fast
+    // -----------------------------------------------------------------------------------------------------
+    if (in.iT>0) // Found T (or alias) as an input
+    {
+        T=vals[in.iT-1];
+        if (in.iRH>0) //Relative Humidity is provided
+        {
+            psi_w=MoleFractionWater(T,p,GIVEN_RH,vals[in.iRH-1],terms);
         }
-        else if (!strcmp(OutputName,"Tdp") || !strcmp(OutputName,"D"))
+        else if (in.iW>0)
         {
-            return DewpointTemperature(T,p,psi_w); //[K]
+            psi_w=MoleFractionWater(T,p,GIVEN_HUMRAT,vals[in.iW-1]);
         }
-        else if (!strcmp(OutputName,"Twb") || !strcmp(OutputName,"T_wb") || !strcmp(OutputName,"WetBulb") || !strcmp(OutputName,"B"))
+        else if (in.iTdp>0)
         {
-            return WetbulbTemperature(T,p,psi_w); //[K]
+            psi_w=MoleFractionWater(T,p,GIVEN_TDP,vals[in.iTdp-1]);
         }
-        else if (!strcmp(OutputName,"Omega") || !strcmp(OutputName,"HumRat") || !strcmp(OutputName,"W"))
+        else
         {
-            return HumidityRatio(psi_w);
+            if (in.iSecondary < 0){
+                return _HUGE;
+            }
+            // Find the value for W that matches the other input
+            HAPropsInputs inW = HAPropsResolve(in.AsOutput[in.iSecondary-1],GIVEN_HUMRAT,GIVEN_P,GIVEN_T);
+            W_guess=0.0001;
+            W=Secant_HAProps_W(inW,p,T,vals[in.iSecondary-1],W_guess,terms);
+            // Mole fraction of water
+            psi_w=MoleFractionWater(T,p,GIVEN_HUMRAT,W);
+            // And on to output...
         }
-        else if (!strcmp(OutputName,"RH") || !strcmp(OutputName,"RelHum") || !strcmp(OutputName,"R"))
+    }
+    else
+    {
+        // Need to iterate to find dry bulb temperature since temperature is not provided
+        if (in.iMain < 0)
         {
-            return RelativeHumidity(T,p,psi_w);
+            printf("Sorry, but currently at least one of the variables as an input to HAProps() must be temperature, relative humidity, humidity ratio, or dewpoint\n  Eventually will add a 2-D NR solver to find T and psi_w simultaneously, but not included now\n");
+            return -1000;
         }
-        else if (!strcmp(OutputName,"mu") || !strcmp(OutputName,"Visc") || !strcmp(OutputName,"M"))
+        // Hold the "nice" input fixed and alter T to match the other input
+        double MainInputValue = vals[in.iMain-1], SecondaryInputValue = vals[in.iTarget-1];
+        HAPropsInputs inT = HAPropsResolve(in.AsOutput[in.iTarget-1],GIVEN_T,GIVEN_P,in.Type[in.iMain-1]);
+
+        double T_min = 210;
+        double T_max = 450;
+
+        T = -1;
+
+        // First try to use the secant solver to find T at a few different temperatures
+        for (T_guess = 210; T_guess < 450; T_guess += 60)
         {
-            return Viscosity(T,p,psi_w);
+            try{
+                T = Secant_HAProps_T(inT,p,MainInputValue,SecondaryInputValue,T_guess,terms);
+                double valsT[3] = {T, p, MainInputValue};
+                double val = HAProps_nothrow(inT,valsT,terms);
+                if (!ValidNumber(T) || !ValidNumber(val) || !(T_min < T && T < T_max) || fabs(val-SecondaryInputValue)>1e-6)
+                { 
+                    throw ValueError(); 
+                }
+                else
+                {
+                    break;
+                }
+            }
+            catch (std::exception &){};
         }
-        else if (!strcmp(OutputName,"k") || !strcmp(OutputName,"Conductivity") || !strcmp(OutputName,"K"))
+        
+        if (T < 0) // No solution found using secant
         {
-            return Conductivity(T,p,psi_w);
+            // Use the Brent's method solver to find T
+            T = Brent_HAProps_T(inT,p,MainInputValue,SecondaryInputValue,T_min,T_max,terms);
         }
+        
+        // If you want the temperature, return it
+        if (in.iOutput==OUTPUT_T)
+            return T;
         else
         {
-            return -1000;
+            // Otherwise, find psi_w for further calculations in the following section
+            HAPropsInputs inHumRat = HAPropsResolve(OUTPUT_HUMRAT,GIVEN_T,GIVEN_P,in.Type[in.iMain-1]);
+            double valsT[3] = {T, p, MainInputValue};
+            W=HAProps_nothrow(inHumRat,valsT,terms);
+            psi_w=MoleFractionWater(T,p,GIVEN_HUMRAT,W);
         }
     }
+    
+    // -----------------------------------------------------------------
+    // Calculate and return the desired value for known set of T,p,psi_w
+    // -----------------------------------------------------------------
+    return _HAProps_Tppsi(in.iOutput,T,p,psi_w,terms);
+}
+
+static double HAProps_nothrow(const HAPropsInputs &in, const double *vals, HumidAirTerms &terms)
+{
+    try
+    {
+        return _HAProps(in,vals,terms);
+    }
     catch (std::exception &e)
     {
         set_err_string(e.what());
@@ -1350,6 +1597,31 @@ EXPORT_CODE double CONVENTION HAProps(const char *OutputName, const char *Input1
     }
 }
 
+EXPORT_CODE double CONVENTION HAProps(const char *OutputName, const char *Input1Name, double Input1, const char *Input2Name, double Input2, const char *Input3Name, double Input3)
+{
+    // First figure out what kind of inputs you have, convert names to Macro expansions
+    HAPropsInputs in = HAPropsResolve(OutputName,Input1Name,Input2Name,Input3Name);
+    double vals[3] = {Input1, Input2, Input3};
+    HumidAirTerms terms;
+    return HAProps_nothrow(in,vals,terms);
+}
+
+EXPORT_CODE long CONVENTION HAPropsArray(const char *OutputName, const char *Input1Name, const double *Input1, const char *Input2Name, const double *Input2, const char *Input3Name, const double *Input3, long length, double *outputs)
+{
+    // The names are resolved once for the whole array, and the virial coefficients are shared 
+    // by consecutive state points at the same temperature
+    HAPropsInputs in = HAPropsResolve(OutputName,Input1Name,Input2Name,Input3Name);
+    HumidAirTerms terms;
+    long Nfail = 0;
+    for (long i = 0; i < length; i++)
+    {
+        double vals[3] = {Input1[i], Input2[i], Input3[i]};
+        outputs[i] = HAProps_nothrow(in,vals,terms);
+        if (!ValidNumber(outputs[i])){ Nfail++; }
+    }
+    return Nfail;
+}
+
 EXPORT_CODE double CONVENTION HAProps_Aux(const char* Name,double T, double p, double W, char *units)
 {
     // This function provides some things that are not usually needed, but could be interesting for debug purposes.
@@ -1633,4 +1905,71 @@ TEST_CASE((char*)"Tests from ASHRAE RP-1485",(char*)"[RP1485]")
         }
     }
 }
+TEST_CASE((char*)"HAPropsArray gives the same outputs as HAProps",(char*)"[fast],[HAPropsArray]")
+{
+    const char *outputs[] = {"H","S","V","W","Tdp"};
+    std::vector<double> T, p, R;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 5; j++)
+        {
+            T.push_back(265+10*i); p.push_back(101.325); R.push_back(0.1+0.2*j);
+        }
+    }
+    std::vector<double> out(T.size());
+    for (int k = 0; k < 5; k++)
+    {
+        CAPTURE(outputs[k]);
+        CHECK(HAPropsArray(outputs[k],"T",&(T[0]),"P",&(p[0]),"R",&(R[0]),(long)T.size(),&(out[0])) == 0);
+        for (std::size_t i = 0; i < T.size(); i++)
+        {
+            CAPTURE(T[i]);
+            CAPTURE(R[i]);
+            CHECK(out[i] == HAProps(outputs[k],"T",T[i],"P",p[i],"R",R[i]));
+        }
+    }
+    SECTION((char*)"Failed points")
+    {
+        double Tbad[] = {300,-5}, pbad[] = {101.325,101.325}, Rbad[] = {0.5,0.5};
+        double outbad[2];
+        CHECK(HAPropsArray("H","T",Tbad,"P",pbad,"R",Rbad,2,outbad) == 1);
+        CHECK(ValidNumber(outbad[0]));
+        CHECK(!ValidNumber(outbad[1]));
+    }
+}
+TEST_CASE((char*)"Fast mode with the tabulated terms",(char*)"[fast],[HAProps]")
+{
+    const char *outputs[] = {"H","S","V","W","Tdp","Twb","R","C"};
+    double T[] = {250, 300, 300, 350, 400}, p[] = {101.325, 101.325, 1000, 101.325, 5000}, R[] = {0.5, 0.1, 0.9, 0.5, 0.3};
+    for (int k = 0; k < 8; k++)
+    {
+        for (int i = 0; i < 5; i++)
+        {
+            UseTabulatedTerms(0);
+            double y0 = HAProps(outputs[k],"T",T[i],"P",p[i],"R",R[i]);
+            UseTabulatedTerms(1);
+            double y1 = HAProps(outputs[k],"T",T[i],"P",p[i],"R",R[i]);
+            UseTabulatedTerms(0);
+            CAPTURE(outputs[k]);
+            CAPTURE(T[i]);
+            CAPTURE(p[i]);
+            CAPTURE(y0);
+            CAPTURE(y1);
+            CHECK(fabs(y1-y0) < 1e-7*std::max(fabs(y0),1.0));
+        }
+    }
+    SECTION((char*)"Enhancement factor")
+    {
+        for (double Tf = 275; Tf < 620; Tf += 50)
+        {
+            UseTabulatedTerms(0);
+            double f0 = f_factor(Tf,10000);
+            UseTabulatedTerms(1);
+            double f1 = f_factor(Tf,10000);
+            UseTabulatedTerms(0);
+            CAPTURE(Tf);
+            CHECK(fabs(f1/f0-1) < 1e-6);
+        }
+    }
+}
 #endif
\ No newline at end of file
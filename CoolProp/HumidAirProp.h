@@ -9,6 +9,13 @@
 // Standard I/O function
 // -----------------------
 EXPORT_CODE double CONVENTION HAProps(const char *OutputName, const char *Input1Name, double Input1, const char *Input2Name, double Input2, const char *Input3Name, double Input3);
+/// HAProps for arrays of state points with the same combination of inputs.  The names are only resolved once, and the
+/// virial coefficients, saturation pressure of water and enhancement factor are re-used by consecutive state points
+/// at the same temperature (and pressure), so grids are fastest with temperature as the outer loop
+/// @param length The number of state points in Input1, Input2, Input3 and outputs
+/// @param outputs Filled with the outputs, _HUGE where the point could not be evaluated
+/// @returns The number of state points that could not be evaluated
+EXPORT_CODE long CONVENTION HAPropsArray(const char *OutputName, const char *Input1Name, const double *Input1, const char *Input2Name, const double *Input2, const char *Input3Name, const double *Input3, long length, double *outputs);
 
 // -----------------------
 // Extra I/O function
@@ -22,6 +29,13 @@ double IceProps(const char* Name, double T, double p);
 void UseVirialCorrelations(int flag);
 void UseIsothermCompressCorrelation(int flag);
 void UseIdealGasEnthalpyCorrelations(int flag);
+/// Turn on the fast mode, in which the virial coefficients of air and water and the saturation properties of water that
+/// enter the enhancement factor are evaluated from piecewise Chebyshev expansions in temperature rather than from the
+/// equations of state, which makes HAProps 20 to 100 times faster.  The expansions are built on first use, in about
+/// 0.1 s.  Up to 10 MPa, the virial coefficients differ from the full equations by less than 1e-10 relative, the
+/// enhancement factor by less than 1e-6 relative, and the outputs of HAProps by less than 1e-8 relative (1e-7 for the
+/// wetbulb temperature)
+void UseTabulatedTerms(int flag);
 
 // --------------
 // Help functions
@@ -1,6 +1,7 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <math.h>
 #include <stdio.h>
 #include "CoolPropTools.h"
@@ -838,6 +839,73 @@ double IncompressibleClass::expval(std::vector< std::vector<double> > const& coe
 }
 
 
+/// Coefficients of the polynomial in T that is obtained by evaluating
+/// a two-dimensional polynomial at a fixed value of the 1st dimension
+/// @param coefficients vector containing the ordered coefficients
+/// @param x double value that represents the current input in the 1st dimension
+std::vector<double> IncompressibleClass::polyvalT(std::vector< std::vector<double> > const& coefficients, double x){
+	unsigned int n = 0;
+	for(unsigned int i=0; i<coefficients.size(); i++) {
+		n = std::max(n, (unsigned int)coefficients[i].size());
+	}
+	std::vector<double> result(n, 0.);
+	for(int i=coefficients.size()-1; i>=0; i--) {
+		for(unsigned int j=0; j<n; j++) {
+			result[j] *= x;
+			if (j < coefficients[i].size()) result[j] += coefficients[i][j];
+		}
+	}
+	return result;
+}
+
+/// Solves h = int(c,Tref,T) + p/rho(T) for T with Halley's method
+/// @param cHeat vector containing the ordered coefficients of the heat capacity
+/// @param cRho vector containing the ordered coefficients of the density
+/// @param h double value of the enthalpy
+/// @param p double value of the pressure
+/// @param Tref double value that represents the reference state
+/// @param Tlow double value of the lower bound of the temperature
+/// @param Thigh double value of the upper bound of the temperature
+/// @param Tguess double value of the initial guess
+double IncompressibleClass::polyinvh(std::vector<double> const& cHeat, std::vector<double> const& cRho, double h, double p, double Tref, double Tlow, double Thigh, double Tguess){
+	double u0 = baseHornerInt(cHeat, Tref);
+	double T = std::min(std::max(Tguess, Tlow), Thigh);
+	for(int iter=0; iter<50; iter++) {
+		// Heat capacity, its derivative and its integral in one Horner pass
+		double c = 0., dc = 0., u = 0.;
+		for(int i=cHeat.size()-1; i>=0; i--) {
+			dc = dc*T + c;
+			c  =  c*T + cHeat[i];
+			u  =  u*T + cHeat[i]/(i+1.);
+		}
+		u = u*T - u0;
+		// Density and its first two derivatives
+		double r = 0., dr = 0., d2r = 0.;
+		for(int i=cRho.size()-1; i>=0; i--) {
+			d2r = d2r*T + 2*dr;
+			dr  =  dr*T + r;
+			r   =   r*T + cRho[i];
+		}
+		double f   = u + p/r - h;
+		double df  = c - p*dr/(r*r);
+		double d2f = dc - p*(d2r/(r*r) - 2*dr*dr/(r*r*r));
+		double Tnew = T - 2*f*df/(2*df*df - f*d2f);
+		if (!ValidNumber(Tnew)) {
+			break;
+		}
+		Tnew = std::min(std::max(Tnew, Tlow), Thigh);
+		if (fabs(Tnew-T) < 1e-10) {
+			if (fabs(f) > 1e-6*std::max(fabs(h), 1.)) {
+				throw ValueError(format("Your enthalpy %g is out of range for the temperature range [%g,%g]. ",h,Tlow,Thigh));
+			}
+			return Tnew;
+		}
+		T = Tnew;
+	}
+	throw SolutionError(format("T_hp did not converge for h=%g and p=%g. ",h,p));
+	return _HUGE;
+}
+
 //int main() {
 //
 //	SimpleIncompressible* liquid = new DowthermQClass();
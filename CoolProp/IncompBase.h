@@ -339,6 +339,22 @@ public:
 
 
 
+	/// Coefficients of the polynomial in the 2nd dimension (T) of a two-dimensional polynomial at fixed x
+	/// @param coefficients vector containing the ordered coefficients
+	/// @param x double value that represents the current input in the 1st dimension
+	std::vector<double> polyvalT(std::vector< std::vector<double> > const& coefficients, double x);
+
+	/// Inverts h = int(cHeat,Tref,T) + p/polyval(cRho,T) for T using both polynomials and their analytic derivatives (Halley's method)
+	/// @param cHeat vector containing the ordered coefficients of the heat capacity
+	/// @param cRho vector containing the ordered coefficients of the density
+	/// @param h double value of the enthalpy
+	/// @param p double value of the pressure
+	/// @param Tref double value that represents the reference state
+	/// @param Tlow double value of the lower bound of the temperature
+	/// @param Thigh double value of the upper bound of the temperature
+	/// @param Tguess double value of the initial guess
+	double polyinvh(std::vector<double> const& cHeat, std::vector<double> const& cRho, double h, double p, double Tref, double Tlow, double Thigh, double Tguess);
+
 	/// Evaluates an exponential function for the given coefficients
 	/// @param coefficients vector containing the ordered coefficients
 	/// @param T double value that represents the current input
@@ -94,6 +94,20 @@ bool IncompressibleLiquid::checkTP(double T, double p) {
 	return (checkT(T) && checkP(T,p));
 }
 
+/// Temperature from enthalpy and pressure.
+/** Newton's method with the heat capacity as the derivative,
+ *  used for liquids without polynomial coefficients. */
+double IncompressibleLiquid::T_h(double h, double p) {
+	double T = Tmax - 10.0;
+	for (int iter = 0; iter < 100; iter++) {
+		double dT = (this->h(T,p) - h)/cp(T,p);
+		T = std::min(std::max(T - dT, Tmin), Tmax);
+		if (fabs(dT) < 1e-10) return T;
+	}
+	throw SolutionError(format("T_hp did not converge for h=%g and p=%g. ",h,p));
+	return _HUGE;
+}
+
 
 
 /** Handle all the objects in a single list of incompressible
@@ -256,4 +270,9 @@ double IncompLiquidSI(long iOutput, double T, double p_SI, std::string name)
 	return pIncompLiquidSI(iOutput,T,p_SI,Liquids.get_liquid(name));
 }
 
+double IncompLiquid_T_hp(std::string name, double h, double p_SI)
+{
+	return Liquids.get_liquid(name)->T_h(h,p_SI);
+}
+
 
@@ -46,6 +46,8 @@ public:
 	virtual double cond(double T_K, double p){return -_HUGE;};
 	/// Saturation pressure as a function of temperature.
 	virtual double psat(double T_K){return -_HUGE;};
+	/// Temperature as a function of enthalpy and pressure.
+	virtual double T_h (double h, double p);
 
     void testInputs(double T_K, double p);
 
@@ -106,6 +108,7 @@ protected:
 bool IsIncompressibleLiquid(std::string name);
 double IncompLiquidSI(long iOutput, double T, double p, long iFluid);
 double IncompLiquidSI(long iOutput, double T, double p, std::string name);
+double IncompLiquid_T_hp(std::string name, double h, double p);
 // only two functions needed
 // no name processing
 // no concentration issues
@@ -178,6 +181,11 @@ public:
     		return expval(cPsat, T_K, 1);
     	}
     };
+    double T_h(double h, double p){
+    	double T = polyinvh(cHeat, cRho, h, p, Tref, Tmin, Tmax, Tmax - 10.0);
+    	checkTP(T, p);
+    	return T;
+    }
 };
 
 /*
@@ -116,6 +116,20 @@ bool IncompressibleSolution::checkTPX(double T, double p, double x) {
 	return (checkT(T,p,x) && checkP(T,p,x) && checkX(x));
 }
 
+/// Temperature from enthalpy, pressure and composition.
+/** Newton's method with the heat capacity as the derivative,
+ *  used for solutions without polynomial coefficients. */
+double IncompressibleSolution::T_h(double h, double p, double x) {
+	double T = (Tmin + Tmax)/2.0;
+	for (int iter = 0; iter < 100; iter++) {
+		double dT = (this->h(T,p,x) - h)/cp(T,p,x);
+		T = std::min(std::max(T - dT, Tmin), Tmax);
+		if (fabs(dT) < 1e-10) return T;
+	}
+	throw SolutionError(format("T_hp did not converge for h=%g, p=%g and x=%g. ",h,p,x));
+	return _HUGE;
+}
+
 
 
 /** Handle all the objects in a single list of incompressible
@@ -249,6 +263,11 @@ double IncompSolutionSI(long iOutput, double T, double p, double x, std::string
 	return pIncompSolutionSI(iOutput,T,p,x,Solutions.get_solution(name));
 }
 
+double IncompSolution_T_hp(std::string name, double h, double p)
+{
+	return Solutions.get_solution(getSolutionName(name))->T_h(h, p, getSolutionConc(name));
+}
+
 /** Just some convenience functions to allow for backward compatibility.
  *  We might end up using them in the beginning until we can
  *  handle a third parameter properly. */
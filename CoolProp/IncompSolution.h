@@ -74,6 +74,8 @@ public:
     virtual double psat(double T_K          , double x){return -_HUGE;};
     /// Freezing temperature as a function of pressure and composition.
     virtual double Tfreeze(         double p, double x){return -_HUGE;};
+    /// Temperature as a function of enthalpy, pressure and composition.
+    virtual double T_h (double h, double p, double x);
 
     void testInputs(double T_K, double p, double x);
 
@@ -141,6 +143,8 @@ protected:
 bool IsIncompressibleSolution(std::string name);
 double IncompSolutionSI(long iOutput, double T, double p, double x, long iFluid);
 double IncompSolutionSI(long iOutput, double T, double p, double x, std::string name);
+/// Temperature from enthalpy and pressure of a solution given as "EG-20%" or "EG-0.2"
+double IncompSolution_T_hp(std::string name, double h, double p);
 double IncompSolutionSI(long iOutput, double T, double p, std::string name);  // TODO Solutions: Remove as soon as possible
 std::string getSolutionName(std::string name); // TODO Solutions: Remove as soon as possible
 double getSolutionConc(std::string name); // TODO Solutions: Remove as soon as possible
@@ -548,6 +552,15 @@ public:
 		IncompressibleClass::checkCoefficients(cHeat,6,4);
 		return polyint(cHeat, getxInput(x), getTInput(T_K), getTInput(Tref));
 	}
+	double T_h(double h, double p, double x){
+		checkX(x);
+		IncompressibleClass::checkCoefficients(cHeat,6,4);
+		IncompressibleClass::checkCoefficients(cRho,6,4);
+		double xin = getxInput(x);
+		double T = polyinvh(polyvalT(cHeat, xin), polyvalT(cRho, xin), h, p, getTInput(Tref), getTInput(Tmin), getTInput(Tmax), getTInput((Tmin+Tmax)/2.0)) + Tbase;
+		checkTPX(T, p, x);
+		return T;
+	}
 //	double psat(double T_K, double x){
 //		//checkT(T_K,p,x);
 //		Incompressible::checkCoefficients(cPsat,6,4);
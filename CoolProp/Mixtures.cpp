@@ -381,6 +381,8 @@ void Mixture::initialize()
 			}
 		}
 	}
+	// The departure functions were replaced directly in the matrix
+	pExcess->clear_cache();
 	
 	///         END OF INITIALIZATION
 	///         END OF INITIALIZATION
@@ -1198,7 +1200,7 @@ double Mixture::phir(double tau, double delta, const std::vector<double> &x)
 }
 double Mixture::dphir_dxi(double tau, double delta, const std::vector<double> &x, int i)
 {	
-	return pFluids[i]->phir(tau,delta) + pExcess->dphir_dxi(tau,delta,x,i);
+	return pResidualIdealMix->component_derivatives(tau,delta)[i].base + pExcess->dphir_dxi(tau,delta,x,i);
 }
 double Mixture::d2phirdxidxj(double tau, double delta, const std::vector<double> &x, int i, int j)
 {	
@@ -1206,11 +1208,11 @@ double Mixture::d2phirdxidxj(double tau, double delta, const std::vector<double>
 }
 double Mixture::d2phir_dxi_dTau(double tau, double delta, const std::vector<double> &x, int i)
 {	
-	return pFluids[i]->dphir_dTau(tau,delta) + pExcess->d2phir_dxi_dTau(tau,delta,x,i);
+	return pResidualIdealMix->component_derivatives(tau,delta)[i].dTau + pExcess->d2phir_dxi_dTau(tau,delta,x,i);
 }
 double Mixture::d2phir_dxi_dDelta(double tau, double delta, const std::vector<double> &x, int i)
 {	
-	return pFluids[i]->dphir_dDelta(tau,delta) + pExcess->d2phir_dxi_dDelta(tau,delta,x,i);
+	return pResidualIdealMix->component_derivatives(tau,delta)[i].dDelta + pExcess->d2phir_dxi_dDelta(tau,delta,x,i);
 }
 double Mixture::dphir_dDelta(double tau, double delta, const std::vector<double> &x)
 {
@@ -1568,13 +1570,30 @@ double Mixture::dgdbeta_RachfordRice(const std::vector<double> &z, const std::ve
 	return summer;
 }
 
-double GERG2008ReducingFunction::Tr(const std::vector<double> &x)
+const ReducingFunctionCacheElement &GERG2008ReducingFunction::cached(const std::vector<double> &x)
+{
+	if (cache[cache_last].x == x){ return cache[cache_last]; }
+	// Replace the least recently used element if the other one does not match either
+	int other = 1-cache_last;
+	if (cache[other].x != x){ evaluate(x, cache[other]); }
+	cache_last = other;
+	return cache[other];
+}
+void GERG2008ReducingFunction::evaluate(const std::vector<double> &x, ReducingFunctionCacheElement &e)
 {
-	double Tr = 0;
+	// See Table B9 from Kunz Wagner 2012 (GERG 2008)
+	e.x = x;
+	e.dTrdxi.resize(N);
+	e.dvrbardxi.resize(N);
+	e.d2Trdxidxj.resize(N, std::vector<double>(N, 0));
+	e.d2vrbardxidxj.resize(N, std::vector<double>(N, 0));
+
+	double Tr = 0, vrbar = 0;
 	for (unsigned int i = 0; i < N; i++)
 	{
-		double xi = x[i], Tci = pFluids[i]->reduce.T;
+		double xi = x[i], Tci = pFluids[i]->reduce.T, rhobarci = pFluids[i]->reduce.rhobar;
 		Tr += xi*xi*Tci;
+		vrbar += xi*xi/rhobarci;
 		
 		// The last term is only used for the pure component, as it is sum_{i=1}^{N-1}sum_{j=1}^{N}
 		if (i==N-1){ break; }
@@ -1582,127 +1601,99 @@ double GERG2008ReducingFunction::Tr(const std::vector<double> &x)
 		for (unsigned int j = i+1; j < N; j++)
 		{
 			Tr += c_Y_ij(i, j, &beta_T, &gamma_T, &T_c)*f_Y_ij(x, i, j, &beta_T);
+			vrbar += c_Y_ij(i, j, &beta_v, &gamma_v, &v_c)*f_Y_ij(x, i, j, &beta_v);
 		}
 	}
-	return Tr;
+	e.Tr = Tr;
+	e.rhorbar = 1/vrbar;
+
+	for (unsigned int i = 0; i < N; i++)
+	{
+		double xi = x[i], Tci = pFluids[i]->reduce.T, rhobarci = pFluids[i]->reduce.rhobar;
+		double dTr_dxi = 2*xi*Tci, d2Tr_dxi2 = 2*Tci;
+		double dvrbar_dxi = 2*xi/rhobarci, d2vrbar_dxi2 = 2/rhobarci;
+		for (unsigned int k = 0; k < i; k++)
+		{
+			dTr_dxi += c_Y_ji(k, i, &beta_T, &gamma_T, &T_c)*dfYkidxi__constxk(x, k, i, &beta_T);
+			d2Tr_dxi2 += c_Y_ij(k, i, &beta_T, &gamma_T, &T_c)*d2fYkidxi2__constxk(x, k, i, &beta_T);
+			dvrbar_dxi += c_Y_ij(k, i, &beta_v, &gamma_v, &v_c)*dfYkidxi__constxk(x, k, i, &beta_v);
+			d2vrbar_dxi2 += c_Y_ij(k, i, &beta_v, &gamma_v, &v_c)*d2fYkidxi2__constxk(x, k, i, &beta_v);
+		}
+		for (unsigned int k = i+1; k < N; k++)
+		{
+			dTr_dxi += c_Y_ij(i, k, &beta_T, &gamma_T, &T_c)*dfYikdxi__constxk(x, i, k, &beta_T);
+			d2Tr_dxi2 += c_Y_ij(i, k, &beta_T, &gamma_T, &T_c)*d2fYikdxi2__constxk(x, i, k, &beta_T);
+			dvrbar_dxi += c_Y_ij(i, k, &beta_v, &gamma_v, &v_c)*dfYikdxi__constxk(x, i, k, &beta_v);
+			d2vrbar_dxi2 += c_Y_ij(i, k, &beta_v, &gamma_v, &v_c)*d2fYikdxi2__constxk(x, i, k, &beta_v);
+		}
+		e.dTrdxi[i] = dTr_dxi;
+		e.dvrbardxi[i] = dvrbar_dxi;
+		for (unsigned int j = 0; j < N; j++)
+		{
+			if (i == j)
+			{
+				e.d2Trdxidxj[i][j] = d2Tr_dxi2;
+				e.d2vrbardxidxj[i][j] = d2vrbar_dxi2;
+			}
+			else
+			{
+				e.d2Trdxidxj[i][j] = c_Y_ij(i, j, &beta_T, &gamma_T, &T_c)*d2fYijdxidxj(x, i, j, &beta_T);
+				e.d2vrbardxidxj[i][j] = c_Y_ij(i, j, &beta_v, &gamma_v, &v_c)*d2fYijdxidxj(x, i, j, &beta_v);
+			}
+		}
+	}
+}
+double GERG2008ReducingFunction::Tr(const std::vector<double> &x)
+{
+	return cached(x).Tr;
 }
 double GERG2008ReducingFunction::dTrdxi__constxj(const std::vector<double> &x, int i)
 {
-	// See Table B9 from Kunz Wagner 2012 (GERG 2008)
-	double xi = x[i];
-	double dTr_dxi = 2*xi*pFluids[i]->reduce.T;
-	for (int k = 0; k < i; k++)
-	{
-		dTr_dxi += c_Y_ji(k,i,&beta_T,&gamma_T,&T_c)*dfYkidxi__constxk(x,k,i,&beta_T);
-	}
-	for (unsigned int k = i+1; k < N; k++)
-	{
-		dTr_dxi += c_Y_ij(i,k,&beta_T,&gamma_T,&T_c)*dfYikdxi__constxk(x,i,k,&beta_T);
-	}
-	return dTr_dxi;
+	return cached(x).dTrdxi[i];
 }
 double GERG2008ReducingFunction::d2Trdxi2__constxj(const std::vector<double> &x, int i)
 {
-	// See Table B9 from Kunz Wagner 2012 (GERG 2008)
-	double d2Tr_dxi2 = 2*pFluids[i]->reduce.T;
-	for (int k = 0; k < i; k++)
-	{
-		d2Tr_dxi2 += c_Y_ij(k,i,&beta_T,&gamma_T,&T_c)*d2fYkidxi2__constxk(x,k,i,&beta_T);
-	}
-	for (unsigned int k = i+1; k < N; k++)
-	{
-		d2Tr_dxi2 += c_Y_ij(i,k,&beta_T,&gamma_T,&T_c)*d2fYikdxi2__constxk(x,i,k,&beta_T);
-	}
-	return d2Tr_dxi2;
+	return cached(x).d2Trdxidxj[i][i];
 }
 double GERG2008ReducingFunction::d2Trdxidxj(const std::vector<double> &x, int i, int j)
 {
-	if (i == j)
-	{
-		return d2Trdxi2__constxj(x,i);
-	}
-	else
-	{
-		// See Table B9 from Kunz Wagner 2012 (GERG 2008)
-		return c_Y_ij(i,j,&beta_T,&gamma_T,&T_c)*d2fYijdxidxj(x,i,j,&beta_T);
-	}
+	return cached(x).d2Trdxidxj[i][j];
 }
 double GERG2008ReducingFunction::dvrbardxi__constxj(const std::vector<double> &x, int i)
 {
-	// See Table B9 from Kunz Wagner 2012 (GERG 2008)
-	double xi = x[i];
-	double dvrbar_dxi = 2*xi/pFluids[i]->reduce.rhobar;
-
-	for (int k = 0; k < i; k++)
-	{
-		dvrbar_dxi += c_Y_ij(k, i, &beta_v, &gamma_v, &v_c)*dfYkidxi__constxk(x, k, i, &beta_v);
-	}
-	for (unsigned int k = i+1; k < N; k++)
-	{
-		dvrbar_dxi += c_Y_ij(i, k, &beta_v, &gamma_v, &v_c)*dfYikdxi__constxk(x, i, k, &beta_v);	
-	}
-	return dvrbar_dxi;
+	return cached(x).dvrbardxi[i];
 }
 double GERG2008ReducingFunction::d2vrbardxidxj(const std::vector<double> &x, int i, int j)
 {
-	if (i == j)
-	{
-		return d2vrbardxi2__constxj(x, i);
-	}
-	else
-	{
-		return c_Y_ij(i, j, &beta_v, &gamma_v, &v_c)*d2fYijdxidxj(x, i, j, &beta_v);
-	}
+	return cached(x).d2vrbardxidxj[i][j];
 }
 double GERG2008ReducingFunction::drhorbardxi__constxj(const std::vector<double> &x, int i)
 {
-	return -pow(rhorbar(x),2)*dvrbardxi__constxj(x,i);
+	const ReducingFunctionCacheElement &e = cached(x);
+	return -pow(e.rhorbar,2)*e.dvrbardxi[i];
 }
 double GERG2008ReducingFunction::d2vrbardxi2__constxj(const std::vector<double> &x, int i)
 {
-	// See Table B9 from Kunz Wagner 2012 (GERG 2008)
-	double d2vrbardxi2 = 2/pFluids[i]->reduce.rhobar;
-
-	for (int k = 0; k < i; k++)
-	{
-		d2vrbardxi2 += c_Y_ij(k, i, &beta_v, &gamma_v, &v_c)*d2fYkidxi2__constxk(x, k, i, &beta_v);
-	}
-	for (unsigned int k = i+1; k < N; k++)
-	{
-		d2vrbardxi2 += c_Y_ij(i, k, &beta_v, &gamma_v, &v_c)*d2fYikdxi2__constxk(x, i, k, &beta_v);	
-	}
-	return d2vrbardxi2;
+	return cached(x).d2vrbardxidxj[i][i];
 }
 double GERG2008ReducingFunction::d2rhorbardxi2__constxj(const std::vector<double> &x, int i)
 {
-	double rhor = this->rhorbar(x);
-	double dvrbardxi = this->dvrbardxi__constxj(x,i);
-	return 2*pow(rhor,(int)3)*pow(dvrbardxi,(int)2)-pow(rhor,(int)2)*this->d2vrbardxi2__constxj(x,i);
+	const ReducingFunctionCacheElement &e = cached(x);
+	double rhor = e.rhorbar;
+	double dvrbardxi = e.dvrbardxi[i];
+	return 2*pow(rhor,(int)3)*pow(dvrbardxi,(int)2)-pow(rhor,(int)2)*e.d2vrbardxidxj[i][i];
 }
 double GERG2008ReducingFunction::d2rhorbardxidxj(const std::vector<double> &x, int i, int j)
 {
-	double rhor = this->rhorbar(x);
-	double dvrbardxi = this->dvrbardxi__constxj(x,i);
-	double dvrbardxj = this->dvrbardxi__constxj(x,j);
-	return 2*pow(rhor,(int)3)*dvrbardxi*dvrbardxj-pow(rhor,(int)2)*this->d2vrbardxidxj(x,i,j);
+	const ReducingFunctionCacheElement &e = cached(x);
+	double rhor = e.rhorbar;
+	double dvrbardxi = e.dvrbardxi[i];
+	double dvrbardxj = e.dvrbardxi[j];
+	return 2*pow(rhor,(int)3)*dvrbardxi*dvrbardxj-pow(rhor,(int)2)*e.d2vrbardxidxj[i][j];
 }
-
 double GERG2008ReducingFunction::rhorbar(const std::vector<double> &x)
 {
-	double vrbar = 0;
-	for (unsigned int i = 0; i < N; i++)
-	{
-		double xi = x[i];
-		vrbar += xi*xi/pFluids[i]->reduce.rhobar;
-
-		if (i == N-1){ break; }
-
-		for (unsigned int j = i+1; j < N; j++)
-		{	
-			vrbar += c_Y_ij(i, j, &beta_v, &gamma_v, &v_c)*f_Y_ij(x,i,j,&beta_v);
-		}
-	}
-	return 1/vrbar;
+	return cached(x).rhorbar;
 }
 double GERG2008ReducingFunction::dfYkidxi__constxk(const std::vector<double> &x, int k, int i, std::vector< std::vector< double> > * beta)
 {
@@ -1751,6 +1742,7 @@ void GERG2008ReducingFunction::set_coeffs_from_map(int i, int j, std::map<std::s
 		
 	gamma_v[i][j] = m.find("gammaV")->second;
 	gamma_T[i][j] = m.find("gammaT")->second;
+	clear_cache();
 
 	//std::map<std::string,std::vector<double> >::iterator it;
 	//// Try to find using the ma
@@ -1908,6 +1900,14 @@ double GERG2008DepartureFunction::d2phir_dTau2(double tau, double delta)
 	}
 }
 
+void GERG2008DepartureFunction::all(double tau, double delta, HelmholtzDerivatives &derivs)
+{
+	phi1.all(tau, delta, derivs, 2);
+	if (using_gaussian){
+		phi2.all(tau, delta, derivs, 2);
+	}
+}
+
 void GERG2008DepartureFunction::set_coeffs_from_map(std::map<std::string,std::vector<double> > m)
 {
 	std::vector<double> n = m.find("n")->second;
@@ -2049,6 +2049,11 @@ double LemmonHFCDepartureFunction::d2phir_dTau2(double tau, double delta)
 	}
 }
 
+void LemmonHFCDepartureFunction::all(double tau, double delta, HelmholtzDerivatives &derivs)
+{
+	phi1.all(tau, delta, derivs, 2);
+}
+
 void LemmonHFCDepartureFunction::set_coeffs_from_map(std::map<std::string,std::vector<double> > m)
 {
 	std::vector<double> n = m.find("n")->second;
@@ -2071,6 +2076,42 @@ void LemmonAirHFCReducingFunction::set_coeffs_from_map(int i, int j, std::map<st
 	double v_j = 1/pFluids[j]->reduce.rhobar;
 	double one_third = 0.33333333333333333;
 	gamma_v[i][j] = (v_i + v_j + zeta_ij)/(0.25*pow(pow(v_i, one_third)+pow(v_j, one_third),(int)3));
+	clear_cache();
+}
+
+void DepartureFunction::all(double tau, double delta, HelmholtzDerivatives &derivs)
+{
+	derivs.base += phir(tau, delta);
+	derivs.dTau += dphir_dTau(tau, delta);
+	derivs.dDelta += dphir_dDelta(tau, delta);
+	derivs.dTau2 += d2phir_dTau2(tau, delta);
+	derivs.dDelta_dTau += d2phir_dDelta_dTau(tau, delta);
+	derivs.dDelta2 += d2phir_dDelta2(tau, delta);
+}
+
+const std::vector<HelmholtzDerivatives> *HelmholtzTermsCache::find(double tau, double delta)
+{
+	for (int k = 0; k < 2; k++)
+	{
+		int i = (last+k)%2;
+		if (elements[i].valid && tau == elements[i].tau && delta == elements[i].delta)
+		{
+			last = i;
+			return &(elements[i].derivs);
+		}
+	}
+	return NULL;
+}
+std::vector<HelmholtzDerivatives> &HelmholtzTermsCache::insert(double tau, double delta, unsigned int N)
+{
+	last = 1-last;
+	Element &e = elements[last];
+	e.valid = true;
+	e.tau = tau;
+	e.delta = delta;
+	e.derivs.resize(N);
+	for (unsigned int i = 0; i < N; i++){ e.derivs[i].reset(); }
+	return e.derivs;
 }
 
 ExcessTerm::ExcessTerm(int N)
@@ -2092,87 +2133,112 @@ ExcessTerm::~ExcessTerm()
 		}
 	}
 }
+const std::vector<HelmholtzDerivatives> &ExcessTerm::departure_derivatives(double tau, double delta)
+{
+	const std::vector<HelmholtzDerivatives> *cached = cache.find(tau, delta);
+	if (cached != NULL){ return *cached; }
+
+	std::vector<HelmholtzDerivatives> &derivs = cache.insert(tau, delta, N*N);
+	for (unsigned int i = 0; i < N; i++)
+	{
+		for (unsigned int j = 0; j < N; j++)
+		{	
+			if (i != j)
+			{
+				DepartureFunctionMatrix[i][j]->all(tau, delta, derivs[i*N+j]);
+			}
+		}
+	}
+	return derivs;
+}
 
 double ExcessTerm::phir(double tau, double delta, const std::vector<double> &x)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = departure_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int i = 0; i < N-1; i++)
 	{
 		for (unsigned int j = i + 1; j < N; j++)
 		{	
-			summer += x[i]*x[j]*F[i][j]*DepartureFunctionMatrix[i][j]->phir(tau,delta);
+			summer += x[i]*x[j]*F[i][j]*derivs[i*N+j].base;
 		}
 	}
 	return summer;
 }
 double ExcessTerm::dphir_dTau(double tau, double delta, const std::vector<double> &x)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = departure_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int i = 0; i < N-1; i++)
 	{
 		for (unsigned int j = i + 1; j < N; j++)
 		{	
-			summer += x[i]*x[j]*F[i][j]*DepartureFunctionMatrix[i][j]->dphir_dTau(tau,delta);
+			summer += x[i]*x[j]*F[i][j]*derivs[i*N+j].dTau;
 		}
 	}
 	return summer;
 }
 double ExcessTerm::dphir_dDelta(double tau, double delta, const std::vector<double> &x)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = departure_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int i = 0; i < N-1; i++)
 	{
 		for (unsigned int j = i + 1; j < N; j++)
 		{	
-			summer += x[i]*x[j]*F[i][j]*DepartureFunctionMatrix[i][j]->dphir_dDelta(tau,delta);
+			summer += x[i]*x[j]*F[i][j]*derivs[i*N+j].dDelta;
 		}
 	}
 	return summer;
 }
 double ExcessTerm::d2phir_dDelta2(double tau, double delta, const std::vector<double> &x)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = departure_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int i = 0; i < N-1; i++)
 	{
 		for (unsigned int j = i + 1; j < N; j++)
 		{	
-			summer += x[i]*x[j]*F[i][j]*DepartureFunctionMatrix[i][j]->d2phir_dDelta2(tau,delta);
+			summer += x[i]*x[j]*F[i][j]*derivs[i*N+j].dDelta2;
 		}
 	}
 	return summer;
 }
 double ExcessTerm::d2phir_dTau2(double tau, double delta, const std::vector<double> &x)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = departure_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int i = 0; i < N-1; i++)
 	{
 		for (unsigned int j = i + 1; j < N; j++)
 		{	
-			summer += x[i]*x[j]*F[i][j]*DepartureFunctionMatrix[i][j]->d2phir_dTau2(tau,delta);
+			summer += x[i]*x[j]*F[i][j]*derivs[i*N+j].dTau2;
 		}
 	}
 	return summer;
 }
 double ExcessTerm::d2phir_dDelta_dTau(double tau, double delta, const std::vector<double> &x)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = departure_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int i = 0; i < N-1; i++)
 	{
 		for (unsigned int j = i + 1; j < N; j++)
 		{	
-			summer += x[i]*x[j]*F[i][j]*DepartureFunctionMatrix[i][j]->d2phir_dDelta_dTau(tau,delta);
+			summer += x[i]*x[j]*F[i][j]*derivs[i*N+j].dDelta_dTau;
 		}
 	}
 	return summer;
 }
 double ExcessTerm::dphir_dxi(double tau, double delta, const std::vector<double> &x, unsigned int i)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = departure_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int k = 0; k < N; k++)
 	{
 		if (i != k)
 		{
-			summer += x[k]*F[i][k]*DepartureFunctionMatrix[i][k]->phir(tau,delta);
+			summer += x[k]*F[i][k]*derivs[i*N+k].base;
 		}
 	}
 	return summer;
@@ -2181,7 +2247,7 @@ double ExcessTerm::d2phirdxidxj(double tau, double delta, const std::vector<doub
 {
 	if (i != j)
 	{
-		return F[i][j]*DepartureFunctionMatrix[i][j]->phir(tau,delta);
+		return F[i][j]*departure_derivatives(tau, delta)[i*N+j].base;
 	}
 	else
 	{
@@ -2190,24 +2256,26 @@ double ExcessTerm::d2phirdxidxj(double tau, double delta, const std::vector<doub
 }
 double ExcessTerm::d2phir_dxi_dTau(double tau, double delta, const std::vector<double> &x, unsigned int i)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = departure_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int k = 0; k < N; k++)
 	{
 		if (i != k)
 		{
-			summer += x[k]*F[i][k]*DepartureFunctionMatrix[i][k]->dphir_dTau(tau,delta);
+			summer += x[k]*F[i][k]*derivs[i*N+k].dTau;
 		}
 	}
 	return summer;
 }
 double ExcessTerm::d2phir_dxi_dDelta(double tau, double delta, const std::vector<double> &x, unsigned int i)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = departure_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int k = 0; k < N; k++)
 	{
 		if (i != k)
 		{
-			summer += x[k]*F[i][k]*DepartureFunctionMatrix[i][k]->dphir_dDelta(tau,delta);
+			summer += x[k]*F[i][k]*derivs[i*N+k].dDelta;
 		}
 	}
 	return summer;
@@ -2215,6 +2283,7 @@ double ExcessTerm::d2phir_dxi_dDelta(double tau, double delta, const std::vector
 void ExcessTerm::set_coeffs_from_map(int i, int j, std::map<std::string, std::vector<double> > m)
 {
 	DepartureFunctionMatrix[i][j]->set_coeffs_from_map(m);
+	clear_cache();
 }
 
 ResidualIdealMixture::ResidualIdealMixture(std::vector<Fluid*> pFluids)
@@ -2222,57 +2291,79 @@ ResidualIdealMixture::ResidualIdealMixture(std::vector<Fluid*> pFluids)
 	this->pFluids = pFluids;
 	this->N = pFluids.size();
 }
+const std::vector<HelmholtzDerivatives> &ResidualIdealMixture::component_derivatives(double tau, double delta)
+{
+	const std::vector<HelmholtzDerivatives> *cached = cache.find(tau, delta);
+	if (cached != NULL){ return *cached; }
+
+	std::vector<HelmholtzDerivatives> &derivs = cache.insert(tau, delta, N);
+	for (unsigned int i = 0; i < N; i++)
+	{
+		std::vector<phi_BC*> &phirlist = pFluids[i]->phirlist;
+		for (std::vector<phi_BC*>::iterator it = phirlist.begin(); it != phirlist.end(); it++)
+		{
+			(*it)->all(tau, delta, derivs[i], 2);
+		}
+	}
+	return derivs;
+}
 double ResidualIdealMixture::phir(double tau, double delta, const std::vector<double> &x)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = component_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int i = 0; i < N; i++)
 	{
-		summer += x[i]*pFluids[i]->phir(tau,delta);
+		summer += x[i]*derivs[i].base;
 	}
 	return summer;
 }
 double ResidualIdealMixture::dphir_dDelta(double tau, double delta, const std::vector<double> &x)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = component_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int i = 0; i < N; i++)
 	{
-		summer += x[i]*pFluids[i]->dphir_dDelta(tau,delta);
+		summer += x[i]*derivs[i].dDelta;
 	}
 	return summer;
 }
 double ResidualIdealMixture::d2phir_dDelta2(double tau, double delta, const std::vector<double> &x)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = component_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int i = 0; i < N; i++)
 	{
-		summer += x[i]*pFluids[i]->d2phir_dDelta2(tau,delta);
+		summer += x[i]*derivs[i].dDelta2;
 	}
 	return summer;
 }
 double ResidualIdealMixture::d2phir_dDelta_dTau(double tau, double delta, const std::vector<double> &x)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = component_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int i = 0; i < N; i++)
 	{
-		summer += x[i]*pFluids[i]->d2phir_dDelta_dTau(tau,delta);
+		summer += x[i]*derivs[i].dDelta_dTau;
 	}
 	return summer;
 }
 double ResidualIdealMixture::dphir_dTau(double tau, double delta, const std::vector<double> &x)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = component_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int i = 0; i < N; i++)
 	{
-		summer += x[i]*pFluids[i]->dphir_dTau(tau,delta);
+		summer += x[i]*derivs[i].dTau;
 	}
 	return summer;
 }
 double ResidualIdealMixture::d2phir_dTau2(double tau, double delta, const std::vector<double> &x)
 {
+	const std::vector<HelmholtzDerivatives> &derivs = component_derivatives(tau, delta);
 	double summer = 0;
 	for (unsigned int i = 0; i < N; i++)
 	{
-		summer += x[i]*pFluids[i]->d2phir_dTau2(tau,delta);
+		summer += x[i]*derivs[i].dTau2;
 	}
 	return summer;
 }
@@ -2928,6 +3019,37 @@ void PhaseEnvelope::to_python_files(std::string base_fname)
 
 #ifndef DISABLE_CATCH
 #include "Catch/catch.hpp"
+TEST_CASE("Mixture caches give the same values as a fresh evaluation", "[mixtures],[fast]")
+{
+	Mixture Mix("Methane|Ethane");
+	double x1[] = {0.3, 0.7}, x2[] = {0.5, 0.5}, x3[] = {0.8, 0.2};
+	std::vector<double> z1(x1, x1+2), z2(x2, x2+2), z3(x3, x3+2);
+
+	SECTION("reducing parameters after the cache has been cycled")
+	{
+		// Three compositions through a two-slot cache evicts the first one
+		Mix.pReducing->Tr(z1); Mix.pReducing->Tr(z2); Mix.pReducing->Tr(z3);
+		Mixture Fresh("Methane|Ethane");
+		CHECK(Mix.pReducing->Tr(z1) == Fresh.pReducing->Tr(z1));
+		CHECK(Mix.pReducing->rhorbar(z1) == Fresh.pReducing->rhorbar(z1));
+		CHECK(Mix.pReducing->d2rhorbardxi2__constxj(z1,0) == Fresh.pReducing->d2rhorbardxi2__constxj(z1,0));
+	}
+	SECTION("residual Helmholtz energy after the cache has been cycled")
+	{
+		double phir1 = Mix.phir(1.1, 0.4, z1);
+		Mix.phir(1.2, 0.5, z1); Mix.phir(1.3, 0.6, z1);
+		CHECK(Mix.phir(1.1, 0.4, z1) == phir1);
+		CHECK(Mix.dphir_dDelta(1.1, 0.4, z2) == Mixture("Methane|Ethane").dphir_dDelta(1.1, 0.4, z2));
+	}
+	SECTION("new reducing coefficients invalidate the cache")
+	{
+		double Tr_before = Mix.pReducing->Tr(z2);
+		std::map<std::string, double> m = Mix.load_reducing_values(0, 1);
+		m.find("gammaT")->second *= 1.01;
+		Mix.pReducing->set_coeffs_from_map(0, 1, m);
+		CHECK(Mix.pReducing->Tr(z2) != Tr_before);
+	}
+}
 TEST_CASE("Mixture derivative checks", "")
 	{
 		Mixture Mix("Methane|Ethane");
@@ -55,9 +55,26 @@ public:
 	double ndTrdni__constnj(const std::vector<double> &x, int i);
 };
 
+/// The reducing parameters and their first and second derivatives with respect to the mole fractions at one composition
+struct ReducingFunctionCacheElement
+{
+	std::vector<double> x; ///< The composition, empty if the element is not in use
+	double Tr, ///< Reducing temperature [K]
+		   rhorbar; ///< Molar reducing density [mol/m^3]
+	std::vector<double> dTrdxi, ///< \f$ (\partial T_r/\partial x_i)_{x_j} \f$
+						dvrbardxi; ///< \f$ (\partial \bar v_r/\partial x_i)_{x_j} \f$
+	STLMatrix d2Trdxidxj, ///< \f$ \partial^2 T_r/\partial x_i \partial x_j \f$
+			  d2vrbardxidxj; ///< \f$ \partial^2 \bar v_r/\partial x_i \partial x_j \f$
+};
+
 /*! 
 The Reducing parameter model used by the GERG-2008 formulation to yield the
 reducing parameters \f$ \bar\rho_r \f$ and \f$ T_r \f$ and derivatives thereof
+
+The reducing parameters and all their composition derivatives are evaluated together the first time they are
+needed for a composition, and then taken from a cache of the two most recently used compositions.  Two are kept 
+so that the liquid and vapor phases of a VLE calculation do not evict each other.  The cache is cleared
+when the coefficients are changed.
 */
 class GERG2008ReducingFunction : public ReducingFunction
 {
@@ -69,6 +86,13 @@ protected:
 	STLMatrix beta_T; //!< \f$ \beta_{T,ij} \f$ from GERG-2008
 	STLMatrix gamma_T; //!< \f$ \gamma_{T,ij} \f$ from GERG-2008
 	std::vector<Fluid *> pFluids; //!< List of pointers to fluids
+
+	ReducingFunctionCacheElement cache[2];
+	int cache_last; ///< The index of the most recently used element of the cache
+	/// The cache element for the composition x, which is evaluated if it is not in the cache
+	const ReducingFunctionCacheElement &cached(const std::vector<double> &x);
+	/// Evaluate the reducing parameters and their derivatives at the composition x
+	void evaluate(const std::vector<double> &x, ReducingFunctionCacheElement &e);
 public:
 	GERG2008ReducingFunction(std::vector<Fluid *> pFluids, STLMatrix beta_v, STLMatrix gamma_v, STLMatrix beta_T, STLMatrix gamma_T)
 	{
@@ -78,11 +102,13 @@ public:
 		this->beta_T = beta_T;
 		this->gamma_T = gamma_T;
 		this->N = pFluids.size();
+		clear_cache();
 	};
 	GERG2008ReducingFunction(std::vector<Fluid *> pFluids)
 	{
 		this->pFluids = pFluids;
 		this->N = pFluids.size();
+		clear_cache();
 		/// Resize reducing parameter matrices to be the same size as x in both directions
 		beta_v.resize(N,std::vector<double>(N,0));
 		gamma_v.resize(N,std::vector<double>(N,0));
@@ -121,6 +147,9 @@ public:
 	/// Set the coefficients based on reducing parameters loaded from JSON
 	void set_coeffs_from_map(int i, int j, std::map<std::string,double >);
 
+	/// Drop the cached reducing parameters, must be called if the coefficients are changed
+	void clear_cache(){ cache[0].x.clear(); cache[1].x.clear(); cache_last = 0; };
+
 	double c_Y_ij(int i, int j, std::vector< std::vector< double> > * beta, std::vector< std::vector< double> > *gamma, std::vector< std::vector< double> > *Y_c);
 	double c_Y_ji(int j, int i, std::vector< std::vector< double> > * beta, std::vector< std::vector< double> > *gamma, std::vector< std::vector< double> > *Y_c);
 	double f_Y_ij(const std::vector<double> &x, int i, int j, std::vector< std::vector< double> > * beta);
@@ -194,6 +223,9 @@ public:
 	virtual double dphir_dTau(double tau, double delta) = 0;
 	virtual double d2phir_dTau2(double tau, double delta) = 0;
 	virtual void set_coeffs_from_map(std::map<std::string,std::vector<double> >) = 0;
+	/// Add the excess Helmholtz energy and its derivatives up to second order to derivs.  The default calls each of
+	/// the derivative functions, the departure functions override it to evaluate each term only once
+	virtual void all(double tau, double delta, HelmholtzDerivatives &derivs);
 };
 
 struct DepartureFunctionCacheElement
@@ -223,6 +255,7 @@ public:
 	double d2phir_dDelta2(double tau, double delta);
 	double d2phir_dTau2(double tau, double delta);
 	void set_coeffs_from_map(std::map<std::string,std::vector<double> >);
+	void all(double tau, double delta, HelmholtzDerivatives &derivs);
 };
 
 class LemmonHFCDepartureFunction : public DepartureFunction
@@ -241,16 +274,50 @@ public:
 	double d2phir_dDelta2(double tau, double delta);
 	double d2phir_dTau2(double tau, double delta);
 	void set_coeffs_from_map(std::map<std::string,std::vector<double> >);
+	void all(double tau, double delta, HelmholtzDerivatives &derivs);
+};
+
+/*!
+The residual Helmholtz energy and its derivatives up to second order of each of a set of terms (the components of 
+a mixture, or its departure functions) at the two most recently used values of (tau, delta).  Two are kept so that 
+the liquid and vapor phases of a VLE calculation do not evict each other
+*/
+class HelmholtzTermsCache
+{
+protected:
+	struct Element
+	{
+		bool valid;
+		double tau, delta;
+		std::vector<HelmholtzDerivatives> derivs;
+	};
+	Element elements[2];
+	int last; ///< The index of the most recently used element
+public:
+	HelmholtzTermsCache(){ clear(); };
+	/// Drop all the cached values
+	void clear(){ elements[0].valid = false; elements[1].valid = false; last = 0; };
+	/// The cached derivatives at (tau, delta), or NULL if they are not in the cache
+	const std::vector<HelmholtzDerivatives> *find(double tau, double delta);
+	/// Make room for the derivatives of N terms at (tau, delta) in place of the least recently used ones; all of them are reset to zero
+	std::vector<HelmholtzDerivatives> &insert(double tau, double delta, unsigned int N);
 };
 
 class ExcessTerm
 {
+protected:
+	HelmholtzTermsCache cache;
 public:
 	unsigned int N;
 	std::vector<std::vector<DepartureFunction*> > DepartureFunctionMatrix;
 	std::vector<std::vector<double> > F;
 	ExcessTerm(int N);
 	~ExcessTerm();
+	/// The derivatives of the departure function of each binary pair at (tau, delta), the pair i,j is at index i*N+j.
+	/// They do not depend on the composition, so they are cached
+	const std::vector<HelmholtzDerivatives> &departure_derivatives(double tau, double delta);
+	/// Drop the cached departure function values, must be called if DepartureFunctionMatrix is changed directly
+	void clear_cache(){ cache.clear(); };
 	double phir(double tau, double delta, const std::vector<double> &x);
 	double dphir_dDelta(double tau, double delta, const std::vector<double> &x);
 	double d2phir_dDelta2(double tau, double delta, const std::vector<double> &x);
@@ -270,8 +337,11 @@ class ResidualIdealMixture
 protected:
 	unsigned int N;
 	std::vector<Fluid*> pFluids;
+	HelmholtzTermsCache cache;
 public:
 	ResidualIdealMixture(std::vector<Fluid*> pFluids);
+	/// The residual Helmholtz energy derivatives of each of the components at (tau, delta), which are cached
+	const std::vector<HelmholtzDerivatives> &component_derivatives(double tau, double delta);
 	double phir(double tau, double delta, const std::vector<double> &x);
 	double dphir_dDelta(double tau, double delta, const std::vector<double> &x);
 	double d2phir_dDelta2(double tau, double delta, const std::vector<double> &x);
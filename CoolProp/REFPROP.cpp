@@ -1069,7 +1069,15 @@ bool REFPROPFluidClass::refpropSupported () {
 		if (rpv.compare("NOTAVAILABLE")!=0) {
 			// Function names were defined in "REFPROP_lib.h",
 			// This platform theoretically supports Refprop.
-			if (load_REFPROP()) {
+			// load_REFPROP throws if the library cannot be found, which is reported below
+			bool loaded;
+			try{
+				loaded = load_REFPROP();
+			}
+			catch(std::exception &){
+				loaded = false;
+			}
+			if (loaded) {
 				return true;
 			}
 			else {
@@ -1140,6 +1148,41 @@ double REFPROPFluidClass::d2phir_dTau2(double tau, double delta)
 	return -cvr/(params.R_u*tau*tau);
 }
 
+/// Fill in the third derivatives of phir and the third tau derivative of phi0 by centered finite differences
+/// of the second derivatives of the fluid, for fluids that only provide derivatives up to second order
+static void _third_derivatives_by_finite_differences(Fluid *pFluid, double tau, double delta, FluidHelmholtzDerivatives &derivs)
+{
+	double dtau = 1e-5*tau, ddelta = 1e-5*delta;
+	derivs.phir.dDelta3 = (pFluid->d2phir_dDelta2(tau,delta+ddelta)-pFluid->d2phir_dDelta2(tau,delta-ddelta))/(2*ddelta);
+	derivs.phir.dDelta2_dTau = (pFluid->d2phir_dDelta2(tau+dtau,delta)-pFluid->d2phir_dDelta2(tau-dtau,delta))/(2*dtau);
+	derivs.phir.dDelta_dTau2 = (pFluid->d2phir_dDelta_dTau(tau+dtau,delta)-pFluid->d2phir_dDelta_dTau(tau-dtau,delta))/(2*dtau);
+	derivs.phir.dTau3 = (pFluid->d2phir_dTau2(tau+dtau,delta)-pFluid->d2phir_dTau2(tau-dtau,delta))/(2*dtau);
+	derivs.phi0.dTau3 = (pFluid->d2phi0_dTau2(tau+dtau,delta)-pFluid->d2phi0_dTau2(tau-dtau,delta))/(2*dtau);
+}
+FluidHelmholtzDerivatives REFPROPFluidClass::Helmholtz_derivatives(double tau, double delta, int max_order)
+{
+	// REFPROP provides the derivatives up to second order, the third derivatives are obtained
+	// from them by centered finite differences
+	FluidHelmholtzDerivatives derivs;
+	derivs.phir.base = phir(tau,delta);
+	derivs.phir.dDelta = dphir_dDelta(tau,delta);
+	derivs.phir.dTau = dphir_dTau(tau,delta);
+	derivs.phir.dDelta2 = d2phir_dDelta2(tau,delta);
+	derivs.phir.dDelta_dTau = d2phir_dDelta_dTau(tau,delta);
+	derivs.phir.dTau2 = d2phir_dTau2(tau,delta);
+	derivs.phi0.base = phi0(tau,delta);
+	derivs.phi0.dTau = dphi0_dTau(tau,delta);
+	derivs.phi0.dTau2 = d2phi0_dTau2(tau,delta);
+	// The ideal-gas part only depends on delta through log(delta)
+	derivs.phi0.dDelta = 1/delta;
+	derivs.phi0.dDelta2 = -1/(delta*delta);
+	derivs.phi0.dDelta3 = 2/(delta*delta*delta);
+	if (max_order >= 3){
+		_third_derivatives_by_finite_differences(this,tau,delta,derivs);
+	}
+	return derivs;
+}
+
 double REFPROPFluidClass::d2phir_dDelta_dTau(double tau, double delta)
 {
 	double T,rho,rhobar,dpdT_constrho;
@@ -1278,7 +1321,7 @@ void REFPROPFluidClass::temperature_ph(double p, double h, double &Tout, double
 		this->saturation_p(p*1000,false,TsatL,TsatV,dummy1,dummy2);
 	}
 }
-void REFPROPFluidClass::temperature_ps(double p, double s, double &Tout, double &rho, double &rhoL, double &rhoV, double &TsatL, double &TsatV)
+void REFPROPFluidClass::temperature_ps(double p, double s, double &Tout, double &rho, double &rhoL, double &rhoV, double &TsatL, double &TsatV, double /*T0*/, double /*rho0*/)
 {
     double q,e,h,cv,cp,w,sbar = s*params.molemass, dummy1,dummy2;
 	long ierr;
@@ -1303,7 +1346,7 @@ void REFPROPFluidClass::temperature_ps(double p, double s, double &Tout, double
 		this->saturation_p(p*1000,false,TsatL,TsatV,dummy1,dummy2);
 	}
 }
-void REFPROPFluidClass::temperature_hs(double h, double s, double &Tout, double &rho, double &rhoL, double &rhoV, double &TsatL, double &TsatV)
+void REFPROPFluidClass::temperature_hs(double h, double s, double &Tout, double &rho, double &rhoL, double &rhoV, double &TsatL, double &TsatV, double /*T0*/, double /*rho0*/)
 {
     double q,e,cv,cp,w,p,sbar = s*params.molemass, hbar = h*params.molemass, dummy1, dummy2;
 	long ierr;
@@ -1399,7 +1442,7 @@ double REFPROPFluidClass::rhosatL(double T)
 TEST_CASE("REFPROP Fluid Class Helmholtz derivatives check", "[helmholtz],[fast]")
 {
 	std::vector<double> x(1,1);
-	REFPROPFluidClass fluid = REFPROPFluidClass("REFPROP-Water",x);
+	REFPROPFluidClass fluid("REFPROP-Water",x);
 	double eps = sqrt(DBL_EPSILON);
 
 	SECTION("dDelta")
@@ -1434,10 +1477,39 @@ TEST_CASE("REFPROP Fluid Class Helmholtz derivatives check", "[helmholtz],[fast]
 	}
 }
 
+TEST_CASE("REFPROP Fluid Class third derivatives", "[helmholtz],[fast]")
+{
+	// REFPROP and CoolProp both use IAPWS-95 for water
+	Fluid *pWater = get_fluid(get_Fluid_index("Water"));
+	SECTION("finite differences of the CoolProp second derivatives")
+	{
+		// The same scheme as for REFPROP, so it can be checked without REFPROP
+		FluidHelmholtzDerivatives derivs;
+		_third_derivatives_by_finite_differences(pWater, 0.5, 0.5, derivs);
+		CHECK(fabs(derivs.phir.dDelta3/pWater->d3phir_dDelta3(0.5, 0.5)-1) < 1e-5);
+		CHECK(fabs(derivs.phir.dDelta2_dTau/pWater->d3phir_dDelta2_dTau(0.5, 0.5)-1) < 1e-5);
+		CHECK(fabs(derivs.phir.dDelta_dTau2/pWater->d3phir_dDelta_dTau2(0.5, 0.5)-1) < 1e-5);
+		CHECK(fabs(derivs.phir.dTau3/pWater->d3phir_dTau3(0.5, 0.5)-1) < 1e-5);
+		CHECK(fabs(derivs.phi0.dTau3/pWater->d3phi0_dTau3(0.5, 0.5)-1) < 1e-5);
+	}
+	SECTION("REFPROP against CoolProp")
+	{
+		if (REFPROPFluidClass::refpropSupported()) {
+			std::vector<double> x(1,1);
+			REFPROPFluidClass fluid("REFPROP-Water",x);
+			FluidHelmholtzDerivatives derivs = fluid.Helmholtz_derivatives(0.5, 0.5);
+			CHECK(fabs(derivs.phir.dDelta3/pWater->d3phir_dDelta3(0.5, 0.5)-1) < 1e-5);
+			CHECK(fabs(derivs.phir.dDelta2_dTau/pWater->d3phir_dDelta2_dTau(0.5, 0.5)-1) < 1e-5);
+			CHECK(fabs(derivs.phir.dDelta_dTau2/pWater->d3phir_dDelta_dTau2(0.5, 0.5)-1) < 1e-5);
+			CHECK(fabs(derivs.phir.dTau3/pWater->d3phir_dTau3(0.5, 0.5)-1) < 1e-5);
+		}
+	}
+}
+
 TEST_CASE("REFPROP Fluid Class check saturation consistency", "")
 {
 	std::vector<double> x(1,1);
-	REFPROPFluidClass fluid = REFPROPFluidClass("REFPROP-Water",x);
+	REFPROPFluidClass fluid("REFPROP-Water",x);
 	double eps = sqrt(DBL_EPSILON);
 
 	SECTION("sat")
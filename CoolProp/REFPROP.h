@@ -26,6 +26,8 @@
 		double dphi0_dTau(double tau, double delta);
 		double d2phi0_dTau2(double tau, double delta);
 
+		FluidHelmholtzDerivatives Helmholtz_derivatives(double tau, double delta, int max_order = 3);
+
 		double viscosity_Trho(double T, double rho);
 		double conductivity_Trho(double T, double rho);
 		double surface_tension_T(double T);
@@ -35,8 +37,8 @@
 
 		// Flash routines
 		void temperature_ph(double p, double h, double &Tout, double &rhoout, double &rhoLout, double &rhoVout, double &TsatLout, double &TsatVout, double T0, double rho0);
-		void temperature_ps(double p, double s, double &Tout, double &rhoout, double &rhoLout, double &rhoVout, double &TsatLout, double &TsatVout);
-		void temperature_hs(double h, double s, double &Tout, double &rhoout, double &rhoLout, double &rhoVout, double &TsatLout, double &TsatVout);
+		void temperature_ps(double p, double s, double &Tout, double &rhoout, double &rhoLout, double &rhoVout, double &TsatLout, double &TsatVout, double T0, double rho0);
+		void temperature_hs(double h, double s, double &Tout, double &rhoout, double &rhoLout, double &rhoVout, double &TsatLout, double &TsatVout, double T0, double rho0);
 		double density_Tp(double T, double p);
 		double density_Tp(double T, double p, double rho_guess);
 
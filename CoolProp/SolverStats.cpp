@@ -0,0 +1,108 @@
+#include "SolverStats.h"
+#include <exception>
+#include <ctime>
+#if defined(COOLPROP_CXX11_THREADS)
+#include <chrono>
+#endif
+
+CoolPropAtomicBool solver_stats_enabled(false);
+SolverStatsClass unattributed_solver_stats;
+
+/// The fluid whose routine is running in this thread, NULL if none
+static COOLPROP_THREAD_LOCAL SolverStatsClass *current_solver_stats = NULL;
+
+static const char *solver_stats_routine_names[SOLVER_STATS_N] = {
+	"temperature_ph", "temperature_ps", "temperature_hs", "temperature_rhou", "temperature_rhoh", "temperature_pu", "density_Tp", "density_Tu", "density_Th", "saturation_T", "saturation_p",
+	"rhosatPure", "rhosatPure_Akasaka", "rhosatPure_Brent", "rhosatPure_BrentrhoV",
+	"Brent", "Secant", "BoundedSecant", "Newton", "BracketedNewton", "NDNewtonRaphson_Jacobian"
+};
+
+std::string get_solver_stats_routine_name(int routine)
+{
+	if (routine < 0 || routine >= SOLVER_STATS_N){ return std::string(""); }
+	return std::string(solver_stats_routine_names[routine]);
+}
+
+static long long nanoseconds_now()
+{
+#if defined(COOLPROP_CXX11_THREADS)
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+	return (long long)((double)clock()/CLOCKS_PER_SEC*1e9);
+#endif
+}
+
+/// The number of exceptions in flight in this thread
+static int uncaught_exceptions()
+{
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+	return std::uncaught_exceptions();
+#else
+	return std::uncaught_exception() ? 1 : 0;
+#endif
+}
+
+void SolverStatsClass::reset()
+{
+	for (int i = 0; i < SOLVER_STATS_N; i++)
+	{
+		entries[i].calls = 0;
+		entries[i].iterations = 0;
+		entries[i].fallbacks = 0;
+		entries[i].failures = 0;
+		entries[i].nanoseconds = 0;
+	}
+}
+
+bool SolverStatsClass::empty()
+{
+	for (int i = 0; i < SOLVER_STATS_N; i++)
+	{
+		if (entries[i].calls > 0){ return false; }
+	}
+	return true;
+}
+
+std::string SolverStatsClass::to_string(const std::string &name)
+{
+	std::string out;
+	for (int i = 0; i < SOLVER_STATS_N; i++)
+	{
+		SolverStatsEntry &e = entries[i];
+		long long calls = e.calls;
+		if (calls == 0){ continue; }
+		out += format("%s,%s,%lld,%lld,%lld,%lld,%0.9g\n", name.c_str(), solver_stats_routine_names[i],
+			calls, (long long)e.iterations, (long long)e.fallbacks, (long long)e.failures, (double)e.nanoseconds*1e-9);
+	}
+	return out;
+}
+
+void SolverStatsScope::begin(SolverStatsClass *stats, int routine, bool owner)
+{
+	if (stats == NULL)
+	{
+		stats = (current_solver_stats != NULL) ? current_solver_stats : &unattributed_solver_stats;
+	}
+	this->owner = owner;
+	if (owner)
+	{
+		previous = current_solver_stats;
+		current_solver_stats = stats;
+	}
+	entry = &(stats->entries[routine]);
+	exceptions = uncaught_exceptions();
+	t_start = nanoseconds_now();
+}
+
+void SolverStatsScope::end()
+{
+	entry->nanoseconds += nanoseconds_now()-t_start;
+	entry->calls += 1;
+	if (iterations > 0){ entry->iterations += iterations; }
+	if (fallbacks > 0){ entry->fallbacks += fallbacks; }
+	if (failed || uncaught_exceptions() > exceptions){ entry->failures += 1; }
+	if (owner)
+	{
+		current_solver_stats = previous;
+	}
+}
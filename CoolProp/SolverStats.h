@@ -0,0 +1,117 @@
+#ifndef SOLVERSTATS_H
+#define SOLVERSTATS_H
+
+#include <string>
+#include <cstddef>
+#include "CoolPropTools.h"
+
+/// The routines for which the number of calls, iterations, fallbacks and failures and the time are recorded
+enum solver_stats_routines
+{
+	SOLVER_STATS_TEMPERATURE_PH,
+	SOLVER_STATS_TEMPERATURE_PS,
+	SOLVER_STATS_TEMPERATURE_HS,
+	SOLVER_STATS_TEMPERATURE_RHOU,
+	SOLVER_STATS_TEMPERATURE_RHOH,
+	SOLVER_STATS_TEMPERATURE_PU,
+	SOLVER_STATS_DENSITY_TP,
+	SOLVER_STATS_DENSITY_TU,
+	SOLVER_STATS_DENSITY_TH,
+	SOLVER_STATS_SATURATION_T,
+	SOLVER_STATS_SATURATION_P,
+	SOLVER_STATS_RHOSATPURE,
+	SOLVER_STATS_RHOSATPURE_AKASAKA,
+	SOLVER_STATS_RHOSATPURE_BRENT,
+	SOLVER_STATS_RHOSATPURE_BRENTRHOV,
+	SOLVER_STATS_BRENT,
+	SOLVER_STATS_SECANT,
+	SOLVER_STATS_BOUNDEDSECANT,
+	SOLVER_STATS_NEWTON,
+	SOLVER_STATS_BRACKETEDNEWTON,
+	SOLVER_STATS_NDNEWTONRAPHSON_JACOBIAN,
+	SOLVER_STATS_N
+};
+
+#if defined(COOLPROP_CXX11_THREADS)
+	typedef std::atomic<long long> SolverStatsCounter;
+#else
+	typedef long long SolverStatsCounter;
+#endif
+
+/// The counters of one routine.  Copies take a snapshot of the counters, so that the atomic counters do not 
+/// make the fluids that hold them non-copyable
+struct SolverStatsEntry
+{
+	SolverStatsCounter calls, ///< The number of calls
+		iterations, ///< The number of iterations of the solver, summed over the calls
+		fallbacks, ///< The number of times that a method failed and another one was tried
+		failures, ///< The number of calls that threw an exception or returned an error
+		nanoseconds; ///< The time spent in the routine, including the routines it calls
+	SolverStatsEntry(){ calls = 0; iterations = 0; fallbacks = 0; failures = 0; nanoseconds = 0; };
+	SolverStatsEntry(const SolverStatsEntry &other){ *this = other; };
+	SolverStatsEntry & operator=(const SolverStatsEntry &other)
+	{
+		calls = (long long)other.calls; iterations = (long long)other.iterations; fallbacks = (long long)other.fallbacks;
+		failures = (long long)other.failures; nanoseconds = (long long)other.nanoseconds;
+		return *this;
+	};
+};
+
+/// The counters of all the routines for one fluid
+class SolverStatsClass
+{
+public:
+	SolverStatsClass(){ reset(); };
+	SolverStatsEntry entries[SOLVER_STATS_N];
+	/// Set all the counters to zero
+	void reset();
+	/// True if no routine has been called since the last reset
+	bool empty();
+	/// The counters as comma-separated lines of the form
+	///
+	///		name,routine,calls,iterations,fallbacks,failures,seconds
+	///
+	/// for each routine that has been called
+	std::string to_string(const std::string &name);
+};
+
+/// The name of the routine, like "temperature_ph" or "Brent"
+std::string get_solver_stats_routine_name(int routine);
+
+/// True if the statistics are recorded; off by default
+extern CoolPropAtomicBool solver_stats_enabled;
+
+/// The statistics of the solvers that are not called by a routine of a fluid (humid air for instance)
+extern SolverStatsClass unattributed_solver_stats;
+
+/// Records one call of a routine if the statistics are enabled; does nothing otherwise.
+///
+/// Put at the top of the routine.  The call is counted and timed when the scope is left, and counted
+/// as a failure if it is left by an exception.  While a routine of a fluid is running, the solvers that
+/// are called from it in the same thread are attributed to this fluid.
+class SolverStatsScope
+{
+public:
+	/// A routine of a fluid
+	SolverStatsScope(SolverStatsClass &stats, int routine){ entry = NULL; iterations = 0; fallbacks = 0; failed = false; if (solver_stats_enabled){ begin(&stats, routine, true); } };
+	/// One of the solvers in Solvers.cpp, attributed to the fluid whose routine is running in this thread
+	SolverStatsScope(int routine){ entry = NULL; iterations = 0; fallbacks = 0; failed = false; if (solver_stats_enabled){ begin(NULL, routine, false); } };
+	~SolverStatsScope(){ if (entry != NULL){ end(); } };
+
+	/// Count one iteration
+	void iteration(){ iterations++; };
+	/// Count a fallback to another method
+	void fallback(){ fallbacks++; };
+	/// Count the call as a failure even though it does not throw
+	void failure(){ failed = true; };
+private:
+	SolverStatsEntry *entry;
+	SolverStatsClass *previous;
+	bool owner, failed;
+	long long iterations, fallbacks, t_start;
+	int exceptions;
+	void begin(SolverStatsClass *stats, int routine, bool owner);
+	void end();
+};
+
+#endif
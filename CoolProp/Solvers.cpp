@@ -4,6 +4,7 @@
 #include "MatrixMath.h"
 #include <iostream>
 #include "CoolPropTools.h"
+#include "SolverStats.h"
 /**
 In this formulation of the Multi-Dimensional Newton-Raphson solver the Jacobian matrix is known.
 Therefore, the dx vector can be obtained from 
@@ -22,6 +23,7 @@ functions, each of which take the vector x. The data is managed using std::vecto
 */
 std::vector<double> NDNewtonRaphson_Jacobian(FuncWrapperND *f, std::vector<double> x0, double tol, int maxiter, std::string *errstring)
 {
+	SolverStatsScope stats(SOLVER_STATS_NDNEWTONRAPHSON_JACOBIAN);
 	int iter=0;
 	*errstring=std::string("");
 	std::vector<double> f0,v,negative_f0;
@@ -43,8 +45,10 @@ std::vector<double> NDNewtonRaphson_Jacobian(FuncWrapperND *f, std::vector<doubl
 		if (iter>maxiter){
 			*errstring=std::string("reached maximum number of iterations");
 			x0[0]=_HUGE;
+			stats.failure();
 		}
 		iter++;
+		stats.iteration();
 	}
 	return x0;
 }
@@ -61,6 +65,7 @@ In the newton function, a 1-D Newton-Raphson solver is implemented using exact s
 */
 double Newton(FuncWrapper1D *f, double x0, double ftol, int maxiter, std::string *errstring)
 {
+	SolverStatsScope stats(SOLVER_STATS_NEWTON);
 	double x, dx, fval=999;
     int iter=1;
 	(*errstring).empty();
@@ -70,6 +75,7 @@ double Newton(FuncWrapper1D *f, double x0, double ftol, int maxiter, std::string
 		fval = f->call(x);
 		dx = -fval/f->deriv(x);
 		x += dx;
+		stats.iteration();
 		
 		if (fabs(dx/x) < 10*DBL_EPSILON)
 		{
@@ -86,6 +92,50 @@ double Newton(FuncWrapper1D *f, double x0, double ftol, int maxiter, std::string
     return x;
 }
 
+/**
+Newton's method safeguarded by bisection.  The root is bracketed by xneg and xpos, and the Newton step is replaced by 
+a bisection of the bracket when it would leave the bracket.  deriv() is always called right after call() with the 
+same x, so that it can reuse the work done in call().
+
+@param f A pointer to an instance of the FuncWrapper1D class that implements the call() and deriv() functions
+@param xneg A value of x where f is negative
+@param xpos A value of x where f is positive
+@param x0 The initial guess for the solution, between xneg and xpos
+@param tol The absolute value of the tolerance accepted for the step in x
+@param maxiter Maximum number of iterations
+@param errstr A pointer to the std::string that returns the error from BracketedNewton.  Length is zero if no errors are found
+@returns The solution
+*/
+double BracketedNewton(FuncWrapper1D *f, double xneg, double xpos, double x0, double tol, int maxiter, std::string *errstr)
+{
+	SolverStatsScope stats(SOLVER_STATS_BRACKETEDNEWTON);
+	*errstr = std::string("");
+	double x = x0;
+	for (int iter = 1; iter <= maxiter; iter++)
+	{
+		stats.iteration();
+		double fval = f->call(x);
+		if (!ValidNumber(fval)){
+			throw ValueError(format("BracketedNewton's method f(x) is NAN for x = %g",x).c_str());
+		}
+		if (fval == 0){ return x; }
+		if (fval < 0){ xneg = x; } else { xpos = x; }
+
+		double xnew = x - fval/f->deriv(x);
+		// Bisect if the Newton step leaves the bracket
+		if (!ValidNumber(xnew) || (xnew-xneg)*(xnew-xpos) >= 0)
+		{
+			xnew = 0.5*(xneg+xpos);
+		}
+		double dx = xnew-x;
+		x = xnew;
+		if (fabs(dx) < tol || fabs(xpos-xneg) < tol){ return x; }
+	}
+	*errstr = std::string("reached maximum number of iterations");
+	stats.failure();
+	return x;
+}
+
 /**
 In the secant function, a 1-D Newton-Raphson solver is implemented.  An initial guess for the solution is provided.
 
@@ -99,13 +149,15 @@ In the secant function, a 1-D Newton-Raphson solver is implemented.  An initial
 */
 double Secant(FuncWrapper1D *f, double x0, double dx, double tol, int maxiter, std::string *errstring)
 {
+	SolverStatsScope stats(SOLVER_STATS_SECANT);
 	double x1=0,x2=0,x3=0,y1=0,y2=0,x,fval=999;
     int iter=1;
 	*errstring=std::string("");
 	
-	if (fabs(dx)==0){ *errstring=std::string("dx cannot be zero"); return _HUGE;}
+	if (fabs(dx)==0){ *errstring=std::string("dx cannot be zero"); stats.failure(); return _HUGE;}
     while ((iter<=2 || fabs(fval)>tol) && iter<maxiter)
     {
+		stats.iteration();
         if (iter==1){x1=x0; x=x1;}
         if (iter==2){x2=x0+dx; x=x2;}
         if (iter>2) {x=x2;}
@@ -155,13 +207,15 @@ In the secant function, a 1-D Newton-Raphson solver is implemented.  An initial
 */
 double BoundedSecant(FuncWrapper1D *f, double x0, double xmin, double xmax, double dx, double tol, int maxiter, std::string *errstring)
 {
+	SolverStatsScope stats(SOLVER_STATS_BOUNDEDSECANT);
 	double x1=0,x2=0,x3=0,y1=0,y2=0,x,fval=999;
     int iter=1;
 	*errstring=std::string("");
 	
-	if (fabs(dx)==0){ *errstring=std::string("dx cannot be zero"); return _HUGE;}
+	if (fabs(dx)==0){ *errstring=std::string("dx cannot be zero"); stats.failure(); return _HUGE;}
     while ((iter<=3 || fabs(fval)>tol) && iter<100)
     {
+		stats.iteration();
         if (iter==1){x1=x0; x=x1;}
         if (iter==2){x2=x0+dx; x=x2;}
         if (iter>2) {x=x2;}
@@ -211,6 +265,7 @@ at least one solution in the interval [a,b].
 */
 double Brent(FuncWrapper1D *f, double a, double b, double macheps, double t, int maxiter, std::string *errstr)
 {
+	SolverStatsScope stats(SOLVER_STATS_BRENT);
 	int iter;
 	*errstr=std::string("");
 	double fa,fb,c,fc,m,tol,d,e,p,q,s,r;
@@ -296,6 +351,7 @@ double Brent(FuncWrapper1D *f, double a, double b, double macheps, double t, int
             b+=-tol;
 		}
 		fb=f->call(b);
+		stats.iteration();
 		if (!ValidNumber(fb)){
 			throw ValueError(format("Brent's method f(t) is NAN for t = %g",b).c_str());
 		}
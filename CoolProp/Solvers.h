@@ -30,6 +30,7 @@ double Brent(FuncWrapper1D *f, double a, double b, double macheps, double t, int
 double Secant(FuncWrapper1D *f, double x0, double dx, double ftol, int maxiter, std::string *errstring);
 double BoundedSecant(FuncWrapper1D *f, double x0, double xmin, double xmax, double dx, double ftol, int maxiter, std::string *errstring);
 double Newton(FuncWrapper1D *f, double x0, double ftol, int maxiter, std::string *errstring);
+double BracketedNewton(FuncWrapper1D *f, double xneg, double xpos, double x0, double tol, int maxiter, std::string *errstr);
 
 // Multi-Dimensional solvers
 std::vector<double> NDNewtonRaphson_Jacobian(FuncWrapperND *f, std::vector<double> x0, double tol, int maxiter, std::string *errstring);
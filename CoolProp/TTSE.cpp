@@ -13,6 +13,8 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h> // for mmap
+#include <fcntl.h>
 #endif
 
 
@@ -23,6 +25,7 @@
 #include <vector>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <iostream>
 #include <fstream>
 #include <streambuf>
@@ -33,13 +36,70 @@
 #include <cerrno>
 #include <float.h>
 
+#if defined(COOLPROP_CXX11_THREADS)
+#include <thread>
+#include <chrono>
+#endif
+
 // An ugly hack to disable the timing function on PPC since the sysClkRate function not found
 #if defined(__powerpc__)
 #define CLOCKS_PER_SEC 1000
 #endif
 
 // The revision of the TTSE tables, only use tables with the same revision.  Increment this macro if any non-forward compatible changes are made
-#define TTSEREV 6
+#define TTSEREV 7
+
+/// The name of the file with all the single-phase tables, in the folder for the fluid
+#define TTSE_TABLE_FILE "TTSE_tables.bin"
+
+/// The header at the beginning of the table file.  All the offsets are in bytes from the beginning of the file 
+/// and are multiples of 64 so that the packed tables are aligned in the mapped file
+struct TTSEFileHeader
+{
+	char magic[8]; ///< "CPTTSE" followed by two null characters
+	int revision; ///< TTSEREV when the file was written
+	int header_size; ///< sizeof(TTSEFileHeader) when the file was written, guards against changes of the layout
+	char fluid[64]; ///< Name of the fluid
+	unsigned long long EOS_hash; ///< Hash of the equation of state (see EOS_hash())
+	double pmin, pmax, hmin, hmax, Tmin, Tmax, rhomin, rhomax;
+	int Np, Nh, NT, Nrho;
+	int transport; ///< 1 if the viscosity and conductivity are in the tables
+	int padding;
+	unsigned long long offset_p, offset_h, offset_T, offset_rho, offset_ph_nodes, offset_ph_cells, offset_Trho_nodes, offset_Trho_cells;
+	unsigned long long file_size;
+};
+static const char TTSE_FILE_MAGIC[8] = {'C','P','T','T','S','E','\0','\0'};
+
+/// A hash of the parameters and the Helmholtz energy of the fluid at a few states, so that tables that were 
+/// built with a different equation of state (or a different version of it) are not used
+static unsigned long long EOS_hash(Fluid *pFluid)
+{
+	// 64-bit FNV-1a hash
+	unsigned long long hash = 14695981039346656037ULL;
+	std::string text = pFluid->get_name() + pFluid->get_EOSReference();
+	for (std::size_t i = 0; i < text.size(); i++){
+		hash = (hash ^ (unsigned char)text[i])*1099511628211ULL;
+	}
+	double tau[] = {0.7, 1.0, 1.3, 2.1}, delta[] = {0.001, 0.8, 1.0, 2.2};
+	std::vector<double> values;
+	values.push_back(pFluid->params.molemass);
+	values.push_back(pFluid->R());
+	values.push_back(pFluid->crit.T); values.push_back(pFluid->crit.p.Pa); values.push_back(pFluid->crit.rho);
+	values.push_back(pFluid->reduce.T); values.push_back(pFluid->reduce.p.Pa); values.push_back(pFluid->reduce.rho);
+	for (int i = 0; i < 4; i++)
+	{
+		values.push_back(pFluid->phir(tau[i],delta[i]));
+		values.push_back(pFluid->phi0(tau[i],delta[i]));
+	}
+	for (std::size_t i = 0; i < values.size(); i++)
+	{
+		const unsigned char *bytes = (const unsigned char *)&values[i];
+		for (std::size_t k = 0; k < sizeof(double); k++){
+			hash = (hash ^ bytes[k])*1099511628211ULL;
+		}
+	}
+	return hash;
+}
 
 std::string get_home_dir(void)
 {
@@ -103,7 +163,7 @@ double round(double r) {
     return (r > 0.0) ? floor(r + 0.5) : ceil(r - 0.5);
 }
 
-void matrix_vector_product(std::vector<double> *x, std::vector<double> *y)
+static void matrix_vector_product(const double *x, double *y)
 {
 	double sum;
 	for (unsigned int i = 0; i < 16; i++)
@@ -111,15 +171,183 @@ void matrix_vector_product(std::vector<double> *x, std::vector<double> *y)
 		sum = 0;
 		for (unsigned int j = 0; j < 16; j++)
 		{
-			sum += Ainv[i][j]*(*x)[j];
+			sum += Ainv[i][j]*x[j];
+		}
+		y[i] = sum;
+	}
+}
+
+TTSEAlignedArray & TTSEAlignedArray::operator=(const TTSEAlignedArray &other)
+{
+	if (this != &other && other.buffer.empty() && other.data != NULL)
+	{
+		// A view stays a view, whoever owns the memory is copied along with it (see TTSEMappedFile)
+		view(other.data, other.N);
+	}
+	else if (this != &other)
+	{
+		// The buffer can't just be copied since the offset to the aligned element depends on its address
+		resize(other.N);
+		for (std::size_t i = 0; i < N; i++){ data[i] = other.data[i]; }
+	}
+	return *this;
+}
+void TTSEAlignedArray::view(double *data, std::size_t N)
+{
+	std::vector<double>().swap(buffer);
+	this->data = data;
+	this->N = N;
+}
+void TTSEAlignedArray::resize(std::size_t N)
+{
+	this->N = N;
+	// Over-allocate by one cache line and start at the first aligned element
+	buffer.assign(N + 64/sizeof(double), _HUGE);
+	std::size_t misalignment = ((std::size_t)&buffer[0]) % 64;
+	data = &buffer[0] + (misalignment == 0 ? 0 : (64 - misalignment)/sizeof(double));
+}
+
+TTSEMappedFile & TTSEMappedFile::operator=(const TTSEMappedFile &other)
+{
+	if (other.mapping != NULL){ other.mapping->count++; }
+	release();
+	mapping = other.mapping;
+	return *this;
+}
+void TTSEMappedFile::release()
+{
+	if (mapping != NULL && --(mapping->count) == 0)
+	{
+		#if defined(__ISWINDOWS__)
+			UnmapViewOfFile(mapping->addr);
+		#else
+			munmap(mapping->addr, mapping->length);
+		#endif
+		delete mapping;
+	}
+	mapping = NULL;
+}
+bool TTSEMappedFile::open(const std::string &fName)
+{
+	release();
+	void *addr = NULL;
+	std::size_t length = 0;
+	#if defined(__ISWINDOWS__)
+		HANDLE file = CreateFileA(fName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE){ return false; }
+		LARGE_INTEGER file_size;
+		if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+		{
+			HANDLE map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (map != NULL)
+			{
+				// The view keeps the mapping alive after the handles are closed
+				addr = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+				length = (std::size_t)file_size.QuadPart;
+				CloseHandle(map);
+			}
+		}
+		CloseHandle(file);
+		if (addr == NULL){ return false; }
+	#else
+		int fd = ::open(fName.c_str(), O_RDONLY);
+		if (fd < 0){ return false; }
+		struct stat st;
+		if (fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			length = (std::size_t)st.st_size;
+			// Shared so that all the processes that map the same file use the same pages
+			addr = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+			if (addr == MAP_FAILED){ addr = NULL; }
+		}
+		::close(fd);
+		if (addr == NULL){ return false; }
+	#endif
+	mapping = new Mapping;
+	mapping->addr = addr;
+	mapping->length = length;
+	mapping->count = 1;
+	return true;
+}
+
+/// Index of the property in the packed tables with p,h as inputs
+static int ph_property_index(long iParam)
+{
+	switch (iParam)
+	{
+	case iT: return TTSE_PH_T;
+	case iD: return TTSE_PH_RHO;
+	case iS: return TTSE_PH_S;
+	default:
+		throw ValueError(format("Output key value [%d] to evaluate is invalid",iParam));
+	}
+}
+/// Index of the property in the packed tables with T,rho as inputs
+static int Trho_property_index(long iParam)
+{
+	switch (iParam)
+	{
+	case iS: return TTSE_TRHO_S;
+	case iP: return TTSE_TRHO_P;
+	case iH: return TTSE_TRHO_H;
+	case iV: return TTSE_TRHO_MU;
+	case iL: return TTSE_TRHO_K;
+	default:
+		throw ValueError(format("Output key value [%d] to evaluate is invalid",iParam));
+	}
+}
+
+/// Pack the value and derivatives of each property at each node into one block, and calculate the 
+/// coefficients of the bicubic interpolation for each cell
+/// @param Nx Number of nodes in the first input (h or T)
+/// @param Ny Number of nodes in the second input (p or rho)
+/// @param x Values of the first input
+/// @param y Values of the second input
+/// @param mats For each property, the matrices of f, df/dx, df/dy, d2f/dx2, d2f/dy2, d2f/dxdy; they are freed once packed
+/// @param nodes The packed node blocks
+/// @param cells The packed bicubic coefficients
+static void pack_tables(unsigned int Nx, unsigned int Ny, const std::vector<double> &x, const std::vector<double> &y, 
+						const std::vector< std::vector< std::vector<double> > * > &mats, TTSEAlignedArray &nodes, TTSEAlignedArray &cells)
+{
+	const unsigned int Nprops = (unsigned int)mats.size()/6;
+	double z[16];
+	nodes.resize(Nx*Ny*Nprops*TTSE_NODE_BLOCK);
+	cells.resize(Nx*Ny*Nprops*TTSE_CELL_BLOCK);
+	for (unsigned int i = 0; i < Nx; i++)
+	{
+		for (unsigned int j = 0; j < Ny; j++)
+		{
+			for (unsigned int k = 0; k < Nprops; k++)
+			{
+				const std::vector< std::vector<double> > &f = *mats[6*k], &dfdx = *mats[6*k+1], &dfdy = *mats[6*k+2], &d2fdxdy = *mats[6*k+5];
+				double *node = &nodes[((i*Ny+j)*Nprops+k)*TTSE_NODE_BLOCK];
+				for (unsigned int m = 0; m < 6; m++){
+					node[m] = (*mats[6*k+m])[i][j];
+				}
+				if (i+1 < Nx && j+1 < Ny)
+				{
+					double dxdX = x[i+1]-x[i], dydY = y[j+1]-y[j];
+					z[0] = f[i][j]; z[1] = f[i+1][j]; z[2] = f[i][j+1]; z[3] = f[i+1][j+1];
+					z[4] = dfdx[i][j]*dxdX; z[5] = dfdx[i+1][j]*dxdX; z[6] = dfdx[i][j+1]*dxdX; z[7] = dfdx[i+1][j+1]*dxdX;
+					z[8] = dfdy[i][j]*dydY; z[9] = dfdy[i+1][j]*dydY; z[10] = dfdy[i][j+1]*dydY; z[11] = dfdy[i+1][j+1]*dydY;
+					z[12] = d2fdxdy[i][j]*dxdX*dydY; z[13] = d2fdxdy[i+1][j]*dxdX*dydY; z[14] = d2fdxdy[i][j+1]*dxdX*dydY; z[15] = d2fdxdy[i+1][j+1]*dxdX*dydY;
+					// Find the alpha values by doing the matrix operation alpha = Ainv*z
+					matrix_vector_product(z, &cells[((i*Ny+j)*Nprops+k)*TTSE_CELL_BLOCK]);
+				}
+			}
 		}
-		(*y)[i] = sum;
+	}
+	// Only the packed layout is used from now on, free the matrices rather than keeping two copies of the tables
+	for (std::size_t m = 0; m < mats.size(); m++)
+	{
+		std::vector< std::vector<double> >().swap(*mats[m]);
 	}
 }
 
 TTSESinglePhaseTableClass::TTSESinglePhaseTableClass(){
 	this->enable_writing_tables_to_files = true;
 	this->enable_transport = true;
+	this->Nthreads_build = 0;
 	SatL = NULL; 
 	SatV = NULL;
 
@@ -140,13 +368,10 @@ TTSESinglePhaseTableClass::TTSESinglePhaseTableClass(Fluid *pFluid) {
 	srand((unsigned int)time(NULL));
 	this->enable_writing_tables_to_files = true;
 	this->enable_transport = true;
+	this->Nthreads_build = 0;
 	SatL = NULL;
 	SatV = NULL;
 
-	// Instantiate the storage vectors for bicubic interpolation; instantiated once since instantation is quite slow
-	alpha_bicubic = std::vector<double>(16);
-	z_bicubic = std::vector<double>(16);
-
 	// Default to use the "normal" TTSE evaluation
 	mode = TTSE_MODE_TTSE;
 }
@@ -254,42 +479,42 @@ void TTSESinglePhaseTableClass::set_size_Trho(unsigned int NT, unsigned int Nrho
 
 void TTSESinglePhaseTableClass::nearest_good_neighbor(int *i, int *j) {
 	// Left
-	if (*i>0 && ValidNumber(rho[*i-1][*j]) && ValidNumber(T[*i-1][*j])){
+	if (*i>0 && ValidNumber(ph_value(*i-1,*j,TTSE_PH_RHO)) && ValidNumber(ph_value(*i-1,*j,TTSE_PH_T))){
 		*i -= 1;
 		return;
 	}
 	// Right
-	else if (*i<(int)Nh-1 && ValidNumber(rho[*i+1][*j]) && ValidNumber(T[*i+1][*j])){
+	else if (*i<(int)Nh-1 && ValidNumber(ph_value(*i+1,*j,TTSE_PH_RHO)) && ValidNumber(ph_value(*i+1,*j,TTSE_PH_T))){
 		*i += 1;
 		return;
 	}
 	// Down
-	else if (*j>0 && ValidNumber(rho[*i][*j-1]) && ValidNumber(T[*i][*j-1])){
+	else if (*j>0 && ValidNumber(ph_value(*i,*j-1,TTSE_PH_RHO)) && ValidNumber(ph_value(*i,*j-1,TTSE_PH_T))){
 		*j -= 1;
 		return;
 	}
 	// Up
-	else if (*j<(int)Np-1 && ValidNumber(rho[*i][*j+1]) && ValidNumber(T[*i][*j+1])){
+	else if (*j<(int)Np-1 && ValidNumber(ph_value(*i,*j+1,TTSE_PH_RHO)) && ValidNumber(ph_value(*i,*j+1,TTSE_PH_T))){
 		*j += 1;
 		return;
 	}
 	// Two Left
-	if (*i>1 && ValidNumber(rho[*i-2][*j]) && ValidNumber(T[*i-2][*j])){
+	if (*i>1 && ValidNumber(ph_value(*i-2,*j,TTSE_PH_RHO)) && ValidNumber(ph_value(*i-2,*j,TTSE_PH_T))){
 		*i -= 2;
 		return;
 	}
 	// Two Right
-	else if (*i<(int)Nh-2 && ValidNumber(rho[*i+2][*j]) && ValidNumber(T[*i+2][*j])){
+	else if (*i<(int)Nh-2 && ValidNumber(ph_value(*i+2,*j,TTSE_PH_RHO)) && ValidNumber(ph_value(*i+2,*j,TTSE_PH_T))){
 		*i += 2;
 		return;
 	}
 	// Two Down
-	else if (*j>1 && ValidNumber(rho[*i][*j-2]) && ValidNumber(T[*i][*j-2])){
+	else if (*j>1 && ValidNumber(ph_value(*i,*j-2,TTSE_PH_RHO)) && ValidNumber(ph_value(*i,*j-2,TTSE_PH_T))){
 		*j -= 2;
 		return;
 	}
 	// Two Up
-	else if (*j<(int)Np-2 && ValidNumber(rho[*i][*j+2]) && ValidNumber(T[*i][*j+2])){
+	else if (*j<(int)Np-2 && ValidNumber(ph_value(*i,*j+2,TTSE_PH_RHO)) && ValidNumber(ph_value(*i,*j+2,TTSE_PH_T))){
 		*j += 2;
 		return;
 	}
@@ -394,22 +619,22 @@ void TTSESinglePhaseTableClass::nearest_good_neighbor_ph_interpolate(int *i, int
 void TTSESinglePhaseTableClass::nearest_good_neighbor_Trho(int *i, int *j)
 {
 	// Left
-	if (*i>0 && ValidNumber(h_Trho[*i-1][*j]) && ValidNumber(p_Trho[*i-1][*j])){
+	if (*i>0 && ValidNumber(Trho_value(*i-1,*j,TTSE_TRHO_H)) && ValidNumber(Trho_value(*i-1,*j,TTSE_TRHO_P))){
 		*i -= 1;
 		return;
 	}
 	// Right
-	else if (*i<(int)Nh-1 && ValidNumber(h_Trho[*i+1][*j]) && ValidNumber(p_Trho[*i+1][*j])){
+	else if (*i<(int)Nh-1 && ValidNumber(Trho_value(*i+1,*j,TTSE_TRHO_H)) && ValidNumber(Trho_value(*i+1,*j,TTSE_TRHO_P))){
 		*i += 1;
 		return;
 	}
 	// Down
-	else if (*j>0 && ValidNumber(h_Trho[*i][*j-1]) && ValidNumber(p_Trho[*i][*j-1])){
+	else if (*j>0 && ValidNumber(Trho_value(*i,*j-1,TTSE_TRHO_H)) && ValidNumber(Trho_value(*i,*j-1,TTSE_TRHO_P))){
 		*j -= 1;
 		return;
 	}
 	// Up
-	else if (*j<(int)Np-1 && ValidNumber(h_Trho[*i][*j+1]) && ValidNumber(p_Trho[*i][*j+1])){
+	else if (*j<(int)Np-1 && ValidNumber(Trho_value(*i,*j+1,TTSE_TRHO_H)) && ValidNumber(Trho_value(*i,*j+1,TTSE_TRHO_P))){
 		*j += 1;
 		return;
 	}
@@ -422,20 +647,11 @@ void TTSESinglePhaseTableClass::nearest_good_neighbor_Trho(int *i, int *j)
 
 void TTSESinglePhaseTableClass::nearest_neighbor_ph(int i, int j, double *T0, double *rho0)
 {
-	// Left
-	if (i>0 && ValidNumber(rho[i-1][j]) && ValidNumber(T[i-1][j])){
-		*T0 = T[i-1][j];
-		*rho0 = rho[i-1][j];
-		return;
-	}
-	// Right
-	else if (i<(int)Nh-1 && ValidNumber(rho[i+1][j]) && ValidNumber(T[i+1][j])){
-		*T0 = T[i+1][j];
-		*rho0 = rho[i+1][j];
-		return;
-	}
+	// Only the nodes in the same row (same enthalpy) are used so that the rows can be built 
+	// independently of each other and the tables do not depend on the number of threads
+
 	// Down
-	else if (j>0 && ValidNumber(rho[i][j-1]) && ValidNumber(T[i][j-1])){
+	if (j>0 && ValidNumber(rho[i][j-1]) && ValidNumber(T[i][j-1])){
 		*T0 = T[i][j-1];
 		*rho0 = rho[i][j-1];
 		return;
@@ -463,57 +679,6 @@ std::string join(std::vector<std::string> strings, char delim)
 	return output;
 }
 
-void TTSESinglePhaseTableClass::matrix_to_file(std::string fName, std::vector< std::vector<double> > *A)
-{
-	FILE *pFile;
-	pFile = fopen(fName.c_str(),"wb");
-	if (pFile != NULL)
-	{
-		for (unsigned int i = 0; i < Nh; i++)
-		{
-			fwrite(&(((*A)[i])[0]), sizeof(double),Np,pFile);
-		}
-		fclose(pFile);
-	}
-}
-
-void TTSESinglePhaseTableClass::matrix_from_file(std::string fName, std::vector<std::vector<double> > *A)
-{
-	FILE *pFile;
-	pFile = fopen(fName.c_str(),"rb");
-	if (pFile != NULL)
-	{
-		for (unsigned int i = 0; i < Nh; i++)
-		{
-			/*std::vector<double> row(Nh,0);
-			fread(&(row[0]), sizeof(double), Np, pFile);
-			double tgregt = 1;*/
-			fread(&(((*A)[i])[0]), sizeof(double),Np,pFile);
-		}
-		fclose(pFile);
-	}
-}
-
-void TTSESinglePhaseTableClass::vector_to_file(std::string fName, std::vector<double>*A)
-{
-	FILE *pFile;
-	pFile = fopen(fName.c_str(),"wb");
-	if (pFile != NULL)
-	{
-		fwrite((const char *)&(*A).front(), sizeof(double),(*A).size(),pFile);
-		fclose(pFile);
-	}
-}
-void TTSESinglePhaseTableClass::vector_from_file(std::string fName, int N, std::vector<double> *vec)
-{
-	FILE *pFile;
-	pFile = fopen(fName.c_str(),"rb");
-	if (pFile != NULL)
-	{
-		fread(&((*vec)[0]), sizeof(double), N, pFile);
-		fclose(pFile);
-	}
-}
 bool pathExists(std::string path)
 {
 	#if defined(__ISWINDOWS__) // Defined for 32-bit and 64-bit windows
@@ -583,147 +748,86 @@ void make_dirs(std::string file_path)
 	}
 }
 
-bool TTSESinglePhaseTableClass::read_all_from_file(std::string root_path)
+/// Replace any '\' with '/' in the path and remove the trailing '/'
+static std::string normalize_path(std::string root_path)
 {
-	std::string Fluid;
-	double hmin,hmax,pmin,pmax;
-	int Np, Nh, TTSERev;
-
-	// Replace any '\' with '/' in the path
 	for (unsigned int i = 0; i<root_path.length(); i++)
 	{
 		if (root_path[i] == '\\') root_path[i] = '/';
 	}
-	// If it ends with a '/', remove it for now
 	if (root_path[root_path.size()-1] == '/')
 		root_path = std::string(root_path,0,root_path.size()-1);
+	return root_path;
+}
+/// Round up the offset to the next multiple of 64 bytes
+static unsigned long long align64(unsigned long long offset)
+{
+	return (offset + 63)/64*64;
+}
 
-	if (!pathExists(root_path)) return false;
-
-	// Append a '/'
-	root_path += format("/");
+bool TTSESinglePhaseTableClass::read_all_from_file(std::string root_path)
+{
+	root_path = normalize_path(root_path);
+
+	TTSEMappedFile file;
+	if (!file.open(root_path + "/" + TTSE_TABLE_FILE)) return false;
+
+	// Check the header, the tables can only be used if they were built with the same
+	// fluid, equation of state, ranges and sizes, otherwise they need to be built again
+	if (file.size() < sizeof(TTSEFileHeader)) return false;
+	const TTSEFileHeader &header = *(const TTSEFileHeader *)file.data();
+	if (memcmp(header.magic, TTSE_FILE_MAGIC, sizeof(TTSE_FILE_MAGIC)) != 0
+		|| header.revision != TTSEREV
+		|| header.header_size != (int)sizeof(TTSEFileHeader)
+		|| header.file_size != file.size()
+		) return false;
+
+	if (!(std::string(header.fluid, strnlen(header.fluid, sizeof(header.fluid))) == pFluid->get_name()
+		  && header.EOS_hash == EOS_hash(pFluid)
+		  && header.Nh == (int)this->Nh
+		  && header.Np == (int)this->Np
+		  && fabs(header.pmin - this->pmin)<10*DBL_EPSILON
+		  && fabs(header.pmax - this->pmax)<10*DBL_EPSILON
+		  && fabs(header.hmin - this->hmin)<10*DBL_EPSILON
+		  && fabs(header.hmax - this->hmax)<10*DBL_EPSILON
+		  && header.NT == (int)this->NT
+		  && header.Nrho == (int)this->Nrho
+		  && (header.transport != 0) == enable_transport
+		)) return false;
 
-	if (!pathExists(root_path+format("Info_ph.txt"))) return false;
+	// Check that all the blocks are aligned and within the file
+	std::size_t N_ph = Nh*Np*TTSE_PH_N, N_Trho = NT*Nrho*TTSE_TRHO_N;
+	unsigned long long offsets[] = {header.offset_p, header.offset_h, header.offset_T, header.offset_rho, header.offset_ph_nodes, header.offset_ph_cells, header.offset_Trho_nodes, header.offset_Trho_cells};
+	std::size_t lengths[] = {Np, Nh, NT, Nrho, N_ph*TTSE_NODE_BLOCK, N_ph*TTSE_CELL_BLOCK, N_Trho*TTSE_NODE_BLOCK, N_Trho*TTSE_CELL_BLOCK};
+	for (int i = 0; i < 8; i++)
+	{
+		if (offsets[i] % 64 != 0 || offsets[i] + lengths[i]*sizeof(double) > header.file_size) return false;
+	}
 
-	// Parse the info file to find the dimensions and boundaries and check that they are the same
-	std::string info = get_file_contents((root_path+format("Info_ph.txt")).c_str());
+	// The ranges of T,rho were determined from the ranges of p,h when the tables were built
+	Tmin = header.Tmin; Tmax = header.Tmax; rhomin = header.rhomin; rhomax = header.rhomax;
 
-	// Split into lines
-#if defined(__ISWINDOWS__)
-	std::vector<std::string> lines = strsplit(info,'\r');
-#else
-	std::vector<std::string> lines = strsplit(info,'\n');
-#endif
+	// The axes are small, copy them
+	double *base = (double *)file.data();
+	p.assign(base + header.offset_p/sizeof(double), base + header.offset_p/sizeof(double) + Np);
+	h.assign(base + header.offset_h/sizeof(double), base + header.offset_h/sizeof(double) + Nh);
+	T_Trho.assign(base + header.offset_T/sizeof(double), base + header.offset_T/sizeof(double) + NT);
+	rho_Trho.assign(base + header.offset_rho/sizeof(double), base + header.offset_rho/sizeof(double) + Nrho);
 
-	for (unsigned int i = 0; i< lines.size(); i++) {
-
-		// Split at ':'
-		std::vector<std::string> line = strsplit(lines[i],':');
-		if (line.size() == 1) // No : found
-			continue;
-
-		if (line[0].find("Fluid")!=  std::string::npos){
-			Fluid = line[1];}
-		else if (line[0].find("hmin")!=  std::string::npos) {	
-			hmin = strtod(line[1].c_str(),NULL);}
-		else if (line[0].find("hmax")!=  std::string::npos) {	
-			hmax = strtod(line[1].c_str(),NULL);}
-		else if (line[0].find("pmin")!=  std::string::npos) {	
-			pmin = strtod(line[1].c_str(),NULL);}
-		else if (line[0].find("pmax")!=  std::string::npos) {	
-			pmax = strtod(line[1].c_str(),NULL);}
-		else if (line[0].find("Np")!=  std::string::npos) {	
-			Np = (int)strtol(line[1].c_str(),NULL,0);}
-		else if (line[0].find("Nh")!=  std::string::npos) {	
-			Nh = (int)strtol(line[1].c_str(),NULL,0);}
-		else if (line[0].find("Tmin")!=  std::string::npos) {
-			Tmin = strtod(line[1].c_str(),NULL);}
-		else if (line[0].find("Tmax")!=  std::string::npos) {	
-			Tmax = strtod(line[1].c_str(),NULL);}
-		else if (line[0].find("rhomin")!=  std::string::npos) {	
-			rhomin = strtod(line[1].c_str(),NULL);}
-		else if (line[0].find("rhomax")!=  std::string::npos) {	
-			rhomax = strtod(line[1].c_str(),NULL);}
-		else if (line[0].find("NT")!=  std::string::npos) {	
-			NT = (int)strtol(line[1].c_str(),NULL,0);}
-		else if (line[0].find("Nrho")!=  std::string::npos) {	
-			Nrho = (int)strtol(line[1].c_str(),NULL,0);}
-		else if (line[0].find("TTSERev")!=  std::string::npos) {
-			TTSERev = (int)strtol(line[1].c_str(),NULL,0);}
-	}
-
-	// Didn't work since at least one of the parameters was different
-	// so we need to build the tables again
-	if (!(!Fluid.compare(pFluid->get_name())
-		  && Nh == (int)this->Nh
-		  && Np == (int)this->Np
-		  && fabs(pmin - this->pmin)<10*DBL_EPSILON
-		  && fabs(pmax - this->pmax)<10*DBL_EPSILON
-		  && fabs(hmin - this->hmin)<10*DBL_EPSILON
-		  && fabs(hmax - this->hmax)<10*DBL_EPSILON
-		  && NT == this->NT
-		  && Nrho == this->Nrho
-		  && fabs(Tmin - this->Tmin)<10*DBL_EPSILON
-		  && fabs(Tmax - this->Tmax)<10*DBL_EPSILON
-		  && fabs(rhomin - this->rhomin)<10*DBL_EPSILON
-		  && fabs(rhomax - this->rhomax)<10*DBL_EPSILON
-		  && TTSERev == TTSEREV
-		)) return false;
+	// The packed tables are used directly from the mapped file, which is never written to
+	ph_nodes.view(base + header.offset_ph_nodes/sizeof(double), lengths[4]);
+	ph_cells.view(base + header.offset_ph_cells/sizeof(double), lengths[5]);
+	Trho_nodes.view(base + header.offset_Trho_nodes/sizeof(double), lengths[6]);
+	Trho_cells.view(base + header.offset_Trho_cells/sizeof(double), lengths[7]);
+	mapped_file = file;
 
-	// Read all the data from the binary files
-	vector_from_file(root_path + std::string("p_ph.ttse"),Np,&p);
-	vector_from_file(root_path + std::string("h_ph.ttse"),Nh,&h);
-	matrix_from_file(root_path + std::string("T_ph.ttse"),&T);
-	matrix_from_file(root_path + std::string("dTdh_ph.ttse"),&dTdh);
-	matrix_from_file(root_path + std::string("dTdp_ph.ttse"),&dTdp);
-	matrix_from_file(root_path + std::string("d2Tdh2_ph.ttse"),&d2Tdh2);
-	matrix_from_file(root_path + std::string("d2Tdp2_ph.ttse"),&d2Tdp2);
-	matrix_from_file(root_path + std::string("d2Tdhdp_ph.ttse"),&d2Tdhdp);
-	matrix_from_file(root_path + std::string("s_ph.ttse"),&s);
-	matrix_from_file(root_path + std::string("dsdh_ph.ttse"),&dsdh);
-	matrix_from_file(root_path + std::string("dsdp_ph.ttse"),&dsdp);
-	matrix_from_file(root_path + std::string("d2sdh2_ph.ttse"),&d2sdh2);
-	matrix_from_file(root_path + std::string("d2sdp2_ph.ttse"),&d2sdp2);
-	matrix_from_file(root_path + std::string("d2sdhdp_ph.ttse"),&d2sdhdp);
-	matrix_from_file(root_path + std::string("rho_ph.ttse"),&rho);
-	matrix_from_file(root_path + std::string("drhodh_ph.ttse"),&drhodh);
-	matrix_from_file(root_path + std::string("drhodp_ph.ttse"),&drhodp);
-	matrix_from_file(root_path + std::string("d2rhodh2_ph.ttse"),&d2rhodh2);
-	matrix_from_file(root_path + std::string("d2rhodp2_ph.ttse"),&d2rhodp2);
-	matrix_from_file(root_path + std::string("d2rhoTdhdp_ph.ttse"),&d2rhodhdp);
-
-	vector_from_file(root_path + std::string("T_Trho.ttse"),NT,&T_Trho);
-	vector_from_file(root_path + std::string("rho_Trho.ttse"),Nrho,&rho_Trho);
-	matrix_from_file(root_path + std::string("p_Trho.ttse"),&p_Trho);
-	matrix_from_file(root_path + std::string("dpdT_Trho.ttse"),&dpdT_Trho);
-	matrix_from_file(root_path + std::string("dpdrho_Trho.ttse"),&dpdrho_Trho);
-	matrix_from_file(root_path + std::string("d2pdT2_Trho.ttse"),&d2pdT2_Trho);
-	matrix_from_file(root_path + std::string("d2pdrho2_Trho.ttse"),&d2pdrho2_Trho);
-	matrix_from_file(root_path + std::string("d2pdTdrho_Trho.ttse"),&d2pdTdrho_Trho);
-	matrix_from_file(root_path + std::string("s_Trho.ttse"),&s_Trho);
-	matrix_from_file(root_path + std::string("dsdT_Trho.ttse"),&dsdT_Trho);
-	matrix_from_file(root_path + std::string("dsdrho_Trho.ttse"),&dsdrho_Trho);
-	matrix_from_file(root_path + std::string("d2sdT2_Trho.ttse"),&d2sdT2_Trho);
-	matrix_from_file(root_path + std::string("d2sdrho2_Trho.ttse"),&d2sdrho2_Trho);
-	matrix_from_file(root_path + std::string("d2sdTdrho_Trho.ttse"),&d2sdTdrho_Trho);
-	matrix_from_file(root_path + std::string("h_Trho.ttse"),&h_Trho);
-	matrix_from_file(root_path + std::string("dhdT_Trho.ttse"),&dhdT_Trho);
-	matrix_from_file(root_path + std::string("dhdrho_Trho.ttse"),&dhdrho_Trho);
-	matrix_from_file(root_path + std::string("d2hdT2_Trho.ttse"),&d2hdT2_Trho);
-	matrix_from_file(root_path + std::string("d2hdrho2_Trho.ttse"),&d2hdrho2_Trho);
-	matrix_from_file(root_path + std::string("d2hdTdrho_Trho.ttse"),&d2hdTdrho_Trho);
-	matrix_from_file(root_path + std::string("mu_Trho.ttse"),&mu_Trho);
-	matrix_from_file(root_path + std::string("dmudT_Trho.ttse"),&dmudT_Trho);
-	matrix_from_file(root_path + std::string("dmudrho_Trho.ttse"),&dmudrho_Trho);
-	matrix_from_file(root_path + std::string("d2mudT2_Trho.ttse"),&d2mudT2_Trho);
-	matrix_from_file(root_path + std::string("d2mudrho2_Trho.ttse"),&d2mudrho2_Trho);
-	matrix_from_file(root_path + std::string("d2mudTdrho_Trho.ttse"),&d2mudTdrho_Trho);
-	matrix_from_file(root_path + std::string("k_Trho.ttse"),&k_Trho);
-	matrix_from_file(root_path + std::string("dkdT_Trho.ttse"),&dkdT_Trho);
-	matrix_from_file(root_path + std::string("dkdrho_Trho.ttse"),&dkdrho_Trho);
-	matrix_from_file(root_path + std::string("d2kdT2_Trho.ttse"),&d2kdT2_Trho);
-	matrix_from_file(root_path + std::string("d2kdrho2_Trho.ttse"),&d2kdrho2_Trho);
-	matrix_from_file(root_path + std::string("d2kdTdrho_Trho.ttse"),&d2kdTdrho_Trho);
+	// The matrices are only needed to build the tables, free them
+	std::vector< std::vector< std::vector<double> > * > mats = ph_matrices(), Trho_mats = Trho_matrices();
+	mats.insert(mats.end(), Trho_mats.begin(), Trho_mats.end());
+	for (std::size_t i = 0; i < mats.size(); i++)
+	{
+		std::vector< std::vector<double> >().swap(*mats[i]);
+	}
 
 	this->pratio = pow(pmax/pmin,1/((double)Np-1));
 	this->logpratio = log(pratio); // For speed since log() is a slow function
@@ -731,8 +835,6 @@ bool TTSESinglePhaseTableClass::read_all_from_file(std::string root_path)
 	this->rhoratio = pow(rhomax/rhomin,1/((double)Nrho-1));
 	this->logrhoratio = log(rhoratio); // For speed since log() is a slow function
 	this->logrhomin = log(rhomin);
-	this->jpcrit_floor = (int)floor((log(pFluid->reduce.p.Pa)-logpmin)/logpratio);
-	this->jpcrit_ceil = (int)ceil((log(pFluid->reduce.p.Pa)-logpmin)/logpratio);
 	
 	update_saturation_boundary_indices();
 
@@ -742,272 +844,291 @@ bool TTSESinglePhaseTableClass::read_all_from_file(std::string root_path)
 }
 void TTSESinglePhaseTableClass::write_all_to_file(std::string root_path)
 {
-	// Replace any '\' with '/' in the path
-	for (unsigned int i = 0; i<root_path.length(); i++)
-	{
-		if (root_path[i] == '\\') root_path[i] = '/';
-	}
-	// If it ends with a '/', remove it for now
-	if (root_path[root_path.size()-1] == '/')
-		root_path = std::string(root_path,0,root_path.size()-1);
+	root_path = normalize_path(root_path);
 
 	if (!pathExists(root_path))
 		make_dirs(root_path);
 
-	// Append a '/'
-	root_path += format("/");
+	TTSEFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TTSE_FILE_MAGIC, sizeof(TTSE_FILE_MAGIC));
+	header.revision = TTSEREV;
+	header.header_size = (int)sizeof(TTSEFileHeader);
+	strncpy(header.fluid, pFluid->get_name().c_str(), sizeof(header.fluid)-1);
+	header.EOS_hash = EOS_hash(pFluid);
+	header.pmin = pmin; header.pmax = pmax; header.hmin = hmin; header.hmax = hmax;
+	header.Tmin = Tmin; header.Tmax = Tmax; header.rhomin = rhomin; header.rhomax = rhomax;
+	header.Np = Np; header.Nh = Nh; header.NT = NT; header.Nrho = Nrho;
+	header.transport = enable_transport ? 1 : 0;
+
+	// Lay out the blocks one after the other, each one starting on a cache line
+	const double *blocks[] = {&p[0], &h[0], &T_Trho[0], &rho_Trho[0], &ph_nodes[0], &ph_cells[0], &Trho_nodes[0], &Trho_cells[0]};
+	std::size_t lengths[] = {p.size(), h.size(), T_Trho.size(), rho_Trho.size(), ph_nodes.size(), ph_cells.size(), Trho_nodes.size(), Trho_cells.size()};
+	unsigned long long *offsets[] = {&header.offset_p, &header.offset_h, &header.offset_T, &header.offset_rho, &header.offset_ph_nodes, &header.offset_ph_cells, &header.offset_Trho_nodes, &header.offset_Trho_cells};
+	unsigned long long offset = align64(sizeof(TTSEFileHeader));
+	for (int i = 0; i < 8; i++)
+	{
+		*offsets[i] = offset;
+		offset = align64(offset + lengths[i]*sizeof(double));
+	}
+	header.file_size = offset;
 
-	std::string header = std::string("Data for the TTSE method\nDO NOT CHANGE ANY OF THESE PARAMETERS FOR ANY REASON!\n\n");
-		
-	header += format("TTSERev:%d\nFluid:%s\npmin:%23.19g\npmax:%23.19g\nNp:%25d\nhmin:%23.19g\nhmax:%23.19g\nNh:%25d\nTmin:%23.19g\nTmax:%23.19g\nNT:%25d\nrhomin:%23.19g\nrhomax:%23.19g\nNrho:%25d\n",TTSEREV,pFluid->get_name().c_str(),pmin,pmax,Np,hmin,hmax,Nh,Tmin,Tmax,NT,rhomin,rhomax,Nrho);
-	
 	clock_t t1,t2;
 	t1 = clock();
 
-	// Write the header information to a text file
-	FILE *fp;
-	fp = fopen((root_path+std::string("Info_ph.txt")).c_str(),"w");
-	fprintf(fp,"%s",header.c_str());
-	fclose(fp);
+	// Write to a temporary file and then rename it, so that another process never maps a partly written file
+	std::string fName = root_path + "/" + TTSE_TABLE_FILE;
+	#if defined(__ISWINDOWS__)
+		std::string tmpName = fName + format(".%lu.tmp", (unsigned long)GetCurrentProcessId());
+	#else
+		std::string tmpName = fName + format(".%lu.tmp", (unsigned long)getpid());
+	#endif
+	FILE *fp = fopen(tmpName.c_str(),"wb");
+	if (fp == NULL) return;
+	const char zeros[64] = {0};
+	bool ok = fwrite(&header, sizeof(TTSEFileHeader), 1, fp) == 1;
+	unsigned long long position = sizeof(TTSEFileHeader);
+	for (int i = 0; i < 8 && ok; i++)
+	{
+		ok = ok && fwrite(zeros, 1, (std::size_t)(*offsets[i] - position), fp) == (std::size_t)(*offsets[i] - position);
+		ok = ok && fwrite(blocks[i], sizeof(double), lengths[i], fp) == lengths[i];
+		position = *offsets[i] + lengths[i]*sizeof(double);
+	}
+	ok = ok && fwrite(zeros, 1, (std::size_t)(header.file_size - position), fp) == (std::size_t)(header.file_size - position);
+	ok = (fclose(fp) == 0) && ok;
 
-	// Write each of these files in binary mode
-	vector_to_file(root_path + std::string("p_ph.ttse"),&p);
-	vector_to_file(root_path + std::string("h_ph.ttse"),&h);
-	matrix_to_file(root_path + std::string("T_ph.ttse"),&T);
-	matrix_to_file(root_path + std::string("dTdh_ph.ttse"),&dTdh);
-	matrix_to_file(root_path + std::string("dTdp_ph.ttse"),&dTdp);
-	matrix_to_file(root_path + std::string("d2Tdh2_ph.ttse"),&d2Tdh2);
-	matrix_to_file(root_path + std::string("d2Tdp2_ph.ttse"),&d2Tdp2);
-	matrix_to_file(root_path + std::string("d2Tdhdp_ph.ttse"),&d2Tdhdp);
-	matrix_to_file(root_path + std::string("s_ph.ttse"),&s);
-	matrix_to_file(root_path + std::string("dsdh_ph.ttse"),&dsdh);
-	matrix_to_file(root_path + std::string("dsdp_ph.ttse"),&dsdp);
-	matrix_to_file(root_path + std::string("d2sdh2_ph.ttse"),&d2sdh2);
-	matrix_to_file(root_path + std::string("d2sdp2_ph.ttse"),&d2sdp2);
-	matrix_to_file(root_path + std::string("d2sdhdp_ph.ttse"),&d2sdhdp);
-	matrix_to_file(root_path + std::string("rho_ph.ttse"),&rho);
-	matrix_to_file(root_path + std::string("drhodh_ph.ttse"),&drhodh);
-	matrix_to_file(root_path + std::string("drhodp_ph.ttse"),&drhodp);
-	matrix_to_file(root_path + std::string("d2rhodh2_ph.ttse"),&d2rhodh2);
-	matrix_to_file(root_path + std::string("d2rhodp2_ph.ttse"),&d2rhodp2);
-	matrix_to_file(root_path + std::string("d2rhoTdhdp_ph.ttse"),&d2rhodhdp);
-	
-	vector_to_file(root_path + std::string("T_Trho.ttse"),&T_Trho);
-	vector_to_file(root_path + std::string("rho_Trho.ttse"),&rho_Trho);
-	matrix_to_file(root_path + std::string("p_Trho.ttse"),&p_Trho);
-	matrix_to_file(root_path + std::string("dpdT_Trho.ttse"),&dpdT_Trho);
-	matrix_to_file(root_path + std::string("dpdrho_Trho.ttse"),&dpdrho_Trho);
-	matrix_to_file(root_path + std::string("d2pdT2_Trho.ttse"),&d2pdT2_Trho);
-	matrix_to_file(root_path + std::string("d2pdrho2_Trho.ttse"),&d2pdrho2_Trho);
-	matrix_to_file(root_path + std::string("d2pdTdrho_Trho.ttse"),&d2pdTdrho_Trho);
-	matrix_to_file(root_path + std::string("s_Trho.ttse"),&s_Trho);
-	matrix_to_file(root_path + std::string("dsdT_Trho.ttse"),&dsdT_Trho);
-	matrix_to_file(root_path + std::string("dsdrho_Trho.ttse"),&dsdrho_Trho);
-	matrix_to_file(root_path + std::string("d2sdT2_Trho.ttse"),&d2sdT2_Trho);
-	matrix_to_file(root_path + std::string("d2sdrho2_Trho.ttse"),&d2sdrho2_Trho);
-	matrix_to_file(root_path + std::string("d2sdTdrho_Trho.ttse"),&d2sdTdrho_Trho);
-	matrix_to_file(root_path + std::string("h_Trho.ttse"),&h_Trho);
-	matrix_to_file(root_path + std::string("dhdT_Trho.ttse"),&dhdT_Trho);
-	matrix_to_file(root_path + std::string("dhdrho_Trho.ttse"),&dhdrho_Trho);
-	matrix_to_file(root_path + std::string("d2hdT2_Trho.ttse"),&d2hdT2_Trho);
-	matrix_to_file(root_path + std::string("d2hdrho2_Trho.ttse"),&d2hdrho2_Trho);
-	matrix_to_file(root_path + std::string("d2hdTdrho_Trho.ttse"),&d2hdTdrho_Trho);
-	matrix_to_file(root_path + std::string("k_Trho.ttse"),&k_Trho);
-	matrix_to_file(root_path + std::string("dkdT_Trho.ttse"),&dkdT_Trho);
-	matrix_to_file(root_path + std::string("dkdrho_Trho.ttse"),&dkdrho_Trho);
-	matrix_to_file(root_path + std::string("d2kdT2_Trho.ttse"),&d2kdT2_Trho);
-	matrix_to_file(root_path + std::string("d2kdrho2_Trho.ttse"),&d2kdrho2_Trho);
-	matrix_to_file(root_path + std::string("d2kdTdrho_Trho.ttse"),&d2kdTdrho_Trho);
-	matrix_to_file(root_path + std::string("mu_Trho.ttse"),&mu_Trho);
-	matrix_to_file(root_path + std::string("dmudT_Trho.ttse"),&dmudT_Trho);
-	matrix_to_file(root_path + std::string("dmudrho_Trho.ttse"),&dmudrho_Trho);
-	matrix_to_file(root_path + std::string("d2mudT2_Trho.ttse"),&d2mudT2_Trho);
-	matrix_to_file(root_path + std::string("d2mudrho2_Trho.ttse"),&d2mudrho2_Trho);
-	matrix_to_file(root_path + std::string("d2mudTdrho_Trho.ttse"),&d2mudTdrho_Trho);
+	#if defined(__ISWINDOWS__)
+		// rename() does not replace an existing file on windows
+		ok = ok && MoveFileExA(tmpName.c_str(), fName.c_str(), MOVEFILE_REPLACE_EXISTING);
+	#else
+		ok = ok && rename(tmpName.c_str(), fName.c_str()) == 0;
+	#endif
+	if (!ok){ remove(tmpName.c_str()); }
 
 	t2 = clock();
 	std::cout << "write time: " << (double)(t2-t1)/CLOCKS_PER_SEC << std::endl;
 }
 
-double TTSESinglePhaseTableClass::build_ph(double hmin, double hmax, double pmin, double pmax, TTSETwoPhaseTableClass *SatL, TTSETwoPhaseTableClass *SatV)
+/// Wall-clock time in seconds; clock() adds up the time of all the threads
+static double wall_time()
 {
-	bool SinglePhase = false;
-
-	this->hmin = hmin;
-	this->hmax = hmax;
-	this->pmin = pmin;
-	this->pmax = pmax;
-	this->logpmin = log(pmin);
+#if defined(COOLPROP_CXX11_THREADS)
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+	return (double)clock()/CLOCKS_PER_SEC;
+#endif
+}
 
+/// Builds one row of the tables with p,h as inputs
+struct TTSEphRowBuilder
+{
+	TTSESinglePhaseTableClass *LUT;
+	TTSETwoPhaseTableClass *SatL, *SatV;
+	TTSEphRowBuilder(TTSESinglePhaseTableClass *LUT, TTSETwoPhaseTableClass *SatL, TTSETwoPhaseTableClass *SatV) : LUT(LUT), SatL(SatL), SatV(SatV){};
+	void operator()(unsigned int i, CoolPropStateClassSI &CPS){ LUT->build_ph_row(i, CPS, SatL, SatV); };
+};
+/// Builds one row of the tables with T,rho as inputs
+struct TTSETrhoRowBuilder
+{
+	TTSESinglePhaseTableClass *LUT;
+	TTSETwoPhaseTableClass *SatL, *SatV;
+	TTSETrhoRowBuilder(TTSESinglePhaseTableClass *LUT, TTSETwoPhaseTableClass *SatL, TTSETwoPhaseTableClass *SatV) : LUT(LUT), SatL(SatL), SatV(SatV){};
+	void operator()(unsigned int i, CoolPropStateClassSI &CPS){ LUT->build_Trho_row(i, CPS, SatL, SatV); };
+};
+
+#if defined(COOLPROP_CXX11_THREADS)
+/// Take the next row that has not been built yet until there are none left
+template<class RowBuilder> static void build_rows_worker(RowBuilder *builder, Fluid *pFluid, std::atomic<unsigned int> *next_row, unsigned int Nrows, std::string *errstr)
+{
 	CoolPropStateClassSI CPS(pFluid);
+	try
+	{
+		for (unsigned int i = (*next_row)++; i < Nrows; i = (*next_row)++)
+		{
+			(*builder)(i, CPS);
+		}
+	}
+	catch (std::exception &e)
+	{
+		*errstr = e.what();
+		// No need for the other threads to keep going
+		*next_row = Nrows;
+	}
+}
+#endif
 
-	long iFluid = get_Fluid_index(CPS.pFluid->get_name());
-
-	double dh = (hmax - hmin)/(Nh - 1);
-	pratio = pow(pmax/pmin,1/((double)Np-1));
-	logpratio = log(pratio);
+/// Build all the rows of a table, using several threads if there is thread support (see COOLPROP_CXX11_THREADS).  
+/// Each thread has its own state class, and the rows are handed out one at a time since the rows that cross 
+/// the saturation curve take much longer than the others
+/// @param builder Builds one row
+/// @param pFluid The fluid
+/// @param Nrows The number of rows
+/// @param Nthreads The number of threads, the number of hardware threads if less than one
+template<class RowBuilder> static void build_rows(RowBuilder &builder, Fluid *pFluid, unsigned int Nrows, int Nthreads)
+{
+#if defined(COOLPROP_CXX11_THREADS)
+	if (Nthreads < 1){ Nthreads = (int)std::thread::hardware_concurrency(); }
+	if (Nthreads > (int)Nrows){ Nthreads = (int)Nrows; }
+	if (Nthreads > 1)
+	{
+		std::atomic<unsigned int> next_row(0);
+		std::vector<std::string> errstr(Nthreads);
+		std::vector<std::thread> threads;
+		for (int k = 1; k < Nthreads; k++){
+			threads.push_back(std::thread(build_rows_worker<RowBuilder>, &builder, pFluid, &next_row, Nrows, &(errstr[k])));
+		}
+		// The calling thread is worker 0
+		build_rows_worker(&builder, pFluid, &next_row, Nrows, &(errstr[0]));
+		for (std::size_t k = 0; k < threads.size(); k++){
+			threads[k].join();
+		}
+		for (int k = 0; k < Nthreads; k++){
+			if (!errstr[k].empty()){ throw ValueError(errstr[k]); }
+		}
+		return;
+	}
+#endif
+	CoolPropStateClassSI CPS(pFluid);
+	for (unsigned int i = 0; i < Nrows; i++)
+	{
+		builder(i, CPS);
+	}
+}
 
-	clock_t t1,t2;
-	t1 = clock();
-	for (unsigned int i = 0; i<Nh; i++)
+void TTSESinglePhaseTableClass::build_ph_row(unsigned int i, CoolPropStateClassSI &CPS, TTSETwoPhaseTableClass *SatL, TTSETwoPhaseTableClass *SatV)
+{
+	bool SinglePhase = false;
+	double hval = h[i];
+	for (unsigned int j = 0; j<Np; j++)
 	{
-		double hval = hmin + i*dh;
-		h[i] = hval;
-		for (unsigned int j = 0; j<Np; j++)
+		double pval = p[j];
+		
+		// Check whether the point is single phase
+		// If pressure between ptriple point and pcrit, might be two-phase or single phase, otherwise definitely single phase
+		if (pval <= pFluid->reduce.p.Pa && pval >= pFluid->params.ptriple)
 		{
-			double pval = pmin*pow(pratio,(int)j);
-			p[j] = pval;
-			
-			// Check whether the point is single phase
-			// If pressure between ptriple point and pcrit, might be two-phase or single phase, otherwise definitely single phase
-			if (pval <= pFluid->reduce.p.Pa && pval >= pFluid->params.ptriple)
-			{
-				if (SatL == NULL || SatV == NULL){
-					// Not using TTSE method, use saturation (slow...)
-					CPS.update(iP,pval,iQ,0.5);
-					SinglePhase = (hval < CPS.hL() || hval > CPS.hV());
-				}
-				else{
-					// Using the TTSE method, nice and fast
-					SinglePhase = (hval < SatL->evaluate(iH,pval)  || hval > SatV->evaluate(iH,pval));
-				}
+			if (SatL == NULL || SatV == NULL){
+				// Not using TTSE method, use saturation (slow...)
+				CPS.update(iP,pval,iQ,0.5);
+				SinglePhase = (hval < CPS.hL() || hval > CPS.hV());
 			}
-			else
-			{
-				SinglePhase = true;
+			else{
+				// Using the TTSE method, nice and fast
+				SinglePhase = (hval < SatL->evaluate(iH,pval)  || hval > SatV->evaluate(iH,pval));
 			}
-			
-			// If enthalpy is outside the saturation region, continue and do the calculation as a function of p,h
-			if (SinglePhase)
+		}
+		else
+		{
+			SinglePhase = true;
+		}
+		
+		// If enthalpy is outside the saturation region, continue and do the calculation as a function of p,h
+		if (SinglePhase)
+		{
+			try
 			{
-				try
-				{
-					double T0=-1,rho0=-1,T,rho,rhoL,rhoV,TsatL,TsatV;
+				double T0=-1,rho0=-1,T,rho,rhoL,rhoV,TsatL,TsatV;
 
-					// Find a good point around this point that is single-phase if any of its neighbors have been calculated
-					nearest_neighbor_ph(i,j,&T0,&rho0);
+				// Find a good point around this point that is single-phase if any of its neighbors have been calculated
+				nearest_neighbor_ph(i,j,&T0,&rho0);
 
-					// If good T,rho was returned, use it as a guess value to calculate T,rho from p,h more quickly
-					if (T0 > 0 && rho0 > 0)
+				// If good T,rho was returned, use it as a guess value to calculate T,rho from p,h more quickly
+				if (T0 > 0 && rho0 > 0)
+				{
+					// Get T,rho from p,h using our guess value
+					CPS.pFluid->temperature_ph(pval,hval,T,rho,rhoL,rhoV,TsatL,TsatV,T0,rho0);
+					CPS.flag_SinglePhase = true;
+					CPS.update(iT, T, iD, rho);
+				}
+				else
+				{
+					// Probably here you are close to the saturation boundary since TTSE says it is single phase, but no neighbors to lean on
+					CPS.flag_SinglePhase = true;
+
+					double hsatLTTSE,hsatVTTSE;
+					if (SatL == NULL || SatV == NULL){
+						// Not using TTSE method, use saturation (slow...)
+						CPS.update(iP,pval,iQ,0.5);
+						hsatLTTSE = CPS.hL();
+						hsatVTTSE = CPS.hV();
+					}	
+					else
+					{
+						hsatLTTSE = SatL->evaluate(iH,pval);
+						hsatVTTSE = SatV->evaluate(iH,pval);
+					}
+
+					if (fabs(hval-hsatLTTSE)<10)
 					{
-						// Get T,rho from p,h using our guess value
+						// Close to the saturated liquid boundary
+						T0 = SatL->evaluate(iT,pval);
+						rho0 = SatL->evaluate(iD,pval);
 						CPS.pFluid->temperature_ph(pval,hval,T,rho,rhoL,rhoV,TsatL,TsatV,T0,rho0);
 						CPS.flag_SinglePhase = true;
 						CPS.update(iT, T, iD, rho);
 					}
-					else
+					else if (fabs(hval-hsatVTTSE)<10)
 					{
-						// Probably here you are close to the saturation boundary since TTSE says it is single phase, but no neighbors to lean on
+						// Close to the saturated vapor boundary
+						T0 = SatV->evaluate(iT,pval);
+						rho0 = SatV->evaluate(iD,pval);
+						CPS.pFluid->temperature_ph(pval,hval,T,rho,rhoL,rhoV,TsatL,TsatV,T0,rho0);
 						CPS.flag_SinglePhase = true;
-
-						double hsatLTTSE,hsatVTTSE;
-						if (SatL == NULL || SatV == NULL){
-							// Not using TTSE method, use saturation (slow...)
-							CPS.update(iP,pval,iQ,0.5);
-							hsatLTTSE = CPS.hL();
-							hsatVTTSE = CPS.hV();
-						}	
-						else
-						{
-							hsatLTTSE = SatL->evaluate(iH,pval);
-							hsatVTTSE = SatV->evaluate(iH,pval);
-						}
-
-						if (fabs(hval-hsatLTTSE)<10)
-						{
-							// Close to the saturated liquid boundary
-							T0 = SatL->evaluate(iT,pval);
-							rho0 = SatL->evaluate(iD,pval);
-							CPS.pFluid->temperature_ph(pval,hval,T,rho,rhoL,rhoV,TsatL,TsatV,T0,rho0);
-							CPS.flag_SinglePhase = true;
-							CPS.update(iT, T, iD, rho);
-						}
-						else if (fabs(hval-hsatVTTSE)<10)
-						{
-							// Close to the saturated vapor boundary
-							T0 = SatV->evaluate(iT,pval);
-							rho0 = SatV->evaluate(iD,pval);
-							CPS.pFluid->temperature_ph(pval,hval,T,rho,rhoL,rhoV,TsatL,TsatV,T0,rho0);
-							CPS.flag_SinglePhase = true;
-							CPS.update(iT, T, iD, rho);
-						}
-						else
-						{
-							CPS.update(iP, pval, iH, hval);
-						}
-						//std::cout << format("%d %d %g %g\n",i,j,pval,hval);
+						CPS.update(iT, T, iD, rho);
 					}
-					
-					T = CPS.T();
-					rho = CPS.rho();
-					double cp = CPS.cp();
-
-					double A = CPS.dpdT_constrho()*CPS.dhdrho_constT()-CPS.dpdrho_constT()*CPS.dhdT_constrho();
-
-					this->T[i][j] = T;
-					dTdh[i][j] = 1/cp;
-					dTdp[i][j] = 1/A*CPS.dhdrho_constT();
-					this->rho[i][j] = rho;
-					drhodh[i][j] = 1/A*CPS.dpdT_constrho();
-					drhodp[i][j] = -1/A*CPS.dhdT_constrho();
-					s[i][j] = CPS.s();
-					dsdh[i][j] = 1/T;
-					dsdp[i][j] = -1/(T*rho);
-					
-					// Matrices for second derivatives of entropy as a function of pressure and enthalpy
-					d2sdh2[i][j] = -1/(T*T)*dTdh[i][j];
-					d2sdhdp[i][j] = -1/(T*T)*dTdp[i][j];
-					d2sdp2[i][j] = 1/(T*T*rho)*dTdp[i][j]+1/(T*rho*rho)*drhodp[i][j];
-
-					// These are common terms needed for a range of terms for T(h,p) as well as rho(h,p)
-					double dAdT_constrho = CPS.d2pdT2_constrho()*CPS.dhdrho_constT()+CPS.dpdT_constrho()*CPS.d2hdrhodT()-CPS.d2pdrhodT()*CPS.dhdT_constrho()-CPS.dpdrho_constT()*CPS.d2hdT2_constrho();
-					double dAdrho_constT = CPS.d2pdrhodT()*CPS.dhdrho_constT()+CPS.dpdT_constrho()*CPS.d2hdrho2_constT()-CPS.d2pdrho2_constT()*CPS.dhdT_constrho()-CPS.dpdrho_constT()*CPS.d2hdrhodT();
-
-					//Matrices for temperature as a function of pressure and enthalpy
-					double ddT_dTdp_h_constrho = 1/A*CPS.d2hdrhodT()-1/(A*A)*dAdT_constrho*CPS.dhdrho_constT(); //[check]
-					double ddrho_dTdp_h_constT = 1/A*CPS.d2hdrho2_constT()-1/(A*A)*dAdrho_constT*CPS.dhdrho_constT(); //[check
-					double ddT_dTdh_p_constrho = -1/(cp*cp)*(CPS.d2hdT2_constrho()-CPS.dhdp_constT()*CPS.d2pdT2_constrho()+CPS.d2hdrhodT()*CPS.drhodT_constp()-CPS.dhdp_constT()*CPS.drhodT_constp()*CPS.d2pdrhodT());
-					double ddrho_dTdh_p_constT = -1/(cp*cp)*(CPS.d2hdrhodT()-CPS.dhdp_constT()*CPS.d2pdrhodT()+CPS.d2hdrho2_constT()*CPS.drhodT_constp()-CPS.dhdp_constT()*CPS.drhodT_constp()*CPS.d2pdrho2_constT());
-					
-					d2Tdh2[i][j]  = ddT_dTdh_p_constrho/CPS.dhdT_constp()+ddrho_dTdh_p_constT/CPS.dhdrho_constp();
-					d2Tdhdp[i][j] = ddT_dTdp_h_constrho/CPS.dhdT_constp()+ddrho_dTdp_h_constT/CPS.dhdrho_constp();
-					d2Tdp2[i][j]  = ddT_dTdp_h_constrho/CPS.dpdT_consth()+ddrho_dTdp_h_constT/CPS.dpdrho_consth();
-
-					//// Matrices for density as a function of pressure and enthalpy
-					double ddT_drhodp_h_constrho = -1/A*CPS.d2hdT2_constrho()+1/(A*A)*dAdT_constrho*CPS.dhdT_constrho();
-					double ddrho_drhodp_h_constT = -1/A*CPS.d2hdrhodT()+1/(A*A)*dAdrho_constT*CPS.dhdT_constrho();
-					double ddT_drhodh_p_constrho = 1/A*CPS.d2pdT2_constrho()-1/(A*A)*dAdT_constrho*CPS.dpdT_constrho();
-					double ddrho_drhodh_p_constT = 1/A*CPS.d2pdrhodT()-1/(A*A)*dAdrho_constT*CPS.dpdT_constrho();
-					
-					d2rhodh2[i][j]  = ddT_drhodh_p_constrho/CPS.dhdT_constp()+ddrho_drhodh_p_constT/CPS.dhdrho_constp();
-					d2rhodhdp[i][j] = ddT_drhodp_h_constrho/CPS.dhdT_constp()+ddrho_drhodp_h_constT/CPS.dhdrho_constp();
-					d2rhodp2[i][j]  = ddT_drhodp_h_constrho/CPS.dpdT_consth()+ddrho_drhodp_h_constT/CPS.dpdrho_consth();
-				}
-				catch(std::exception &)
-				{
-					s[i][j] = _HUGE;
-					dsdh[i][j] = _HUGE;
-					dsdp[i][j] = _HUGE;
-					d2sdh2[i][j] = _HUGE;
-					d2sdhdp[i][j] = _HUGE;
-					d2sdp2[i][j] = _HUGE;
-
-					this->T[i][j] = _HUGE;
-					dTdh[i][j] = _HUGE;
-					dTdp[i][j] = _HUGE;
-					d2Tdh2[i][j]  = _HUGE;
-					d2Tdhdp[i][j] = _HUGE;
-					d2Tdp2[i][j]  = _HUGE;
-
-					this->rho[i][j] = _HUGE;
-					drhodh[i][j] = _HUGE;
-					drhodp[i][j] = _HUGE;
-					d2rhodh2[i][j]  = _HUGE;
-					d2rhodhdp[i][j] = _HUGE;
-					d2rhodp2[i][j]  = _HUGE;
+					else
+					{
+						CPS.update(iP, pval, iH, hval);
+					}
+					//std::cout << format("%d %d %g %g\n",i,j,pval,hval);
 				}
+				
+				T = CPS.T();
+				rho = CPS.rho();
+				double cp = CPS.cp();
+
+				double A = CPS.dpdT_constrho()*CPS.dhdrho_constT()-CPS.dpdrho_constT()*CPS.dhdT_constrho();
+
+				this->T[i][j] = T;
+				dTdh[i][j] = 1/cp;
+				dTdp[i][j] = 1/A*CPS.dhdrho_constT();
+				this->rho[i][j] = rho;
+				drhodh[i][j] = 1/A*CPS.dpdT_constrho();
+				drhodp[i][j] = -1/A*CPS.dhdT_constrho();
+				s[i][j] = CPS.s();
+				dsdh[i][j] = 1/T;
+				dsdp[i][j] = -1/(T*rho);
+				
+				// Matrices for second derivatives of entropy as a function of pressure and enthalpy
+				d2sdh2[i][j] = -1/(T*T)*dTdh[i][j];
+				d2sdhdp[i][j] = -1/(T*T)*dTdp[i][j];
+				d2sdp2[i][j] = 1/(T*T*rho)*dTdp[i][j]+1/(T*rho*rho)*drhodp[i][j];
+
+				// These are common terms needed for a range of terms for T(h,p) as well as rho(h,p)
+				double dAdT_constrho = CPS.d2pdT2_constrho()*CPS.dhdrho_constT()+CPS.dpdT_constrho()*CPS.d2hdrhodT()-CPS.d2pdrhodT()*CPS.dhdT_constrho()-CPS.dpdrho_constT()*CPS.d2hdT2_constrho();
+				double dAdrho_constT = CPS.d2pdrhodT()*CPS.dhdrho_constT()+CPS.dpdT_constrho()*CPS.d2hdrho2_constT()-CPS.d2pdrho2_constT()*CPS.dhdT_constrho()-CPS.dpdrho_constT()*CPS.d2hdrhodT();
+
+				//Matrices for temperature as a function of pressure and enthalpy
+				double ddT_dTdp_h_constrho = 1/A*CPS.d2hdrhodT()-1/(A*A)*dAdT_constrho*CPS.dhdrho_constT(); //[check]
+				double ddrho_dTdp_h_constT = 1/A*CPS.d2hdrho2_constT()-1/(A*A)*dAdrho_constT*CPS.dhdrho_constT(); //[check
+				double ddT_dTdh_p_constrho = -1/(cp*cp)*(CPS.d2hdT2_constrho()-CPS.dhdp_constT()*CPS.d2pdT2_constrho()+CPS.d2hdrhodT()*CPS.drhodT_constp()-CPS.dhdp_constT()*CPS.drhodT_constp()*CPS.d2pdrhodT());
+				double ddrho_dTdh_p_constT = -1/(cp*cp)*(CPS.d2hdrhodT()-CPS.dhdp_constT()*CPS.d2pdrhodT()+CPS.d2hdrho2_constT()*CPS.drhodT_constp()-CPS.dhdp_constT()*CPS.drhodT_constp()*CPS.d2pdrho2_constT());
+				
+				d2Tdh2[i][j]  = ddT_dTdh_p_constrho/CPS.dhdT_constp()+ddrho_dTdh_p_constT/CPS.dhdrho_constp();
+				d2Tdhdp[i][j] = ddT_dTdp_h_constrho/CPS.dhdT_constp()+ddrho_dTdp_h_constT/CPS.dhdrho_constp();
+				d2Tdp2[i][j]  = ddT_dTdp_h_constrho/CPS.dpdT_consth()+ddrho_dTdp_h_constT/CPS.dpdrho_consth();
+
+				//// Matrices for density as a function of pressure and enthalpy
+				double ddT_drhodp_h_constrho = -1/A*CPS.d2hdT2_constrho()+1/(A*A)*dAdT_constrho*CPS.dhdT_constrho();
+				double ddrho_drhodp_h_constT = -1/A*CPS.d2hdrhodT()+1/(A*A)*dAdrho_constT*CPS.dhdT_constrho();
+				double ddT_drhodh_p_constrho = 1/A*CPS.d2pdT2_constrho()-1/(A*A)*dAdT_constrho*CPS.dpdT_constrho();
+				double ddrho_drhodh_p_constT = 1/A*CPS.d2pdrhodT()-1/(A*A)*dAdrho_constT*CPS.dpdT_constrho();
+				
+				d2rhodh2[i][j]  = ddT_drhodh_p_constrho/CPS.dhdT_constp()+ddrho_drhodh_p_constT/CPS.dhdrho_constp();
+				d2rhodhdp[i][j] = ddT_drhodp_h_constrho/CPS.dhdT_constp()+ddrho_drhodp_h_constT/CPS.dhdrho_constp();
+				d2rhodp2[i][j]  = ddT_drhodp_h_constrho/CPS.dpdT_consth()+ddrho_drhodp_h_constT/CPS.dpdrho_consth();
 			}
-			else
+			catch(std::exception &)
 			{
 				s[i][j] = _HUGE;
 				dsdh[i][j] = _HUGE;
@@ -1029,15 +1150,63 @@ double TTSESinglePhaseTableClass::build_ph(double hmin, double hmax, double pmin
 				d2rhodh2[i][j]  = _HUGE;
 				d2rhodhdp[i][j] = _HUGE;
 				d2rhodp2[i][j]  = _HUGE;
+			}
+		}
+		else
+		{
+			s[i][j] = _HUGE;
+			dsdh[i][j] = _HUGE;
+			dsdp[i][j] = _HUGE;
+			d2sdh2[i][j] = _HUGE;
+			d2sdhdp[i][j] = _HUGE;
+			d2sdp2[i][j] = _HUGE;
+
+			this->T[i][j] = _HUGE;
+			dTdh[i][j] = _HUGE;
+			dTdp[i][j] = _HUGE;
+			d2Tdh2[i][j]  = _HUGE;
+			d2Tdhdp[i][j] = _HUGE;
+			d2Tdp2[i][j]  = _HUGE;
+
+			this->rho[i][j] = _HUGE;
+			drhodh[i][j] = _HUGE;
+			drhodp[i][j] = _HUGE;
+			d2rhodh2[i][j]  = _HUGE;
+			d2rhodhdp[i][j] = _HUGE;
+			d2rhodp2[i][j]  = _HUGE;
 
 
-			}
 		}
 	}
-	t2 = clock();
-	double elap = (double)(t2-t1)/CLOCKS_PER_SEC;
+}
+
+double TTSESinglePhaseTableClass::build_ph(double hmin, double hmax, double pmin, double pmax, TTSETwoPhaseTableClass *SatL, TTSETwoPhaseTableClass *SatV)
+{
+	this->hmin = hmin;
+	this->hmax = hmax;
+	this->pmin = pmin;
+	this->pmax = pmax;
+	this->logpmin = log(pmin);
+
+	// The matrices are freed once the tables are packed, allocate them again in case the tables are rebuilt
+	set_size_ph(Np, Nh);
+
+	double dh = (hmax - hmin)/(Nh - 1);
+	pratio = pow(pmax/pmin,1/((double)Np-1));
+	logpratio = log(pratio);
+
+	for (unsigned int i = 0; i<Nh; i++){ h[i] = hmin + i*dh; }
+	for (unsigned int j = 0; j<Np; j++){ p[j] = pmin*pow(pratio,(int)j); }
+
+	double t1 = wall_time();
+	// The rows (constant enthalpy) only warm-start from nodes in the same row, so they are built in parallel
+	TTSEphRowBuilder builder(this, SatL, SatV);
+	build_rows(builder, pFluid, Nh, Nthreads_build);
+	double elap = wall_time()-t1;
 	std::cout << elap << " to build single phase table with p,h" << std::endl;
 
+	pack_ph();
+
 	// Update the boundaries of the points within the single-phase regions
 	update_saturation_boundary_indices();
 	
@@ -1046,10 +1215,150 @@ double TTSESinglePhaseTableClass::build_ph(double hmin, double hmax, double pmin
 
 	return elap;
 }
-double TTSESinglePhaseTableClass::build_Trho(double Tmin, double Tmax, double rhomin, double rhomax, TTSETwoPhaseTableClass *SatL, TTSETwoPhaseTableClass *SatV)
+void TTSESinglePhaseTableClass::build_Trho_row(unsigned int i, CoolPropStateClassSI &CPS, TTSETwoPhaseTableClass *SatL, TTSETwoPhaseTableClass *SatV)
 {
 	bool SinglePhase = false;
+	long iFluid = get_Fluid_index(pFluid->get_name());
+	double Tval = T_Trho[i];
+	for (unsigned int j = 0; j<Nrho; j++)
+	{
+		double rhoval = rho_Trho[j];
+		
+		// Check whether the point is single phase
+		// If pressure between Ttriple point and Tcrit, might be two-phase or single phase, otherwise definitely single phase
+		if (Tval <= pFluid->crit.T && Tval >= pFluid->params.Ttriple)
+		{
+			if (SatL == NULL || SatV == NULL){
+				// Not using TTSE method, use saturation (slow...)
+				CPS.update(iT,Tval,iQ,0.5);
+				SinglePhase = (rhoval < CPS.rhoV() || rhoval > CPS.rhoL());
+			}
+			else{
+				// Using the TTSE method, nice and fast
+				double psatV = SatV->evaluate_T(Tval);
+				double psatL = SatL->evaluate_T(Tval);
+				SinglePhase = (rhoval < SatV->evaluate(iD,psatV)  || rhoval > SatL->evaluate(iD,psatL));
+			}
+		}
+		else
+		{
+			SinglePhase = true;
+		}
+		
+		// If enthalpy is outside the saturation region, continue and do the calculation as a function of T,rho
+		if (SinglePhase)
+		{
+			CPS.update(iT,Tval,iD,rhoval);
+
+			s_Trho[i][j] = CPS.s();
+			dsdT_Trho[i][j] = CPS.dsdT_constrho();
+			dsdrho_Trho[i][j] = CPS.dsdrho_constT();
+			d2sdT2_Trho[i][j] = CPS.d2sdT2_constrho();
+			d2sdTdrho_Trho[i][j] = CPS.d2sdrhodT();
+			d2sdrho2_Trho[i][j] = CPS.d2sdrho2_constT();
+
+			h_Trho[i][j] = CPS.h();
+			dhdT_Trho[i][j] = CPS.dhdT_constrho();
+			dhdrho_Trho[i][j] = CPS.dhdrho_constT();
+			d2hdT2_Trho[i][j] = CPS.d2hdT2_constrho();
+			d2hdTdrho_Trho[i][j] = CPS.d2hdrhodT();
+			d2hdrho2_Trho[i][j] = CPS.d2hdrho2_constT();
+
+			p_Trho[i][j] = CPS.p();
+			dpdT_Trho[i][j] = CPS.dpdT_constrho();
+			dpdrho_Trho[i][j] = CPS.dpdrho_constT();
+			d2pdT2_Trho[i][j] = CPS.d2pdT2_constrho();
+			d2pdTdrho_Trho[i][j] = CPS.d2pdrhodT();
+			d2pdrho2_Trho[i][j] = CPS.d2pdrho2_constT();
 
+			
+			/// Transport properties
+			///
+			// Using second-order centered finite differences to calculate the transport property derivatives
+			double deltaT = 1e-3, deltarho = 1e-4;
+
+			if (deltarho > rhoval)
+				deltarho = rhoval/100;
+
+			// The viscosity values
+			double muval =             IPropsSI(iV,iT,Tval,       iD,rhoval,         iFluid);
+			double muplusrho =         IPropsSI(iV,iT,Tval,       iD,rhoval+deltarho,iFluid);
+			double muminusrho =        IPropsSI(iV,iT,Tval,       iD,rhoval-deltarho,iFluid);
+			double muplusT =           IPropsSI(iV,iT,Tval+deltaT,iD,rhoval,         iFluid);
+			double muminusT =          IPropsSI(iV,iT,Tval-deltaT,iD,rhoval,         iFluid);
+			double muplusT_plusrho =   IPropsSI(iV,iT,Tval+deltaT,iD,rhoval+deltarho,iFluid);
+			double muplusT_minusrho =  IPropsSI(iV,iT,Tval+deltaT,iD,rhoval-deltarho,iFluid);
+			double muminusT_plusrho =  IPropsSI(iV,iT,Tval-deltaT,iD,rhoval+deltarho,iFluid);
+			double muminusT_minusrho = IPropsSI(iV,iT,Tval-deltaT,iD,rhoval-deltarho,iFluid);
+
+			mu_Trho[i][j] = muval;
+			dmudT_Trho[i][j] = (-muminusT + muplusT)/(2*deltaT);
+			dmudrho_Trho[i][j] = (-muminusrho + muplusrho)/(2*deltarho);
+			d2mudT2_Trho[i][j] = (muminusT - 2*muval + muplusT)/(deltaT*deltaT);
+			d2mudrho2_Trho[i][j] = (muminusrho - 2*muval + muplusrho)/(deltarho*deltarho);
+			d2mudTdrho_Trho[i][j] = (muplusT_plusrho - muplusT_minusrho - muminusT_plusrho + muminusT_minusrho)/(2*deltaT*deltarho);
+
+			// The thermal conductivity values
+			double kval =             IPropsSI(iL,iT,Tval,       iD,rhoval,         iFluid);
+			double kplusrho =         IPropsSI(iL,iT,Tval,       iD,rhoval+deltarho,iFluid);
+			double kminusrho =        IPropsSI(iL,iT,Tval,       iD,rhoval-deltarho,iFluid);
+			double kplusT =           IPropsSI(iL,iT,Tval+deltaT,iD,rhoval,         iFluid);
+			double kminusT =          IPropsSI(iL,iT,Tval-deltaT,iD,rhoval,         iFluid);
+			double kplusT_plusrho =   IPropsSI(iL,iT,Tval+deltaT,iD,rhoval+deltarho,iFluid);
+			double kplusT_minusrho =  IPropsSI(iL,iT,Tval+deltaT,iD,rhoval-deltarho,iFluid);
+			double kminusT_plusrho =  IPropsSI(iL,iT,Tval-deltaT,iD,rhoval+deltarho,iFluid);
+			double kminusT_minusrho = IPropsSI(iL,iT,Tval-deltaT,iD,rhoval-deltarho,iFluid);
+
+			k_Trho[i][j] = kval;
+			dkdT_Trho[i][j] = (-kminusT + kplusT)/(2*deltaT);
+			dkdrho_Trho[i][j] = (-kminusrho + kplusrho)/(2*deltarho);
+			d2kdT2_Trho[i][j] = (kminusT - 2*kval + kplusT)/(deltaT*deltaT);
+			d2kdrho2_Trho[i][j] = (kminusrho - 2*kval + kplusrho)/(deltarho*deltarho);
+			d2kdTdrho_Trho[i][j] = (kplusT_plusrho - kplusT_minusrho - kminusT_plusrho + kminusT_minusrho)/(2*deltaT*deltarho);
+		}
+		else
+		{
+			s_Trho[i][j] = _HUGE;
+			dsdT_Trho[i][j] = _HUGE;
+			dsdrho_Trho[i][j] = _HUGE;
+			d2sdT2_Trho[i][j] = _HUGE;
+			d2sdTdrho_Trho[i][j] = _HUGE;
+			d2sdrho2_Trho[i][j] = _HUGE;
+
+			h_Trho[i][j] = _HUGE;
+			dhdT_Trho[i][j] = _HUGE;
+			dhdrho_Trho[i][j] = _HUGE;
+			d2hdT2_Trho[i][j] = _HUGE;
+			d2hdTdrho_Trho[i][j] = _HUGE;
+			d2hdrho2_Trho[i][j] = _HUGE;
+
+			p_Trho[i][j] = _HUGE;
+			dpdT_Trho[i][j] = _HUGE;
+			dpdrho_Trho[i][j] = _HUGE;
+			d2pdT2_Trho[i][j] = _HUGE;
+			d2pdTdrho_Trho[i][j] = _HUGE;
+			d2pdrho2_Trho[i][j] = _HUGE;
+
+			mu_Trho[i][j] = _HUGE;
+			dmudT_Trho[i][j] = _HUGE;
+			dmudrho_Trho[i][j] = _HUGE;
+			d2mudT2_Trho[i][j] = _HUGE;
+			d2mudTdrho_Trho[i][j] = _HUGE;
+			d2mudrho2_Trho[i][j] = _HUGE;
+
+			k_Trho[i][j] = _HUGE;
+			dkdT_Trho[i][j] = _HUGE;
+			dkdrho_Trho[i][j] = _HUGE;
+			d2kdT2_Trho[i][j] = _HUGE;
+			d2kdTdrho_Trho[i][j] = _HUGE;
+			d2kdrho2_Trho[i][j] = _HUGE;
+		}
+		//std::cout << format("%d %d\n",i,j);
+	}
+}
+
+double TTSESinglePhaseTableClass::build_Trho(double Tmin, double Tmax, double rhomin, double rhomax, TTSETwoPhaseTableClass *SatL, TTSETwoPhaseTableClass *SatV)
+{
 	if (Tmin < 0 && Tmax < 0 && rhomin < 0 && rhomax < 0)
 	{
 		rhomin = 9e9;
@@ -1061,17 +1370,18 @@ double TTSESinglePhaseTableClass::build_Trho(double Tmin, double Tmax, double rh
 		{
 			for (unsigned int j = 0; j<Np; j++)
 			{
-				if (ValidNumber(rho[i][j]) && rho[i][j] > rhomax){
-					rhomax = rho[i][j];
+				double rhoij = ph_value(i,j,TTSE_PH_RHO), Tij = ph_value(i,j,TTSE_PH_T);
+				if (ValidNumber(rhoij) && rhoij > rhomax){
+					rhomax = rhoij;
 				}
-				if (ValidNumber(rho[i][j]) && rho[i][j] < rhomin){
-					rhomin = rho[i][j];
+				if (ValidNumber(rhoij) && rhoij < rhomin){
+					rhomin = rhoij;
 				}
-				if (ValidNumber(T[i][j]) && T[i][j] > Tmax){
-					Tmax = T[i][j];
+				if (ValidNumber(Tij) && Tij > Tmax){
+					Tmax = Tij;
 				}
-				if (ValidNumber(T[i][j]) && T[i][j] < Tmin){
-					Tmin = T[i][j];
+				if (ValidNumber(Tij) && Tij < Tmin){
+					Tmin = Tij;
 				}
 			}
 		}
@@ -1086,160 +1396,22 @@ double TTSESinglePhaseTableClass::build_Trho(double Tmin, double Tmax, double rh
 	rhoratio = pow(rhomax/rhomin,1/((double)Nrho-1));
 	logrhoratio = log(rhoratio);
 
-	CoolPropStateClassSI CPS(pFluid);
-
-	long iFluid = get_Fluid_index(pFluid->get_name());
+	// The matrices are freed once the tables are packed, allocate them again in case the tables are rebuilt
+	set_size_Trho(NT, Nrho);
 
 	double dT = (Tmax - Tmin)/((double)NT - 1);
-
-	clock_t t1,t2;
-	t1 = clock();
-
-	for (unsigned int i = 0; i<NT; i++)
-	{
-		double Tval = Tmin + i*dT;
-		T_Trho[i] = Tval;
-		for (unsigned int j = 0; j<Nrho; j++)
-		{
-			double rhoval = rhomin*pow(rhoratio,(int)j);
-			rho_Trho[j] = rhoval;
-			
-			// Check whether the point is single phase
-			// If pressure between Ttriple point and Tcrit, might be two-phase or single phase, otherwise definitely single phase
-			if (Tval <= pFluid->crit.T && Tval >= pFluid->params.Ttriple)
-			{
-				if (SatL == NULL || SatV == NULL){
-					// Not using TTSE method, use saturation (slow...)
-					CPS.update(iT,Tval,iQ,0.5);
-					SinglePhase = (rhoval < CPS.rhoV() || rhoval > CPS.rhoL());
-				}
-				else{
-					// Using the TTSE method, nice and fast
-					double psatV = SatV->evaluate_T(Tval);
-					double psatL = SatL->evaluate_T(Tval);
-					SinglePhase = (rhoval < SatV->evaluate(iD,psatV)  || rhoval > SatL->evaluate(iD,psatL));
-				}
-			}
-			else
-			{
-				SinglePhase = true;
-			}
-			
-			// If enthalpy is outside the saturation region, continue and do the calculation as a function of T,rho
-			if (SinglePhase)
-			{
-				CPS.update(iT,Tval,iD,rhoval);
-
-				s_Trho[i][j] = CPS.s();
-				dsdT_Trho[i][j] = CPS.dsdT_constrho();
-				dsdrho_Trho[i][j] = CPS.dsdrho_constT();
-				d2sdT2_Trho[i][j] = CPS.d2sdT2_constrho();
-				d2sdTdrho_Trho[i][j] = CPS.d2sdrhodT();
-				d2sdrho2_Trho[i][j] = CPS.d2sdrho2_constT();
-
-				h_Trho[i][j] = CPS.h();
-				dhdT_Trho[i][j] = CPS.dhdT_constrho();
-				dhdrho_Trho[i][j] = CPS.dhdrho_constT();
-				d2hdT2_Trho[i][j] = CPS.d2hdT2_constrho();
-				d2hdTdrho_Trho[i][j] = CPS.d2hdrhodT();
-				d2hdrho2_Trho[i][j] = CPS.d2hdrho2_constT();
-
-				p_Trho[i][j] = CPS.p();
-				dpdT_Trho[i][j] = CPS.dpdT_constrho();
-				dpdrho_Trho[i][j] = CPS.dpdrho_constT();
-				d2pdT2_Trho[i][j] = CPS.d2pdT2_constrho();
-				d2pdTdrho_Trho[i][j] = CPS.d2pdrhodT();
-				d2pdrho2_Trho[i][j] = CPS.d2pdrho2_constT();
-
-				
-				/// Transport properties
-				///
-				// Using second-order centered finite differences to calculate the transport property derivatives
-				double deltaT = 1e-3, deltarho = 1e-4;
-
-				if (deltarho > rhoval)
-					deltarho = rhoval/100;
-
-				// The viscosity values
-				double muval =             IPropsSI(iV,iT,Tval,       iD,rhoval,         iFluid);
-				double muplusrho =         IPropsSI(iV,iT,Tval,       iD,rhoval+deltarho,iFluid);
-				double muminusrho =        IPropsSI(iV,iT,Tval,       iD,rhoval-deltarho,iFluid);
-				double muplusT =           IPropsSI(iV,iT,Tval+deltaT,iD,rhoval,         iFluid);
-				double muminusT =          IPropsSI(iV,iT,Tval-deltaT,iD,rhoval,         iFluid);
-				double muplusT_plusrho =   IPropsSI(iV,iT,Tval+deltaT,iD,rhoval+deltarho,iFluid);
-				double muplusT_minusrho =  IPropsSI(iV,iT,Tval+deltaT,iD,rhoval-deltarho,iFluid);
-				double muminusT_plusrho =  IPropsSI(iV,iT,Tval-deltaT,iD,rhoval+deltarho,iFluid);
-				double muminusT_minusrho = IPropsSI(iV,iT,Tval-deltaT,iD,rhoval-deltarho,iFluid);
-
-				mu_Trho[i][j] = muval;
-				dmudT_Trho[i][j] = (-muminusT + muplusT)/(2*deltaT);
-				dmudrho_Trho[i][j] = (-muminusrho + muplusrho)/(2*deltarho);
-				d2mudT2_Trho[i][j] = (muminusT - 2*muval + muplusT)/(deltaT*deltaT);
-				d2mudrho2_Trho[i][j] = (muminusrho - 2*muval + muplusrho)/(deltarho*deltarho);
-				d2mudTdrho_Trho[i][j] = (muplusT_plusrho - muplusT_minusrho - muminusT_plusrho + muminusT_minusrho)/(2*deltaT*deltarho);
-
-				// The thermal conductivity values
-				double kval =             IPropsSI(iL,iT,Tval,       iD,rhoval,         iFluid);
-				double kplusrho =         IPropsSI(iL,iT,Tval,       iD,rhoval+deltarho,iFluid);
-				double kminusrho =        IPropsSI(iL,iT,Tval,       iD,rhoval-deltarho,iFluid);
-				double kplusT =           IPropsSI(iL,iT,Tval+deltaT,iD,rhoval,         iFluid);
-				double kminusT =          IPropsSI(iL,iT,Tval-deltaT,iD,rhoval,         iFluid);
-				double kplusT_plusrho =   IPropsSI(iL,iT,Tval+deltaT,iD,rhoval+deltarho,iFluid);
-				double kplusT_minusrho =  IPropsSI(iL,iT,Tval+deltaT,iD,rhoval-deltarho,iFluid);
-				double kminusT_plusrho =  IPropsSI(iL,iT,Tval-deltaT,iD,rhoval+deltarho,iFluid);
-				double kminusT_minusrho = IPropsSI(iL,iT,Tval-deltaT,iD,rhoval-deltarho,iFluid);
-
-				k_Trho[i][j] = kval;
-				dkdT_Trho[i][j] = (-kminusT + kplusT)/(2*deltaT);
-				dkdrho_Trho[i][j] = (-kminusrho + kplusrho)/(2*deltarho);
-				d2kdT2_Trho[i][j] = (kminusT - 2*kval + kplusT)/(deltaT*deltaT);
-				d2kdrho2_Trho[i][j] = (kminusrho - 2*kval + kplusrho)/(deltarho*deltarho);
-				d2kdTdrho_Trho[i][j] = (kplusT_plusrho - kplusT_minusrho - kminusT_plusrho + kminusT_minusrho)/(2*deltaT*deltarho);
-			}
-			else
-			{
-				s_Trho[i][j] = _HUGE;
-				dsdT_Trho[i][j] = _HUGE;
-				dsdrho_Trho[i][j] = _HUGE;
-				d2sdT2_Trho[i][j] = _HUGE;
-				d2sdTdrho_Trho[i][j] = _HUGE;
-				d2sdrho2_Trho[i][j] = _HUGE;
-
-				h_Trho[i][j] = _HUGE;
-				dhdT_Trho[i][j] = _HUGE;
-				dhdrho_Trho[i][j] = _HUGE;
-				d2hdT2_Trho[i][j] = _HUGE;
-				d2hdTdrho_Trho[i][j] = _HUGE;
-				d2hdrho2_Trho[i][j] = _HUGE;
-
-				p_Trho[i][j] = _HUGE;
-				dpdT_Trho[i][j] = _HUGE;
-				dpdrho_Trho[i][j] = _HUGE;
-				d2pdT2_Trho[i][j] = _HUGE;
-				d2pdTdrho_Trho[i][j] = _HUGE;
-				d2pdrho2_Trho[i][j] = _HUGE;
-
-				mu_Trho[i][j] = _HUGE;
-				dmudT_Trho[i][j] = _HUGE;
-				dmudrho_Trho[i][j] = _HUGE;
-				d2mudT2_Trho[i][j] = _HUGE;
-				d2mudTdrho_Trho[i][j] = _HUGE;
-				d2mudrho2_Trho[i][j] = _HUGE;
-
-				k_Trho[i][j] = _HUGE;
-				dkdT_Trho[i][j] = _HUGE;
-				dkdrho_Trho[i][j] = _HUGE;
-				d2kdT2_Trho[i][j] = _HUGE;
-				d2kdTdrho_Trho[i][j] = _HUGE;
-				d2kdrho2_Trho[i][j] = _HUGE;
-			}
-			//std::cout << format("%d %d\n",i,j);
-		}
-	}
-	t2 = clock();
-	double elap = (double)(t2-t1)/CLOCKS_PER_SEC;
+	for (unsigned int i = 0; i<NT; i++){ T_Trho[i] = Tmin + i*dT; }
+	for (unsigned int j = 0; j<Nrho; j++){ rho_Trho[j] = rhomin*pow(rhoratio,(int)j); }
+
+	double t1 = wall_time();
+	// Each node is independent, build the rows (constant temperature) in parallel
+	TTSETrhoRowBuilder builder(this, SatL, SatV);
+	build_rows(builder, pFluid, NT, Nthreads_build);
+	double elap = wall_time()-t1;
 	std::cout << elap << " to build single phase table for T,rho" << std::endl;
 
+	pack_Trho();
+
 	// Update the boundaries of the points within the single-phase regions
 	update_saturation_boundary_indices();
 
@@ -1250,13 +1422,14 @@ double TTSESinglePhaseTableClass::build_Trho(double Tmin, double Tmax, double rh
 
 void TTSESinglePhaseTableClass::update_cell_validity()
 {
-	for (unsigned int i = 0; i < NT; i++)
+	// The tables with T,rho as inputs are built after the ones with p,h as inputs
+	for (unsigned int i = 0; i < NT && Trho_nodes.size() > 0; i++)
 	{
 		for (unsigned int j = 0; j < Nrho; j++)
 		{
 			if (i < NT-1 && j < Nrho-1)
 			{ 
-				if(ValidNumber(s_Trho[i][j]) && ValidNumber(s_Trho[i][j+1]) && ValidNumber(s_Trho[i+1][j]) && ValidNumber(s_Trho[i+1][j+1]))
+				if(ValidNumber(Trho_value(i,j,TTSE_TRHO_S)) && ValidNumber(Trho_value(i,j+1,TTSE_TRHO_S)) && ValidNumber(Trho_value(i+1,j,TTSE_TRHO_S)) && ValidNumber(Trho_value(i+1,j+1,TTSE_TRHO_S)))
 				{
 					bicubic_cells.cells[i][j].valid_Trho = true;
 				}
@@ -1274,7 +1447,7 @@ void TTSESinglePhaseTableClass::update_cell_validity()
 		{
 			if (i < Nh-1 && j < Np-1)
 			{ 
-				if(ValidNumber(s[i][j]) && ValidNumber(s[i][j+1]) && ValidNumber(s[i+1][j]) && ValidNumber(s[i+1][j+1]))
+				if(ValidNumber(ph_value(i,j,TTSE_PH_S)) && ValidNumber(ph_value(i,j+1,TTSE_PH_S)) && ValidNumber(ph_value(i+1,j,TTSE_PH_S)) && ValidNumber(ph_value(i+1,j+1,TTSE_PH_S)))
 				{
 					bicubic_cells.cells[i][j].valid_hp = true;
 				}
@@ -1286,6 +1459,32 @@ void TTSESinglePhaseTableClass::update_cell_validity()
 		}
 	}
 }
+std::vector< std::vector< std::vector<double> > * > TTSESinglePhaseTableClass::ph_matrices()
+{
+	std::vector< std::vector< std::vector<double> > * > mats;
+	mats.push_back(&T); mats.push_back(&dTdh); mats.push_back(&dTdp); mats.push_back(&d2Tdh2); mats.push_back(&d2Tdp2); mats.push_back(&d2Tdhdp);
+	mats.push_back(&rho); mats.push_back(&drhodh); mats.push_back(&drhodp); mats.push_back(&d2rhodh2); mats.push_back(&d2rhodp2); mats.push_back(&d2rhodhdp);
+	mats.push_back(&s); mats.push_back(&dsdh); mats.push_back(&dsdp); mats.push_back(&d2sdh2); mats.push_back(&d2sdp2); mats.push_back(&d2sdhdp);
+	return mats;
+}
+std::vector< std::vector< std::vector<double> > * > TTSESinglePhaseTableClass::Trho_matrices()
+{
+	std::vector< std::vector< std::vector<double> > * > mats;
+	mats.push_back(&s_Trho); mats.push_back(&dsdT_Trho); mats.push_back(&dsdrho_Trho); mats.push_back(&d2sdT2_Trho); mats.push_back(&d2sdrho2_Trho); mats.push_back(&d2sdTdrho_Trho);
+	mats.push_back(&p_Trho); mats.push_back(&dpdT_Trho); mats.push_back(&dpdrho_Trho); mats.push_back(&d2pdT2_Trho); mats.push_back(&d2pdrho2_Trho); mats.push_back(&d2pdTdrho_Trho);
+	mats.push_back(&h_Trho); mats.push_back(&dhdT_Trho); mats.push_back(&dhdrho_Trho); mats.push_back(&d2hdT2_Trho); mats.push_back(&d2hdrho2_Trho); mats.push_back(&d2hdTdrho_Trho);
+	mats.push_back(&mu_Trho); mats.push_back(&dmudT_Trho); mats.push_back(&dmudrho_Trho); mats.push_back(&d2mudT2_Trho); mats.push_back(&d2mudrho2_Trho); mats.push_back(&d2mudTdrho_Trho);
+	mats.push_back(&k_Trho); mats.push_back(&dkdT_Trho); mats.push_back(&dkdrho_Trho); mats.push_back(&d2kdT2_Trho); mats.push_back(&d2kdrho2_Trho); mats.push_back(&d2kdTdrho_Trho);
+	return mats;
+}
+void TTSESinglePhaseTableClass::pack_ph()
+{
+	pack_tables(Nh, Np, h, p, ph_matrices(), ph_nodes, ph_cells);
+}
+void TTSESinglePhaseTableClass::pack_Trho()
+{
+	pack_tables(NT, Nrho, T_Trho, rho_Trho, Trho_matrices(), Trho_nodes, Trho_cells);
+}
 //void TTSESinglePhaseTableClass::update_Trho_map()
 //{
 //	int ii,jj;
@@ -1342,6 +1541,10 @@ void TTSESinglePhaseTableClass::update_saturation_boundary_indices()
 	// Store some information about the phase boundaries so that we 
 	// can use other inputs than p,h more easily
 
+	// The pressure indices on either side of the critical pressure
+	this->jpcrit_floor = (int)floor((log(pFluid->reduce.p.Pa)-logpmin)/logpratio);
+	this->jpcrit_ceil = (int)ceil((log(pFluid->reduce.p.Pa)-logpmin)/logpratio);
+
 	for (unsigned int j = 0; j < Np; j++)
 	{
 		if (p[j] < pFluid->reduce.p.Pa)
@@ -1350,7 +1553,7 @@ void TTSESinglePhaseTableClass::update_saturation_boundary_indices()
 			// Sweep left to right to find a phase boundary, use the first one that fails in the saturation region
 			for (unsigned int i = 0; i < Nh; i++)
 			{
-				if (!ValidNumber(T[i][j]))
+				if (!ValidNumber(ph_value(i,j,TTSE_PH_T)))
 				{
 					IL[j] = i;
 					break;
@@ -1360,7 +1563,7 @@ void TTSESinglePhaseTableClass::update_saturation_boundary_indices()
 			// Sweep right to left to find a phase boundary, use the first one that fails in the saturation region
 			for (int i = Nh-1; i > 0; i--)
 			{
-				if (!ValidNumber(T[i][j]))
+				if (!ValidNumber(ph_value(i,j,TTSE_PH_T)))
 				{
 					IV[j] = i;
 					break;	
@@ -1401,7 +1604,7 @@ void TTSESinglePhaseTableClass::write_dotdrawing_tofile(char fName[])
 	{
 		for (unsigned int i = 0; i<Nh; i++)
 		{
-			if (ValidNumber(rho[i][j]))
+			if (ValidNumber(ph_value(i,j,TTSE_PH_RHO)))
 			{
 				fprintf(fp,".");
 			}
@@ -1499,7 +1702,7 @@ double TTSESinglePhaseTableClass::evaluate(long iParam, double p, double logp, d
 	// If the value at i,j is too close to the saturation boundary, the nearest point i,j 
 	// might be in the two-phase region which is not defined for single-phase table.  
 	// Therefore, search around its neighbors for a better choice
-	if (!ValidNumber(T[i][j])){
+	if (!ValidNumber(node_ph(i,j,TTSE_PH_T)[TTSE_NODE_F])){
 		nearest_good_neighbor(&i,&j);
 	}
 
@@ -1507,17 +1710,9 @@ double TTSESinglePhaseTableClass::evaluate(long iParam, double p, double logp, d
 	double deltap = p-this->p[j];
 	double deltah = h-this->h[i];
 	
-	switch (iParam)
-	{
-	case iS:
-		return s[i][j]+deltah*dsdh[i][j]+deltap*dsdp[i][j]+0.5*deltah*deltah*d2sdh2[i][j]+0.5*deltap*deltap*d2sdp2[i][j]+deltap*deltah*d2sdhdp[i][j]; break;
-	case iT:
-		return T[i][j]+deltah*dTdh[i][j]+deltap*dTdp[i][j]+0.5*deltah*deltah*d2Tdh2[i][j]+0.5*deltap*deltap*d2Tdp2[i][j]+deltap*deltah*d2Tdhdp[i][j]; break;
-	case iD:
-		return rho[i][j]+deltah*drhodh[i][j]+deltap*drhodp[i][j]+0.5*deltah*deltah*d2rhodh2[i][j]+0.5*deltap*deltap*d2rhodp2[i][j]+deltap*deltah*d2rhodhdp[i][j]; break;
-	default:
-		throw ValueError(format("Output key value [%d] to evaluate is invalid",iParam));
-	}
+	// The value and all its derivatives are in one cache line
+	const double *f = node_ph(i,j,ph_property_index(iParam));
+	return f[TTSE_NODE_F]+deltah*f[TTSE_NODE_DFDX]+deltap*f[TTSE_NODE_DFDY]+0.5*deltah*deltah*f[TTSE_NODE_D2FDX2]+0.5*deltap*deltap*f[TTSE_NODE_D2FDY2]+deltap*deltah*f[TTSE_NODE_D2FDXDY];
 }
 
 void TTSESinglePhaseTableClass::bicubic_cell_coordinates_Trho(double Tval, double rhoval, double logrhoval, int *i, int *j)
@@ -1564,213 +1759,14 @@ void TTSESinglePhaseTableClass::bicubic_cell_coordinates_ph(double hval, double
 	nearest_good_neighbor_ph_interpolate(i, j);
 }
 
-std::vector<double> * TTSESinglePhaseTableClass::bicubic_cell_coeffs_ph(long iParam, int i, int j)
+const double * TTSESinglePhaseTableClass::bicubic_cell_coeffs_ph(long iParam, int i, int j)
 {
-	std::vector<double> *alpha = NULL;
-	std::vector< std::vector<double> > *f = NULL, *dfdp = NULL, *dfdh = NULL, *d2fdhdp = NULL;
-	
-	switch(iParam)
-	{
-	case iS:
-		if (!bicubic_cells.cells[i][j].alpha_s_hp.empty())
-		{
-			// Make alpha point to the pre-calculated values
-			alpha = &bicubic_cells.cells[i][j].alpha_s_hp;
-			break;
-		}
-		else
-		{
-			f = &s; dfdh = &dsdh; dfdp = &dsdp; d2fdhdp = &d2sdhdp; break;
-		}
-	case iT:
-		if (!bicubic_cells.cells[i][j].alpha_T_hp.empty())
-		{
-			// Make alpha point to the pre-calculated values
-			alpha = &bicubic_cells.cells[i][j].alpha_T_hp;
-			break;
-		}
-		else
-		{
-			f = &T; dfdh = &dTdh; dfdp = &dTdp; d2fdhdp = &d2Tdhdp; break;
-		}
-	case iD:
-		if (!bicubic_cells.cells[i][j].alpha_rho_hp.empty())
-		{
-			// Make alpha point to the pre-calculated values
-			alpha = &bicubic_cells.cells[i][j].alpha_rho_hp;
-			break;
-		}
-		else
-		{
-			f = &rho; dfdh = &drhodh; dfdp = &drhodp; d2fdhdp = &d2rhodhdp; break;
-		}
-	default:
-		throw ValueError("iParam is invalid");
-	}
-
-	if (alpha == NULL)
-	{
-		double dhdx = (h[i+1]-h[i]);
-		double dpdy = (p[j+1]-p[j]);
-
-		z_bicubic[0] = (*f)[i][j];
-		z_bicubic[1] = (*f)[i+1][j];
-		z_bicubic[2] = (*f)[i][j+1];
-		z_bicubic[3] = (*f)[i+1][j+1];
-		
-		z_bicubic[4] = (*dfdh)[i][j]*dhdx;
-		z_bicubic[5] = (*dfdh)[i+1][j]*dhdx;
-		z_bicubic[6] = (*dfdh)[i][j+1]*dhdx;
-		z_bicubic[7] = (*dfdh)[i+1][j+1]*dhdx;
-		
-		z_bicubic[8] = (*dfdp)[i][j]*dpdy;
-		z_bicubic[9] = (*dfdp)[i+1][j]*dpdy;
-		z_bicubic[10] = (*dfdp)[i][j+1]*dpdy;
-		z_bicubic[11] = (*dfdp)[i+1][j+1]*dpdy;
-
-		z_bicubic[12] = (*d2fdhdp)[i][j]*dpdy*dhdx;
-		z_bicubic[13] = (*d2fdhdp)[i+1][j]*dpdy*dhdx;
-		z_bicubic[14] = (*d2fdhdp)[i][j+1]*dpdy*dhdx;
-		z_bicubic[15] = (*d2fdhdp)[i+1][j+1]*dpdy*dhdx;
-
-		// Find the alpha values by doing the matrix operation alpha = Ainv*z
-		matrix_vector_product(&z_bicubic, &alpha_bicubic);
-		// Set the pointer in this function
-		alpha = &alpha_bicubic;
-		
-		// Store this array of bicubic coefficients
-		switch (iParam)
-		{
-		case iS:	
-			bicubic_cells.cells[i][j].alpha_s_hp = alpha_bicubic; break;
-		case iT:
-			bicubic_cells.cells[i][j].alpha_T_hp = alpha_bicubic; break;
-		case iD:
-			bicubic_cells.cells[i][j].alpha_rho_hp = alpha_bicubic; break;
-		default:
-			throw ValueError("iParam is invalid");
-		}
-	}
-	return alpha;
+	return &ph_cells[((i*Np+j)*TTSE_PH_N+ph_property_index(iParam))*TTSE_CELL_BLOCK];
 }
 
-std::vector<double> * TTSESinglePhaseTableClass::bicubic_cell_coeffs_Trho(long iParam, int i, int j)
+const double * TTSESinglePhaseTableClass::bicubic_cell_coeffs_Trho(long iParam, int i, int j)
 {
-
-	std::vector<double> *alpha = NULL;
-	std::vector< std::vector<double> > *f = NULL, *dfdT = NULL, *dfdrho = NULL, *d2fdTdrho = NULL;
-
-	// Find the coefficients for the bicubic function
-	switch(iParam)
-	{
-	case iS:
-		if (!bicubic_cells.cells[i][j].alpha_s_Trho.empty())
-		{
-			// Make alpha point to the pre-calculated values
-			alpha = &bicubic_cells.cells[i][j].alpha_s_Trho;
-			break;
-		}
-		else
-		{
-			f = &s_Trho; dfdT = &dsdT_Trho; dfdrho = &dsdrho_Trho; d2fdTdrho = &d2sdTdrho_Trho; break;
-		}
-	case iH:
-		if (!bicubic_cells.cells[i][j].alpha_h_Trho.empty())
-		{
-			// Make alpha point to the pre-calculated values
-			alpha = &bicubic_cells.cells[i][j].alpha_h_Trho;
-			break;
-		}
-		else
-		{
-			f = &h_Trho; dfdT = &dhdT_Trho; dfdrho = &dhdrho_Trho; d2fdTdrho = &d2hdTdrho_Trho; break;
-		}
-	case iP:
-		if (!bicubic_cells.cells[i][j].alpha_p_Trho.empty())
-		{
-			// Make alpha point to the pre-calculated values
-			alpha = &bicubic_cells.cells[i][j].alpha_p_Trho;
-			break;
-		}
-		else
-		{
-			f = &p_Trho; dfdT = &dpdT_Trho; dfdrho = &dpdrho_Trho; d2fdTdrho = &d2pdTdrho_Trho; break;
-		}
-	case iV:
-		if (!bicubic_cells.cells[i][j].alpha_mu_Trho.empty())
-		{
-			// Make alpha point to the pre-calculated values
-			alpha = &bicubic_cells.cells[i][j].alpha_mu_Trho;
-			break;
-		}
-		else
-		{
-			f = &mu_Trho; dfdT = &dmudT_Trho; dfdrho = &dmudrho_Trho; d2fdTdrho = &d2mudTdrho_Trho; break;
-		}
-	case iL:
-		if (!bicubic_cells.cells[i][j].alpha_k_Trho.empty())
-		{
-			// Make alpha point to the pre-calculated values
-			alpha = &bicubic_cells.cells[i][j].alpha_k_Trho;
-			break;
-		}
-		else
-		{
-			f = &k_Trho; dfdT = &dkdT_Trho; dfdrho = &dkdrho_Trho; d2fdTdrho = &d2kdTdrho_Trho; break;
-		}
-	default:
-		throw ValueError(format("iParam [%d] is invalid",iParam).c_str());
-	}
-
-	if (alpha == NULL)
-	{
-		double dTdx = (T_Trho[i+1]-T_Trho[i]);
-		double drhody = (rho_Trho[j+1]-rho_Trho[j]);
-
-		z_bicubic[0] = (*f)[i][j];
-		z_bicubic[1] = (*f)[i+1][j];
-		z_bicubic[2] = (*f)[i][j+1];
-		z_bicubic[3] = (*f)[i+1][j+1];
-		
-		z_bicubic[4] = (*dfdT)[i][j]*dTdx;
-		z_bicubic[5] = (*dfdT)[i+1][j]*dTdx;
-		z_bicubic[6] = (*dfdT)[i][j+1]*dTdx;
-		z_bicubic[7] = (*dfdT)[i+1][j+1]*dTdx;
-		
-		z_bicubic[8] = (*dfdrho)[i][j]*drhody;
-		z_bicubic[9] = (*dfdrho)[i+1][j]*drhody;
-		z_bicubic[10] = (*dfdrho)[i][j+1]*drhody;
-		z_bicubic[11] = (*dfdrho)[i+1][j+1]*drhody;
-
-		z_bicubic[12] = (*d2fdTdrho)[i][j]*drhody*dTdx;
-		z_bicubic[13] = (*d2fdTdrho)[i+1][j]*drhody*dTdx;
-		z_bicubic[14] = (*d2fdTdrho)[i][j+1]*drhody*dTdx;
-		z_bicubic[15] = (*d2fdTdrho)[i+1][j+1]*drhody*dTdx;
-
-		// Find the alpha values by doing the matrix operation alpha = Ainv*z
-		matrix_vector_product(&z_bicubic, &alpha_bicubic);
-		// Set the pointer in this function
-		alpha = &alpha_bicubic;
-		
-		// Store this array of bicubic coefficients
-		switch (iParam)
-		{
-		case iS:	
-			bicubic_cells.cells[i][j].alpha_s_Trho = alpha_bicubic; break;
-		case iH:
-			bicubic_cells.cells[i][j].alpha_h_Trho = alpha_bicubic; break;
-		case iP:
-			bicubic_cells.cells[i][j].alpha_p_Trho = alpha_bicubic; break;
-		case iV:
-			bicubic_cells.cells[i][j].alpha_mu_Trho = alpha_bicubic; break;
-		case iL:
-			bicubic_cells.cells[i][j].alpha_k_Trho = alpha_bicubic; break;
-		default:
-			throw ValueError(format("iParam [%d] is invalid",iParam).c_str());
-		}
-	}
-
-	return alpha;
+	return &Trho_cells[((i*Nrho+j)*TTSE_TRHO_N+Trho_property_index(iParam))*TTSE_CELL_BLOCK];
 }
 
 /*!
@@ -1821,7 +1817,7 @@ A^{-1} =  \left[ \begin{array}{*{16}c} 1 & 0 & 0 & 0 & 0 & 0 & 0 & 0 & 0 & 0 & 0
 */
 double TTSESinglePhaseTableClass::interpolate_bicubic_ph(long iParam, double pval, double logp, double hval)
 {
-	std::vector<double> *alpha = NULL;
+	const double *alpha = NULL;
 	int i, j;
 
 	// Get the i,j coordinates of the cell
@@ -1839,17 +1835,17 @@ double TTSESinglePhaseTableClass::interpolate_bicubic_ph(long iParam, double pva
 	double y_0 = 1, y_1 = y, y_2 = y*y, y_3 = y*y*y;
 
 	double summer;
-	// Old version was "summer += (*alpha)[ii+jj*4]*x^i*y^j" for i in [0,3] and j in [0,3]
-	summer = (*alpha)[0+0*4]*x_0*y_0+(*alpha)[0+1*4]*x_0*y_1+(*alpha)[0+2*4]*x_0*y_2+(*alpha)[0+3*4]*x_0*y_3
-		    +(*alpha)[1+0*4]*x_1*y_0+(*alpha)[1+1*4]*x_1*y_1+(*alpha)[1+2*4]*x_1*y_2+(*alpha)[1+3*4]*x_1*y_3
-			+(*alpha)[2+0*4]*x_2*y_0+(*alpha)[2+1*4]*x_2*y_1+(*alpha)[2+2*4]*x_2*y_2+(*alpha)[2+3*4]*x_2*y_3
-			+(*alpha)[3+0*4]*x_3*y_0+(*alpha)[3+1*4]*x_3*y_1+(*alpha)[3+2*4]*x_3*y_2+(*alpha)[3+3*4]*x_3*y_3;
+	// Old version was "summer += alpha[ii+jj*4]*x^i*y^j" for i in [0,3] and j in [0,3]
+	summer = alpha[0+0*4]*x_0*y_0+alpha[0+1*4]*x_0*y_1+alpha[0+2*4]*x_0*y_2+alpha[0+3*4]*x_0*y_3
+		    +alpha[1+0*4]*x_1*y_0+alpha[1+1*4]*x_1*y_1+alpha[1+2*4]*x_1*y_2+alpha[1+3*4]*x_1*y_3
+			+alpha[2+0*4]*x_2*y_0+alpha[2+1*4]*x_2*y_1+alpha[2+2*4]*x_2*y_2+alpha[2+3*4]*x_2*y_3
+			+alpha[3+0*4]*x_3*y_0+alpha[3+1*4]*x_3*y_1+alpha[3+2*4]*x_3*y_2+alpha[3+3*4]*x_3*y_3;
 	
 	return summer;
 }
 double TTSESinglePhaseTableClass::bicubic_evaluate_first_derivative_ph(long iOF, long iWRT, long iCONSTANT, double p, double logp, double h)
 {
-	std::vector<double> *alpha = NULL;
+	const double *alpha = NULL;
 	int i, j;
 
 	// Get the i,j coordinates of the cell
@@ -1869,19 +1865,19 @@ double TTSESinglePhaseTableClass::bicubic_evaluate_first_derivative_ph(long iOF,
 	double summer;
 	if (iWRT == iH)
 	{
-		// Old version was "summer += (*alpha)[ii+jj*4]*i*x^(i-1)*y^j" for i in [0,3] and j in [0,3]
-		double dsummer_dx = +(*alpha)[1+0*4]*1*x_0*y_0+(*alpha)[1+1*4]*1*x_0*y_1+(*alpha)[1+2*4]*1*x_0*y_2+(*alpha)[1+3*4]*1*x_0*y_3
-				            +(*alpha)[2+0*4]*2*x_1*y_0+(*alpha)[2+1*4]*2*x_1*y_1+(*alpha)[2+2*4]*2*x_1*y_2+(*alpha)[2+3*4]*2*x_1*y_3
-				            +(*alpha)[3+0*4]*3*x_2*y_0+(*alpha)[3+1*4]*3*x_2*y_1+(*alpha)[3+2*4]*3*x_2*y_2+(*alpha)[3+3*4]*3*x_2*y_3;
+		// Old version was "summer += alpha[ii+jj*4]*i*x^(i-1)*y^j" for i in [0,3] and j in [0,3]
+		double dsummer_dx = +alpha[1+0*4]*1*x_0*y_0+alpha[1+1*4]*1*x_0*y_1+alpha[1+2*4]*1*x_0*y_2+alpha[1+3*4]*1*x_0*y_3
+				            +alpha[2+0*4]*2*x_1*y_0+alpha[2+1*4]*2*x_1*y_1+alpha[2+2*4]*2*x_1*y_2+alpha[2+3*4]*2*x_1*y_3
+				            +alpha[3+0*4]*3*x_2*y_0+alpha[3+1*4]*3*x_2*y_1+alpha[3+2*4]*3*x_2*y_2+alpha[3+3*4]*3*x_2*y_3;
 		return dsummer_dx/dhdx;
 	}
 	else if (iWRT == iP)
 	{
-		// Old version was "summer += (*alpha)[ii+jj*4]*j*x^i*y^(j-1)" for i in [0,3] and j in [0,3]
-		double dsummer_dy = (*alpha)[0+1*4]*1*x_0*y_0+(*alpha)[0+2*4]*2*x_0*y_1+(*alpha)[0+3*4]*3*x_0*y_2
-					       +(*alpha)[1+1*4]*1*x_1*y_0+(*alpha)[1+2*4]*2*x_1*y_1+(*alpha)[1+3*4]*3*x_1*y_2
-					       +(*alpha)[2+1*4]*1*x_2*y_0+(*alpha)[2+2*4]*2*x_2*y_1+(*alpha)[2+3*4]*3*x_2*y_2
-					       +(*alpha)[3+1*4]*1*x_3*y_0+(*alpha)[3+2*4]*2*x_3*y_1+(*alpha)[3+3*4]*3*x_3*y_2;
+		// Old version was "summer += alpha[ii+jj*4]*j*x^i*y^(j-1)" for i in [0,3] and j in [0,3]
+		double dsummer_dy = alpha[0+1*4]*1*x_0*y_0+alpha[0+2*4]*2*x_0*y_1+alpha[0+3*4]*3*x_0*y_2
+					       +alpha[1+1*4]*1*x_1*y_0+alpha[1+2*4]*2*x_1*y_1+alpha[1+3*4]*3*x_1*y_2
+					       +alpha[2+1*4]*1*x_2*y_0+alpha[2+2*4]*2*x_2*y_1+alpha[2+3*4]*3*x_2*y_2
+					       +alpha[3+1*4]*1*x_3*y_0+alpha[3+2*4]*2*x_3*y_1+alpha[3+3*4]*3*x_3*y_2;
 		return dsummer_dy/dpdy;
 	}
 	else
@@ -1895,7 +1891,7 @@ double TTSESinglePhaseTableClass::bicubic_evaluate_first_derivative_ph(long iOF,
 double TTSESinglePhaseTableClass::interpolate_bicubic_Trho(long iParam, double Tval, double rhoval, double logrho)
 {
 	// A pointer to the values of the coefficients for the bicubic interpolation
-	std::vector<double> *alpha = NULL;
+	const double *alpha = NULL;
 	int i,j;
 	std::vector< std::vector<double> > *f = NULL, *dfdT = NULL, *dfdrho = NULL, *d2fdTdrho = NULL;
 	
@@ -1913,11 +1909,11 @@ double TTSESinglePhaseTableClass::interpolate_bicubic_Trho(long iParam, double T
 	double y_0 = 1, y_1 = y, y_2 = y*y, y_3 = y*y*y;
 
 	double summer;
-	// Old version was "summer += (*alpha)[ii+jj*4]*x^i*y^j" for i in [0,3] and j in [0,3]
-	summer = (*alpha)[0+0*4]*x_0*y_0+(*alpha)[0+1*4]*x_0*y_1+(*alpha)[0+2*4]*x_0*y_2+(*alpha)[0+3*4]*x_0*y_3
-		    +(*alpha)[1+0*4]*x_1*y_0+(*alpha)[1+1*4]*x_1*y_1+(*alpha)[1+2*4]*x_1*y_2+(*alpha)[1+3*4]*x_1*y_3
-			+(*alpha)[2+0*4]*x_2*y_0+(*alpha)[2+1*4]*x_2*y_1+(*alpha)[2+2*4]*x_2*y_2+(*alpha)[2+3*4]*x_2*y_3
-			+(*alpha)[3+0*4]*x_3*y_0+(*alpha)[3+1*4]*x_3*y_1+(*alpha)[3+2*4]*x_3*y_2+(*alpha)[3+3*4]*x_3*y_3;
+	// Old version was "summer += alpha[ii+jj*4]*x^i*y^j" for i in [0,3] and j in [0,3]
+	summer = alpha[0+0*4]*x_0*y_0+alpha[0+1*4]*x_0*y_1+alpha[0+2*4]*x_0*y_2+alpha[0+3*4]*x_0*y_3
+		    +alpha[1+0*4]*x_1*y_0+alpha[1+1*4]*x_1*y_1+alpha[1+2*4]*x_1*y_2+alpha[1+3*4]*x_1*y_3
+			+alpha[2+0*4]*x_2*y_0+alpha[2+1*4]*x_2*y_1+alpha[2+2*4]*x_2*y_2+alpha[2+3*4]*x_2*y_3
+			+alpha[3+0*4]*x_3*y_0+alpha[3+1*4]*x_3*y_1+alpha[3+2*4]*x_3*y_2+alpha[3+3*4]*x_3*y_3;
 	
 	return summer;
 }
@@ -1932,18 +1928,8 @@ double TTSESinglePhaseTableClass::bicubic_evaluate_one_other_input(long iInput1,
 	// My goal here is to find deltah
 	int L,R,M,i,j,phase;
 	double p,TL, TV, DL, DV, SL, SV, HL, HV, Q, ValV, ValL;
-	std::vector<std::vector<double> > *mat;
-	
-	// Connect a pointer to the array of interest
-	switch (iOther)
-	{
-	case iT:
-		mat = &T; break;
-	case iS:
-		mat = &s; break;
-	case iD:
-		mat = &rho; break;
-	}
+	// The index of the property of interest in the packed tables
+	int kmat = ph_property_index(iOther);
 
 	// One is pressure, we are getting enthalpy
 	if (iInput1 == iP)
@@ -1960,7 +1946,7 @@ double TTSESinglePhaseTableClass::bicubic_evaluate_one_other_input(long iInput1,
 			// there can't be any saturation curve
 			L = 0; R = Nh-1; M = (L+R)/2;
 			while (R-L>1){
-				if (isbetween((*mat)[M][j],(*mat)[R][j],Other)){
+				if (isbetween(ph_value(M,j,kmat),ph_value(R,j,kmat),Other)){
 					L=M; M=(L+R)/2; continue;
 				}
 				else{
@@ -1992,20 +1978,20 @@ double TTSESinglePhaseTableClass::bicubic_evaluate_one_other_input(long iInput1,
 			{
 				L = IV[j]+1; R = Nh - 1; M = (L+R)/2;
 				// Check if caught between saturation curve and first point
-				if (isbetween((*mat)[L][j],ValV,Other))
+				if (isbetween(ph_value(L,j,kmat),ValV,Other))
 				{
-					// If caught, use gas value
-					L = R;
+					// If caught, use the first gas value
+					R = L;
 				}
 			}
 			else if (phase == iPHASE_LIQUID)
 			{
 				L = 0; R = IL[j]-1; M = (L+R)/2;
 				// Check if caught between saturation curve and first point
-				if (isbetween((*mat)[R][j],ValL,Other))
+				if (isbetween(ph_value(R,j,kmat),ValL,Other))
 				{
-					// If caught, use liquid value
-					R = L;
+					// If caught, use the last liquid value
+					L = R;
 				}
 			}
 			else if (phase == iPHASE_TWOPHASE)
@@ -2022,7 +2008,7 @@ double TTSESinglePhaseTableClass::bicubic_evaluate_one_other_input(long iInput1,
 			// Interval bisection
 			while (R-L>1)
 			{
-				if (isbetween((*mat)[M][j],(*mat)[R][j],Other))
+				if (isbetween(ph_value(M,j,kmat),ph_value(R,j,kmat),Other))
 				{ 
 					L=M; M=(L+R)/2; continue;
 				}
@@ -2037,13 +2023,13 @@ double TTSESinglePhaseTableClass::bicubic_evaluate_one_other_input(long iInput1,
 		nearest_good_neighbor_ph_interpolate(&i, &j);
 		
 		// Invert the bicubic to find h
-		// Old version was "summer += (*alpha)[ii+jj*4]*x^i*y^j" for i in [0,3] and j in [0,3]
+		// Old version was "summer += alpha[ii+jj*4]*x^i*y^j" for i in [0,3] and j in [0,3]
 		/* 
 		Summation function is 
-		summer = (*alpha)[0+0*4]*x_0*y_0+(*alpha)[0+1*4]*x_0*y_1+(*alpha)[0+2*4]*x_0*y_2+(*alpha)[0+3*4]*x_0*y_3
-		  		+(*alpha)[1+0*4]*x_1*y_0+(*alpha)[1+1*4]*x_1*y_1+(*alpha)[1+2*4]*x_1*y_2+(*alpha)[1+3*4]*x_1*y_3
-				+(*alpha)[2+0*4]*x_2*y_0+(*alpha)[2+1*4]*x_2*y_1+(*alpha)[2+2*4]*x_2*y_2+(*alpha)[2+3*4]*x_2*y_3
-				+(*alpha)[3+0*4]*x_3*y_0+(*alpha)[3+1*4]*x_3*y_1+(*alpha)[3+2*4]*x_3*y_2+(*alpha)[3+3*4]*x_3*y_3;
+		summer = alpha[0+0*4]*x_0*y_0+alpha[0+1*4]*x_0*y_1+alpha[0+2*4]*x_0*y_2+alpha[0+3*4]*x_0*y_3
+		  		+alpha[1+0*4]*x_1*y_0+alpha[1+1*4]*x_1*y_1+alpha[1+2*4]*x_1*y_2+alpha[1+3*4]*x_1*y_3
+				+alpha[2+0*4]*x_2*y_0+alpha[2+1*4]*x_2*y_1+alpha[2+2*4]*x_2*y_2+alpha[2+3*4]*x_2*y_3
+				+alpha[3+0*4]*x_3*y_0+alpha[3+1*4]*x_3*y_1+alpha[3+2*4]*x_3*y_2+alpha[3+3*4]*x_3*y_3;
 
 		but in this case we know y, which is simply
 
@@ -2062,15 +2048,15 @@ double TTSESinglePhaseTableClass::bicubic_evaluate_one_other_input(long iInput1,
 		double y_0 = 1, y_1 = y, y_2 = y*y, y_3 = y*y*y;
 
 		// Find the coefficients for the cubic
-		std::vector<double> *alpha = NULL;
+		const double *alpha = NULL;
 		
 		// Get bicubic coefficients
 		alpha = this->bicubic_cell_coeffs_ph(iOther, i, j);
 
-		double a = (*alpha)[3+0*4]*y_0+(*alpha)[3+1*4]*y_1+(*alpha)[3+2*4]*y_2+(*alpha)[3+3*4]*y_3; // factors of x^3
-		double b = (*alpha)[2+0*4]*y_0+(*alpha)[2+1*4]*y_1+(*alpha)[2+2*4]*y_2+(*alpha)[2+3*4]*y_3; // factors of x^2
-		double c = (*alpha)[1+0*4]*y_0+(*alpha)[1+1*4]*y_1+(*alpha)[1+2*4]*y_2+(*alpha)[1+3*4]*y_3; // factors of x
-		double d = (*alpha)[0+0*4]*y_0+(*alpha)[0+1*4]*y_1+(*alpha)[0+2*4]*y_2+(*alpha)[0+3*4]*y_3 - Other; // constant factors
+		double a = alpha[3+0*4]*y_0+alpha[3+1*4]*y_1+alpha[3+2*4]*y_2+alpha[3+3*4]*y_3; // factors of x^3
+		double b = alpha[2+0*4]*y_0+alpha[2+1*4]*y_1+alpha[2+2*4]*y_2+alpha[2+3*4]*y_3; // factors of x^2
+		double c = alpha[1+0*4]*y_0+alpha[1+1*4]*y_1+alpha[1+2*4]*y_2+alpha[1+3*4]*y_3; // factors of x
+		double d = alpha[0+0*4]*y_0+alpha[0+1*4]*y_1+alpha[0+2*4]*y_2+alpha[0+3*4]*y_3 - Other; // constant factors
 		double x0,x1,x2;
 		solve_cubic(a,b,c,d,&x0,&x1,&x2);
 		
@@ -2130,9 +2116,9 @@ bool TTSESinglePhaseTableClass::within_range_one_other_input(long iInput1, doubl
 	{
 		double right, left;
 		if (iOther == iT) 
-			{ right = this->T[Nh-1][j]; left = this->T[0][j]; }
+			{ right = ph_value(Nh-1,j,TTSE_PH_T); left = ph_value(0,j,TTSE_PH_T); }
 		else 
-			{ right = this->s[Nh-1][j]; left = this->s[0][j]; }
+			{ right = ph_value(Nh-1,j,TTSE_PH_S); left = ph_value(0,j,TTSE_PH_S); }
 
 		if (ValidNumber(right) && ValidNumber(left))
 		{
@@ -2148,7 +2134,7 @@ bool TTSESinglePhaseTableClass::within_range_one_other_input(long iInput1, doubl
 	}
 	else if (iOther == iD)
 	{
-		double right = this->rho[Nh-1][j], left = this->rho[0][j];
+		double right = ph_value(Nh-1,j,TTSE_PH_RHO), left = ph_value(0,j,TTSE_PH_RHO);
 
 		if (ValidNumber(right) && ValidNumber(left))
 		{
@@ -2165,8 +2151,53 @@ bool TTSESinglePhaseTableClass::within_range_one_other_input(long iInput1, doubl
 
 	return true;
 }
+double TTSESinglePhaseTableClass::evaluate_one_other_input_u(double p, double u)
+{
+	double logp = log(p), hL = hmin, hR = hmax, h;
+	if (p < pFluid->reduce.p.Pa && p > pFluid->params.ptriple)
+	{
+		// Stay on the side of the saturation curve where the state is, since the tables are not defined in 
+		// the two-phase region
+		double hsatL = SatL->evaluate(iH,p), hsatV = SatV->evaluate(iH,p);
+		double usatL = hsatL-p/SatL->evaluate(iD,p), usatV = hsatV-p/SatV->evaluate(iD,p);
+		if (u < usatL)
+		{
+			hR = hsatL;
+			h = hsatL-(usatL-u);
+		}
+		else if (u > usatV)
+		{
+			hL = hsatV;
+			h = hsatV+(u-usatV);
+		}
+		else
+		{
+			throw ValueError(format("It's two phase input"));
+		}
+	}
+	else
+	{
+		h = u+p/pFluid->reduce.rho;
+	}
+	for (int iter = 0; iter < 50; iter++)
+	{
+		h = std::min(std::max(h, hL), hR);
+		double rho = evaluate(iD,p,logp,h);
+		// d(h-p/rho)/dh at constant p
+		double dudh = 1+p/(rho*rho)*evaluate_first_derivative(iD,iH,iP,p,logp,h);
+		double dh = -(h-p/rho-u)/dudh;
+		h += dh;
+		if (fabs(dh) < 1e-10*fabs(h)+1e-9){ return h; }
+	}
+	throw SolutionError(format("Unable to find the enthalpy for p = %g, u = %g in the TTSE tables",p,u));
+}
+
 double TTSESinglePhaseTableClass::evaluate_one_other_input(long iInput1, double Input1, long iOther, double Other)
 {
+	// The internal energy is not in the tables
+	if (iInput1 == iP && iOther == iU){
+		return evaluate_one_other_input_u(Input1,Other);
+	}
 	// Use Bicubic interpolation if requested
 	if (mode == TTSE_MODE_BICUBIC){ 
 		return bicubic_evaluate_one_other_input(iInput1,Input1,iOther,Other);
@@ -2174,18 +2205,8 @@ double TTSESinglePhaseTableClass::evaluate_one_other_input(long iInput1, double
 	// My goal here is to find deltah
 	int L,R,M,i;
 	double p,dh1,dh2,a,b,c;
-	std::vector<std::vector<double> > *mat;
-	
-	// Connect a pointer to the array of interest
-	switch (iOther)
-	{
-	case iT:
-		mat = &T; break;
-	case iS:
-		mat = &s; break;
-	case iD:
-		mat = &rho; break;
-	}
+	// The index of the property of interest in the packed tables
+	int kmat = ph_property_index(iOther);
 
 	// One is pressure, we are getting enthalpy
 	// within_TTSE_range() guarantees that the pressure is within range
@@ -2202,9 +2223,9 @@ double TTSESinglePhaseTableClass::evaluate_one_other_input(long iInput1, double
 		{
 			// Very close to the boundary of the LUT, not 1-1 relationship between p-h and other
 			// sets of inputs, need to allow for a bit of raggedness here
-			if (   (iOther == iT && Other < 1.1*this->T[Np-1][j] && Other > this->T[Np-1][j])
-			    || (iOther == iS && Other < this->s[Np-1][j]+0.1 && Other > this->s[Np-1][j])
-			    || (iOther == iD && Other > 0.85*this->rho[Np-1][j] && Other < this->rho[Np-1][j])
+			if (   (iOther == iT && Other < 1.1*ph_value(Np-1,j,TTSE_PH_T) && Other > ph_value(Np-1,j,TTSE_PH_T))
+			    || (iOther == iS && Other < ph_value(Np-1,j,TTSE_PH_S)+0.1 && Other > ph_value(Np-1,j,TTSE_PH_S))
+			    || (iOther == iD && Other > 0.85*ph_value(Np-1,j,TTSE_PH_RHO) && Other < ph_value(Np-1,j,TTSE_PH_RHO))
 			    )
 			{
 				i = Np-1;
@@ -2215,7 +2236,7 @@ double TTSESinglePhaseTableClass::evaluate_one_other_input(long iInput1, double
 				// there can't be any saturation curve
 				L = 0; R = Nh-1; M = (L+R)/2;
 				while (R-L>1){
-					if (isbetween((*mat)[M][j],(*mat)[R][j],Other)){ 
+					if (isbetween(ph_value(M,j,kmat),ph_value(R,j,kmat),Other)){ 
 						L=M; M=(L+R)/2; continue;
 					}
 					else{ 
@@ -2223,7 +2244,7 @@ double TTSESinglePhaseTableClass::evaluate_one_other_input(long iInput1, double
 					}
 				}
 				// Find which one of the bounds is closer
-				if (fabs((*mat)[L][j]-Other)<fabs((*mat)[R][j]-Other)){
+				if (fabs(ph_value(L,j,kmat)-Other)<fabs(ph_value(R,j,kmat)-Other)){
 					i = L;
 				}
 				else{
@@ -2242,18 +2263,18 @@ double TTSESinglePhaseTableClass::evaluate_one_other_input(long iInput1, double
 				//
 				// If it is within between the saturation curve and the first point in the SH region,
 				// just use the first point in the superheated region
-				if (   (iOther == iT && Other < this->T[IV[j]+1][j])
-				    || (iOther == iS && Other < this->s[IV[j]+1][j])
-					|| (iOther == iD && Other > this->rho[IV[j]+1][j])
+				if (   (iOther == iT && Other < ph_value(IV[j]+1,j,TTSE_PH_T))
+				    || (iOther == iS && Other < ph_value(IV[j]+1,j,TTSE_PH_S))
+					|| (iOther == iD && Other > ph_value(IV[j]+1,j,TTSE_PH_RHO))
 					)
 				{
 					i = IV[j]+1;
 				}
 				// Very close to the boundary of the LUT, not 1-1 relationship between p-h and other
 				// sets of inputs, need to allow for a bit of raggedness here
-				else if (   (iOther == iT && Other < 1.1*this->T[Np-1][j] && Other > this->T[Np-1][j])
-				         || (iOther == iS && Other < this->s[Np-1][j]+0.1 && Other > this->s[Np-1][j])
-					     || (iOther == iD && Other > 0.85*this->rho[Np-1][j] && Other < this->rho[Np-1][j])
+				else if (   (iOther == iT && Other < 1.1*ph_value(Np-1,j,TTSE_PH_T) && Other > ph_value(Np-1,j,TTSE_PH_T))
+				         || (iOther == iS && Other < ph_value(Np-1,j,TTSE_PH_S)+0.1 && Other > ph_value(Np-1,j,TTSE_PH_S))
+					     || (iOther == iD && Other > 0.85*ph_value(Np-1,j,TTSE_PH_RHO) && Other < ph_value(Np-1,j,TTSE_PH_RHO))
 					     )
 				{
 					i = Np-1;
@@ -2265,23 +2286,23 @@ double TTSESinglePhaseTableClass::evaluate_one_other_input(long iInput1, double
 					switch (iOther)
 					{
 					case iT:
-						if (Other > this->T[Nh-1][j]) 
-							throw ValueError(format("Input T [%g] is greater than max T [%g] at LUT pressure [%g]",Other,this->T[Np-1][j],this->p[j]));
+						if (Other > ph_value(Nh-1,j,TTSE_PH_T)) 
+							throw ValueError(format("Input T [%g] is greater than max T [%g] at LUT pressure [%g]",Other,ph_value(Np-1,j,TTSE_PH_T),this->p[j]));
 						break;
 					case iD:
-						if (Other < this->rho[Nh-1][j])
-							throw ValueError(format("Input rho [%g] is less than minimum rho [%g] at LUT pressure [%g]",Other,this->rho[Np-1][j],this->p[j]));
+						if (Other < ph_value(Nh-1,j,TTSE_PH_RHO))
+							throw ValueError(format("Input rho [%g] is less than minimum rho [%g] at LUT pressure [%g]",Other,ph_value(Np-1,j,TTSE_PH_RHO),this->p[j]));
 						break;
 					case iS:
-						if (Other > this->s[Nh-1][j]) 
-							throw ValueError(format("Input s [%g] is greater than max s [%g] at LUT pressure [%g]",Other,this->s[Np-1][j],this->p[j]));
+						if (Other > ph_value(Nh-1,j,TTSE_PH_S)) 
+							throw ValueError(format("Input s [%g] is greater than max s [%g] at LUT pressure [%g]",Other,ph_value(Np-1,j,TTSE_PH_S),this->p[j]));
 						break;
 					}
 					
 					L = IV[j]+1; R = Np-1; M = (L+R)/2;
 					while (R-L>1)
 					{
-						if (isbetween((*mat)[M][j],(*mat)[R][j],Other))
+						if (isbetween(ph_value(M,j,kmat),ph_value(R,j,kmat),Other))
 						{ 
 							L=M; M=(L+R)/2; continue;
 						}
@@ -2291,7 +2312,7 @@ double TTSESinglePhaseTableClass::evaluate_one_other_input(long iInput1, double
 						}
 					}
 					// Find which one of the bounds is closer
-					if (fabs((*mat)[L][j]-Other)<fabs((*mat)[R][j]-Other))
+					if (fabs(ph_value(L,j,kmat)-Other)<fabs(ph_value(R,j,kmat)-Other))
 						i = L;
 					else
 						i = R;
@@ -2301,10 +2322,10 @@ double TTSESinglePhaseTableClass::evaluate_one_other_input(long iInput1, double
 			{
 				// We are at low pressure, so we don't know how to calculate, going to just use the i==1 element
 				// if it is valid, or the i = 0 if not, otherwise, there are no values left and we have to fail
-				if (ValidNumber(this->T[1][j])){
+				if (ValidNumber(ph_value(1,j,TTSE_PH_T))){
 					i = 1;
 				}
-				else if (ValidNumber(this->T[0][j])){
+				else if (ValidNumber(ph_value(0,j,TTSE_PH_T))){
 					i = 0;
 				}
 				else{
@@ -2321,9 +2342,9 @@ double TTSESinglePhaseTableClass::evaluate_one_other_input(long iInput1, double
 				//
 				// If it is within one spacing of the outlet variable of the saturation curve, 
 				// just use the first point in the subcooled region
-				if (   (iOther == iT && Other > this->T[IL[j]-1][j])
-				    || (iOther == iS && Other > this->s[IL[j]-1][j])
-					|| (iOther == iD && Other < this->rho[IL[j]-1][j])
+				if (   (iOther == iT && Other > ph_value(IL[j]-1,j,TTSE_PH_T))
+				    || (iOther == iS && Other > ph_value(IL[j]-1,j,TTSE_PH_S))
+					|| (iOther == iD && Other < ph_value(IL[j]-1,j,TTSE_PH_RHO))
 					)
 				{
 					i = IL[j]-1;
@@ -2333,16 +2354,16 @@ double TTSESinglePhaseTableClass::evaluate_one_other_input(long iInput1, double
 					switch (iOther)
 					{
 					case iT:
-						if (Other < this->T[0][j]) 
-							throw ValueError(format("Input T [%g] is less than min T [%g] at LUT pressure [%g]",Other,this->T[0][j],this->p[j]));
+						if (Other < ph_value(0,j,TTSE_PH_T)) 
+							throw ValueError(format("Input T [%g] is less than min T [%g] at LUT pressure [%g]",Other,ph_value(0,j,TTSE_PH_T),this->p[j]));
 						break;
 					case iD:
-						if (Other > this->rho[0][j]) 
-							throw ValueError(format("Input rho [%g] is greater than max rho [%g] at LUT pressure [%g]",Other,this->rho[0][j],this->p[j]));
+						if (Other > ph_value(0,j,TTSE_PH_RHO)) 
+							throw ValueError(format("Input rho [%g] is greater than max rho [%g] at LUT pressure [%g]",Other,ph_value(0,j,TTSE_PH_RHO),this->p[j]));
 						break;
 					case iS:
-						if (Other < this->s[0][j])
-							throw ValueError(format("Input s [%g] is less than min s [%g] at LUT pressure [%g]",Other,this->s[0][j],this->p[j]));
+						if (Other < ph_value(0,j,TTSE_PH_S))
+							throw ValueError(format("Input s [%g] is less than min s [%g] at LUT pressure [%g]",Other,ph_value(0,j,TTSE_PH_S),this->p[j]));
 						break;
 					}
 					
@@ -2350,7 +2371,7 @@ double TTSESinglePhaseTableClass::evaluate_one_other_input(long iInput1, double
 					// Its subcooled
 					while (R-L>1)
 					{
-						if (isbetween((*mat)[M][j],(*mat)[R][j],Other))
+						if (isbetween(ph_value(M,j,kmat),ph_value(R,j,kmat),Other))
 						{ 
 							L=M; M=(L+R)/2; continue;
 						}
@@ -2360,7 +2381,7 @@ double TTSESinglePhaseTableClass::evaluate_one_other_input(long iInput1, double
 						}
 					}
 					// Find which one of the bounds is closer
-					if (fabs((*mat)[L][j]-Other)<fabs((*mat)[R][j]-Other))
+					if (fabs(ph_value(L,j,kmat)-Other)<fabs(ph_value(R,j,kmat)-Other))
 						i = L;
 					else
 						i = R;
@@ -2374,27 +2395,13 @@ double TTSESinglePhaseTableClass::evaluate_one_other_input(long iInput1, double
 		}
 
 		// Now we calculate deltah
-		switch (iOther)
-		{
 		// Quadratic in deltah
 		// 0 = 0.5*deltah*deltah*d2Tdh2[i][j]+deltah*dTdh[i][j]+deltap*deltah*d2Tdhdp[i][j]+T[i][j]-T+deltap*dTdp[i][j]+0.5*deltap*deltap*d2Tdp2[i][j];
 		// 0 = a*deltah^2+b*deltah+c
-		case iT:
-			a = 0.5*d2Tdh2[i][j];
-			b = dTdh[i][j]+deltap*d2Tdhdp[i][j];
-			c = T[i][j]-Other+deltap*dTdp[i][j]+0.5*deltap*deltap*d2Tdp2[i][j];
-			break;
-		case iS:
-			a = 0.5*d2sdh2[i][j];
-			b = dsdh[i][j]+deltap*d2sdhdp[i][j];
-			c = s[i][j]-Other+deltap*dsdp[i][j]+0.5*deltap*deltap*d2sdp2[i][j];
-			break;
-		case iD:
-			a = 0.5*d2rhodh2[i][j];
-			b = drhodh[i][j]+deltap*d2rhodhdp[i][j];
-			c = rho[i][j]-Other+deltap*drhodp[i][j]+0.5*deltap*deltap*d2rhodp2[i][j];
-			break;
-		}
+		const double *f = node_ph(i,j,ph_property_index(iOther));
+		a = 0.5*f[TTSE_NODE_D2FDX2];
+		b = f[TTSE_NODE_DFDX]+deltap*f[TTSE_NODE_D2FDXDY];
+		c = f[TTSE_NODE_F]-Other+deltap*f[TTSE_NODE_DFDY]+0.5*deltap*deltap*f[TTSE_NODE_D2FDY2];
 		// Solutions from quadratic equation
 		dh1 = (-b+sqrt(b*b-4*a*c))/(2*a);
 		dh2 = (-b-sqrt(b*b-4*a*c))/(2*a);
@@ -2443,29 +2450,80 @@ double TTSESinglePhaseTableClass::evaluate_Trho(long iOutput, double T, double r
 	// If the value at i,j is too close to the saturation boundary, the nearest point i,j 
 	// might be in the two-phase region which is not defined for single-phase table.  
 	// Therefore, search around its neighbors for a better choice
-	if (!ValidNumber(mu_Trho[i][j])){
+	if (!ValidNumber(node_Trho(i,j,TTSE_TRHO_MU)[TTSE_NODE_F])){
 		nearest_good_neighbor_Trho(&i,&j);
 	}
 
 	// Distances from the node
 	double deltaT = T - this->T_Trho[i];
 	double deltarho = rho - this->rho_Trho[j];
-	
-	switch (iOutput)
-	{
-	case iS:
-		return s_Trho[i][j]+deltaT*dsdT_Trho[i][j]+deltarho*dsdrho_Trho[i][j]+0.5*deltaT*deltaT*d2sdT2_Trho[i][j]+0.5*deltarho*deltarho*d2sdrho2_Trho[i][j]+deltaT*deltarho*d2sdTdrho_Trho[i][j]; break;
-	case iP:
-		return p_Trho[i][j]+deltaT*dpdT_Trho[i][j]+deltarho*dpdrho_Trho[i][j]+0.5*deltaT*deltaT*d2pdT2_Trho[i][j]+0.5*deltarho*deltarho*d2pdrho2_Trho[i][j]+deltaT*deltarho*d2pdTdrho_Trho[i][j]; break;
-	case iH:
-		return h_Trho[i][j]+deltaT*dhdT_Trho[i][j]+deltarho*dhdrho_Trho[i][j]+0.5*deltaT*deltaT*d2hdT2_Trho[i][j]+0.5*deltarho*deltarho*d2hdrho2_Trho[i][j]+deltaT*deltarho*d2hdTdrho_Trho[i][j]; break;
-	case iV:
-		return mu_Trho[i][j]+deltaT*dmudT_Trho[i][j]+deltarho*dmudrho_Trho[i][j]+0.5*deltaT*deltaT*d2mudT2_Trho[i][j]+0.5*deltarho*deltarho*d2mudrho2_Trho[i][j]+deltaT*deltarho*d2mudTdrho_Trho[i][j]; break;
-	case iL:
-		return k_Trho[i][j]+deltaT*dkdT_Trho[i][j]+deltarho*dkdrho_Trho[i][j]+0.5*deltaT*deltaT*d2kdT2_Trho[i][j]+0.5*deltarho*deltarho*d2kdrho2_Trho[i][j]+deltaT*deltarho*d2kdTdrho_Trho[i][j]; break;
-	default:
-		throw ValueError(format("Output key value [%d] to evaluate is invalid",iOutput));
+
+	// The value and all its derivatives are in one cache line
+	const double *f = node_Trho(i,j,Trho_property_index(iOutput));
+	return f[TTSE_NODE_F]+deltaT*f[TTSE_NODE_DFDX]+deltarho*f[TTSE_NODE_DFDY]+0.5*deltaT*deltaT*f[TTSE_NODE_D2FDX2]+0.5*deltarho*deltarho*f[TTSE_NODE_D2FDY2]+deltaT*deltarho*f[TTSE_NODE_D2FDXDY];
+}
+
+double TTSESinglePhaseTableClass::evaluate_Trho_one_other_input(long iOther, double rho, double logrho, double Other)
+{
+	if (iOther != iH && iOther != iU){ throw ValueError(format("iOther [%d] must be iH or iU",iOther)); }
+	int j = (int)round((logrho-logrhomin)/logrhoratio);
+	if (j < 0 || j > (int)Nrho-1){ return _HUGE; }
+
+	// The energy increases with the temperature along the column, so bisection for the first node that is not
+	// below Other, where the nodes in the two-phase region (at the low temperatures) count as below
+	int lo = 0, hi = (int)NT-1;
+	double e_hi = Trho_node_energy(iOther,hi,j), e_lo = Trho_node_energy(iOther,lo,j);
+	if (!ValidNumber(e_hi) || e_hi < Other){ return _HUGE; }
+	if (ValidNumber(e_lo) && e_lo > Other){ return _HUGE; }
+	while (hi-lo > 1)
+	{
+		int mid = (lo+hi)/2;
+		double e_mid = Trho_node_energy(iOther,mid,j);
+		if (ValidNumber(e_mid) && e_mid >= Other){ hi = mid; } else { lo = mid; }
+	}
+	// Below the lowest single-phase node
+	if (!ValidNumber(Trho_node_energy(iOther,lo,j))){ return _HUGE; }
+
+	// Regula falsi (Illinois) between the two nodes on the interpolated energy at rho, which is not exactly bracketed
+	// by the values at the nodes since rho is between two columns, so the bracket is widened if needed
+	double Ta = T_Trho[lo], Tb = T_Trho[hi];
+	double fa = energy_Trho(iOther,Ta,rho,logrho)-Other, fb = energy_Trho(iOther,Tb,rho,logrho)-Other;
+	for (int k = 0; k < 3 && fa > 0 && lo > 0; k++){ Ta = T_Trho[--lo]; fa = energy_Trho(iOther,Ta,rho,logrho)-Other; }
+	for (int k = 0; k < 3 && fb < 0 && hi < (int)NT-1; k++){ Tb = T_Trho[++hi]; fb = energy_Trho(iOther,Tb,rho,logrho)-Other; }
+	if (fa*fb > 0){ return _HUGE; }
+	int side = 0;
+	for (int iter = 0; iter < 50; iter++)
+	{
+		double T = (Ta*fb-Tb*fa)/(fb-fa);
+		double f = energy_Trho(iOther,T,rho,logrho)-Other;
+		if (f == 0 || fabs(Tb-Ta) < 1e-12*T){ return T; }
+		if (f*fb > 0)
+		{
+			Tb = T; fb = f;
+			if (side == -1){ fa /= 2; }
+			side = -1;
+		}
+		else
+		{
+			Ta = T; fa = f;
+			if (side == +1){ fb /= 2; }
+			side = +1;
+		}
+		if (fabs(f) < 1e-12*fabs(Other)){ return T; }
 	}
+	return (Ta*fb-Tb*fa)/(fb-fa);
+}
+
+double TTSESinglePhaseTableClass::Trho_node_energy(long iOther, int i, int j)
+{
+	double h = Trho_value(i,j,TTSE_TRHO_H);
+	return (iOther == iH) ? h : h-Trho_value(i,j,TTSE_TRHO_P)/rho_Trho[j];
+}
+
+double TTSESinglePhaseTableClass::energy_Trho(long iOther, double T, double rho, double logrho)
+{
+	double h = evaluate_Trho(iH,T,rho,logrho);
+	return (iOther == iH) ? h : h-evaluate_Trho(iP,T,rho,logrho)/rho;
 }
 
 double TTSESinglePhaseTableClass::evaluate_first_derivative(long iOF, long iWRT, long iCONSTANT, double p, double logp, double h)
@@ -2486,7 +2544,7 @@ double TTSESinglePhaseTableClass::evaluate_first_derivative(long iOF, long iWRT,
 	// If the value at i,j is too close to the saturation boundary, the nearest point i,j 
 	// might be in the two-phase region which is not defined for single-phase table.  
 	// Therefore, search around its neighbors for a better choice
-	if (!ValidNumber(T[i][j]))
+	if (!ValidNumber(ph_value(i,j,TTSE_PH_T)))
 	{
 		nearest_good_neighbor(&i,&j);
 	}
@@ -2494,6 +2552,9 @@ double TTSESinglePhaseTableClass::evaluate_first_derivative(long iOF, long iWRT,
 	// Distances from the node
 	double deltah = h-this->h[i];
 	double deltap = p-this->p[j];
+
+	// The blocks of the properties at the node
+	const double *fT = node_ph(i,j,TTSE_PH_T), *fs = node_ph(i,j,TTSE_PH_S), *frho = node_ph(i,j,TTSE_PH_RHO);
 	
 	// This is a first-order expansion of the derivative around the node point.
 	//
@@ -2501,34 +2562,34 @@ double TTSESinglePhaseTableClass::evaluate_first_derivative(long iOF, long iWRT,
 	if (iOF == iT && iWRT == iH && iCONSTANT == iP)
 	{
 		// Derivative of T w.r.t. h for p constant (for cp, the constant-pressure specific heat)
-		return dTdh[i][j]+deltah*d2Tdh2[i][j]+deltap*d2Tdhdp[i][j];
+		return fT[TTSE_NODE_DFDX]+deltah*fT[TTSE_NODE_D2FDX2]+deltap*fT[TTSE_NODE_D2FDXDY];
 	}
 	else if (iOF == iS && iWRT == iH && iCONSTANT == iP)
 	{
 		// Derivative of s w.r.t. h for p constant
-		return dsdh[i][j]+deltah*d2sdh2[i][j]+deltap*d2sdhdp[i][j];
+		return fs[TTSE_NODE_DFDX]+deltah*fs[TTSE_NODE_D2FDX2]+deltap*fs[TTSE_NODE_D2FDXDY];
 	}
 	else if (iOF == iD && iWRT == iH && iCONSTANT == iP)
 	{
 		// Derivative of density w.r.t. h for p constant
-		return drhodh[i][j]+deltah*d2rhodh2[i][j]+deltap*d2rhodhdp[i][j];
+		return frho[TTSE_NODE_DFDX]+deltah*frho[TTSE_NODE_D2FDX2]+deltap*frho[TTSE_NODE_D2FDXDY];
 	}
 
 	// Derivatives for constant h
 	else if (iOF == iT && iWRT == iP && iCONSTANT == iH)
 	{
 		// Derivative of T w.r.t. p for h constant
-		return dTdp[i][j]+deltap*d2Tdp2[i][j]+deltah*d2Tdhdp[i][j];
+		return fT[TTSE_NODE_DFDY]+deltap*fT[TTSE_NODE_D2FDY2]+deltah*fT[TTSE_NODE_D2FDXDY];
 	}
 	else if (iOF == iS && iWRT == iP && iCONSTANT == iH)
 	{
 		// Derivative of s w.r.t. p for h constant
-		return dsdp[i][j]+deltap*d2sdp2[i][j]+deltah*d2sdhdp[i][j];
+		return fs[TTSE_NODE_DFDY]+deltap*fs[TTSE_NODE_D2FDY2]+deltah*fs[TTSE_NODE_D2FDXDY];
 	}
 	else if (iOF == iD && iWRT == iP && iCONSTANT == iH)
 	{
 		// Derivative of density w.r.t. p for h constant
-		return drhodp[i][j]+deltap*d2rhodp2[i][j]+deltah*d2rhodhdp[i][j];
+		return frho[TTSE_NODE_DFDY]+deltap*frho[TTSE_NODE_D2FDY2]+deltah*frho[TTSE_NODE_D2FDXDY];
 	}
 	else{
 		throw ValueError(format("Your inputs [%d,%d,%d,%g,%g] are invalid to evaluate_first_derivative",iOF,iWRT,iCONSTANT,p,h));
@@ -2927,3 +2988,111 @@ double TTSETwoPhaseTableClass::check_randomly(long iParam, unsigned int N, std::
 	return val;
 }
 
+
+#ifndef DISABLE_CATCH
+#include "Catch/catch.hpp"
+TEST_CASE("TTSE and bicubic evaluation from the packed tables", "[fast],[TTSE]")
+{
+	Fluid *pFluid = get_fluid(get_Fluid_index("R245fa"));
+	CoolPropStateClassSI CPS(pFluid);
+
+	// Reference values from the EOS for a subcooled and a superheated state
+	double p[] = {1e6, 2e5}, h[] = {250e3, 480e3}, T[2], rho[2], s[2];
+	for (int i = 0; i < 2; i++)
+	{
+		CPS.update(iP, p[i], iH, h[i]);
+		T[i] = CPS.T(); rho[i] = CPS.rho(); s[i] = CPS.s();
+	}
+
+	CPS.disable_TTSE_LUT_writing();
+	CPS.set_TTSESinglePhase_LUT_size(100, 100);
+	CPS.enable_TTSE_LUT();
+	pFluid->build_TTSE_LUT();
+	TTSESinglePhaseTableClass &LUT = pFluid->TTSESinglePhase;
+
+	SECTION("packed blocks are aligned on cache lines")
+	{
+		CHECK((((std::size_t)&LUT.ph_nodes[0]) % 64) == 0);
+		CHECK((((std::size_t)&LUT.ph_cells[0]) % 64) == 0);
+		CHECK((((std::size_t)&LUT.Trho_nodes[0]) % 64) == 0);
+		CHECK((((std::size_t)&LUT.Trho_cells[0]) % 64) == 0);
+	}
+	SECTION("matrices are freed once the tables are packed")
+	{
+		CHECK(LUT.d2rhodhdp.empty());
+		CHECK(LUT.s_Trho.empty());
+		CHECK(LUT.ph_nodes.size() == 100*100*TTSE_PH_N*TTSE_NODE_BLOCK);
+	}
+	int modes[] = {TTSE_MODE_TTSE, TTSE_MODE_BICUBIC};
+	for (int m = 0; m < 2; m++)
+	{
+		LUT.set_mode(modes[m]);
+		for (int i = 0; i < 2; i++)
+		{
+			CPS.update(iP, p[i], iH, h[i]);
+			CHECK(fabs(CPS.T()/T[i]-1) < 1e-3);
+			CHECK(fabs(CPS.rho()/rho[i]-1) < 1e-3);
+			CHECK(fabs(CPS.s()/s[i]-1) < 1e-3);
+		}
+	}
+	SECTION("tables are mapped from file")
+	{
+		LUT.set_mode(TTSE_MODE_TTSE);
+		std::string path = LUT.root_path + "_catch";
+		LUT.write_all_to_file(path);
+
+		TTSESinglePhaseTableClass mapped(pFluid);
+		mapped.set_size_ph(100, 100);
+		mapped.set_size_Trho(100, 100);
+		mapped.hmin = LUT.hmin; mapped.hmax = LUT.hmax; mapped.pmin = LUT.pmin; mapped.pmax = LUT.pmax;
+		mapped.SatL = LUT.SatL; mapped.SatV = LUT.SatV;
+		REQUIRE(mapped.read_all_from_file(path));
+		// Zero-copy: the matrices are not filled, the packed tables are in the mapped file
+		CHECK(mapped.T.empty());
+		CHECK(mapped.ph_nodes.size() == LUT.ph_nodes.size());
+		CHECK(&mapped.ph_nodes[0] >= (const double *)mapped.mapped_file.data());
+		CHECK(&mapped.ph_nodes[0] < (const double *)(mapped.mapped_file.data() + mapped.mapped_file.size()));
+		for (int i = 0; i < 2; i++)
+		{
+			CHECK(mapped.evaluate(iT, p[i], log(p[i]), h[i]) == LUT.evaluate(iT, p[i], log(p[i]), h[i]));
+			CHECK(mapped.evaluate_one_other_input(iP, p[i], iS, s[i]) == LUT.evaluate_one_other_input(iP, p[i], iS, s[i]));
+			CHECK(fabs(mapped.evaluate_one_other_input(iP, p[i], iS, s[i])/h[i]-1) < 1e-3);
+		}
+		// Tables for another size are not used
+		TTSESinglePhaseTableClass other(pFluid);
+		other.set_size_ph(50, 100);
+		other.set_size_Trho(50, 100);
+		other.hmin = LUT.hmin; other.hmax = LUT.hmax; other.pmin = LUT.pmin; other.pmax = LUT.pmax;
+		CHECK(!other.read_all_from_file(path));
+
+		remove((path + "/" + TTSE_TABLE_FILE).c_str());
+		remove(path.c_str());
+	}
+	SECTION("tables do not depend on the number of build threads")
+	{
+		// The tables are built from the EOS
+		CPS.disable_TTSE_LUT();
+		TTSESinglePhaseTableClass serial(pFluid), threaded(pFluid);
+		serial.Nthreads_build = 1;
+		threaded.Nthreads_build = 4;
+		TTSESinglePhaseTableClass *tables[] = {&serial, &threaded};
+		for (int k = 0; k < 2; k++)
+		{
+			tables[k]->set_size_ph(40, 40);
+			tables[k]->set_size_Trho(40, 40);
+			tables[k]->SatL = &(pFluid->TTSESatL);
+			tables[k]->SatV = &(pFluid->TTSESatV);
+			tables[k]->build_ph(LUT.hmin, LUT.hmax, LUT.pmin, LUT.pmax, &(pFluid->TTSESatL), &(pFluid->TTSESatV));
+			tables[k]->build_Trho(-1, -1, -1, -1, &(pFluid->TTSESatL), &(pFluid->TTSESatV));
+		}
+		// Compared bit for bit since the nodes outside the range of the EOS are NaN
+		REQUIRE(serial.ph_nodes.size() == threaded.ph_nodes.size());
+		REQUIRE(serial.Trho_nodes.size() == threaded.Trho_nodes.size());
+		CHECK(memcmp(&serial.ph_nodes[0], &threaded.ph_nodes[0], serial.ph_nodes.size()*sizeof(double)) == 0);
+		CHECK(memcmp(&serial.Trho_nodes[0], &threaded.Trho_nodes[0], serial.Trho_nodes.size()*sizeof(double)) == 0);
+		CPS.enable_TTSE_LUT();
+	}
+	LUT.set_mode(TTSE_MODE_TTSE);
+	CPS.disable_TTSE_LUT();
+}
+#endif
@@ -4,13 +4,65 @@
 #include "FluidClass.h"
 
 class Fluid;
+class CoolPropStateClassSI;
 
 enum TTSE_MODES{ TTSE_MODE_TTSE,TTSE_MODE_BICUBIC};
 
+/// The packed tables store, for each node, one 64-byte block per property with the value and its derivatives
+/// with respect to the two inputs (x is h or T, y is p or rho).  The bicubic coefficients are stored as 16
+/// doubles (two cache lines) per cell and property
+enum TTSE_NODE_SLOTS{ TTSE_NODE_F, TTSE_NODE_DFDX, TTSE_NODE_DFDY, TTSE_NODE_D2FDX2, TTSE_NODE_D2FDY2, TTSE_NODE_D2FDXDY, TTSE_NODE_BLOCK = 8, TTSE_CELL_BLOCK = 16};
+/// The properties in the packed tables with p,h as inputs
+enum TTSE_PH_PROPERTIES{ TTSE_PH_T, TTSE_PH_RHO, TTSE_PH_S, TTSE_PH_N};
+/// The properties in the packed tables with T,rho as inputs
+enum TTSE_TRHO_PROPERTIES{ TTSE_TRHO_S, TTSE_TRHO_P, TTSE_TRHO_H, TTSE_TRHO_MU, TTSE_TRHO_K, TTSE_TRHO_N};
+
+/// A contiguous array of doubles with the first element aligned on a 64-byte cache line
+class TTSEAlignedArray
+{
+protected:
+	std::vector<double> buffer;
+	double *data;
+	std::size_t N;
+public:
+	TTSEAlignedArray(){ data = NULL; N = 0; };
+	TTSEAlignedArray(const TTSEAlignedArray &other){ data = NULL; N = 0; *this = other; };
+	TTSEAlignedArray & operator=(const TTSEAlignedArray &other);
+	/// Resize the array, all the elements are set to _HUGE
+	void resize(std::size_t N);
+	/// Use N elements of memory owned by someone else (a mapped file for instance) without copying them.  The 
+	/// memory must be 64-byte aligned and outlive the array
+	void view(double *data, std::size_t N);
+	std::size_t size() const { return N; };
+	double & operator[](std::size_t i){ return data[i]; };
+	const double & operator[](std::size_t i) const { return data[i]; };
+};
+
+/// A read-only mapping of a whole file into memory.  Copies of the handle share the same mapping, which
+/// is unmapped when the last copy is destroyed
+class TTSEMappedFile
+{
+protected:
+	/// The count is atomic since the tables, and so the copies of the handle, are shared between threads
+	struct Mapping{ void *addr; std::size_t length; CoolPropAtomicInt count; };
+	Mapping *mapping;
+	void release();
+public:
+	TTSEMappedFile(){ mapping = NULL; };
+	TTSEMappedFile(const TTSEMappedFile &other){ mapping = other.mapping; if (mapping != NULL){ mapping->count++; } };
+	TTSEMappedFile & operator=(const TTSEMappedFile &other);
+	~TTSEMappedFile(){ release(); };
+	/// Map the file, returns false if it could not be mapped
+	bool open(const std::string &fName);
+	/// Unmap the file (if this is the last copy of the handle)
+	void close(){ release(); };
+	const char * data() const { return (mapping != NULL) ? (const char *)mapping->addr : NULL; };
+	std::size_t size() const { return (mapping != NULL) ? mapping->length : 0; };
+};
+
 class BiCubicCellClass
 {
 public:
-	std::vector<double> alpha_s_hp, alpha_rho_hp, alpha_T_hp, alpha_s_Trho, alpha_h_Trho, alpha_p_Trho, alpha_mu_Trho, alpha_k_Trho;
 	bool valid_hp,valid_Trho;
 	BiCubicCellClass(){valid_hp = false; valid_Trho = false;};
 };
@@ -108,12 +160,17 @@ public:
 	double hmin,hmax,pmin,pmax,Tmin,Tmax,rhomin,rhomax;
 	bool enable_writing_tables_to_files;
 	bool enable_transport;
-
-	// Storage vectors for bicubic to keep from having to remake them every time (SLOW!)
-	std::vector<double> alpha_bicubic, z_bicubic;
+	/// The number of threads used to build the tables, the number of hardware threads if less than one
+	int Nthreads_build;
 
 	BiCubicCellsContainerClass bicubic_cells;
 
+	/// Packed copies of the tables that are used for the evaluation (see TTSE_NODE_SLOTS).  The matrices 
+	/// below are only used to build the tables and are freed once the tables are packed; when the tables are
+	/// read from file, the matrices are never filled and the packed arrays point directly into the mapped file
+	TTSEAlignedArray ph_nodes, ph_cells, Trho_nodes, Trho_cells;
+	TTSEMappedFile mapped_file;
+
 	// Variables with h, p as inputs
 	std::vector<std::vector<double> > T,dTdh,dTdp,d2Tdh2,d2Tdp2,d2Tdhdp;
 	std::vector<std::vector<double> > rho,drhodh,drhodp,d2rhodh2,d2rhodp2,d2rhodhdp;
@@ -134,12 +191,13 @@ public:
 
 	int set_mode(int mode);
 	int get_mode();
+	/// Map the tables from the file in the folder root_path if it was written for the same fluid, equation 
+	/// of state, ranges and sizes
+	/// @param root_path The folder with the tables
+	/// @returns True if the tables could be used, false if they need to be built
 	bool read_all_from_file(std::string root_path);
+	/// Write the tables to one binary file in the folder root_path, which can then be mapped by read_all_from_file
 	void write_all_to_file(std::string root_path = std::string());
-	void matrix_to_file(std::string fName, std::vector< std::vector<double> > *A);
-	void vector_to_file(std::string fName, std::vector<double> *A);
-	void vector_from_file(std::string fName, int N, std::vector<double> *A);
-	void matrix_from_file(std::string fName, std::vector< std::vector<double> > *A);
 
 	/// Set the sizes of the matrices with h,p as inputs
 	void set_size_ph(unsigned int Np = 100, unsigned int Nh = 100);
@@ -150,6 +208,23 @@ public:
 
 	void update_cell_validity();
 
+	/// Fill the packed node blocks and the bicubic coefficients from the matrices with p,h as inputs, and free the matrices
+	void pack_ph();
+	/// Fill the packed node blocks and the bicubic coefficients from the matrices with T,rho as inputs, and free the matrices
+	void pack_Trho();
+	/// The matrices with p,h as inputs, in the order of TTSE_PH_PROPERTIES and TTSE_NODE_SLOTS
+	std::vector< std::vector< std::vector<double> > * > ph_matrices();
+	/// The matrices with T,rho as inputs, in the order of TTSE_TRHO_PROPERTIES and TTSE_NODE_SLOTS
+	std::vector< std::vector< std::vector<double> > * > Trho_matrices();
+	/// Pointer to the packed block of the property k (one of TTSE_PH_PROPERTIES) at the node i,j
+	const double * node_ph(int i, int j, int k) const { return &ph_nodes[((i*Np+j)*TTSE_PH_N+k)*TTSE_NODE_BLOCK]; };
+	/// Pointer to the packed block of the property k (one of TTSE_TRHO_PROPERTIES) at the node i,j
+	const double * node_Trho(int i, int j, int k) const { return &Trho_nodes[((i*Nrho+j)*TTSE_TRHO_N+k)*TTSE_NODE_BLOCK]; };
+	/// Value of the property k (one of TTSE_PH_PROPERTIES) at the node i,j
+	double ph_value(int i, int j, int k) const { return node_ph(i,j,k)[TTSE_NODE_F]; };
+	/// Value of the property k (one of TTSE_TRHO_PROPERTIES) at the node i,j
+	double Trho_value(int i, int j, int k) const { return node_Trho(i,j,k)[TTSE_NODE_F]; };
+
 	/// Build the tables with p,h as the independent variables
 	/// @param hmin Minimum enthalpy [kJ/kg]
 	/// @param hmax Maximum enthalpy [kJ/kg]
@@ -158,6 +233,12 @@ public:
 	/// @param TTSESatL Saturated liquid TTSE LUT
 	/// @param TTSESatV Saturated vapor TTSE LUT
 	double build_ph(double hmin, double hmax, double pmin, double pmax, TTSETwoPhaseTableClass *SatL = NULL, TTSETwoPhaseTableClass *SatV = NULL);
+	/// Build the row i (constant enthalpy) of the tables with p,h as inputs, the axes must already be set
+	/// @param i Index in h
+	/// @param CPS The state class used for the calculations, one for each thread
+	/// @param TTSESatL Saturated liquid TTSE LUT
+	/// @param TTSESatV Saturated vapor TTSE LUT
+	void build_ph_row(unsigned int i, CoolPropStateClassSI &CPS, TTSETwoPhaseTableClass *SatL, TTSETwoPhaseTableClass *SatV);
 
 	/// Build the tables with T,rho as the independent variables
 	/// @param Tmin Minimum temperature [K]
@@ -167,6 +248,12 @@ public:
 	/// @param TTSESatL Saturated liquid TTSE LUT
 	/// @param TTSESatV Saturated vapor TTSE LUT
 	double build_Trho(double Tmin, double Tmax, double rhomin, double rhomax, TTSETwoPhaseTableClass *SatL, TTSETwoPhaseTableClass *SatV);
+	/// Build the row i (constant temperature) of the tables with T,rho as inputs, the axes must already be set
+	/// @param i Index in T
+	/// @param CPS The state class used for the calculations, one for each thread
+	/// @param TTSESatL Saturated liquid TTSE LUT
+	/// @param TTSESatV Saturated vapor TTSE LUT
+	void build_Trho_row(unsigned int i, CoolPropStateClassSI &CPS, TTSETwoPhaseTableClass *SatL, TTSETwoPhaseTableClass *SatV);
 	
 	/// Evaluate a property in the single-phase region with p,h as inputs
 	/// @param iParam Index of desired output
@@ -175,8 +262,14 @@ public:
 	/// @param h Enthalpy [kJ/kg]
 	double evaluate(long iParam, double p, double logp, double h);
 
-	/// Evaluate the TTSE using P,S or P,T
+	/// Evaluate the TTSE using P,S, P,T, P,D or P,U; returns the enthalpy
 	double evaluate_one_other_input(long iInput1, double Param1, long iOther, double Other);
+
+	/// The enthalpy with p,u as inputs.  The internal energy is not in the tables, so u = h-p/rho is solved for 
+	/// the enthalpy by Newton's method at constant pressure
+	/// @param p Pressure [Pa]
+	/// @param u Internal energy [J/kg]
+	double evaluate_one_other_input_u(double p, double u);
 	
 	/// See if the inputs are within range
 	bool within_range_one_other_input(long iInput1, double Input1, long iOther, double Other);
@@ -189,6 +282,21 @@ public:
 	/// @param rho Density [kg/m^3]
 	double evaluate_Trho(long iOutput, double T, double rho, double logrho);
 
+	/// Solve for the temperature at which the enthalpy (iOther = iH) or the internal energy (iOther = iU) has the
+	/// value Other at the density rho in the single-phase region, with T,rho as inputs
+	/// @param iOther iH or iU
+	/// @param rho Density [kg/m^3]
+	/// @param logrho Logarithm of the density [log(kg/m^3)]
+	/// @param Other Enthalpy or internal energy [J/kg]
+	/// @returns The temperature [K], or _HUGE if Other is above the range of the tables or below the lowest 
+	/// single-phase node at this density (the state might be two-phase then)
+	double evaluate_Trho_one_other_input(long iOther, double rho, double logrho, double Other);
+
+	/// The enthalpy (iOther = iH) or the internal energy (iOther = iU) with T,rho as inputs
+	double energy_Trho(long iOther, double T, double rho, double logrho);
+	/// The enthalpy or the internal energy at the node i,j of the tables with T,rho as inputs, not a valid number in the two-phase region
+	double Trho_node_energy(long iOther, int i, int j);
+
 	/// Evaluate a property in the two-phase region using bicubic interpolation with T,rho as inputs
 	/// @param iParam Index of desired output
 	/// @param T Pressure [kPa]
@@ -210,8 +318,8 @@ public:
 
 	void bicubic_cell_coordinates_Trho(double Tval, double rho, double logrhoval, int *i, int *j);
 	void bicubic_cell_coordinates_ph(double hval, double p, double logpval, int *i, int *j);
-	std::vector<double> * bicubic_cell_coeffs_Trho(long iParam, int i, int j);
-	std::vector<double> * bicubic_cell_coeffs_ph(long iParam, int i, int j);
+	const double * bicubic_cell_coeffs_Trho(long iParam, int i, int j);
+	const double * bicubic_cell_coeffs_ph(long iParam, int i, int j);
 	double bicubic_evaluate_first_derivative_ph(long iOF, long iWRT, long iCONSTANT, double p, double logp, double h);
 	double bicubic_evaluate_one_other_input(long iInput1, double Input1, long iOther, double Other);
 
@@ -229,7 +337,8 @@ public:
 	/// Write a representation of the ph surface to file with O in each "good" spot and "X" in each "bad" one or two-phase
 	void write_dotdrawing_tofile(char fName[]);
 
-	/// Find the nearest neighbor density and temperature if they exist to speed up calcs for the calculation of T(p,h) and rho(p,h)
+	/// Find the nearest neighbor density and temperature if they exist to speed up calcs for the calculation of T(p,h) and rho(p,h).
+	/// Only the neighbors at the same enthalpy are considered so that the rows can be built in parallel
 	/// @param i Index in h
 	/// @param j Index in p
 	/// @param T0 Temperature
@@ -287,7 +287,7 @@ TEST_CASE("Acetic acid validation from Piazza, FPE, 2011","[aceticacid],[validat
 }
 TEST_CASE("Check acetic derivatives residual","[aceticacid],[helmholtz]")
 {
-    AceticAcidClass Acetic = AceticAcidClass();
+    AceticAcidClass Acetic;
 	double eps = sqrt(DBL_EPSILON);
 	SECTION("dDelta")
 	{
@@ -323,7 +323,7 @@ TEST_CASE("Check acetic derivatives residual","[aceticacid],[helmholtz]")
 
 TEST_CASE("Check acetic derivatives ideal","[aceticacid],[helmholtz]")
 {
-    AceticAcidClass Acetic = AceticAcidClass();
+    AceticAcidClass Acetic;
 	double eps = sqrt(DBL_EPSILON);
 
 	SECTION("dDelta")
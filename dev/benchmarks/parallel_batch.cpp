@@ -0,0 +1,55 @@
+/*
+Scaling of the parallel array evaluation IPropsSIArrayParallel with the number of threads.
+
+T(p,h) is evaluated over a p-h grid that covers subcooled, two-phase, superheated and 
+supercritical states, for 1 to N threads, where N is the number of hardware threads.
+The output is one line per case of the form
+
+	fluid,threads,points,seconds,points_per_second
+*/
+#include "CoolProp.h"
+#include <cstdio>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+static void run(const char *fluid, long Nthreads_max)
+{
+	long iFluid = get_Fluid_index(fluid);
+	double pcrit = Props1SI(fluid, "pcrit");
+	
+	// h from the saturated liquid at the lowest pressure to well into the superheated region at the highest pressure
+	double pmin = PropsSI("P","T",Props1SI(fluid,"Tmin")+5,"Q",0,fluid);
+	double hmin = PropsSI("H","P",pmin,"Q",0,fluid);
+	double hmax = PropsSI("H","P",2*pcrit,"T",1.5*Props1SI(fluid,"Tcrit"),fluid);
+
+	const int N = 200;
+	std::vector<double> p, h, T(N*N);
+	for (int i = 0; i < N; i++){
+		for (int j = 0; j < N; j++){
+			p.push_back(pmin+(2*pcrit-pmin)*i/(N-1));
+			h.push_back(hmin+(hmax-hmin)*j/(N-1));
+		}
+	}
+	// Warm up, builds the ancillaries of the fluid
+	IPropsSIArrayParallel(iT,iP,&(p[0]),iH,&(h[0]),100,iFluid,1,&(T[0]));
+
+	for (long Nthreads = 1; Nthreads <= Nthreads_max; Nthreads++)
+	{
+		std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+		IPropsSIArrayParallel(iT,iP,&(p[0]),iH,&(h[0]),(long)p.size(),iFluid,Nthreads,&(T[0]));
+		std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+		double elapsed = std::chrono::duration<double>(t2-t1).count();
+		printf("%s,%ld,%ld,%g,%g\n", fluid, Nthreads, (long)p.size(), elapsed, p.size()/elapsed);
+	}
+}
+
+int main()
+{
+	long Nthreads_max = (long)std::thread::hardware_concurrency();
+	if (Nthreads_max < 1){ Nthreads_max = 1; }
+	printf("fluid,threads,points,seconds,points_per_second\n");
+	run("R134a", Nthreads_max);
+	run("Water", Nthreads_max);
+	return 0;
+}
@@ -0,0 +1,247 @@
+/*
+Time per call of PropsSI and of CoolPropStateClassSI::update for the CoolProp fluids.
+
+For each fluid, a state is chosen in each of the regions
+
+	subcooled      10 K below the saturation temperature halfway between Tmin and Tc
+	twophase       at the same saturation temperature with a quality of 0.5
+	superheated    10 K above the same saturation temperature
+	supercritical  1.2 Tc, 2 pc
+	nearcritical   1.002 Tc, 1.005 pc
+
+and the state is given by each of the input pairs TP, PH, PS, HS, TQ, PQ and DT (TQ and PQ only in the
+two-phase region, TP not in the two-phase region).  Each case is timed with the EOS and with the TTSE and
+bicubic tables.  States outside the range of the tables are evaluated with the EOS, as in PropsSI.
+The time to build the tables is not included.  The output is one line per case of the form
+
+	fluid,mode,region,pair,api,calls,us_per_call,us_per_call_min,status
+
+where us_per_call is the median and us_per_call_min the minimum over the repeats, and status is "ok" or
+"error" if the call failed.  The options are
+
+	--fluids Water,R134a    only these fluids (default: all of them)
+	--modes EOS,TTSE        only these modes, among EOS, TTSE and BICUBIC (default: all of them)
+	--calls 50              calls per repeat
+	--repeats 5             number of repeats
+
+The messages printed while the tables are built go to stderr.  Linux only.
+*/
+#include "CoolProp.h"
+#include "CPState.h"
+#include "CoolPropTools.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <unistd.h>
+
+struct RegionState
+{
+	std::string name;
+	double T, p, rho, h, s, Q;
+	bool twophase;
+};
+
+struct InputPair
+{
+	const char *name;
+	const char *Output; ///< The output of PropsSI, one that is not an input
+	long iInput1, iInput2;
+};
+
+static const InputPair pairs[] = {
+	{"TP", "D", iT, iP},
+	{"PH", "T", iP, iH},
+	{"PS", "T", iP, iS},
+	{"HS", "T", iH, iS},
+	{"TQ", "D", iT, iQ},
+	{"PQ", "T", iP, iQ},
+	{"DT", "P", iD, iT},
+};
+
+static double value(const RegionState &state, long iInput)
+{
+	switch (iInput)
+	{
+	case iT: return state.T;
+	case iP: return state.p;
+	case iD: return state.rho;
+	case iH: return state.h;
+	case iS: return state.s;
+	case iQ: return state.Q;
+	default: return _HUGE;
+	}
+}
+
+static std::string name(long iInput)
+{
+	switch (iInput)
+	{
+	case iT: return "T";
+	case iP: return "P";
+	case iD: return "D";
+	case iH: return "H";
+	case iS: return "S";
+	case iQ: return "Q";
+	default: return "";
+	}
+}
+
+/// The states in each region from the EOS; a region is left out if its state cannot be found
+static std::vector<RegionState> region_states(const std::string &fluid)
+{
+	std::vector<RegionState> states;
+	double Tmin = Props1SI(fluid, "Tmin"), Tc = Props1SI(fluid, "Tcrit"), pc = Props1SI(fluid, "pcrit");
+	double Tsat = (Tmin+Tc)/2, dT = std::min(10.0, (Tsat-Tmin)/2);
+	struct { const char *name; double T, p, Q; } cases[] = {
+		{"subcooled", Tsat-dT, -1, -1},
+		{"twophase", Tsat, -1, 0.5},
+		{"superheated", Tsat+dT, -1, -1},
+		{"supercritical", 1.2*Tc, 2*pc, -1},
+		{"nearcritical", 1.002*Tc, 1.005*pc, -1},
+	};
+	CoolPropStateClassSI CPS(fluid);
+	for (int i = 0; i < 5; i++)
+	{
+		RegionState state;
+		state.name = cases[i].name;
+		try
+		{
+			if (cases[i].Q >= 0)
+			{
+				CPS.update(iT, cases[i].T, iQ, cases[i].Q);
+			}
+			else if (cases[i].p < 0)
+			{
+				// At the saturation pressure of the two-phase state
+				double psat = PropsSI("P", "T", Tsat, "Q", (cases[i].T < Tsat) ? 0 : 1, fluid);
+				CPS.update(iT, cases[i].T, iP, psat);
+			}
+			else
+			{
+				CPS.update(iT, cases[i].T, iP, cases[i].p);
+			}
+			state.T = CPS.T(); state.p = CPS.p(); state.rho = CPS.rho(); state.h = CPS.h(); state.s = CPS.s();
+			state.twophase = (cases[i].Q >= 0);
+			state.Q = state.twophase ? cases[i].Q : -1;
+			if (ValidNumber(state.T) && ValidNumber(state.p) && ValidNumber(state.rho) && ValidNumber(state.h) && ValidNumber(state.s))
+			{
+				states.push_back(state);
+			}
+		}
+		catch (std::exception &){}
+	}
+	return states;
+}
+
+/// The median and the minimum of the time per call over the repeats [us]
+template <class F>
+static bool time_calls(F f, int Ncalls, int Nrepeats, double &median, double &minimum)
+{
+	std::vector<double> times;
+	// Warm up
+	if (!f()){ return false; }
+	for (int r = 0; r < Nrepeats; r++)
+	{
+		bool ok = true;
+		std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < Ncalls; i++){ ok = f() && ok; }
+		std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+		if (!ok){ return false; }
+		times.push_back(std::chrono::duration<double>(t2-t1).count()/Ncalls*1e6);
+	}
+	std::sort(times.begin(), times.end());
+	median = times[times.size()/2];
+	minimum = times[0];
+	return true;
+}
+
+static void run(FILE *out, const std::string &fluid, const std::vector<std::string> &modes, int Ncalls, int Nrepeats)
+{
+	Fluid *pFluid = get_fluid(get_Fluid_index(fluid));
+	std::vector<RegionState> states = region_states(fluid);
+
+	for (unsigned int m = 0; m < modes.size(); m++)
+	{
+		try
+		{
+			if (!modes[m].compare("EOS"))
+			{
+				pFluid->disable_TTSE_LUT();
+			}
+			else
+			{
+				pFluid->disable_TTSE_LUT_writing();
+				pFluid->enable_TTSE_LUT();
+				pFluid->build_TTSE_LUT();
+				pFluid->TTSESinglePhase.set_mode(!modes[m].compare("BICUBIC") ? TTSE_MODE_BICUBIC : TTSE_MODE_TTSE);
+			}
+		}
+		catch (std::exception &)
+		{
+			pFluid->disable_TTSE_LUT();
+			continue;
+		}
+
+		CoolPropStateClassSI CPS(pFluid);
+		for (unsigned int r = 0; r < states.size(); r++)
+		{
+			const RegionState &state = states[r];
+			for (unsigned int k = 0; k < sizeof(pairs)/sizeof(pairs[0]); k++)
+			{
+				const InputPair &pair = pairs[k];
+				// The quality only in the two-phase region, and T,P everywhere else
+				bool uses_Q = (pair.iInput2 == iQ), uses_TP = (pair.iInput1 == iT && pair.iInput2 == iP);
+				if ((uses_Q && !state.twophase) || (uses_TP && state.twophase)){ continue; }
+
+				double v1 = value(state, pair.iInput1), v2 = value(state, pair.iInput2);
+				std::string Output = pair.Output, Name1 = name(pair.iInput1), Name2 = name(pair.iInput2);
+				double median = 0, minimum = 0;
+
+				bool ok = time_calls([&](){ return ValidNumber(PropsSI(Output, Name1, v1, Name2, v2, fluid)); }, Ncalls, Nrepeats, median, minimum);
+				fprintf(out, "%s,%s,%s,%s,PropsSI,%d,%g,%g,%s\n", fluid.c_str(), modes[m].c_str(), state.name.c_str(), pair.name, Ncalls, median, minimum, ok ? "ok" : "error");
+
+				ok = time_calls([&](){
+					try{ CPS.update(pair.iInput1, v1, pair.iInput2, v2); }
+					catch (std::exception &){ return false; }
+					return ValidNumber(CPS.rho());
+				}, Ncalls, Nrepeats, median, minimum);
+				fprintf(out, "%s,%s,%s,%s,update,%d,%g,%g,%s\n", fluid.c_str(), modes[m].c_str(), state.name.c_str(), pair.name, Ncalls, median, minimum, ok ? "ok" : "error");
+				fflush(out);
+			}
+		}
+	}
+	pFluid->disable_TTSE_LUT();
+}
+
+int main(int argc, char **argv)
+{
+	std::vector<std::string> fluids = strsplit(get_global_param_string("FluidsList"), ',');
+	std::vector<std::string> modes = strsplit("EOS,TTSE,BICUBIC", ',');
+	int Ncalls = 50, Nrepeats = 5;
+	for (int i = 1; i+1 < argc; i += 2)
+	{
+		if (!strcmp(argv[i], "--fluids")){ fluids = strsplit(argv[i+1], ','); }
+		else if (!strcmp(argv[i], "--modes")){ modes = strsplit(argv[i+1], ','); }
+		else if (!strcmp(argv[i], "--calls")){ Ncalls = std::max(1, atoi(argv[i+1])); }
+		else if (!strcmp(argv[i], "--repeats")){ Nrepeats = std::max(1, atoi(argv[i+1])); }
+		else { fprintf(stderr, "Unknown option %s\n", argv[i]); return 1; }
+	}
+	// The messages printed while the tables are built go to stderr so that stdout only has the results
+	FILE *out = fdopen(dup(fileno(stdout)), "w");
+	fflush(stdout);
+	dup2(fileno(stderr), fileno(stdout));
+
+	fprintf(out, "fluid,mode,region,pair,api,calls,us_per_call,us_per_call_min,status\n");
+	for (unsigned int i = 0; i < fluids.size(); i++)
+	{
+		long type = getFluidType(fluids[i]);
+		if (type != FLUID_TYPE_PURE && type != FLUID_TYPE_PSEUDOPURE){ continue; }
+		run(out, fluids[i], modes, Ncalls, Nrepeats);
+	}
+	fclose(out);
+	return 0;
+}
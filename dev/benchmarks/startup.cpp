@@ -0,0 +1,101 @@
+/*
+Cost of loading CoolProp into a short-lived process.
+
+The program re-runs itself as a child process a number of times.  Each child either returns
+from main immediately ("load", which measures the static initialization of the library) or
+makes one call to PropsSI ("first_call", which also includes loading the fluid that is used).
+The wall time is measured by the parent from fork to exit and the resident memory is read by
+the child from /proc/self/status.  The output is one line per case of the form
+
+	case,runs,seconds,VmRSS_kB,VmHWM_kB
+
+where seconds is the median wall time over the runs.  Linux only.
+*/
+#include "CoolProp.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/// Read a field like "VmRSS:" in kB from /proc/self/status
+static long status_kB(const char *field)
+{
+	FILE *fp = fopen("/proc/self/status", "r");
+	if (fp == NULL){ return -1; }
+	char line[256];
+	long val = -1;
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		if (!strncmp(line, field, strlen(field)))
+		{
+			val = strtol(line + strlen(field), NULL, 10);
+			break;
+		}
+	}
+	fclose(fp);
+	return val;
+}
+
+static int child(const char *which, int fd)
+{
+	if (!strcmp(which, "first_call"))
+	{
+		PropsSI("T", "P", 101325, "Q", 0, "Water");
+	}
+	char buf[128];
+	int n = snprintf(buf, sizeof(buf), "%ld %ld", status_kB("VmRSS:"), status_kB("VmHWM:"));
+	if (write(fd, buf, n) != n){ return 1; }
+	return 0;
+}
+
+static void run(const char *self, const char *which, int Nruns)
+{
+	std::vector<double> times;
+	long RSS = -1, HWM = -1;
+	for (int i = 0; i < Nruns; i++)
+	{
+		int fds[2];
+		if (pipe(fds) != 0){ perror("pipe"); exit(1); }
+		std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+		pid_t pid = fork();
+		if (pid == 0)
+		{
+			close(fds[0]);
+			std::string fd = std::to_string(fds[1]);
+			execl(self, self, "--child", which, fd.c_str(), (char*)NULL);
+			_exit(127);
+		}
+		close(fds[1]);
+		int status;
+		waitpid(pid, &status, 0);
+		std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+		char buf[128] = {0};
+		if (read(fds[0], buf, sizeof(buf)-1) > 0)
+		{
+			sscanf(buf, "%ld %ld", &RSS, &HWM);
+		}
+		close(fds[0]);
+		times.push_back(std::chrono::duration<double>(t2-t1).count());
+	}
+	std::sort(times.begin(), times.end());
+	printf("%s,%d,%g,%ld,%ld\n", which, Nruns, times[times.size()/2], RSS, HWM);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc == 4 && !strcmp(argv[1], "--child"))
+	{
+		return child(argv[2], atoi(argv[3]));
+	}
+	int Nruns = (argc > 1) ? atoi(argv[1]) : 21;
+	if (Nruns < 1){ Nruns = 1; }
+	printf("case,runs,seconds,VmRSS_kB,VmHWM_kB\n");
+	run("/proc/self/exe", "load", Nruns);
+	run("/proc/self/exe", "first_call", Nruns);
+	return 0;
+}
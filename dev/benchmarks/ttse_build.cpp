@@ -0,0 +1,52 @@
+/*
+Time to build the single-phase TTSE tables as a function of the number of threads.
+
+The tables with p,h and T,rho as inputs are built from the EOS (tables cached on disk are not 
+used) for 1 to N threads, where N is the number of hardware threads.
+The output is one line per case of the form
+
+	fluid,threads,Nh,Np,seconds
+*/
+#include "CoolProp.h"
+#include "CPState.h"
+#include <cstdio>
+#include <chrono>
+#include <thread>
+
+static void run(const char *fluid, int Nthreads_max)
+{
+	const int Nh = 200, Np = 200;
+	Fluid *pFluid = get_fluid(get_Fluid_index(fluid));
+	// Builds the saturation tables and sets the range of the single-phase tables
+	pFluid->build_TTSE_LUT();
+	// The single-phase tables are built from the EOS
+	pFluid->disable_TTSE_LUT();
+	double hmin, hmax, pmin, pmax;
+	pFluid->get_TTSESinglePhase_LUT_range(&hmin, &hmax, &pmin, &pmax);
+
+	for (int Nthreads = 1; Nthreads <= Nthreads_max; Nthreads++)
+	{
+		TTSESinglePhaseTableClass LUT(pFluid);
+		LUT.Nthreads_build = Nthreads;
+		LUT.set_size_ph(Np, Nh);
+		LUT.set_size_Trho(Np, Nh);
+		LUT.SatL = &(pFluid->TTSESatL);
+		LUT.SatV = &(pFluid->TTSESatV);
+		std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+		LUT.build_ph(hmin, hmax, pmin, pmax, &(pFluid->TTSESatL), &(pFluid->TTSESatV));
+		LUT.build_Trho(-1, -1, -1, -1, &(pFluid->TTSESatL), &(pFluid->TTSESatV));
+		std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+		double elapsed = std::chrono::duration<double>(t2-t1).count();
+		printf("%s,%d,%d,%d,%g\n", fluid, Nthreads, Nh, Np, elapsed);
+	}
+}
+
+int main()
+{
+	int Nthreads_max = (int)std::thread::hardware_concurrency();
+	if (Nthreads_max < 1){ Nthreads_max = 1; }
+	printf("fluid,threads,Nh,Np,seconds\n");
+	run("R134a", Nthreads_max);
+	run("Water", Nthreads_max);
+	return 0;
+}
@@ -19,6 +19,7 @@ CoolPropSolver::CoolPropSolver(const std::string &mediumName, const std::string
 	debug_level     = 0;
 	calc_transport  = false;
 	extend_twophase = false;
+	continuation    = false;
 	twophase_derivsmoothing_xend = 0;
 	rho_smoothing_xend = 0;
 
@@ -68,6 +69,15 @@ CoolPropSolver::CoolPropSolver(const std::string &mediumName, const std::string
 				else
 					errorMessage((char*)format("I don't know how to handle this option [%s]",name_options[i].c_str()).c_str());
 			}
+			else if (!param_val[0].compare("enable_continuation"))
+			{
+				if (!param_val[1].compare("1") || !param_val[1].compare("true"))
+					continuation = true;
+				else if (!param_val[1].compare("0") || !param_val[1].compare("false"))
+					continuation = false;
+				else
+					errorMessage((char*)format("I don't know how to handle this option [%s]",name_options[i].c_str()).c_str());
+			}
 			else if (!param_val[0].compare("twophase_derivsmoothing_xend"))
 			{
 				twophase_derivsmoothing_xend = strtod(param_val[1].c_str(),NULL);
@@ -136,6 +146,12 @@ void CoolPropSolver::preStateChange(void) {
 				state->enable_EXTTP();
 			else
 				state->disable_EXTTP();
+
+			// Start the solvers from the previous state, which is usually close in a time integration
+			if (continuation)
+				state->enable_continuation();
+			else
+				state->disable_continuation();
 		}
 		catch(std::exception &e)
 		{
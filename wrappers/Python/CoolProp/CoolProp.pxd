@@ -60,6 +60,8 @@ cdef extern from "CPState.h":
         double speed_sound() except +
         double keyed_output(long iOutput) except +
         long phase() except +
+        ## Update and evaluate the outputs for a vector of state points, in SI units
+        long update_array(long iInput1, double *Value1, long iInput2, double *Value2, long length, long *iOutputs, long Noutputs, double *outputs, string *errstr) except +
 
         ## ---------------------------------------- 
         ## TTSE LUT things
@@ -232,6 +234,8 @@ cdef extern from "CPState.h":
         double speed_sound() except +
         double keyed_output(long iOutput) except +
         long phase() except +
+        ## Update and evaluate the outputs for a vector of state points, in SI units
+        long update_array(long iInput1, double *Value1, long iInput2, double *Value2, long length, long *iOutputs, long Noutputs, double *outputs, string *errstr) except +
 
         ## ---------------------------------------- 
         ## TTSE LUT things
@@ -361,6 +365,7 @@ cdef extern from "CoolPropDLL.h":
     int _set_reference_stateS "set_reference_stateS"(char *, char *)
     int _set_reference_stateD "set_reference_stateD"(char *, double T, double rho, double h0, double s0)
     int _get_standard_unit_system "get_standard_unit_system"()
+    long _IPropsSIArray "IPropsSIArray"(long iOutput, long iName1, const double *Prop1, long iName2, const double *Prop2, long length, long iFluid, double *outputs) nogil
     
 cdef extern from "CoolPropTools.h":
     bint _ValidNumber "ValidNumber"(double)
@@ -451,6 +456,7 @@ cdef class State:
     cpdef update(self, dict params)
     cpdef update_ph(self, double p, double h)
     cpdef update_Trho(self, double T, double rho)
+    cpdef tuple update_array(self, long iInput1, Value1, long iInput2, Value2, outputs)
     cpdef State copy(self)
     cpdef double Props(self, long iOutput) except *
     cpdef long Phase(self) except *
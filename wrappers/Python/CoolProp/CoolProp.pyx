@@ -23,6 +23,8 @@ from param_constants_header cimport *
 from phase_constants import *
 from phase_constants_header cimport *
 
+from libcpp.vector cimport vector
+
 cpdef bint iterable(object a):
     if _numpy_supported:
         return isinstance(a,(list,tuple, np.ndarray))
@@ -351,7 +353,65 @@ cpdef __PropsSI_err2(in1, in2, in3, in4, in5, in6, errstr):
         raise ValueError("{err:s} :: inputs were:\"{in1:s}\",\"{in2:s}\",{in3:0.16e},\"{in4:s}\",{in5:0.16e},\"{in6:s}\"".format(err=errstr,in1=in1,in2=in2,in3=in3,in4=in4,in5=in5,in6=in6))
     else:
         raise ValueError("PropsSI failed ungracefully :: inputs were:\"{in1:s}\",\"{in2:s}\",{in3:0.16e},\"{in4:s}\",{in5:0.16e},\"{in6:s}\"; please file a ticket at https://github.com/ibell/coolprop/issues".format(in1=in1,in2=in2,in3=in3,in4=in4,in5=in5,in6=in6))
-                        
+
+cdef object __PropsSI_vector(in1, in2, in3, in4, in5, in6):
+    """
+    PropsSI over arrays of inputs for a CoolProp fluid.  The keys and the fluid are only resolved once,
+    and the loop over the state points runs in C++ with the GIL released, writing straight into the output array.
+    ``in3`` and ``in5`` are converted to contiguous arrays of doubles, a scalar is repeated to the length of the other input.
+
+    Returns None if this path cannot be used (no numpy, not a CoolProp fluid, invalid key, inputs
+    that are not one-dimensional), in which case the caller falls back to calling _PropsSI for each point
+    """
+    cdef long iOutput, iName1, iName2, iFluid, N, Nfail, i
+    cdef double[::1] _in3, _in5, _out
+
+    fluid = in6.decode('ascii') if isinstance(in6, bytes) else str(in6)
+    if not _numpy_supported or fluid.startswith('REFPROP-'):
+        return None
+    iFluid = _get_Fluid_index(in6)
+    iOutput = _get_param_index(in1)
+    iName1 = _get_param_index(in2)
+    iName2 = _get_param_index(in4)
+    if iFluid < 0 or iOutput < 0 or iName1 < 0 or iName2 < 0:
+        return None
+
+    # The dimensions are taken before the conversion, np.ascontiguousarray makes a scalar one-dimensional
+    ndim3 = np.ndim(in3)
+    ndim5 = np.ndim(in5)
+    if ndim3 == 0 and ndim5 == 1:
+        a5 = np.ascontiguousarray(in5, dtype = np.float64)
+        a3 = np.full(a5.shape, float(in3), dtype = np.float64)
+    elif ndim5 == 0 and ndim3 == 1:
+        a3 = np.ascontiguousarray(in3, dtype = np.float64)
+        a5 = np.full(a3.shape, float(in5), dtype = np.float64)
+    elif ndim3 == 1 and ndim5 == 1:
+        a3 = np.ascontiguousarray(in3, dtype = np.float64)
+        a5 = np.ascontiguousarray(in5, dtype = np.float64)
+    else:
+        return None
+    if len(a3) != len(a5) : raise TypeError('Lengths of iterables must be the same')
+
+    N = len(a3)
+    out = np.empty(N, dtype = np.float64)
+    if N == 0:
+        return out
+    _in3 = a3
+    _in5 = a5
+    _out = out
+    with nogil:
+        Nfail = _IPropsSIArray(iOutput, iName1, &_in3[0], iName2, &_in5[0], N, iFluid, &_out[0])
+
+    if Nfail > 0:
+        # Raise for the first point that failed, as the loop over the points would have done
+        for i in range(N):
+            if not _ValidNumber(_out[i]):
+                val = _PropsSI(in1, in2, _in3[i], in4, _in5[i], in6)
+                if not _ValidNumber(val):
+                    __PropsSI_err2(in1,in2,_in3[i],in4,_in5[i],in6,_get_global_param_string('errstring'))
+                _out[i] = val
+    return out
+
 cpdef PropsSI(in1, in2, in3 = None, in4 = None, in5 = None, in6 = None, in7 = None):
     """
     Just like Props(), but this function ALWAYS takes in and returns SI units (K, kg, J/kg, Pa, N/m, etc.)
@@ -427,7 +487,8 @@ cpdef PropsSI(in1, in2, in3 = None, in4 = None, in5 = None, in6 = None, in7 = No
     =========================  ======================================
     
     **Python Only** : InputProp1 and InputProp2 can be lists or numpy arrays.  If both are iterables, they must be the same size. 
-    
+    For a CoolProp fluid, the loop over the state points is carried out in C++ without holding the GIL, so that 
+    other Python threads can run in the meantime.
     
     If `InputName1` is `T` and `OutputName` is ``I`` or ``SurfaceTension``, the second input is neglected
     since surface tension is only a function of temperature
@@ -447,7 +508,11 @@ cpdef PropsSI(in1, in2, in3 = None, in4 = None, in5 = None, in6 = None, in7 = No
                 __PropsSI_err2(in1,in2,in3,in4,in5,in6,_get_global_param_string('errstring'))
             else:
                 return val
-        elif iterable(in3) and iterable(in5):
+        else:
+            vals = __PropsSI_vector(in1, in2, in3, in4, in5, in6)
+            if vals is not None:
+                return vals
+        if iterable(in3) and iterable(in5):
             if len(in3) != len(in5) : raise TypeError('Lengths of iterables must be the same')
             vals = []
             for _in3, _in5 in zip(in3,in5):
@@ -1018,6 +1083,71 @@ cdef class State:
         else:
             return _Props(paras[iOutput],'T',self.T_,'D',self.rho_,self.Fluid)
             
+    cpdef tuple update_array(self, long iInput1, Value1, long iInput2, Value2, outputs):
+        """
+        Update the state for each of the state points given by the arrays ``Value1`` and ``Value2`` and
+        evaluate the ``outputs`` at each of them.  The loop over the state points is carried out in C++,
+        so there is only one call from Python.  Inputs and outputs are in the standard unit system, as for update()
+        
+        Parameters
+        ----------
+        iInput1, iInput2: int
+            The indices of the inputs in param_constants
+        Value1, Value2: array-like
+            The values of the inputs, of the same length
+        outputs: list
+            The output keys, either indices in param_constants or their names
+        
+        Returns ``(values, Nfail)``.  ``values`` is a numpy array of shape ``(len(outputs), len(Value1))``, 
+        where ``values[j,i]`` is the output ``outputs[j]`` at the state point ``i``.  ``Nfail`` is the number of 
+        state points that could not be evaluated, their outputs are NaN and a warning with the last error is issued.
+        The state is left at the last state point.  Requires numpy and a CoolProp fluid.
+        """
+        cdef double[::1] _Value1, _Value2
+        cdef double[:,::1] _out
+        cdef vector[long] iOutputs
+        cdef long N, Noutputs = len(outputs), Nfail = 0, i, j
+        cdef int unit_system = _get_standard_unit_system()
+        cdef double T, rho
+        cdef string errstr
+        
+        if not _numpy_supported:
+            raise NotImplementedError('update_array requires numpy')
+        if not self.is_CPFluid:
+            raise NotImplementedError('update_array is only defined for CoolProp fluids')
+        
+        # Copies, since the inputs are converted to SI units in place
+        _Value1 = np.array(Value1, dtype = np.float64, ndmin = 1)
+        _Value2 = np.array(Value2, dtype = np.float64, ndmin = 1)
+        N = _Value1.shape[0]
+        if _Value2.shape[0] != N : raise TypeError('Lengths of iterables must be the same')
+        for key in outputs:
+            iOutputs.push_back(key if isinstance(key, (int, long)) else _get_param_index(key))
+            if iOutputs.back() < 0 : raise ValueError('Your output key [{key:s}] is not valid'.format(key = str(key)))
+        
+        out = np.empty((Noutputs, N), dtype = np.float64)
+        _out = out
+        if N > 0 and Noutputs > 0:
+            for i in range(N):
+                _Value1[i] = _toSIints(iInput1, _Value1[i], unit_system)
+                _Value2[i] = _toSIints(iInput2, _Value2[i], unit_system)
+            Nfail = self.CPS.update_array(iInput1, &_Value1[0], iInput2, &_Value2[0], N, &iOutputs[0], Noutputs, &_out[0,0], &errstr)
+            for j in range(Noutputs):
+                for i in range(N):
+                    if _ValidNumber(_out[j,i]):
+                        _out[j,i] = _fromSIints(iOutputs[j], _out[j,i], unit_system)
+                    else:
+                        _out[j,i] = np.nan
+            if Nfail > 0:
+                warnings.warn("{Nfail:d} of {N:d} state points could not be evaluated, the last error was: {err:s}".format(Nfail = Nfail, N = N, err = errstr))
+            T = self.CPS.T()
+            rho = self.CPS.rho()
+            if _ValidNumber(T) and _ValidNumber(rho):
+                self.T_ = T
+                self.p_ = _fromSIints(iP, self.CPS.p(), unit_system)
+                self.rho_ = rho
+        return out, Nfail
+    
     cpdef double get_Q(self) except *:
         """ Get the quality [-] """
         return self.Props(iQ)
@@ -1,7 +1,11 @@
 from __future__ import division, print_function
+import unittest
+import warnings
+import numpy as np
 import CoolProp.CoolProp as CP
 import CoolProp.unit_systems_constants
 from CoolProp import param_constants
+from CoolProp.param_constants import iT, iP, iH
 from CoolProp.State import State
 
 def first_derivative(S, func, iVal, Val, iConstant, Constant, epsilon = 1e-3):
@@ -143,6 +147,35 @@ def check_sat_second_derivatives(S, func, iVal, Val, iConstant, Constant, deriv_
     if abs(EOS_val/Deriv_val-1) > 1e-2:
         raise ValueError('Finite Diff: ' + str(Deriv_val) + ' EOS: ' +str(EOS_val))
         
+class StateUpdateArray(unittest.TestCase):
+    def testGoodAndBadPoints(self):
+        S = State('R134a',dict(T=300,D=1))
+        T = [300, 310, 320, 330]
+        p = [S.p, 2*S.p, -1, 3*S.p] # The third point is bad
+        with warnings.catch_warnings(record = True) as w:
+            warnings.simplefilter('always')
+            values, Nfail = S.update_array(iT, T, iP, p, [iH, 'D'])
+        self.assertEqual(Nfail, 1)
+        self.assertEqual(len(w), 1)
+        self.assertEqual(values.shape, (2, 4))
+        self.assertTrue(np.all(np.isnan(values[:,2])))
+        # Output-major: each row is one output at all the state points
+        for i in [0, 1, 3]:
+            S2 = State('R134a',dict(T=T[i],P=p[i]))
+            self.assertAlmostEqual(values[0,i]/S2.h, 1, places = 10)
+            self.assertAlmostEqual(values[1,i]/S2.rho, 1, places = 10)
+        # The state is left at the last point
+        self.assertEqual(S.T, T[-1])
+    def testAllGood(self):
+        S = State('R134a',dict(T=300,D=1))
+        values, Nfail = S.update_array(iT, [300, 310], iP, [S.p, S.p], ['H'])
+        self.assertEqual(Nfail, 0)
+        self.assertEqual(values.shape, (1, 2))
+        self.assertFalse(np.any(np.isnan(values)))
+    def testUnmatchedLengths(self):
+        S = State('R134a',dict(T=300,D=1))
+        self.assertRaises(TypeError, S.update_array, iT, [300, 310], iP, [S.p], ['H'])
+        
 if __name__=='__main__':
     import nose
     nose.runmodule()
\ No newline at end of file
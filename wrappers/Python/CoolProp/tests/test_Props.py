@@ -1,5 +1,5 @@
 import unittest
-from CoolProp.CoolProp import Props
+from CoolProp.CoolProp import Props, PropsSI
 import CoolProp
 import numpy as np
        
@@ -20,6 +20,28 @@ class PropsFailures(unittest.TestCase):
     def testMatrix(self):
         self.assertRaises(TypeError,Props,'P','T',np.array([280,290,300,280,290,300]).reshape(2,3),'Q',np.array([0,0.5,1,0.0,0.5,1]).reshape(2,3),'R134a')
 
+class PropsSIVectors(unittest.TestCase):
+    def testScalarAndList(self):
+        vals = PropsSI('H','T',300,'P',[1e5,2e5],'Water')
+        self.assertEqual(len(vals), 2)
+        for val, p in zip(vals, [1e5,2e5]):
+            self.assertEqual(val, PropsSI('H','T',300,'P',p,'Water'))
+    def testListAndScalar(self):
+        vals = PropsSI('H','T',[300,310],'P',1e5,'Water')
+        self.assertEqual(len(vals), 2)
+        for val, T in zip(vals, [300,310]):
+            self.assertEqual(val, PropsSI('H','T',T,'P',1e5,'Water'))
+    def testTwoArrays(self):
+        T = np.linspace(300,350,5)
+        p = np.linspace(1e5,5e5,5)
+        vals = PropsSI('D','T',T,'P',p,'R134a')
+        for i in range(5):
+            self.assertEqual(vals[i], PropsSI('D','T',T[i],'P',p[i],'R134a'))
+    def testUnmatchedLengths(self):
+        self.assertRaises(TypeError,PropsSI,'H','T',[300,310,320],'P',[1e5,2e5],'Water')
+    def testBadPoint(self):
+        self.assertRaises(ValueError,PropsSI,'H','T',[300,310],'P',[1e5,-1],'Water')
+
 if __name__=='__main__':
     import nose
     nose.runmodule()
\ No newline at end of file